@@ -1004,6 +1004,15 @@ const infomap player_times[] =   {{ "seektime",         PLAYER_SEEKTIME },
 ///     @skinning_v17 **[New Infolabel]** \link Player_Process_audiobitspersample `Player.Process(audiobitspersample)`\endlink
 ///     <p>
 ///   }
+///   \table_row3{   <b>`Player.Process(videodecoderpolicy)`</b>,
+///                  \anchor Player_Process_videodecoderpolicy
+///                  _string_,
+///     @return How the software video decoder of the currently playing video uses threads and
+///     what it skips to keep up, e.g. "frame x6, skip loopfilter nonref".
+///     <p><hr>
+///     @skinning_v19 **[New Infolabel]** \link Player_Process_videodecoderpolicy `Player.Process(videodecoderpolicy)`\endlink
+///     <p>
+///   }
 /// \table_end
 ///
 /// -----------------------------------------------------------------------------
@@ -1021,7 +1030,8 @@ const infomap player_process[] =
   { "audiodecoder", PLAYER_PROCESS_AUDIODECODER },
   { "audiochannels", PLAYER_PROCESS_AUDIOCHANNELS },
   { "audiosamplerate", PLAYER_PROCESS_AUDIOSAMPLERATE },
-  { "audiobitspersample", PLAYER_PROCESS_AUDIOBITSPERSAMPLE }
+  { "audiobitspersample", PLAYER_PROCESS_AUDIOBITSPERSAMPLE },
+  { "videodecoderpolicy", PLAYER_PROCESS_VIDEODECODERPOLICY }
 };
 
 /// \page modules__infolabels_boolean_conditions
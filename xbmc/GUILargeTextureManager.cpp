@@ -17,6 +17,7 @@
 #include "utils/log.h"
 #include "windowing/GraphicContext.h"
 
+#include <algorithm>
 #include <cassert>
 
 CImageLoader::CImageLoader(const std::string &path, const bool useCache):
@@ -36,6 +37,10 @@ bool CImageLoader::DoWork()
   bool needsChecking = false;
   std::string loadPath;
 
+  // tells the manager the load started, it won't queue the image again from now on
+  if (ShouldCancel(0, 0))
+    return false;
+
   std::string texturePath = CServiceBroker::GetGUI()->GetTextureManager().GetTexturePath(m_path);
   if (texturePath.empty())
     return false;
@@ -133,6 +138,8 @@ CGUILargeTextureManager::~CGUILargeTextureManager() = default;
 void CGUILargeTextureManager::CleanupUnusedImages(bool immediately)
 {
   CSingleLock lock(m_listSection);
+  LogStatistics();
+
   // check for items to remove from allocated list, and remove
   listIterator it = m_allocated.begin();
   while (it != m_allocated.end())
@@ -150,13 +157,23 @@ void CGUILargeTextureManager::CleanupUnusedImages(bool immediately)
 bool CGUILargeTextureManager::GetImage(const std::string &path, CTextureArray &texture, bool firstRequest, const bool useCache)
 {
   CSingleLock lock(m_listSection);
+  if (firstRequest)
+    m_stats.requests++;
+
   for (listIterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
   {
     CLargeTexture *image = *it;
     if (image->GetPath() == path)
     {
       if (firstRequest)
+      {
         image->AddRef();
+        if (image->IsPrefetched())
+          m_stats.prefetchHits++;
+        else
+          m_stats.hits++;
+        image->SetPrefetched(false);
+      }
       texture = image->GetTexture();
       return texture.size() > 0;
     }
@@ -189,6 +206,7 @@ void CGUILargeTextureManager::ReleaseImage(const std::string &path, bool immedia
     {
       // cancel this job
       CJobManager::GetInstance().CancelJob(id);
+      m_loading.erase(id);
       m_queued.erase(it);
       return;
     }
@@ -208,6 +226,20 @@ void CGUILargeTextureManager::QueueImage(const std::string &path, bool useCache)
     if (image->GetPath() == path)
     {
       image->AddRef();
+      if (image->IsPrefetched())
+      {
+        m_stats.prefetchPending++;
+        image->SetPrefetched(false);
+
+        // already being decoded, queueing it again would decode it twice
+        if (m_loading.find(it->first) != m_loading.end())
+          return;
+
+        // it's on screen now, it mustn't wait behind the other prefetches
+        CJobManager::GetInstance().CancelJob(it->first);
+        it->first = CJobManager::GetInstance().AddJob(new CImageLoader(path, useCache), this,
+                                                      CJob::PRIORITY_NORMAL);
+      }
       return; // already queued
     }
   }
@@ -218,10 +250,21 @@ void CGUILargeTextureManager::QueueImage(const std::string &path, bool useCache)
   m_queued.emplace_back(jobID, image);
 }
 
+void CGUILargeTextureManager::OnJobProgress(unsigned int jobID,
+                                            unsigned int progress,
+                                            unsigned int total,
+                                            const CJob* job)
+{
+  // the loader started
+  CSingleLock lock(m_listSection);
+  m_loading.insert(jobID);
+}
+
 void CGUILargeTextureManager::OnJobComplete(unsigned int jobID, bool success, CJob *job)
 {
   // see if we still have this job id
   CSingleLock lock(m_listSection);
+  m_loading.erase(jobID);
   for (queueIterator it = m_queued.begin(); it != m_queued.end(); ++it)
   {
     if (it->first == jobID)
@@ -236,3 +279,124 @@ void CGUILargeTextureManager::OnJobComplete(unsigned int jobID, bool success, CJ
     }
   }
 }
+
+void CGUILargeTextureManager::Prefetch(const void *owner, const std::vector<std::string> &paths)
+{
+  CSingleLock lock(m_listSection);
+
+  auto it = m_prefetch.find(owner);
+  if (it == m_prefetch.end())
+  {
+    if (paths.empty())
+      return;
+    it = m_prefetch.insert(std::make_pair(owner, std::vector<std::string>())).first;
+  }
+
+  std::vector<std::string> &current = it->second;
+  if (current == paths)
+    return;
+
+  // add the new ones first so that images in both sets are never released in between
+  std::vector<std::string> wanted;
+  wanted.reserve(paths.size());
+  for (const auto& path : paths)
+  {
+    if (path.empty() || std::find(wanted.begin(), wanted.end(), path) != wanted.end())
+      continue;
+    wanted.push_back(path);
+    if (std::find(current.begin(), current.end(), path) == current.end())
+      AddPrefetch(path);
+  }
+
+  // the rest is stale
+  for (const auto& path : current)
+  {
+    if (std::find(wanted.begin(), wanted.end(), path) == wanted.end())
+      ReleasePrefetch(path);
+  }
+
+  if (wanted.empty())
+    m_prefetch.erase(it);
+  else
+    current = std::move(wanted);
+}
+
+void CGUILargeTextureManager::AddPrefetch(const std::string &path)
+{
+  for (const auto& image : m_allocated)
+  {
+    if (image->GetPath() == path)
+    {
+      image->AddRef();
+      return;
+    }
+  }
+
+  for (const auto& queued : m_queued)
+  {
+    if (queued.second->GetPath() == path)
+    {
+      queued.second->AddRef();
+      return;
+    }
+  }
+
+  CLargeTexture *image = new CLargeTexture(path);
+  image->SetPrefetched(true);
+  unsigned int jobID = CJobManager::GetInstance().AddJob(new CImageLoader(path, true), this, CJob::PRIORITY_LOW);
+  m_queued.emplace_back(jobID, image);
+  m_stats.prefetched++;
+}
+
+void CGUILargeTextureManager::ReleasePrefetch(const std::string &path)
+{
+  for (queueIterator it = m_queued.begin(); it != m_queued.end(); ++it)
+  {
+    if (it->second->GetPath() == path)
+    {
+      if (it->second->DecrRef(true))
+      {
+        // nobody wants it anymore, don't waste a decode on it
+        CJobManager::GetInstance().CancelJob(it->first);
+        m_loading.erase(it->first);
+        m_queued.erase(it);
+        m_stats.cancelled++;
+      }
+      return;
+    }
+  }
+
+  for (const auto& image : m_allocated)
+  {
+    if (image->GetPath() == path)
+    {
+      // keep it around for the usual delay in case it is requested after all
+      image->DecrRef(false);
+      return;
+    }
+  }
+}
+
+CGUILargeTextureManager::Statistics CGUILargeTextureManager::GetStatistics() const
+{
+  CSingleLock lock(m_listSection);
+  return m_stats;
+}
+
+void CGUILargeTextureManager::LogStatistics()
+{
+  static const unsigned int LOG_INTERVAL = 60000;
+
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  if (now - m_lastStatsLog < LOG_INTERVAL || !m_stats.requests)
+    return;
+  m_lastStatsLog = now;
+
+  CLog::Log(LOGDEBUG,
+            "CGUILargeTextureManager: %u requests, %.1f%% hits, %.1f%% prefetch hits, %.1f%% "
+            "pending prefetches, %u prefetched, %u cancelled, %zu images allocated",
+            m_stats.requests, 100.0f * m_stats.hits / m_stats.requests,
+            100.0f * m_stats.prefetchHits / m_stats.requests,
+            100.0f * m_stats.prefetchPending / m_stats.requests, m_stats.prefetched,
+            m_stats.cancelled, m_allocated.size());
+}
@@ -12,6 +12,8 @@
 #include "threads/CriticalSection.h"
 #include "utils/Job.h"
 
+#include <map>
+#include <set>
 #include <utility>
 #include <vector>
 
@@ -63,6 +65,15 @@ public:
    */
   void OnJobComplete(unsigned int jobID, bool success, CJob *job) override;
 
+  /*!
+   \brief Callback from CImageLoader when it starts loading an image
+
+   A load in progress isn't queued again when a prefetched image gets requested.
+
+   \sa CImageLoader, IJobCallback
+   */
+  void OnJobProgress(unsigned int jobID, unsigned int progress, unsigned int total, const CJob *job) override;
+
   /*!
    \brief Request a texture to be loaded in the background.
 
@@ -103,6 +114,33 @@ public:
    */
   void CleanupUnusedImages(bool immediately = false);
 
+  /*!
+   \brief Set the images an owner (usually a container) expects to be requested soon.
+
+   The images are queued at low priority and kept referenced for as long as they are in the owner's
+   set. Images that drop out of the set are released again, which cancels their load if it hasn't
+   finished yet. Images already loaded or queued are not loaded twice.
+
+   \param owner identifies the caller, each owner has its own set of images.
+   \param paths images in the order they are expected to be needed. An empty list clears the set.
+   */
+  void Prefetch(const void *owner, const std::vector<std::string> &paths);
+
+  struct Statistics
+  {
+    unsigned int requests = 0; ///< first requests for an image by a texture
+    unsigned int hits = 0; ///< requested images that were already loaded
+    unsigned int prefetchHits = 0; ///< requested images that were loaded by prefetching
+    unsigned int prefetchPending = 0; ///< requested images that were still being prefetched
+    unsigned int prefetched = 0; ///< images queued for prefetching
+    unsigned int cancelled = 0; ///< prefetches cancelled before they were loaded
+  };
+
+  /*!
+   \brief Request counters since startup, useful to size the cache and the prefetch window.
+   */
+  Statistics GetStatistics() const;
+
 private:
   class CLargeTexture
   {
@@ -118,6 +156,9 @@ private:
     const std::string &GetPath() const { return m_path; };
     const CTextureArray &GetTexture() const { return m_texture; };
 
+    bool IsPrefetched() const { return m_prefetched; }
+    void SetPrefetched(bool prefetched) { m_prefetched = prefetched; }
+
   private:
     static const unsigned int TIME_TO_DELETE = 2000;
 
@@ -125,15 +166,24 @@ private:
     std::string m_path;
     CTextureArray m_texture;
     unsigned int m_timeToDelete;
+    bool m_prefetched = false; ///< loaded for a prefetch and not requested by a texture yet
   };
 
   void QueueImage(const std::string &path, bool useCache = true);
+  void AddPrefetch(const std::string &path);
+  void ReleasePrefetch(const std::string &path);
+  void LogStatistics();
 
   std::vector< std::pair<unsigned int, CLargeTexture *> > m_queued;
   std::vector<CLargeTexture *> m_allocated;
   typedef std::vector<CLargeTexture *>::iterator listIterator;
   typedef std::vector< std::pair<unsigned int, CLargeTexture *> >::iterator queueIterator;
 
-  CCriticalSection m_listSection;
+  std::set<unsigned int> m_loading; ///< jobs of m_queued that are loading their image
+  std::map<const void *, std::vector<std::string>> m_prefetch;
+  Statistics m_stats;
+  unsigned int m_lastStatsLog = 0;
+
+  mutable CCriticalSection m_listSection;
 };
 
@@ -77,7 +77,11 @@ bool CTextureCacheJob::CacheTexture(CTexture** out_texture)
   else if (m_details.hash == m_oldHash)
     return true;
 
-  CTexture* texture = LoadImage(image, width, height, additional_info, true);
+  // never decode larger than we cache, so big images are scaled down by the decoder
+  unsigned int decodeWidth = width, decodeHeight = height;
+  CPicture::GetMaxCacheSize(decodeWidth, decodeHeight);
+
+  CTexture* texture = LoadImage(image, decodeWidth, decodeHeight, additional_info, true);
   if (texture)
   {
     if (texture->HasAlpha())
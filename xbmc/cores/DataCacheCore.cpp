@@ -19,6 +19,7 @@ CDataCacheCore::CDataCacheCore() :
   m_playerAudioInfo {},
   m_contentInfo {},
   m_renderInfo {},
+  m_demuxInfo {},
   m_stateInfo {}
 {
   m_hasAVInfoChanges = false;
@@ -50,6 +51,19 @@ void CDataCacheCore::Reset()
     m_contentInfo.m_chapters.clear();
     m_contentInfo.m_cutList.clear();
   }
+
+  {
+    CSingleLock lock(m_demuxSection);
+
+    m_demuxInfo.m_stalls = 0;
+    m_demuxInfo.m_stallTime = 0;
+  }
+
+  {
+    CSingleLock lock(m_startupSection);
+
+    m_startupInfo = {};
+  }
 }
 
 bool CDataCacheCore::HasAVInfoChanges()
@@ -96,6 +110,19 @@ bool CDataCacheCore::IsVideoHwDecoder()
   return m_playerVideoInfo.isHwDecoder;
 }
 
+void CDataCacheCore::SetVideoDecoderPolicy(std::string policy)
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  m_playerVideoInfo.decoderPolicy = std::move(policy);
+}
+
+std::string CDataCacheCore::GetVideoDecoderPolicy()
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  return m_playerVideoInfo.decoderPolicy;
+}
 
 void CDataCacheCore::SetVideoDeintMethod(std::string method)
 {
@@ -285,6 +312,46 @@ bool CDataCacheCore::IsRenderClockSync()
 }
 
 // player states
+void CDataCacheCore::AddDemuxStall(unsigned int ms)
+{
+  CSingleLock lock(m_demuxSection);
+
+  m_demuxInfo.m_stalls++;
+  m_demuxInfo.m_stallTime += ms;
+}
+
+unsigned int CDataCacheCore::GetDemuxStallCount()
+{
+  CSingleLock lock(m_demuxSection);
+
+  return m_demuxInfo.m_stalls;
+}
+
+unsigned int CDataCacheCore::GetDemuxStallTime()
+{
+  CSingleLock lock(m_demuxSection);
+
+  return m_demuxInfo.m_stallTime;
+}
+
+void CDataCacheCore::SetStartupTimes(unsigned int demux, unsigned int codecs, unsigned int firstFrame)
+{
+  CSingleLock lock(m_startupSection);
+
+  m_startupInfo.m_demux = demux;
+  m_startupInfo.m_codecs = codecs;
+  m_startupInfo.m_firstFrame = firstFrame;
+}
+
+void CDataCacheCore::GetStartupTimes(unsigned int& demux, unsigned int& codecs, unsigned int& firstFrame)
+{
+  CSingleLock lock(m_startupSection);
+
+  demux = m_startupInfo.m_demux;
+  codecs = m_startupInfo.m_codecs;
+  firstFrame = m_startupInfo.m_firstFrame;
+}
+
 void CDataCacheCore::SetStateSeeking(bool active)
 {
   CSingleLock lock(m_stateSection);
@@ -35,6 +35,8 @@ public:
   void SetVideoDecoderName(std::string name, bool isHw);
   std::string GetVideoDecoderName();
   bool IsVideoHwDecoder();
+  void SetVideoDecoderPolicy(std::string policy);
+  std::string GetVideoDecoderPolicy();
   void SetVideoDeintMethod(std::string method);
   std::string GetVideoDeintMethod();
   void SetVideoPixelFormat(std::string pixFormat);
@@ -69,6 +71,25 @@ public:
   void SetRenderClockSync(bool enabled);
   bool IsRenderClockSync();
 
+  // demuxer info
+  /*!
+   * \brief Report that the demuxer had to wait for its input
+   * \param ms time waited in ms
+   */
+  void AddDemuxStall(unsigned int ms);
+  unsigned int GetDemuxStallCount();
+  unsigned int GetDemuxStallTime();
+
+  // startup info
+  /*!
+   * \brief Report how long it took to start playback
+   * \param demux time in ms to open the input stream and the demuxer, including probing
+   * \param codecs time in ms to open the codecs
+   * \param firstFrame time in ms until audio and video were in sync and started to play
+   */
+  void SetStartupTimes(unsigned int demux, unsigned int codecs, unsigned int firstFrame);
+  void GetStartupTimes(unsigned int& demux, unsigned int& codecs, unsigned int& firstFrame);
+
   // player states
   void SetStateSeeking(bool active);
   bool IsSeeking();
@@ -134,6 +155,7 @@ protected:
   {
     std::string decoderName;
     bool isHwDecoder;
+    std::string decoderPolicy;
     std::string deintMethod;
     std::string pixFormat;
     std::string stereoMode;
@@ -165,6 +187,21 @@ protected:
     bool m_isClockSync;
   } m_renderInfo;
 
+  CCriticalSection m_demuxSection;
+  struct SDemuxInfo
+  {
+    unsigned int m_stalls;
+    unsigned int m_stallTime;
+  } m_demuxInfo;
+
+  CCriticalSection m_startupSection;
+  struct SStartupInfo
+  {
+    unsigned int m_demux;
+    unsigned int m_codecs;
+    unsigned int m_firstFrame;
+  } m_startupInfo = {};
+
   CCriticalSection m_stateSection;
   bool m_playerStateChanged = false;
   struct SStateInfo
@@ -152,6 +152,7 @@ void CRPProcessInfo::ResetInfo()
   if (m_dataCache != nullptr)
   {
     m_dataCache->SetVideoDecoderName("", false);
+    m_dataCache->SetVideoDecoderPolicy("");
     m_dataCache->SetVideoDeintMethod("");
     m_dataCache->SetVideoPixelFormat("");
     m_dataCache->SetVideoDimensions(0, 0);
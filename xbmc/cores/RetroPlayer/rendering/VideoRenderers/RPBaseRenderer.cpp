@@ -12,6 +12,7 @@
 #include "cores/RetroPlayer/buffers/IRenderBufferPool.h"
 #include "cores/RetroPlayer/rendering/RenderContext.h"
 #include "cores/RetroPlayer/rendering/RenderUtils.h"
+#include "rendering/RenderSystem.h"
 #include "utils/log.h"
 
 using namespace KODI;
@@ -94,6 +95,9 @@ void CRPBaseRenderer::RenderFrame(bool clear, uint8_t alpha)
 
   ManageRenderArea(*m_renderBuffer);
 
+  // the renderers set up their own GL state, so GUI textures queued so far must be drawn first
+  m_context.Rendering()->FlushGUIBatches();
+
   RenderInternal(clear, alpha);
   PostRender();
 
@@ -265,6 +265,21 @@ bool CDVDClock::GetClockInfo(int& MissedVblanks, double& ClockSpeed, double& Ref
   return m_videoRefClock->GetClockInfo(MissedVblanks, ClockSpeed, RefreshRate);
 }
 
+bool CDVDClock::GetNextVblankClock(double& clock)
+{
+  int64_t next;
+  if (!m_videoRefClock->GetNextVblankTime(next))
+    return false;
+
+  CSingleLock lock(m_critSection);
+  // a pending reset starts the clock at the time passed in, which has to be now
+  if (m_bReset)
+    return false;
+
+  clock = SystemToPlaying(next);
+  return true;
+}
+
 double CDVDClock::SystemToAbsolute(int64_t system)
 {
   return DVD_TIME_BASE * (double)(system - m_systemOffset) / m_systemFrequency;
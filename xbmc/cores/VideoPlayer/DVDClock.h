@@ -49,6 +49,12 @@ public:
   double GetFrequency() { return (double)m_systemFrequency ; }
 
   bool GetClockInfo(int& MissedVblanks, double& ClockSpeed, double& RefreshRate) const;
+
+  /*!
+   * \brief Predict the clock at the next vblank
+   * \return false if the video reference clock doesn't run on vblanks
+   */
+  bool GetNextVblankClock(double& clock);
   void SetVsyncAdjust(double adjustment);
   double GetVsyncAdjust();
 
@@ -85,6 +85,8 @@ private:
 #define DVP_FLAG_INTERLACED         0x00000008  //< Set to indicate that this frame is interlaced
 #define DVP_FLAG_DROPPED            0x00000010  //< indicate that this picture has been dropped in decoder stage, will have no data
 
+#define DVD_CODEC_CTRL_DROP_PREDICTED 0x00400000  //< drop some non-reference frame, the player expects to be late
+#define DVD_CODEC_CTRL_DROP_GOP     0x00800000  //< drop everything up to the next key frame
 #define DVD_CODEC_CTRL_SKIPDEINT    0x01000000  //< request to skip a deinterlacing cycle, if possible
 #define DVD_CODEC_CTRL_NO_POSTPROC  0x02000000  //< see GetCodecStats
 #define DVD_CODEC_CTRL_HURRY        0x04000000  //< see GetCodecStats
@@ -228,6 +230,17 @@ public:
    *                  this packet is going to be dropped. decoder is free to use it
    *                  for decoding
    *
+   * DVD_CODEC_CTRL_DROP_ANY :
+   *                  the player is late, decoder may skip non-reference frames
+   *
+   * DVD_CODEC_CTRL_DROP_PREDICTED :
+   *                  the player expects to be late, decoder may skip non-reference
+   *                  frames. Unlike DVD_CODEC_CTRL_DROP_ANY no deadline was missed
+   *
+   * DVD_CODEC_CTRL_DROP_GOP :
+   *                  the player can't keep up, decoder may skip anything but key
+   *                  frames
+   *
    */
   virtual void SetCodecControl(int flags) {}
 
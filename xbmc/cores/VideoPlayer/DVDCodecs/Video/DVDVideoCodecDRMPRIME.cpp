@@ -603,7 +603,7 @@ void CDVDVideoCodecDRMPRIME::SetCodecControl(int flags)
 
   if (m_pCodecContext)
   {
-    if ((flags & DVD_CODEC_CTRL_DROP_ANY) != 0)
+    if ((flags & (DVD_CODEC_CTRL_DROP_ANY | DVD_CODEC_CTRL_DROP_PREDICTED)) != 0)
     {
       m_pCodecContext->skip_frame = AVDISCARD_NONREF;
       m_pCodecContext->skip_idct = AVDISCARD_NONREF;
@@ -11,6 +11,7 @@
 #include "DVDCodecs/DVDCodecs.h"
 #include "DVDCodecs/DVDFactoryCodec.h"
 #include "DVDStreamInfo.h"
+#include "FFmpegDecodePolicy.h"
 #include "ServiceBroker.h"
 #include "cores/VideoPlayer/Interface/TimingConstants.h"
 #include "cores/VideoPlayer/VideoRenderers/RenderManager.h"
@@ -23,6 +24,7 @@
 #include "utils/XTimeUtils.h"
 #include "utils/log.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "system.h"
@@ -361,6 +363,7 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
   m_pCodecContext->codec_tag = hints.codec_tag;
 
   // setup threading model
+  m_threading = SFFmpegThreading();
   if (!(hints.codecOptions & CODEC_FORCE_SOFTWARE))
   {
     if (m_decoderState == STATE_NONE)
@@ -369,12 +372,17 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
     }
     else
     {
-      int num_threads = CServiceBroker::GetCPUInfo()->GetCPUCount() * 3 / 2;
-      num_threads = std::max(1, std::min(num_threads, 16));
-      m_pCodecContext->thread_count = num_threads;
-      m_pCodecContext->thread_safe_callbacks = 1;
+      m_threading = CFFmpegThreadingPolicy::Select(
+          hints.codec, hints.profile, hints.width, hints.height, pCodec->capabilities,
+          CServiceBroker::GetCPUInfo()->GetCPUCount(), m_processInfo.IsRealtimeStream());
+      if (m_threading.threadType)
+        m_pCodecContext->thread_type = m_threading.threadType;
+      m_pCodecContext->thread_count = m_threading.threadCount;
+      if (m_threading.threadType == FF_THREAD_FRAME)
+        m_pCodecContext->thread_safe_callbacks = 1;
       m_decoderState = STATE_SW_MULTI;
-      CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg - open frame threaded with %d threads", num_threads);
+      CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg - open threaded: %s",
+                m_threading.ToString().c_str());
     }
   }
   else
@@ -395,10 +403,9 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
   // advanced setting override for skip loop filter (see avcodec.h for valid options)
   //! @todo allow per video setting?
   int iSkipLoopFilter = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_iSkipLoopFilter;
-  if (iSkipLoopFilter != 0)
-  {
-    m_pCodecContext->skip_loop_filter = static_cast<AVDiscard>(iSkipLoopFilter);
-  }
+  m_skipLoopFilter = static_cast<AVDiscard>(iSkipLoopFilter);
+  m_pCodecContext->skip_loop_filter = m_skipLoopFilter;
+  m_skipControl.Reset();
 
   // set any special options
   for(std::vector<CDVDCodecOption>::iterator it = options.m_keys.begin(); it != options.m_keys.end(); ++it)
@@ -525,10 +532,23 @@ void CDVDVideoCodecFFmpeg::UpdateName()
     m_name += "-" + m_pHardware->Name();
 
   m_processInfo.SetVideoDecoderName(m_name, m_pHardware ? true : false);
+  UpdatePolicy();
 
   CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg - Updated codec: %s", m_name.c_str());
 }
 
+void CDVDVideoCodecFFmpeg::UpdatePolicy()
+{
+  std::string policy;
+  if (!m_pHardware)
+  {
+    policy = m_threading.ToString();
+    if (m_skipControl.GetLevel() != CFFmpegSkipControl::SKIP_NONE)
+      policy += std::string(", ") + CFFmpegSkipControl::GetLevelName(m_skipControl.GetLevel());
+  }
+  m_processInfo.SetVideoDecoderPolicy(policy);
+}
+
 union pts_union
 {
   double  pts_d;
@@ -570,6 +590,14 @@ bool CDVDVideoCodecFFmpeg::AddData(const DemuxPacket &packet)
   avpkt.side_data = static_cast<AVPacketSideData*>(packet.pSideData);
   avpkt.side_data_elems = packet.iSideDataElems;
 
+  // let ffmpeg take a reference to the demuxer's buffer instead of copying the payload. only if
+  // the packet still ends where the payload of the buffer does, the padding of the buffer follows
+  // it then. otherwise ffmpeg copies the data into a padded buffer of its own.
+  if (packet.pBuffer && packet.pData >= packet.pBuffer->data &&
+      packet.pData + packet.iSize + AV_INPUT_BUFFER_PADDING_SIZE ==
+          packet.pBuffer->data + packet.pBuffer->size)
+    avpkt.buf = packet.pBuffer;
+
   int ret = avcodec_send_packet(m_pCodecContext, &avpkt);
 
   // try again
@@ -885,6 +913,7 @@ void CDVDVideoCodecFFmpeg::Reset()
   m_iLastKeyframe = m_pCodecContext->has_b_frames;
   avcodec_flush_buffers(m_pCodecContext);
   av_frame_unref(m_pFrame);
+  m_skipControl.Flush();
 
   if (m_pHardware)
     m_pHardware->Reset();
@@ -1274,7 +1303,7 @@ void CDVDVideoCodecFFmpeg::SetCodecControl(int flags)
 
   if (m_pCodecContext)
   {
-    bool bDrop = (flags & DVD_CODEC_CTRL_DROP_ANY) != 0;
+    bool bDrop = (flags & (DVD_CODEC_CTRL_DROP_ANY | DVD_CODEC_CTRL_DROP_PREDICTED)) != 0;
     if (bDrop && m_pHardware && m_pHardware->CanSkipDeint())
     {
       m_requestSkipDeint = true;
@@ -1283,17 +1312,36 @@ void CDVDVideoCodecFFmpeg::SetCodecControl(int flags)
     else
       m_requestSkipDeint = false;
 
-    if (bDrop)
+    // every packet tells whether the player is late, a software decoder that keeps missing
+    // its deadline skips more work until it catches up. predicted drops already avoid a miss,
+    // counting them as well would make both react to the same lateness
+    if (!m_pHardware && !(flags & DVD_CODEC_CTRL_DRAIN) &&
+        m_skipControl.Process((flags & DVD_CODEC_CTRL_DROP_ANY) != 0))
+    {
+      CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg::SetCodecControl - %.1f%% late, level %d",
+                m_skipControl.GetMissRate(), m_skipControl.GetLevel());
+      UpdatePolicy();
+    }
+
+    AVDiscard skipLoopFilter = m_pHardware ? m_skipLoopFilter
+                                           : m_skipControl.GetSkipLoopFilter(m_skipLoopFilter);
+    if (flags & DVD_CODEC_CTRL_DROP_GOP)
+    {
+      m_pCodecContext->skip_frame = AVDISCARD_NONKEY;
+      m_pCodecContext->skip_idct = AVDISCARD_NONKEY;
+      m_pCodecContext->skip_loop_filter = std::max(skipLoopFilter, AVDISCARD_NONKEY);
+    }
+    else if (bDrop)
     {
       m_pCodecContext->skip_frame = AVDISCARD_NONREF;
       m_pCodecContext->skip_idct = AVDISCARD_NONREF;
-      m_pCodecContext->skip_loop_filter = AVDISCARD_NONREF;
+      m_pCodecContext->skip_loop_filter = std::max(skipLoopFilter, AVDISCARD_NONREF);
     }
     else
     {
-      m_pCodecContext->skip_frame = AVDISCARD_DEFAULT;
+      m_pCodecContext->skip_frame = m_pHardware ? AVDISCARD_DEFAULT : m_skipControl.GetSkipFrame();
       m_pCodecContext->skip_idct = AVDISCARD_DEFAULT;
-      m_pCodecContext->skip_loop_filter = AVDISCARD_DEFAULT;
+      m_pCodecContext->skip_loop_filter = skipLoopFilter;
     }
   }
 
@@ -12,6 +12,7 @@
 #include "cores/VideoPlayer/DVDStreamInfo.h"
 #include "DVDVideoCodec.h"
 #include "DVDVideoPPFFmpeg.h"
+#include "FFmpegDecodePolicy.h"
 #include <string>
 #include <vector>
 
@@ -54,6 +55,7 @@ protected:
   CDVDVideoCodec::VCReturn FilterProcess(AVFrame* frame);
   void SetFilters();
   void UpdateName();
+  void UpdatePolicy();
   bool SetPictureParams(VideoPicture* pVideoPicture);
 
   bool HasHardware() { return m_pHardware != nullptr; };
@@ -98,6 +100,9 @@ protected:
   double m_DAR = 1.0;
   CDVDStreamInfo m_hints;
   CDVDCodecOptions m_options;
+  SFFmpegThreading m_threading;
+  CFFmpegSkipControl m_skipControl;
+  AVDiscard m_skipLoopFilter = AVDISCARD_DEFAULT; //!< advanced setting, the least to skip
 
   struct CDropControl
   {
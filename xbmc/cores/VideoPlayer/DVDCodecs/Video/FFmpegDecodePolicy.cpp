@@ -0,0 +1,168 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FFmpegDecodePolicy.h"
+
+#include "utils/StringUtils.h"
+
+#include <algorithm>
+
+namespace
+{
+// weight of a packet in the miss rate, about the last 16 packets count
+constexpr double RATE_WEIGHT = 1.0 / 16.0;
+}
+
+constexpr double CFFmpegSkipControl::ESCALATE_RATE;
+constexpr double CFFmpegSkipControl::RELAX_RATE;
+constexpr int CFFmpegSkipControl::ESCALATE_HOLD;
+constexpr int CFFmpegSkipControl::RELAX_HOLD;
+constexpr int CFFmpegSkipControl::MAX_RELAX_HOLD;
+
+std::string SFFmpegThreading::ToString() const
+{
+  if (threadType == FF_THREAD_FRAME)
+    return StringUtils::Format("frame x%d", threadCount);
+  else if (threadType == FF_THREAD_SLICE)
+    return StringUtils::Format("slice x%d", threadCount);
+  return "single";
+}
+
+SFFmpegThreading CFFmpegThreadingPolicy::Select(AVCodecID codec,
+                                                int profile,
+                                                int width,
+                                                int height,
+                                                int capabilities,
+                                                int cpuCount,
+                                                bool lowLatency)
+{
+  SFFmpegThreading threading;
+
+  const bool frameThreads = (capabilities & AV_CODEC_CAP_FRAME_THREADS) != 0;
+  const bool sliceThreads = (capabilities & AV_CODEC_CAP_SLICE_THREADS) != 0;
+  if (cpuCount < 2 || (!frameThreads && !sliceThreads))
+    return threading;
+
+  // the size isn't always known before the first frame, assume hd then
+  const bool small = width > 0 && height > 0 && width * height <= 720 * 576;
+
+  // baseline h264 comes from encoders that keep the delay short themselves
+  if (codec == AV_CODEC_ID_H264 &&
+      (profile == FF_PROFILE_H264_BASELINE || profile == FF_PROFILE_H264_CONSTRAINED_BASELINE))
+    lowLatency = true;
+
+  // slices of these are tiles or wavefronts, few streams have more than one per picture
+  const bool tiled = codec == AV_CODEC_ID_HEVC || codec == AV_CODEC_ID_VP9 ||
+                     codec == AV_CODEC_ID_AV1;
+
+  bool slice;
+  if (!frameThreads)
+    slice = true;
+  else if (!sliceThreads)
+    slice = false;
+  else if (codec == AV_CODEC_ID_MPEG1VIDEO || codec == AV_CODEC_ID_MPEG2VIDEO)
+    slice = true;
+  else
+    slice = lowLatency && small && !tiled;
+
+  if (slice)
+  {
+    threading.threadType = FF_THREAD_SLICE;
+    threading.threadCount = cpuCount;
+  }
+  else
+  {
+    // more threads than cores only pay off when a single picture takes long
+    threading.threadType = FF_THREAD_FRAME;
+    if (lowLatency || small)
+      threading.threadCount = cpuCount;
+    else
+      threading.threadCount = cpuCount * 3 / 2;
+  }
+  threading.threadCount = std::max(1, std::min(threading.threadCount, 16));
+
+  return threading;
+}
+
+CFFmpegSkipControl::CFFmpegSkipControl()
+{
+  Reset();
+}
+
+void CFFmpegSkipControl::Reset()
+{
+  m_level = SKIP_NONE;
+  m_relaxHold = RELAX_HOLD;
+  m_relaxed = false;
+  Flush();
+}
+
+void CFFmpegSkipControl::Flush()
+{
+  m_missRate = 0.0;
+  m_packets = 0;
+}
+
+bool CFFmpegSkipControl::Process(bool missed)
+{
+  m_missRate += ((missed ? 1.0 : 0.0) - m_missRate) * RATE_WEIGHT;
+  m_packets++;
+
+  if (m_level < SKIP_MAX && m_packets >= ESCALATE_HOLD && GetMissRate() >= ESCALATE_RATE)
+  {
+    // the last step down didn't last, wait longer before the next one
+    if (m_relaxed && m_packets < m_relaxHold * 2)
+      m_relaxHold = std::min(m_relaxHold * 2, MAX_RELAX_HOLD);
+
+    m_level = static_cast<Level>(m_level + 1);
+    m_relaxed = false;
+    m_packets = 0;
+    return true;
+  }
+
+  if (m_level > SKIP_NONE && m_packets >= m_relaxHold && GetMissRate() < RELAX_RATE)
+  {
+    m_level = static_cast<Level>(m_level - 1);
+    m_relaxed = true;
+    m_packets = 0;
+    return true;
+  }
+
+  return false;
+}
+
+AVDiscard CFFmpegSkipControl::GetSkipLoopFilter(AVDiscard base) const
+{
+  if (m_level >= SKIP_LOOPFILTER_ALL)
+    return AVDISCARD_ALL;
+  else if (m_level >= SKIP_LOOPFILTER_NONREF)
+    return std::max(base, AVDISCARD_NONREF);
+  return base;
+}
+
+AVDiscard CFFmpegSkipControl::GetSkipFrame() const
+{
+  if (m_level >= SKIP_FRAME_NONREF)
+    return AVDISCARD_NONREF;
+  return AVDISCARD_DEFAULT;
+}
+
+const char* CFFmpegSkipControl::GetLevelName(Level level)
+{
+  switch (level)
+  {
+    case SKIP_LOOPFILTER_NONREF:
+      return "skip loopfilter nonref";
+    case SKIP_LOOPFILTER_ALL:
+      return "skip loopfilter";
+    case SKIP_FRAME_NONREF:
+      return "skip nonref";
+    default:
+      return "";
+  }
+}
@@ -0,0 +1,115 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <string>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+}
+
+/*!
+ * \brief How a software decoder spreads its work over the cpu cores
+ */
+struct SFFmpegThreading
+{
+  int threadType = 0; //!< FF_THREAD_FRAME, FF_THREAD_SLICE or 0 for a single thread
+  int threadCount = 1;
+
+  std::string ToString() const;
+};
+
+/*!
+ * \brief Chooses between frame and slice threads for a stream.
+ *
+ * Frame threads scale with any stream but every thread adds a frame of delay and a frame of
+ * memory. Slice threads add no delay but only scale with streams made of several slices, which
+ * mpeg-2 always is. The delay matters for realtime streams, where it shows when zapping, and for
+ * small pictures, which a single core decodes in time anyway.
+ */
+class CFFmpegThreadingPolicy
+{
+public:
+  /*!
+   * \param capabilities AV_CODEC_CAP_* of the decoder
+   * \param lowLatency prefer a short decoder delay over throughput, e.g. for live tv
+   */
+  static SFFmpegThreading Select(AVCodecID codec,
+                                 int profile,
+                                 int width,
+                                 int height,
+                                 int capabilities,
+                                 int cpuCount,
+                                 bool lowLatency);
+};
+
+/*!
+ * \brief Trades picture quality for decoding speed while the decoder misses its deadlines.
+ *
+ * Each packet reports whether the player was late presenting the picture before. While the
+ * rate of misses stays high the decoder skips more work, first the loop filter of non reference
+ * frames, then the loop filter of all frames and last non reference frames as a whole. Once
+ * decoding keeps up the level steps down again, more hesitantly each time stepping down made
+ * it miss again.
+ */
+class CFFmpegSkipControl
+{
+public:
+  enum Level
+  {
+    SKIP_NONE = 0,
+    SKIP_LOOPFILTER_NONREF,
+    SKIP_LOOPFILTER_ALL,
+    SKIP_FRAME_NONREF,
+    SKIP_MAX = SKIP_FRAME_NONREF
+  };
+
+  /*! \brief Rate of missed deadlines to step up at, in percent of the packets */
+  static constexpr double ESCALATE_RATE = 10.0;
+  /*! \brief Rate of missed deadlines to step down at */
+  static constexpr double RELAX_RATE = 1.0;
+  /*! \brief Packets to stay at a level before stepping up again */
+  static constexpr int ESCALATE_HOLD = 48;
+  /*! \brief Packets to stay at a level before stepping down, doubles when that didn't work out */
+  static constexpr int RELAX_HOLD = 250;
+  static constexpr int MAX_RELAX_HOLD = RELAX_HOLD * 16;
+
+  CFFmpegSkipControl();
+
+  /*!
+   * \brief Start over, e.g. for a new stream
+   */
+  void Reset();
+
+  /*!
+   * \brief Forget the rate measured so far but keep the level, e.g. after a seek
+   */
+  void Flush();
+
+  /*!
+   * \brief Account for a packet
+   * \param missed the player presented a picture late
+   * \return true if the level changed
+   */
+  bool Process(bool missed);
+
+  Level GetLevel() const { return m_level; }
+  double GetMissRate() const { return m_missRate * 100.0; }
+
+  AVDiscard GetSkipLoopFilter(AVDiscard base) const;
+  AVDiscard GetSkipFrame() const;
+  static const char* GetLevelName(Level level);
+
+private:
+  Level m_level;
+  double m_missRate;
+  int m_packets; //!< packets at the current level
+  int m_relaxHold;
+  bool m_relaxed; //!< the last step was down
+};
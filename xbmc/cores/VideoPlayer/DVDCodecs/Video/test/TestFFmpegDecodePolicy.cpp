@@ -0,0 +1,149 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDCodecs/Video/FFmpegDecodePolicy.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+constexpr int BOTH = AV_CODEC_CAP_FRAME_THREADS | AV_CODEC_CAP_SLICE_THREADS;
+
+/*!
+ * \brief A decoder that misses every n-th deadline, fewer the more it skips
+ */
+class CEdgeDecoder
+{
+public:
+  explicit CEdgeDecoder(std::initializer_list<int> intervals) : m_intervals(intervals) {}
+
+  bool Decode(CFFmpegSkipControl::Level level)
+  {
+    const int interval = m_intervals[level];
+    return interval > 0 && ++m_packets % interval == 0;
+  }
+
+private:
+  std::vector<int> m_intervals;
+  int m_packets = 0;
+};
+
+} // namespace
+
+TEST(TestFFmpegDecodePolicy, Threading)
+{
+  // software hevc on a quad core, as many frames in flight as it takes
+  SFFmpegThreading threading =
+      CFFmpegThreadingPolicy::Select(AV_CODEC_ID_HEVC, FF_PROFILE_HEVC_MAIN, 1920, 1080, BOTH, 4, false);
+  EXPECT_EQ(FF_THREAD_FRAME, threading.threadType);
+  EXPECT_EQ(6, threading.threadCount);
+  EXPECT_EQ("frame x6", threading.ToString());
+
+  // live tv, no more frames in flight than cores
+  threading =
+      CFFmpegThreadingPolicy::Select(AV_CODEC_ID_H264, FF_PROFILE_H264_HIGH, 1920, 1080, BOTH, 4, true);
+  EXPECT_EQ(FF_THREAD_FRAME, threading.threadType);
+  EXPECT_EQ(4, threading.threadCount);
+
+  // small pictures of live tv don't need frame threads
+  threading =
+      CFFmpegThreadingPolicy::Select(AV_CODEC_ID_H264, FF_PROFILE_H264_MAIN, 720, 576, BOTH, 4, true);
+  EXPECT_EQ(FF_THREAD_SLICE, threading.threadType);
+  EXPECT_EQ(4, threading.threadCount);
+
+  // unless they are hevc, which rarely has more than one slice
+  threading =
+      CFFmpegThreadingPolicy::Select(AV_CODEC_ID_HEVC, FF_PROFILE_HEVC_MAIN, 720, 576, BOTH, 4, true);
+  EXPECT_EQ(FF_THREAD_FRAME, threading.threadType);
+
+  // baseline is low latency on its own
+  threading = CFFmpegThreadingPolicy::Select(AV_CODEC_ID_H264, FF_PROFILE_H264_CONSTRAINED_BASELINE,
+                                             640, 360, BOTH, 4, false);
+  EXPECT_EQ(FF_THREAD_SLICE, threading.threadType);
+
+  // mpeg-2 always slices well
+  threading = CFFmpegThreadingPolicy::Select(AV_CODEC_ID_MPEG2VIDEO, FF_PROFILE_UNKNOWN, 1920, 1080,
+                                             BOTH, 8, false);
+  EXPECT_EQ(FF_THREAD_SLICE, threading.threadType);
+  EXPECT_EQ(8, threading.threadCount);
+
+  // what the decoder can do, and a size not known yet
+  threading = CFFmpegThreadingPolicy::Select(AV_CODEC_ID_H264, FF_PROFILE_H264_MAIN, 0, 0,
+                                             AV_CODEC_CAP_FRAME_THREADS, 32, true);
+  EXPECT_EQ(FF_THREAD_FRAME, threading.threadType);
+  EXPECT_EQ(16, threading.threadCount);
+  threading = CFFmpegThreadingPolicy::Select(AV_CODEC_ID_H264, FF_PROFILE_H264_MAIN, 1920, 1080, 0,
+                                             4, false);
+  EXPECT_EQ(1, threading.threadCount);
+  EXPECT_EQ("single", threading.ToString());
+
+  threading =
+      CFFmpegThreadingPolicy::Select(AV_CODEC_ID_HEVC, FF_PROFILE_HEVC_MAIN, 1920, 1080, BOTH, 1, false);
+  EXPECT_EQ(1, threading.threadCount);
+}
+
+TEST(TestFFmpegDecodePolicy, SkipEscalates)
+{
+  CFFmpegSkipControl control;
+  EXPECT_EQ(AVDISCARD_DEFAULT, control.GetSkipLoopFilter(AVDISCARD_DEFAULT));
+  EXPECT_EQ(AVDISCARD_DEFAULT, control.GetSkipFrame());
+
+  // late on every other frame, steps up at most once per hold
+  int packets = 0;
+  while (control.GetLevel() != CFFmpegSkipControl::SKIP_MAX && packets < 1000)
+  {
+    control.Process(packets++ % 2 == 0);
+    if (control.GetLevel() == CFFmpegSkipControl::SKIP_LOOPFILTER_NONREF)
+    {
+      EXPECT_EQ(AVDISCARD_NONREF, control.GetSkipLoopFilter(AVDISCARD_DEFAULT));
+    }
+  }
+  EXPECT_EQ(CFFmpegSkipControl::SKIP_MAX, control.GetLevel());
+  EXPECT_GE(packets, CFFmpegSkipControl::ESCALATE_HOLD * 3);
+  EXPECT_EQ(AVDISCARD_ALL, control.GetSkipLoopFilter(AVDISCARD_DEFAULT));
+  EXPECT_EQ(AVDISCARD_NONREF, control.GetSkipFrame());
+
+  // a seek keeps the level
+  control.Flush();
+  EXPECT_EQ(CFFmpegSkipControl::SKIP_MAX, control.GetLevel());
+  EXPECT_EQ(0.0, control.GetMissRate());
+
+  // keeping up steps down again
+  for (int i = 0; i < CFFmpegSkipControl::RELAX_HOLD * 3; i++)
+    control.Process(false);
+  EXPECT_EQ(CFFmpegSkipControl::SKIP_NONE, control.GetLevel());
+
+  control.Reset();
+  EXPECT_EQ(CFFmpegSkipControl::SKIP_NONE, control.GetLevel());
+}
+
+TEST(TestFFmpegDecodePolicy, SkipSettles)
+{
+  // keeps up once it skips the loop filter, the way software hevc 1080p on a quad core a9 does
+  CEdgeDecoder decoder({4, 8, 0, 0});
+  CFFmpegSkipControl control;
+
+  int changes = 0;
+  int atLoopFilter = 0;
+  constexpr int PACKETS = 25 * 60 * 10;
+  for (int i = 0; i < PACKETS; i++)
+  {
+    if (control.Process(decoder.Decode(control.GetLevel())))
+      changes++;
+    if (control.GetLevel() == CFFmpegSkipControl::SKIP_LOOPFILTER_ALL)
+      atLoopFilter++;
+    EXPECT_NE(CFFmpegSkipControl::SKIP_FRAME_NONREF, control.GetLevel());
+  }
+
+  // it tries to step down now and then, waiting longer each time that doesn't work out
+  EXPECT_LT(changes, 20);
+  EXPECT_GT(atLoopFilter, PACKETS * 9 / 10);
+}
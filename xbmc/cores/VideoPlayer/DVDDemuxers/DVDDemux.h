@@ -320,6 +320,12 @@ public:
    */
   virtual std::string GetFileName() { return ""; }
 
+  /*
+   * returns the key frame positions recorded while reading, serialized for storing them with the
+   * file state, empty if nothing new was recorded (see CKeyframeIndex)
+   */
+  virtual std::string GetKeyframeIndex() { return ""; }
+
   /*
    * return nr of subtitle streams, 0 if none
    */
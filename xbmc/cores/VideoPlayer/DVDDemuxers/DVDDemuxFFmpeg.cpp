@@ -11,15 +11,19 @@
 #include "DVDDemuxUtils.h"
 #include "DVDInputStreams/DVDInputStream.h"
 #include "DVDInputStreams/DVDInputStreamFFmpeg.h"
+#include "DVDInputStreams/ReadAheadBuffer.h"
 #include "ServiceBroker.h"
 #include "URL.h"
 #include "Util.h"
 #include "commons/Exception.h"
+#include "cores/DataCacheCore.h"
 #include "cores/FFmpeg.h"
 #include "cores/VideoPlayer/Interface/TimingConstants.h" // for DVD_TIME_BASE
 #include "filesystem/CurlFile.h"
 #include "filesystem/Directory.h"
+#include "filesystem/DirectoryChangeJournal.h"
 #include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
@@ -29,6 +33,7 @@
 #include "utils/URIUtils.h"
 #include "utils/XTimeUtils.h"
 #include "utils/log.h"
+#include "video/VideoDatabase.h"
 
 #include <sstream>
 #include <utility>
@@ -161,8 +166,12 @@ static int dvd_file_read(void* h, uint8_t* buf, int size)
   if (interrupt_cb(h))
     return AVERROR_EXIT;
 
-  std::shared_ptr<CDVDInputStream> pInputStream = static_cast<CDVDDemuxFFmpeg*>(h)->m_pInput;
-  int len = pInputStream->Read(buf, size);
+  CDVDDemuxFFmpeg* demuxer = static_cast<CDVDDemuxFFmpeg*>(h);
+  int len;
+  if (demuxer->m_readAhead)
+    len = demuxer->m_readAhead->Read(buf, size);
+  else
+    len = demuxer->m_pInput->Read(buf, size);
   if (len == 0)
     return AVERROR_EOF;
   else
@@ -179,11 +188,14 @@ static int64_t dvd_file_seek(void* h, int64_t pos, int whence)
   if (interrupt_cb(h))
     return AVERROR_EXIT;
 
-  std::shared_ptr<CDVDInputStream> pInputStream = static_cast<CDVDDemuxFFmpeg*>(h)->m_pInput;
+  CDVDDemuxFFmpeg* demuxer = static_cast<CDVDDemuxFFmpeg*>(h);
   if (whence == AVSEEK_SIZE)
-    return pInputStream->GetLength();
+    return demuxer->m_readAhead ? demuxer->m_readAhead->GetLength()
+                                : demuxer->m_pInput->GetLength();
+  else if (demuxer->m_readAhead)
+    return demuxer->m_readAhead->Seek(pos, whence & ~AVSEEK_FORCE);
   else
-    return pInputStream->Seek(pos, whence & ~AVSEEK_FORCE);
+    return demuxer->m_pInput->Seek(pos, whence & ~AVSEEK_FORCE);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -231,6 +243,7 @@ bool CDVDDemuxFFmpeg::Open(const std::shared_ptr<CDVDInputStream>& pInput, bool
   std::string strFile;
   m_streaminfo = !pInput->IsRealtime() && !m_reopen;
   m_reopen = false;
+  m_probeCached = false;
   m_currentPts = DVD_NOPTS_VALUE;
   m_speed = DVD_PLAYSPEED_NORMAL;
   m_program = UINT_MAX;
@@ -366,6 +379,20 @@ bool CDVDDemuxFFmpeg::Open(const std::shared_ptr<CDVDInputStream>& pInput, bool
     if (!seekable)
       m_ioContext->seekable = 0;
 
+    // files on local disks are read ahead on a thread of their own during playback, network
+    // shares (also when mounted) go through the file cache instead
+    const std::string localPath = CSpecialProtocol::TranslatePath(m_pInput->GetFileName());
+    if (!fileinfo && seekable && m_pInput->IsStreamType(DVDSTREAM_TYPE_FILE) &&
+        !m_pInput->IsRealtime() && CURL(localPath).GetProtocol().empty() &&
+        XFILE::CDirectoryChangeJournal::IsLocalFilesystem(localPath))
+    {
+      m_readAhead.reset(new CReadAheadBuffer(
+          m_pInput, [this]() { return Aborted(); },
+          [](unsigned int ms) { CServiceBroker::GetDataCacheCore().AddDemuxStall(ms); }));
+      if (!m_readAhead->Start())
+        m_readAhead.reset();
+    }
+
     std::string content = m_pInput->GetContent();
     StringUtils::ToLower(content);
     if (StringUtils::StartsWith(content, "audio/l16"))
@@ -534,12 +561,33 @@ bool CDVDDemuxFFmpeg::Open(const std::shared_ptr<CDVDInputStream>& pInput, bool
   m_bAVI = strcmp(m_pFormatContext->iformat->name, "avi") == 0;
   m_bSup = strcmp(m_pFormatContext->iformat->name, "sup") == 0;
 
+  // mpeg transport and program streams have no index, remember where the key frames are
+  if ((strcmp(m_pFormatContext->iformat->name, "mpegts") == 0 ||
+       strcmp(m_pFormatContext->iformat->name, "mpeg") == 0) &&
+      m_pInput->IsStreamType(DVDSTREAM_TYPE_FILE) && !m_pInput->IsRealtime() &&
+      m_pInput->GetLength() > 0)
+    LoadKeyframeIndex();
+
   if (m_streaminfo)
   {
     /* to speed up dvd switches, only analyse very short */
     if (m_pInput->IsStreamType(DVDSTREAM_TYPE_DVD))
       av_opt_set_int(m_pFormatContext, "analyzeduration", 500000, 0);
 
+    // live streams are opened again and again with the same streams, probe them only once
+    const bool live = m_pInput->IsRealtime() && !fileinfo;
+    std::vector<CDemuxProbeCache::Stream> cached;
+    m_probeCached = live && CDemuxProbeCache::GetInstance().Get(strFile, cached) &&
+                    ApplyProbeCache(m_pFormatContext, cached);
+
+    if (m_probeCached)
+    {
+      // the parameters are known, probing only reads until every stream has a timestamp, the
+      // start time is taken from those
+      CLog::Log(LOGDEBUG, "%s - stream parameters taken from the probe cache", __FUNCTION__);
+      av_opt_set_int(m_pFormatContext, "analyzeduration", 500000, 0);
+    }
+
     CLog::Log(LOGDEBUG, "%s - avformat_find_stream_info starting", __FUNCTION__);
     int iErr = avformat_find_stream_info(m_pFormatContext, NULL);
     if (iErr < 0)
@@ -549,7 +597,7 @@ bool CDVDDemuxFFmpeg::Open(const std::shared_ptr<CDVDInputStream>& pInput, bool
           m_pInput->IsStreamType(DVDSTREAM_TYPE_BLURAY) ||
           (m_pFormatContext->nb_streams == 1 &&
            m_pFormatContext->streams[0]->codecpar->codec_id == AV_CODEC_ID_AC3) ||
-          m_checkTransportStream)
+          m_checkTransportStream || m_probeCached)
       {
         // special case, our codecs can still handle it.
       }
@@ -561,6 +609,9 @@ bool CDVDDemuxFFmpeg::Open(const std::shared_ptr<CDVDInputStream>& pInput, bool
     }
     CLog::Log(LOGDEBUG, "%s - av_find_stream_info finished", __FUNCTION__);
 
+    if (live && !m_probeCached && iErr >= 0 && m_pFormatContext->nb_streams > 0)
+      CDemuxProbeCache::GetInstance().Set(strFile, GetProbeCache(m_pFormatContext));
+
     // print some extra information
     av_dump_format(m_pFormatContext, 0, CURL::GetRedacted(strFile).c_str(), 0);
 
@@ -689,6 +740,8 @@ void CDVDDemuxFFmpeg::Dispose()
   m_pFormatContext = NULL;
   m_speed = DVD_PLAYSPEED_NORMAL;
 
+  m_readAhead.reset();
+
   DisposeStreams();
 
   m_pInput = NULL;
@@ -1047,6 +1100,13 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
       if (IsProgramChange())
       {
         CLog::Log(LOGINFO, "CDVDDemuxFFmpeg::Read() stream change");
+
+        // the streams aren't the ones probed last time, probe them again on the next open
+        if (m_probeCached)
+        {
+          CDemuxProbeCache::GetInstance().Remove(m_pInput->GetFileName());
+          m_probeCached = false;
+        }
         av_dump_format(m_pFormatContext, 0, CURL::GetRedacted(m_pInput->GetFileName()).c_str(), 0);
 
         // update streams
@@ -1070,7 +1130,7 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
           {
             if (m_pkt.pkt.stream_index == (int)m_pFormatContext->programs[m_program]->stream_index[i])
             {
-              pPacket = CDVDDemuxUtils::AllocateDemuxPacket(m_pkt.pkt.size);
+              pPacket = CDVDDemuxUtils::AllocateDemuxPacket(m_pkt.pkt);
               break;
             }
           }
@@ -1079,7 +1139,7 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
             bReturnEmpty = true;
         }
         else
-          pPacket = CDVDDemuxUtils::AllocateDemuxPacket(m_pkt.pkt.size);
+          pPacket = CDVDDemuxUtils::AllocateDemuxPacket(m_pkt.pkt);
       }
       else
         bReturnEmpty = true;
@@ -1093,13 +1153,6 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
           m_pkt.pkt.pts = AV_NOPTS_VALUE;
         }
 
-        // copy contents into our own packet
-        pPacket->iSize = m_pkt.pkt.size;
-
-        // maybe we can avoid a memcpy here by detecting where pkt.destruct is pointing too?
-        if (m_pkt.pkt.data)
-          memcpy(pPacket->pData, m_pkt.pkt.data, pPacket->iSize);
-
         pPacket->pts = ConvertTimestamp(m_pkt.pkt.pts, stream->time_base.den, stream->time_base.num);
         pPacket->dts = ConvertTimestamp(m_pkt.pkt.dts, stream->time_base.den, stream->time_base.num);
         pPacket->duration =  DVD_SEC_TO_TIME((double)m_pkt.pkt.duration * stream->time_base.num / stream->time_base.den);
@@ -1125,6 +1178,14 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
           }
         }
 
+        if (m_keyframeIndex && (m_pkt.pkt.flags & AV_PKT_FLAG_KEY) && m_pkt.pkt.pos >= 0 &&
+            m_pkt.pkt.stream_index == m_seekStream)
+        {
+          double pts = pPacket->pts != DVD_NOPTS_VALUE ? pPacket->pts : pPacket->dts;
+          if (pts != DVD_NOPTS_VALUE)
+            m_keyframeIndex->Add(DVD_TIME_TO_MSEC(pts), m_pkt.pkt.pos);
+        }
+
         // used to guess streamlength
         if (pPacket->dts != DVD_NOPTS_VALUE && (pPacket->dts > m_currentPts || m_currentPts == DVD_NOPTS_VALUE))
           m_currentPts = pPacket->dts;
@@ -1221,7 +1282,8 @@ bool CDVDDemuxFFmpeg::SeekTime(double time, bool backwards, double* startpts)
     return true;
   }
 
-  if (!m_pInput->Seek(0, SEEK_POSSIBLE) &&
+  // the input stream belongs to the read ahead thread, it is seekable if it is read ahead
+  if (!m_readAhead && !m_pInput->Seek(0, SEEK_POSSIBLE) &&
       !m_pInput->IsStreamType(DVDSTREAM_TYPE_FFMPEG))
   {
     CLog::Log(LOGDEBUG, "%s - input stream reports it is not seekable", __FUNCTION__);
@@ -1262,7 +1324,14 @@ bool CDVDDemuxFFmpeg::SeekTime(double time, bool backwards, double* startpts)
   int ret;
   {
     CSingleLock lock(m_critSection);
-    ret = av_seek_frame(m_pFormatContext, m_seekStream, seek_pts, backwards ? AVSEEK_FLAG_BACKWARD : 0);
+    // go straight to a known key frame, bisecting the file is slow and inexact
+    int64_t keyframePos;
+    ret = -1;
+    if (m_keyframeIndex && m_keyframeIndex->Find(static_cast<int64_t>(time), backwards, keyframePos))
+      ret = av_seek_frame(m_pFormatContext, -1, keyframePos, AVSEEK_FLAG_BYTE);
+
+    if (ret < 0)
+      ret = av_seek_frame(m_pFormatContext, m_seekStream, seek_pts, backwards ? AVSEEK_FLAG_BACKWARD : 0);
 
     if (ret < 0)
     {
@@ -1281,11 +1350,14 @@ bool CDVDDemuxFFmpeg::SeekTime(double time, bool backwards, double* startpts)
         // force eof
         // files of realtime streams may grow
         if (!m_pInput->IsRealtime())
+        {
+          m_readAhead.reset();
           m_pInput->Close();
+        }
         else
           ret = 0;
       }
-      else if (m_pInput->IsEOF())
+      else if (m_readAhead ? m_readAhead->IsEOF() : m_pInput->IsEOF())
         ret = 0;
     }
 
@@ -2020,6 +2092,124 @@ std::string CDVDDemuxFFmpeg::GetStreamCodecName(int iStreamId)
   return strName;
 }
 
+void CDVDDemuxFFmpeg::LoadKeyframeIndex()
+{
+  // reopened, keep what was recorded so far
+  if (m_keyframeIndex)
+    return;
+
+  m_keyframeIndex.reset(new CKeyframeIndex(m_pInput->GetLength()));
+
+  CVideoDatabase db;
+  if (!db.Open())
+    return;
+
+  std::string keyframes;
+  if (db.GetKeyframeIndex(m_pInput->GetFileName(), keyframes) &&
+      m_keyframeIndex->Deserialize(keyframes))
+    CLog::Log(LOGDEBUG, "CDVDDemuxFFmpeg::%s - loaded %zu key frames", __FUNCTION__,
+              m_keyframeIndex->Size());
+
+  db.Close();
+}
+
+std::string CDVDDemuxFFmpeg::GetKeyframeIndex()
+{
+  if (!m_keyframeIndex || !m_keyframeIndex->IsChanged())
+    return "";
+
+  return m_keyframeIndex->Serialize();
+}
+
+bool CDVDDemuxFFmpeg::ApplyProbeCache(AVFormatContext* context,
+                                      const std::vector<CDemuxProbeCache::Stream>& streams)
+{
+  // the header has to announce the streams that were probed
+  if (streams.size() != context->nb_streams)
+    return false;
+
+  for (unsigned int i = 0; i < context->nb_streams; i++)
+  {
+    const AVStream* st = context->streams[i];
+    if (st->id != streams[i].id ||
+        (st->codecpar->codec_type != AVMEDIA_TYPE_UNKNOWN &&
+         st->codecpar->codec_type != streams[i].codecType) ||
+        (st->codecpar->codec_id != AV_CODEC_ID_NONE && st->codecpar->codec_id != streams[i].codecId))
+      return false;
+  }
+
+  for (unsigned int i = 0; i < context->nb_streams; i++)
+  {
+    AVStream* st = context->streams[i];
+    AVCodecParameters* par = st->codecpar;
+    const CDemuxProbeCache::Stream& cached = streams[i];
+
+    par->codec_type = static_cast<AVMediaType>(cached.codecType);
+    par->codec_id = static_cast<AVCodecID>(cached.codecId);
+    par->codec_tag = cached.codecTag;
+    if (!par->extradata && !cached.extraData.empty())
+    {
+      par->extradata = static_cast<uint8_t*>(
+          av_mallocz(cached.extraData.size() + AV_INPUT_BUFFER_PADDING_SIZE));
+      if (par->extradata)
+      {
+        memcpy(par->extradata, cached.extraData.data(), cached.extraData.size());
+        par->extradata_size = static_cast<int>(cached.extraData.size());
+      }
+    }
+    par->format = cached.format;
+    par->bit_rate = cached.bitRate;
+    par->bits_per_coded_sample = cached.bitsPerCodedSample;
+    par->profile = cached.profile;
+    par->level = cached.level;
+    par->width = cached.width;
+    par->height = cached.height;
+    par->channel_layout = cached.channelLayout;
+    par->channels = cached.channels;
+    par->sample_rate = cached.sampleRate;
+    par->block_align = cached.blockAlign;
+    st->r_frame_rate = av_make_q(cached.frameRateNum, cached.frameRateDen);
+    st->avg_frame_rate = av_make_q(cached.avgFrameRateNum, cached.avgFrameRateDen);
+  }
+
+  return true;
+}
+
+std::vector<CDemuxProbeCache::Stream> CDVDDemuxFFmpeg::GetProbeCache(const AVFormatContext* context)
+{
+  std::vector<CDemuxProbeCache::Stream> streams;
+  for (unsigned int i = 0; i < context->nb_streams; i++)
+  {
+    const AVStream* st = context->streams[i];
+    const AVCodecParameters* par = st->codecpar;
+
+    CDemuxProbeCache::Stream stream;
+    stream.id = st->id;
+    stream.codecType = par->codec_type;
+    stream.codecId = par->codec_id;
+    stream.codecTag = par->codec_tag;
+    if (par->extradata && par->extradata_size > 0)
+      stream.extraData.assign(par->extradata, par->extradata + par->extradata_size);
+    stream.format = par->format;
+    stream.bitRate = par->bit_rate;
+    stream.bitsPerCodedSample = par->bits_per_coded_sample;
+    stream.profile = par->profile;
+    stream.level = par->level;
+    stream.width = par->width;
+    stream.height = par->height;
+    stream.channelLayout = par->channel_layout;
+    stream.channels = par->channels;
+    stream.sampleRate = par->sample_rate;
+    stream.blockAlign = par->block_align;
+    stream.frameRateNum = st->r_frame_rate.num;
+    stream.frameRateDen = st->r_frame_rate.den;
+    stream.avgFrameRateNum = st->avg_frame_rate.num;
+    stream.avgFrameRateDen = st->avg_frame_rate.den;
+    streams.push_back(std::move(stream));
+  }
+  return streams;
+}
+
 bool CDVDDemuxFFmpeg::IsProgramChange()
 {
   if (m_program == UINT_MAX)
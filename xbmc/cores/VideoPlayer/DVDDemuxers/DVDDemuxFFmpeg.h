@@ -9,6 +9,8 @@
 #pragma once
 
 #include "DVDDemux.h"
+#include "DemuxProbeCache.h"
+#include "KeyframeIndex.h"
 #include "threads/CriticalSection.h"
 #include "threads/SystemClock.h"
 #include <map>
@@ -20,6 +22,7 @@ extern "C" {
 }
 
 class CDVDDemuxFFmpeg;
+class CReadAheadBuffer;
 class CURL;
 
 enum class TRANSPORT_STREAM_STATE
@@ -108,11 +111,22 @@ public:
   void GetChapterName(std::string& strChapterName, int chapterIdx=-1) override;
   int64_t GetChapterPos(int chapterIdx = -1) override;
   std::string GetStreamCodecName(int iStreamId) override;
+  std::string GetKeyframeIndex() override;
 
   bool Aborted();
 
+  /*!
+   * @brief Apply cached stream parameters to a format context whose header was read.
+   * @return False if the header announces other streams than the cached ones, the context is
+   * left unchanged then.
+   */
+  static bool ApplyProbeCache(AVFormatContext* context,
+                              const std::vector<CDemuxProbeCache::Stream>& streams);
+  static std::vector<CDemuxProbeCache::Stream> GetProbeCache(const AVFormatContext* context);
+
   AVFormatContext* m_pFormatContext;
   std::shared_ptr<CDVDInputStream> m_pInput;
+  std::unique_ptr<CReadAheadBuffer> m_readAhead; //!< reads m_pInput ahead if set
 
 protected:
   friend class CDemuxStreamAudioFFmpeg;
@@ -131,6 +145,7 @@ protected:
   AVDictionary* GetFFMpegOptionsFromInput();
   double ConvertTimestamp(int64_t pts, int den, int num);
   void UpdateCurrentPTS();
+  void LoadKeyframeIndex();
   bool IsProgramChange();
   unsigned int HLSSelectProgram();
 
@@ -170,10 +185,12 @@ protected:
 
   bool m_streaminfo;
   bool m_reopen = false;
+  bool m_probeCached = false; // stream parameters were taken from the probe cache
   bool m_checkTransportStream;
   int m_displayTime = 0;
   double m_dtsAtDisplayTime;
   bool m_seekToKeyFrame = false;
   double m_startTime = 0;
+  std::unique_ptr<CKeyframeIndex> m_keyframeIndex;
 };
 
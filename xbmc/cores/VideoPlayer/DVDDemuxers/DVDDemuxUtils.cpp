@@ -9,19 +9,109 @@
 #include "DVDDemuxUtils.h"
 
 #include "cores/VideoPlayer/Interface/DemuxCrypto.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
 #include "utils/MemUtils.h"
 #include "utils/log.h"
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 extern "C" {
 #include <libavcodec/avcodec.h>
 }
 
+namespace
+{
+
+/*!
+ * Keeps freed packet buffers of the common sizes for reuse, high bitrate streams otherwise
+ * allocate and free a buffer for every packet. Buffers are grouped by power of two size
+ * classes, the class is stored in front of the data.
+ */
+class CPacketBufferPool
+{
+public:
+  uint8_t* Allocate(size_t size)
+  {
+    unsigned int sizeClass = 0;
+    while (sizeClass < CLASSES && ClassSize(sizeClass) < size)
+      sizeClass++;
+
+    if (sizeClass < CLASSES)
+    {
+      CSingleLock lock(m_critSection);
+      std::vector<uint8_t*>& free = m_free[sizeClass];
+      if (!free.empty())
+      {
+        uint8_t* data = free.back();
+        free.pop_back();
+        return data;
+      }
+    }
+
+    const size_t allocSize = sizeClass < CLASSES ? ClassSize(sizeClass) : size;
+    uint8_t* buffer =
+        static_cast<uint8_t*>(KODI::MEMORY::AlignedMalloc(HEADER_SIZE + allocSize, 16));
+    if (!buffer)
+      return nullptr;
+
+    buffer[0] = static_cast<uint8_t>(sizeClass);
+    return buffer + HEADER_SIZE;
+  }
+
+  void Free(uint8_t* data)
+  {
+    uint8_t* buffer = data - HEADER_SIZE;
+    const unsigned int sizeClass = buffer[0];
+
+    if (sizeClass < CLASSES)
+    {
+      CSingleLock lock(m_critSection);
+      std::vector<uint8_t*>& free = m_free[sizeClass];
+      if (free.size() < MaxFree(sizeClass))
+      {
+        free.push_back(data);
+        return;
+      }
+    }
+
+    KODI::MEMORY::AlignedFree(buffer);
+  }
+
+private:
+  static constexpr size_t HEADER_SIZE = 16; // keeps the data aligned
+  static constexpr unsigned int CLASSES = 12; // 1 KiB to 2 MiB
+  static constexpr size_t MAX_FREE_SIZE = 4 * 1024 * 1024; // per class
+
+  static size_t ClassSize(unsigned int sizeClass) { return static_cast<size_t>(1024) << sizeClass; }
+  static size_t MaxFree(unsigned int sizeClass)
+  {
+    return std::min<size_t>(64, MAX_FREE_SIZE / ClassSize(sizeClass));
+  }
+
+  CCriticalSection m_critSection;
+  std::vector<uint8_t*> m_free[CLASSES];
+};
+
+CPacketBufferPool& GetBufferPool()
+{
+  // never destroyed, packets may still be freed during shutdown
+  static CPacketBufferPool* pool = new CPacketBufferPool;
+  return *pool;
+}
+
+} // unnamed namespace
+
 void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 {
   if (pPacket)
   {
-    if (pPacket->pData)
-      KODI::MEMORY::AlignedFree(pPacket->pData);
+    if (pPacket->pBuffer)
+      av_buffer_unref(&pPacket->pBuffer);
+    else if (pPacket->pData)
+      GetBufferPool().Free(pPacket->pData);
     if (pPacket->iSideDataElems)
     {
       AVPacket avPkt;
@@ -51,7 +141,7 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
      * Note, if the first 23 bits of the additional bytes are not 0 then damaged
      * MPEG bitstreams could cause overread and segfault
      */
-    pPacket->pData = static_cast<uint8_t*>(KODI::MEMORY::AlignedMalloc(iDataSize + AV_INPUT_BUFFER_PADDING_SIZE, 16));
+    pPacket->pData = GetBufferPool().Allocate(iDataSize + AV_INPUT_BUFFER_PADDING_SIZE);
     if (!pPacket->pData)
     {
       FreeDemuxPacket(pPacket);
@@ -73,6 +163,33 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(unsigned int iDataSize, unsigne
   return ret;
 }
 
+DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(const AVPacket& pkt)
+{
+  // packets of ffmpeg demuxers come padded, check anyway as we pass the data on to decoders
+  if (pkt.buf && pkt.data && pkt.size > 0 && pkt.data >= pkt.buf->data &&
+      pkt.data + pkt.size + AV_INPUT_BUFFER_PADDING_SIZE <= pkt.buf->data + pkt.buf->size)
+  {
+    AVBufferRef* buffer = av_buffer_ref(pkt.buf);
+    if (buffer)
+    {
+      DemuxPacket* pPacket = new DemuxPacket();
+      pPacket->pBuffer = buffer;
+      pPacket->pData = pkt.data;
+      pPacket->iSize = pkt.size;
+      return pPacket;
+    }
+  }
+
+  DemuxPacket* pPacket = AllocateDemuxPacket(pkt.size);
+  if (pPacket && pkt.size > 0)
+  {
+    if (pkt.data)
+      memcpy(pPacket->pData, pkt.data, pkt.size);
+    pPacket->iSize = pkt.size;
+  }
+  return pPacket;
+}
+
 void CDVDDemuxUtils::StoreSideData(DemuxPacket *pkt, AVPacket *src)
 {
   AVPacket avPkt;
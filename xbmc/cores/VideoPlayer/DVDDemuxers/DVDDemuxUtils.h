@@ -19,6 +19,11 @@ public:
   static void FreeDemuxPacket(DemuxPacket* pPacket);
   static DemuxPacket* AllocateDemuxPacket(int iDataSize = 0);
   static DemuxPacket* AllocateDemuxPacket(unsigned int iDataSize, unsigned int encryptedSubsampleCount);
+  /*!
+   * @brief Create a packet holding the payload of pkt. Refcounted payloads are referenced
+   * instead of copied, the packet keeps them alive after pkt is unreferenced.
+   */
+  static DemuxPacket* AllocateDemuxPacket(const AVPacket& pkt);
   static void StoreSideData(DemuxPacket *pkt, AVPacket *src);
 };
 
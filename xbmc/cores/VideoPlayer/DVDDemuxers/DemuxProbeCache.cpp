@@ -0,0 +1,69 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DemuxProbeCache.h"
+
+#include "threads/SingleLock.h"
+
+#include <algorithm>
+
+constexpr size_t CDemuxProbeCache::MAX_ENTRIES;
+
+CDemuxProbeCache& CDemuxProbeCache::GetInstance()
+{
+  static CDemuxProbeCache instance;
+  return instance;
+}
+
+bool CDemuxProbeCache::Get(const std::string& url, std::vector<Stream>& streams)
+{
+  const std::string key = GetKey(url);
+
+  CSingleLock lock(m_critSection);
+
+  auto it = std::find_if(m_entries.begin(), m_entries.end(),
+                         [&key](const auto& entry) { return entry.first == key; });
+  if (it == m_entries.end())
+    return false;
+
+  m_entries.splice(m_entries.begin(), m_entries, it);
+  streams = it->second;
+  return true;
+}
+
+void CDemuxProbeCache::Set(const std::string& url, std::vector<Stream> streams)
+{
+  const std::string key = GetKey(url);
+
+  CSingleLock lock(m_critSection);
+
+  m_entries.remove_if([&key](const auto& entry) { return entry.first == key; });
+  m_entries.emplace_front(key, std::move(streams));
+
+  while (m_entries.size() > MAX_ENTRIES)
+    m_entries.pop_back();
+}
+
+void CDemuxProbeCache::Remove(const std::string& url)
+{
+  const std::string key = GetKey(url);
+
+  CSingleLock lock(m_critSection);
+  m_entries.remove_if([&key](const auto& entry) { return entry.first == key; });
+}
+
+size_t CDemuxProbeCache::Size() const
+{
+  CSingleLock lock(m_critSection);
+  return m_entries.size();
+}
+
+std::string CDemuxProbeCache::GetKey(const std::string& url)
+{
+  return url.substr(0, url.find('|'));
+}
@@ -0,0 +1,87 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <list>
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*!
+ * @brief Remembers the codec parameters probing found in the streams of a url.
+ *
+ * Probing a live stream (avformat_find_stream_info) reads up to several seconds of it before the
+ * first packet gets to the players. The same channels are opened over and over again and their
+ * stream layout rarely changes, so the demuxer caches what probing found. The next open of the
+ * url applies the cached parameters if the streams found in the header still match them, probing
+ * then only reads until every stream has a timestamp. The cache lives for the session, the least
+ * recently used url is dropped once MAX_ENTRIES are cached.
+ */
+class CDemuxProbeCache
+{
+public:
+  /*!
+   * @brief The parameters of a stream, the fields of AVCodecParameters and AVStream that probing
+   * fills in.
+   */
+  struct Stream
+  {
+    int id = 0;
+    int codecType = -1;
+    int codecId = 0;
+    unsigned int codecTag = 0;
+    std::vector<uint8_t> extraData;
+    int format = -1;
+    int64_t bitRate = 0;
+    int bitsPerCodedSample = 0;
+    int profile = -1;
+    int level = -1;
+    int width = 0;
+    int height = 0;
+    uint64_t channelLayout = 0;
+    int channels = 0;
+    int sampleRate = 0;
+    int blockAlign = 0;
+    int frameRateNum = 0;
+    int frameRateDen = 0;
+    int avgFrameRateNum = 0;
+    int avgFrameRateDen = 0;
+  };
+
+  static CDemuxProbeCache& GetInstance();
+
+  /*!
+   * @brief Look up the streams cached for a url, marks the url as recently used.
+   * @return True if the url is cached.
+   */
+  bool Get(const std::string& url, std::vector<Stream>& streams);
+
+  void Set(const std::string& url, std::vector<Stream> streams);
+
+  /*!
+   * @brief Forget a url, e.g. because its streams changed since they were cached.
+   */
+  void Remove(const std::string& url);
+
+  size_t Size() const;
+
+  /*!
+   * @return The url without protocol options, those often carry session tokens.
+   */
+  static std::string GetKey(const std::string& url);
+
+  static constexpr size_t MAX_ENTRIES = 32;
+
+private:
+  mutable CCriticalSection m_critSection;
+  std::list<std::pair<std::string, std::vector<Stream>>> m_entries; // most recently used first
+};
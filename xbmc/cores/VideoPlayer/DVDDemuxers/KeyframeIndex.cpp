@@ -0,0 +1,142 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "KeyframeIndex.h"
+
+#include "threads/SingleLock.h"
+#include "utils/StringUtils.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+
+constexpr int64_t CKeyframeIndex::MIN_SPACING;
+constexpr int64_t CKeyframeIndex::MAX_GAP;
+
+CKeyframeIndex::CKeyframeIndex(int64_t fileSize) : m_fileSize(fileSize)
+{
+}
+
+void CKeyframeIndex::Add(int64_t time, int64_t pos)
+{
+  if (time < 0 || pos < 0)
+    return;
+
+  CSingleLock lock(m_critSection);
+
+  auto it = std::lower_bound(m_entries.begin(), m_entries.end(), time,
+                             [](const Entry& entry, int64_t t) { return entry.time < t; });
+
+  if (it != m_entries.end() && it->time - time < MIN_SPACING)
+    return;
+  if (it != m_entries.begin() && time - std::prev(it)->time < MIN_SPACING)
+    return;
+
+  m_entries.insert(it, {time, pos});
+  m_changed = true;
+}
+
+bool CKeyframeIndex::Find(int64_t time, bool backwards, int64_t& pos) const
+{
+  CSingleLock lock(m_critSection);
+
+  // first key frame at or after time
+  auto next = std::lower_bound(m_entries.begin(), m_entries.end(), time,
+                               [](const Entry& entry, int64_t t) { return entry.time < t; });
+
+  if (next != m_entries.end() && next->time == time)
+  {
+    pos = next->pos;
+    return true;
+  }
+
+  // last key frame before time
+  auto prev = next != m_entries.begin() ? std::prev(next) : m_entries.end();
+  auto it = backwards ? prev : next;
+  if (it == m_entries.end())
+    return false;
+
+  // recorded while reading across time, any key frame in between would have been recorded too
+  const bool bracketed =
+      prev != m_entries.end() && next != m_entries.end() && next->time - prev->time <= MAX_GAP;
+
+  if (!bracketed && std::abs(it->time - time) > MIN_SPACING)
+    return false;
+
+  pos = it->pos;
+  return true;
+}
+
+size_t CKeyframeIndex::Size() const
+{
+  CSingleLock lock(m_critSection);
+  return m_entries.size();
+}
+
+bool CKeyframeIndex::IsChanged() const
+{
+  CSingleLock lock(m_critSection);
+  return m_changed;
+}
+
+std::string CKeyframeIndex::Serialize() const
+{
+  CSingleLock lock(m_critSection);
+
+  // entries are stored as differences to the previous one, which keeps the numbers short
+  std::ostringstream stream;
+  stream << m_fileSize;
+
+  Entry previous = {0, 0};
+  for (const auto& entry : m_entries)
+  {
+    stream << ' ' << entry.time - previous.time << ',' << entry.pos - previous.pos;
+    previous = entry;
+  }
+
+  return stream.str();
+}
+
+bool CKeyframeIndex::Deserialize(const std::string& data)
+{
+  std::vector<std::string> fields = StringUtils::Split(data, ' ');
+  std::vector<Entry> entries;
+
+  try
+  {
+    if (fields.empty() || std::stoll(fields[0]) != m_fileSize)
+      return false;
+
+    entries.reserve(fields.size() - 1);
+
+    Entry entry = {0, 0};
+    for (size_t i = 1; i < fields.size(); i++)
+    {
+      size_t separator = fields[i].find(',');
+      if (separator == std::string::npos)
+        return false;
+
+      entry.time += std::stoll(fields[i].substr(0, separator));
+      entry.pos += std::stoll(fields[i].substr(separator + 1));
+      if (!entries.empty() && entry.time <= entries.back().time)
+        return false;
+
+      entries.push_back(entry);
+    }
+  }
+  catch (const std::logic_error&)
+  {
+    return false;
+  }
+
+  CSingleLock lock(m_critSection);
+  m_entries.swap(entries);
+  m_changed = false;
+  return true;
+}
@@ -0,0 +1,88 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*!
+ * @brief Maps the times of key frames of a file to their byte positions.
+ *
+ * Containers without an index of their own (mpeg transport and program streams) can only be
+ * seeked by time by bisecting the file, which takes many reads and is inexact. The demuxer
+ * records the key frames it comes across, later seeks close to a recorded key frame go straight
+ * to its byte position. The player stores the index with the file state of library items, so it
+ * keeps growing over several playbacks of a file.
+ */
+class CKeyframeIndex
+{
+public:
+  /*!
+   * @param fileSize The size of the file, stored with the index to detect modified files.
+   */
+  explicit CKeyframeIndex(int64_t fileSize);
+
+  /*!
+   * @brief Record a key frame. Key frames closer than MIN_SPACING to an already recorded one
+   * are ignored.
+   * @param time The presentation time in ms, relative to the start of the file.
+   * @param pos The byte position of the packet.
+   */
+  void Add(int64_t time, int64_t pos);
+
+  /*!
+   * @brief Find the recorded key frame to seek to for a given time.
+   * @param time The seek target in ms.
+   * @param backwards Search for the last key frame at or before time, else the first one at or
+   * after time.
+   * @param pos [out] The byte position of the key frame.
+   * @return True if the recorded key frame is the one searched for: it is within MIN_SPACING of
+   * time, or time lies between two recorded key frames at most MAX_GAP apart. Otherwise there
+   * may be key frames in between that were never read.
+   */
+  bool Find(int64_t time, bool backwards, int64_t& pos) const;
+
+  size_t Size() const;
+
+  /*!
+   * @return True if key frames were added since the index was created or loaded.
+   */
+  bool IsChanged() const;
+
+  /*!
+   * @brief Serialize the index for storing it in the database.
+   */
+  std::string Serialize() const;
+
+  /*!
+   * @brief Replace the index with a serialized one. The stored index is dropped if it belongs
+   * to a file of a different size.
+   * @return True if the stored index was valid and loaded.
+   */
+  bool Deserialize(const std::string& data);
+
+  static constexpr int64_t MIN_SPACING = 1000; // ms
+  static constexpr int64_t MAX_GAP = 5000; // ms
+
+private:
+  struct Entry
+  {
+    int64_t time;
+    int64_t pos;
+  };
+
+  const int64_t m_fileSize;
+
+  mutable CCriticalSection m_critSection;
+  std::vector<Entry> m_entries; // sorted by time
+  bool m_changed = false;
+};
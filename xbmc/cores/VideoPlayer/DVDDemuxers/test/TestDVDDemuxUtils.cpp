@@ -0,0 +1,77 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxUtils.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+TEST(TestDVDDemuxUtils, ReferencesRefcountedPayload)
+{
+  AVPacket pkt;
+  av_init_packet(&pkt);
+  ASSERT_EQ(0, av_new_packet(&pkt, 1000));
+  memset(pkt.data, 0x42, pkt.size);
+
+  DemuxPacket* packet = CDVDDemuxUtils::AllocateDemuxPacket(pkt);
+  ASSERT_NE(nullptr, packet);
+  EXPECT_EQ(pkt.data, packet->pData);
+  EXPECT_EQ(1000, packet->iSize);
+  EXPECT_NE(nullptr, packet->pBuffer);
+
+  // the payload outlives the demuxer's packet
+  av_packet_unref(&pkt);
+  EXPECT_TRUE(std::all_of(packet->pData, packet->pData + packet->iSize,
+                          [](uint8_t b) { return b == 0x42; }));
+
+  CDVDDemuxUtils::FreeDemuxPacket(packet);
+}
+
+TEST(TestDVDDemuxUtils, CopiesUnownedPayload)
+{
+  uint8_t data[100];
+  memset(data, 0x42, sizeof(data));
+
+  AVPacket pkt;
+  av_init_packet(&pkt);
+  pkt.data = data;
+  pkt.size = sizeof(data);
+
+  DemuxPacket* packet = CDVDDemuxUtils::AllocateDemuxPacket(pkt);
+  ASSERT_NE(nullptr, packet);
+  EXPECT_NE(data, packet->pData);
+  EXPECT_EQ(nullptr, packet->pBuffer);
+  ASSERT_EQ(100, packet->iSize);
+  EXPECT_EQ(0, memcmp(data, packet->pData, sizeof(data)));
+
+  // decoders may read past the end
+  EXPECT_TRUE(std::all_of(packet->pData + 100, packet->pData + 100 + AV_INPUT_BUFFER_PADDING_SIZE,
+                          [](uint8_t b) { return b == 0; }));
+
+  CDVDDemuxUtils::FreeDemuxPacket(packet);
+}
+
+TEST(TestDVDDemuxUtils, ReusesFreedBuffers)
+{
+  DemuxPacket* packet = CDVDDemuxUtils::AllocateDemuxPacket(5000);
+  ASSERT_NE(nullptr, packet);
+  uint8_t* data = packet->pData;
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(data) % 16);
+  memset(data, 0xFF, 5000 + AV_INPUT_BUFFER_PADDING_SIZE);
+  CDVDDemuxUtils::FreeDemuxPacket(packet);
+
+  // same size class
+  packet = CDVDDemuxUtils::AllocateDemuxPacket(6000);
+  ASSERT_NE(nullptr, packet);
+  EXPECT_EQ(data, packet->pData);
+  EXPECT_TRUE(std::all_of(packet->pData + 6000, packet->pData + 6000 + AV_INPUT_BUFFER_PADDING_SIZE,
+                          [](uint8_t b) { return b == 0; }));
+  CDVDDemuxUtils::FreeDemuxPacket(packet);
+}
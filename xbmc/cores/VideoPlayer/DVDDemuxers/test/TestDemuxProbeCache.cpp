@@ -0,0 +1,154 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxFFmpeg.h"
+#include "cores/VideoPlayer/DVDDemuxers/DemuxProbeCache.h"
+
+#include <memory>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+std::vector<CDemuxProbeCache::Stream> CreateStreams(int width)
+{
+  CDemuxProbeCache::Stream video;
+  video.id = 0x100;
+  video.codecType = AVMEDIA_TYPE_VIDEO;
+  video.codecId = AV_CODEC_ID_H264;
+  video.width = width;
+  video.extraData = {0x00, 0x00, 0x01, 0x67};
+  video.frameRateNum = 25;
+  video.frameRateDen = 1;
+
+  CDemuxProbeCache::Stream audio;
+  audio.id = 0x101;
+  audio.codecType = AVMEDIA_TYPE_AUDIO;
+  audio.codecId = AV_CODEC_ID_AAC;
+  audio.sampleRate = 48000;
+  audio.channels = 2;
+
+  return {video, audio};
+}
+
+struct FormatContextDeleter
+{
+  void operator()(AVFormatContext* context) const { avformat_free_context(context); }
+};
+using FormatContextPtr = std::unique_ptr<AVFormatContext, FormatContextDeleter>;
+
+// a context as left by reading the header of a transport stream, before probing
+FormatContextPtr CreateContext(const std::vector<int>& ids)
+{
+  FormatContextPtr context(avformat_alloc_context());
+  for (int id : ids)
+  {
+    AVStream* st = avformat_new_stream(context.get(), nullptr);
+    st->id = id;
+  }
+  return context;
+}
+
+} // namespace
+
+TEST(TestDemuxProbeCache, StoresStreams)
+{
+  CDemuxProbeCache cache;
+  std::vector<CDemuxProbeCache::Stream> streams;
+  EXPECT_FALSE(cache.Get("http://host/channel/1.m3u8", streams));
+
+  cache.Set("http://host/channel/1.m3u8|User-Agent=kodi&token=a", CreateStreams(1920));
+
+  // session tokens in the options don't make another channel
+  ASSERT_TRUE(cache.Get("http://host/channel/1.m3u8|token=b", streams));
+  ASSERT_EQ(2u, streams.size());
+  EXPECT_EQ(1920, streams[0].width);
+  EXPECT_EQ(4u, streams[0].extraData.size());
+  EXPECT_EQ(48000, streams[1].sampleRate);
+
+  // probed again
+  cache.Set("http://host/channel/1.m3u8", CreateStreams(1280));
+  EXPECT_EQ(1u, cache.Size());
+  ASSERT_TRUE(cache.Get("http://host/channel/1.m3u8", streams));
+  EXPECT_EQ(1280, streams[0].width);
+
+  cache.Remove("http://host/channel/1.m3u8|token=c");
+  EXPECT_FALSE(cache.Get("http://host/channel/1.m3u8", streams));
+  EXPECT_EQ(0u, cache.Size());
+}
+
+TEST(TestDemuxProbeCache, DropsLeastRecentlyUsed)
+{
+  CDemuxProbeCache cache;
+  for (size_t i = 0; i < CDemuxProbeCache::MAX_ENTRIES; i++)
+    cache.Set("udp://239.0.0." + std::to_string(i), CreateStreams(720));
+  EXPECT_EQ(CDemuxProbeCache::MAX_ENTRIES, cache.Size());
+
+  // zapping back to the first channel keeps it
+  std::vector<CDemuxProbeCache::Stream> streams;
+  EXPECT_TRUE(cache.Get("udp://239.0.0.0", streams));
+
+  cache.Set("udp://239.0.1.0", CreateStreams(720));
+  EXPECT_EQ(CDemuxProbeCache::MAX_ENTRIES, cache.Size());
+  EXPECT_TRUE(cache.Get("udp://239.0.0.0", streams));
+  EXPECT_FALSE(cache.Get("udp://239.0.0.1", streams));
+  EXPECT_TRUE(cache.Get("udp://239.0.1.0", streams));
+}
+
+TEST(TestDemuxProbeCache, AppliesToMatchingStreams)
+{
+  FormatContextPtr context = CreateContext({0x100, 0x101});
+  context->streams[0]->codecpar->codec_type = AVMEDIA_TYPE_VIDEO;
+  ASSERT_TRUE(CDVDDemuxFFmpeg::ApplyProbeCache(context.get(), CreateStreams(1920)));
+
+  const AVCodecParameters* video = context->streams[0]->codecpar;
+  EXPECT_EQ(AVMEDIA_TYPE_VIDEO, video->codec_type);
+  EXPECT_EQ(AV_CODEC_ID_H264, video->codec_id);
+  EXPECT_EQ(1920, video->width);
+  ASSERT_EQ(4, video->extradata_size);
+  EXPECT_EQ(0x67, video->extradata[3]);
+  EXPECT_EQ(25, context->streams[0]->r_frame_rate.num);
+
+  const AVCodecParameters* audio = context->streams[1]->codecpar;
+  EXPECT_EQ(AVMEDIA_TYPE_AUDIO, audio->codec_type);
+  EXPECT_EQ(AV_CODEC_ID_AAC, audio->codec_id);
+  EXPECT_EQ(48000, audio->sample_rate);
+  EXPECT_EQ(2, audio->channels);
+
+  // what gets cached after probing
+  const std::vector<CDemuxProbeCache::Stream> streams =
+      CDVDDemuxFFmpeg::GetProbeCache(context.get());
+  ASSERT_EQ(2u, streams.size());
+  EXPECT_EQ(0x100, streams[0].id);
+  EXPECT_EQ(1920, streams[0].width);
+  EXPECT_EQ(CreateStreams(1920)[0].extraData, streams[0].extraData);
+  EXPECT_EQ(0x101, streams[1].id);
+  EXPECT_EQ(48000, streams[1].sampleRate);
+}
+
+TEST(TestDemuxProbeCache, IgnoresOtherStreams)
+{
+  // another stream layout
+  FormatContextPtr context = CreateContext({0x100});
+  EXPECT_FALSE(CDVDDemuxFFmpeg::ApplyProbeCache(context.get(), CreateStreams(1920)));
+
+  context = CreateContext({0x100, 0x102});
+  EXPECT_FALSE(CDVDDemuxFFmpeg::ApplyProbeCache(context.get(), CreateStreams(1920)));
+
+  // the header announces another codec
+  context = CreateContext({0x100, 0x101});
+  context->streams[0]->codecpar->codec_type = AVMEDIA_TYPE_VIDEO;
+  context->streams[0]->codecpar->codec_id = AV_CODEC_ID_HEVC;
+  EXPECT_FALSE(CDVDDemuxFFmpeg::ApplyProbeCache(context.get(), CreateStreams(1920)));
+
+  // the context is left as it was
+  EXPECT_EQ(AV_CODEC_ID_HEVC, context->streams[0]->codecpar->codec_id);
+  EXPECT_EQ(0, context->streams[0]->codecpar->width);
+  EXPECT_EQ(0, context->streams[1]->codecpar->sample_rate);
+}
@@ -0,0 +1,106 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDDemuxers/KeyframeIndex.h"
+
+#include <gtest/gtest.h>
+
+TEST(TestKeyframeIndex, FindsNearestKeyframe)
+{
+  CKeyframeIndex index(1000000);
+  index.Add(0, 0);
+  index.Add(2000, 20000);
+  index.Add(4000, 40000);
+
+  int64_t pos = -1;
+  EXPECT_TRUE(index.Find(3000, true, pos));
+  EXPECT_EQ(20000, pos);
+  EXPECT_TRUE(index.Find(3000, false, pos));
+  EXPECT_EQ(40000, pos);
+  EXPECT_TRUE(index.Find(2000, true, pos));
+  EXPECT_EQ(20000, pos);
+  EXPECT_TRUE(index.Find(2000, false, pos));
+  EXPECT_EQ(20000, pos);
+
+  // close to the last known key frame
+  EXPECT_TRUE(index.Find(4000 + CKeyframeIndex::MIN_SPACING, true, pos));
+  EXPECT_EQ(40000, pos);
+
+  // nothing known close to the target
+  EXPECT_FALSE(index.Find(4000 + CKeyframeIndex::MIN_SPACING + 1, true, pos));
+  EXPECT_FALSE(index.Find(4001, false, pos));
+}
+
+TEST(TestKeyframeIndex, IgnoresUnreadRanges)
+{
+  // read up to 10 s, then from 40 s on
+  CKeyframeIndex index(1000000);
+  for (int64_t time = 0; time <= 10000; time += 2000)
+    index.Add(time, time * 10);
+  for (int64_t time = 40000; time <= 50000; time += 2000)
+    index.Add(time, time * 10);
+
+  // the key frames before and after 25 s are unknown
+  int64_t pos = -1;
+  EXPECT_FALSE(index.Find(25000, true, pos));
+  EXPECT_FALSE(index.Find(25000, false, pos));
+
+  // close to a known one at the border of the unread range
+  EXPECT_TRUE(index.Find(10500, true, pos));
+  EXPECT_EQ(100000, pos);
+  EXPECT_TRUE(index.Find(39500, false, pos));
+  EXPECT_EQ(400000, pos);
+  EXPECT_FALSE(index.Find(12000, true, pos));
+  EXPECT_FALSE(index.Find(38000, false, pos));
+}
+
+TEST(TestKeyframeIndex, IgnoresCloseKeyframes)
+{
+  CKeyframeIndex index(1000000);
+  EXPECT_FALSE(index.IsChanged());
+
+  index.Add(1000, 10000);
+  index.Add(1000 + CKeyframeIndex::MIN_SPACING / 2, 15000);
+  index.Add(1000 - CKeyframeIndex::MIN_SPACING / 2, 5000);
+  EXPECT_EQ(1u, index.Size());
+  EXPECT_TRUE(index.IsChanged());
+
+  index.Add(1000 + CKeyframeIndex::MIN_SPACING, 20000);
+  EXPECT_EQ(2u, index.Size());
+}
+
+TEST(TestKeyframeIndex, SerializeRoundTrip)
+{
+  CKeyframeIndex index(1000000);
+  index.Add(4000, 40000);
+  index.Add(0, 0);
+  index.Add(2000, 20000);
+
+  CKeyframeIndex loaded(1000000);
+  ASSERT_TRUE(loaded.Deserialize(index.Serialize()));
+  EXPECT_FALSE(loaded.IsChanged());
+  EXPECT_EQ(3u, loaded.Size());
+
+  int64_t pos = -1;
+  EXPECT_TRUE(loaded.Find(2500, true, pos));
+  EXPECT_EQ(20000, pos);
+  EXPECT_TRUE(loaded.Find(3500, false, pos));
+  EXPECT_EQ(40000, pos);
+}
+
+TEST(TestKeyframeIndex, RejectsIndexOfModifiedFile)
+{
+  CKeyframeIndex index(1000000);
+  index.Add(0, 0);
+
+  CKeyframeIndex other(2000000);
+  EXPECT_FALSE(other.Deserialize(index.Serialize()));
+  EXPECT_FALSE(other.Deserialize("garbage"));
+  EXPECT_FALSE(other.Deserialize("2000000 1,x"));
+  EXPECT_EQ(0u, other.Size());
+}
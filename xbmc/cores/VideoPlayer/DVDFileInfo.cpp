@@ -43,6 +43,7 @@
 
 #include <cstdlib>
 #include <memory>
+#include <string>
 
 extern "C" {
 #include <libavformat/avformat.h>
@@ -71,6 +72,46 @@ bool CDVDFileInfo::GetFileDuration(const std::string &path, int& duration)
     return false;
 }
 
+namespace
+{
+
+/*!
+ * \brief Create the decoder for a thumbnail.
+ * \param fast decode key frames only, at reduced size where the codec supports it
+ */
+CDVDVideoCodec* CreateThumbCodec(CDVDStreamInfo& hint,
+                                 CProcessInfo& processInfo,
+                                 unsigned int maxWidth,
+                                 bool fast)
+{
+  // decoders of add-ons don't take the options
+  if (hint.externalInterfaces)
+    return fast ? nullptr : CDVDFactoryCodec::CreateVideoCodec(hint, processInfo);
+
+  if (!fast)
+    return CDVDFactoryCodec::CreateVideoCodec(hint, processInfo);
+
+  CDVDCodecOptions options;
+  options.m_keys.emplace_back("skip_frame", "nokey");
+  options.m_keys.emplace_back("skip_loop_filter", "all");
+
+  // halve the size as long as the thumb still gets its full width, ffmpeg limits the
+  // value to what the codec supports
+  int lowres = 0;
+  while (lowres < 3 && static_cast<unsigned int>(hint.width >> (lowres + 1)) >= maxWidth)
+    lowres++;
+  if (lowres > 0)
+    options.m_keys.emplace_back("lowres", std::to_string(lowres));
+
+  std::unique_ptr<CDVDVideoCodec> codec(new CDVDVideoCodecFFmpeg(processInfo));
+  if (!codec->Open(hint, options))
+    return nullptr;
+
+  return codec.release();
+}
+
+} // unnamed namespace
+
 int DegreeToOrientation(int degrees)
 {
   switch(degrees)
@@ -186,7 +227,6 @@ bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
 
   if (nVideoStream != -1)
   {
-    CDVDVideoCodec *pVideoCodec;
     std::unique_ptr<CProcessInfo> pProcessInfo(CProcessInfo::CreateInstance());
     std::vector<AVPixelFormat> pixFmts;
     pixFmts.push_back(AV_PIX_FMT_YUV420P);
@@ -195,95 +235,97 @@ bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
     CDVDStreamInfo hint(*pDemuxer->GetStream(demuxerId, nVideoStream), true);
     hint.codecOptions = CODEC_FORCE_SOFTWARE;
 
-    pVideoCodec = CDVDFactoryCodec::CreateVideoCodec(hint, *pProcessInfo);
+    const unsigned int imageRes = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_imageRes;
 
-    if (pVideoCodec)
+    // Decode key frames at reduced size first. Streams without usable key frames near the
+    // position (e.g. intra refresh) are decoded frame by frame at full size.
+    for (bool fast : {true, false})
     {
+      std::unique_ptr<CDVDVideoCodec> pVideoCodec(CreateThumbCodec(hint, *pProcessInfo, imageRes, fast));
+      if (!pVideoCodec)
+        continue;
+
       int nTotalLen = pDemuxer->GetStreamLength();
       int64_t nSeekTo = (pos == -1) ? nTotalLen / 3 : pos;
 
       CLog::Log(LOGDEBUG, "%s - seeking to pos %lldms (total: %dms) in %s", __FUNCTION__, nSeekTo, nTotalLen, redactPath.c_str());
-      if (pDemuxer->SeekTime(static_cast<double>(nSeekTo), true))
-      {
-        CDVDVideoCodec::VCReturn iDecoderState = CDVDVideoCodec::VC_NONE;
-        VideoPicture picture = {};
+      if (!pDemuxer->SeekTime(static_cast<double>(nSeekTo), true))
+        break;
 
-        // num streams * 160 frames, should get a valid frame, if not abort.
-        int abort_index = pDemuxer->GetNrOfStreams() * 160;
-        do
-        {
-          DemuxPacket* pPacket = pDemuxer->Read();
-          packetsTried++;
+      CDVDVideoCodec::VCReturn iDecoderState = CDVDVideoCodec::VC_NONE;
+      VideoPicture picture = {};
 
-          if (!pPacket)
-            break;
+      // num streams * 160 frames, should get a valid frame, if not abort.
+      int abort_index = pDemuxer->GetNrOfStreams() * 160;
+      do
+      {
+        DemuxPacket* pPacket = pDemuxer->Read();
+        packetsTried++;
 
-          if (pPacket->iStreamId != nVideoStream)
-          {
-            CDVDDemuxUtils::FreeDemuxPacket(pPacket);
-            continue;
-          }
+        if (!pPacket)
+          break;
 
-          pVideoCodec->AddData(*pPacket);
+        if (pPacket->iStreamId != nVideoStream)
+        {
           CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+          continue;
+        }
 
-          iDecoderState = CDVDVideoCodec::VC_NONE;
-          while (iDecoderState == CDVDVideoCodec::VC_NONE)
-          {
-            iDecoderState = pVideoCodec->GetPicture(&picture);
-          }
-
-          if (iDecoderState == CDVDVideoCodec::VC_PICTURE)
-          {
-            if(!(picture.iFlags & DVP_FLAG_DROPPED))
-              break;
-          }
+        pVideoCodec->AddData(*pPacket);
+        CDVDDemuxUtils::FreeDemuxPacket(pPacket);
 
-        } while (abort_index--);
+        iDecoderState = CDVDVideoCodec::VC_NONE;
+        while (iDecoderState == CDVDVideoCodec::VC_NONE)
+        {
+          iDecoderState = pVideoCodec->GetPicture(&picture);
+        }
 
-        if (iDecoderState == CDVDVideoCodec::VC_PICTURE && !(picture.iFlags & DVP_FLAG_DROPPED))
+        if (iDecoderState == CDVDVideoCodec::VC_PICTURE)
         {
-          {
-            unsigned int nWidth = std::min(picture.iDisplayWidth, CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_imageRes);
-            double aspect = (double)picture.iDisplayWidth / (double)picture.iDisplayHeight;
-            if(hint.forced_aspect && hint.aspect != 0)
-              aspect = hint.aspect;
-            unsigned int nHeight = (unsigned int)((double)nWidth / aspect);
-
-            // We pass the buffers to sws_scale uses 16 aligned widths when using intrinsics
-            int sizeNeeded = FFALIGN(nWidth, 16) * nHeight * 4;
-            uint8_t *pOutBuf = static_cast<uint8_t*>(av_malloc(sizeNeeded));
-            struct SwsContext *context = sws_getContext(picture.iWidth, picture.iHeight,
-                  AV_PIX_FMT_YUV420P, nWidth, nHeight, AV_PIX_FMT_BGRA, SWS_FAST_BILINEAR, NULL, NULL, NULL);
-
-            if (context)
-            {
-              uint8_t *planes[YuvImage::MAX_PLANES];
-              int stride[YuvImage::MAX_PLANES];
-              picture.videoBuffer->GetPlanes(planes);
-              picture.videoBuffer->GetStrides(stride);
-              uint8_t *src[4]= { planes[0], planes[1], planes[2], 0 };
-              int srcStride[] = { stride[0], stride[1], stride[2], 0 };
-              uint8_t *dst[] = { pOutBuf, 0, 0, 0 };
-              int dstStride[] = { (int)nWidth*4, 0, 0, 0 };
-              int orientation = DegreeToOrientation(hint.orientation);
-              sws_scale(context, src, srcStride, 0, picture.iHeight, dst, dstStride);
-              sws_freeContext(context);
-
-              details.width = nWidth;
-              details.height = nHeight;
-              CPicture::CacheTexture(pOutBuf, nWidth, nHeight, nWidth * 4, orientation, nWidth, nHeight, CTextureCache::GetCachedPath(details.file));
-              bOk = true;
-            }
-            av_free(pOutBuf);
-          }
+          if(!(picture.iFlags & DVP_FLAG_DROPPED))
+            break;
         }
-        else
+
+      } while (abort_index--);
+
+      if (iDecoderState == CDVDVideoCodec::VC_PICTURE && !(picture.iFlags & DVP_FLAG_DROPPED))
+      {
+        unsigned int nWidth = std::min(picture.iDisplayWidth, imageRes);
+        double aspect = (double)picture.iDisplayWidth / (double)picture.iDisplayHeight;
+        if(hint.forced_aspect && hint.aspect != 0)
+          aspect = hint.aspect;
+        unsigned int nHeight = (unsigned int)((double)nWidth / aspect);
+
+        // We pass the buffers to sws_scale uses 16 aligned widths when using intrinsics
+        int sizeNeeded = FFALIGN(nWidth, 16) * nHeight * 4;
+        uint8_t *pOutBuf = static_cast<uint8_t*>(av_malloc(sizeNeeded));
+        struct SwsContext *context = sws_getContext(picture.iWidth, picture.iHeight,
+              AV_PIX_FMT_YUV420P, nWidth, nHeight, AV_PIX_FMT_BGRA, SWS_FAST_BILINEAR, NULL, NULL, NULL);
+
+        if (context)
         {
-          CLog::Log(LOGDEBUG,"%s - decode failed in %s after %d packets.", __FUNCTION__, redactPath.c_str(), packetsTried);
+          uint8_t *planes[YuvImage::MAX_PLANES];
+          int stride[YuvImage::MAX_PLANES];
+          picture.videoBuffer->GetPlanes(planes);
+          picture.videoBuffer->GetStrides(stride);
+          uint8_t *src[4]= { planes[0], planes[1], planes[2], 0 };
+          int srcStride[] = { stride[0], stride[1], stride[2], 0 };
+          uint8_t *dst[] = { pOutBuf, 0, 0, 0 };
+          int dstStride[] = { (int)nWidth*4, 0, 0, 0 };
+          int orientation = DegreeToOrientation(hint.orientation);
+          sws_scale(context, src, srcStride, 0, picture.iHeight, dst, dstStride);
+          sws_freeContext(context);
+
+          details.width = nWidth;
+          details.height = nHeight;
+          CPicture::CacheTexture(pOutBuf, nWidth, nHeight, nWidth * 4, orientation, nWidth, nHeight, CTextureCache::GetCachedPath(details.file));
+          bOk = true;
         }
+        av_free(pOutBuf);
+        break;
       }
-      delete pVideoCodec;
+
+      CLog::Log(LOGDEBUG,"%s - decode failed in %s after %d packets%s.", __FUNCTION__, redactPath.c_str(), packetsTried, fast ? " (key frames)" : "");
     }
   }
 
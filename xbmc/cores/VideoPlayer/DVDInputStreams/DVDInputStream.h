@@ -165,6 +165,11 @@ public:
    */
   virtual void SetReadRate(unsigned rate) {}
 
+  /*! \brief Indicate that a range of the stream is going to be read soon.
+   *  Lets the underlying file prefetch it, should be seen as only a hint
+   */
+  virtual void HintReadAhead(int64_t offset, int64_t length) {}
+
   /*! \brief Get the cache status
    \return true when cache status was successfully obtained
    */
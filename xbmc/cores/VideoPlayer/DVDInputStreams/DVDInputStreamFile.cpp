@@ -184,3 +184,12 @@ void CDVDInputStreamFile::SetReadRate(unsigned rate)
   if(m_pFile->IoControl(IOCTRL_CACHE_SETRATE, &maxrate) >= 0)
     CLog::Log(LOGDEBUG, "CDVDInputStreamFile::SetReadRate - set cache throttle rate to %u bytes per second", maxrate);
 }
+
+void CDVDInputStreamFile::HintReadAhead(int64_t offset, int64_t length)
+{
+  if (!m_pFile)
+    return;
+
+  SReadAheadHint hint = {offset, length};
+  m_pFile->IoControl(IOCTRL_READ_AHEAD, &hint);
+}
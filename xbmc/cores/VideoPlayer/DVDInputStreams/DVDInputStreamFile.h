@@ -24,6 +24,7 @@ public:
   BitstreamStats GetBitstreamStats() const override ;
   int GetBlockSize() override;
   void SetReadRate(unsigned rate) override;
+  void HintReadAhead(int64_t offset, int64_t length) override;
   bool GetCacheStatus(XFILE::SCacheStatus *status) override;
 
 protected:
@@ -8,12 +8,17 @@
 
 #include "InputStreamPVRChannel.h"
 
+#include "PVRTimeshiftBuffer.h"
 #include "ServiceBroker.h"
 #include "pvr/PVRManager.h"
 #include "pvr/addons/PVRClient.h"
 #include "pvr/channels/PVRChannelGroupsContainer.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
 #include "utils/log.h"
 
+#include <inttypes.h>
+
 using namespace PVR;
 
 CInputStreamPVRChannel::CInputStreamPVRChannel(IVideoPlayer* pPlayer, const CFileItem& fileitem)
@@ -48,6 +53,36 @@ bool CInputStreamPVRChannel::OpenPVRStream()
   {
     m_bDemuxActive = m_client->GetClientCapabilities().HandlesDemuxing();
     CLog::Log(LOGDEBUG, "CInputStreamPVRChannel - %s - opened channel stream %s", __FUNCTION__, m_item.GetPath().c_str());
+
+    bool bCanPause = false;
+    m_client->CanPauseStream(bCanPause);
+
+    const std::shared_ptr<CAdvancedSettings> advancedSettings =
+        CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+    if (!m_bDemuxActive && !bCanPause && advancedSettings->m_iPVRLocalTimeshiftBufferSize > 0)
+    {
+      // the backend has no timeshift, buffer the stream locally
+      const std::shared_ptr<CPVRClient> client = m_client;
+      m_timeshiftBuffer.reset(new CPVRTimeshiftBuffer(
+          [client](uint8_t* buf, int buf_size) {
+            int ret = -1;
+            client->ReadLiveStream(buf, buf_size, ret);
+            return ret;
+          },
+          static_cast<uint64_t>(advancedSettings->m_iPVRLocalTimeshiftBufferSize) * 1024 * 1024,
+          advancedSettings->m_bPVRLocalTimeshiftOnDisk ? "special://temp/pvrtimeshift.ts" : ""));
+
+      if (m_timeshiftBuffer->Start())
+      {
+        CLog::Log(LOGDEBUG,
+                  "CInputStreamPVRChannel - %s - using local timeshift buffer of %" PRIu64 " MB",
+                  __FUNCTION__, m_timeshiftBuffer->GetSize() / (1024 * 1024));
+      }
+      else
+      {
+        m_timeshiftBuffer.reset();
+      }
+    }
     return true;
   }
   return false;
@@ -55,6 +90,9 @@ bool CInputStreamPVRChannel::OpenPVRStream()
 
 void CInputStreamPVRChannel::ClosePVRStream()
 {
+  // must stop reading before the live stream gets closed
+  m_timeshiftBuffer.reset();
+
   if (m_client && (m_client->CloseLiveStream() == PVR_ERROR_NO_ERROR))
   {
     m_bDemuxActive = false;
@@ -64,6 +102,9 @@ void CInputStreamPVRChannel::ClosePVRStream()
 
 int CInputStreamPVRChannel::ReadPVRStream(uint8_t* buf, int buf_size)
 {
+  if (m_timeshiftBuffer)
+    return m_timeshiftBuffer->Read(buf, buf_size);
+
   int ret = -1;
 
   if (m_client)
@@ -74,6 +115,9 @@ int CInputStreamPVRChannel::ReadPVRStream(uint8_t* buf, int buf_size)
 
 int64_t CInputStreamPVRChannel::SeekPVRStream(int64_t offset, int whence)
 {
+  if (m_timeshiftBuffer)
+    return m_timeshiftBuffer->Seek(offset, whence);
+
   int64_t ret = -1;
 
   if (m_client)
@@ -84,6 +128,9 @@ int64_t CInputStreamPVRChannel::SeekPVRStream(int64_t offset, int whence)
 
 int64_t CInputStreamPVRChannel::GetPVRStreamLength()
 {
+  if (m_timeshiftBuffer)
+    return m_timeshiftBuffer->GetLength();
+
   int64_t ret = -1;
 
   if (m_client)
@@ -102,6 +149,9 @@ CDVDInputStream::ENextStream CInputStreamPVRChannel::NextPVRStream()
 
 bool CInputStreamPVRChannel::CanPausePVRStream()
 {
+  if (m_timeshiftBuffer)
+    return true;
+
   bool ret = false;
 
   if (m_client)
@@ -112,6 +162,9 @@ bool CInputStreamPVRChannel::CanPausePVRStream()
 
 bool CInputStreamPVRChannel::CanSeekPVRStream()
 {
+  if (m_timeshiftBuffer)
+    return true;
+
   bool ret = false;
 
   if (m_client)
@@ -10,6 +10,10 @@
 
 #include "InputStreamPVRBase.h"
 
+#include <memory>
+
+class CPVRTimeshiftBuffer;
+
 class CInputStreamPVRChannel : public CInputStreamPVRBase
 {
 public:
@@ -30,4 +34,5 @@ protected:
 
 private:
   bool m_bDemuxActive;
+  std::unique_ptr<CPVRTimeshiftBuffer> m_timeshiftBuffer; /*!< local timeshift, if the backend has none */
 };
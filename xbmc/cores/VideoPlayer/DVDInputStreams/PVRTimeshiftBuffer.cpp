@@ -0,0 +1,308 @@
+/*
+ *  Copyright (C) 2012-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "PVRTimeshiftBuffer.h"
+
+#include "filesystem/IFileTypes.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace
+{
+constexpr size_t READ_CHUNK_SIZE = 64 * 1024;
+constexpr unsigned int READ_TIMEOUT = 10000; // ms
+constexpr unsigned int NO_DATA_WAIT = 50; // ms
+} // unnamed namespace
+
+constexpr uint64_t CPVRTimeshiftBuffer::MAX_MEMORY_SIZE;
+
+CPVRTimeshiftBuffer::CPVRTimeshiftBuffer(const SourceReader& source,
+                                         uint64_t size,
+                                         const std::string& strFile)
+  : CThread("PVRTimeshiftBuffer"),
+    m_source(source),
+    m_size(strFile.empty() ? std::min(size, MAX_MEMORY_SIZE) : size),
+    m_strFile(strFile)
+{
+  if (m_size < size)
+    CLog::LogF(LOGWARNING, "Timeshift buffer of {} MB in memory limited to {} MB",
+               size / (1024 * 1024), m_size / (1024 * 1024));
+}
+
+CPVRTimeshiftBuffer::~CPVRTimeshiftBuffer()
+{
+  Stop();
+}
+
+bool CPVRTimeshiftBuffer::Start()
+{
+  Stop();
+
+  if (m_size == 0)
+    return false;
+
+  if (m_strFile.empty())
+  {
+    try
+    {
+      m_ring.resize(static_cast<size_t>(m_size));
+    }
+    catch (const std::bad_alloc&)
+    {
+      CLog::LogF(LOGERROR, "Unable to allocate a timeshift buffer of {} MB",
+                 m_size / (1024 * 1024));
+      return false;
+    }
+  }
+  else if (!m_fileWrite.OpenForWrite(m_strFile, true) ||
+           !m_fileRead.Open(m_strFile, XFILE::READ_NO_CACHE))
+  {
+    CLog::LogF(LOGERROR, "Unable to open timeshift file '{}'", m_strFile);
+    m_fileWrite.Close();
+    return false;
+  }
+
+  m_begin = 0;
+  m_end = 0;
+  m_position = 0;
+  m_bEndOfInput = false;
+  m_bError = false;
+  m_dataAvailable.Reset();
+
+  Create();
+  return true;
+}
+
+void CPVRTimeshiftBuffer::Stop()
+{
+  StopThread(true);
+
+  CSingleLock lock(m_critSection);
+  m_ring.clear();
+  m_ring.shrink_to_fit();
+
+  // nothing is left to read
+  m_begin = m_end;
+  m_position = m_end;
+  m_bEndOfInput = true;
+  m_dataAvailable.Set();
+
+  if (!m_strFile.empty())
+  {
+    m_fileRead.Close();
+    m_fileWrite.Close();
+    XFILE::CFile::Delete(m_strFile);
+  }
+}
+
+void CPVRTimeshiftBuffer::Process()
+{
+  std::vector<uint8_t> chunk(static_cast<size_t>(std::min<uint64_t>(READ_CHUNK_SIZE, m_size)));
+
+  while (!m_bStop)
+  {
+    const int iRead = m_source(chunk.data(), static_cast<int>(chunk.size()));
+    if (iRead < 0)
+    {
+      CSingleLock lock(m_critSection);
+      m_bError = true;
+      break;
+    }
+
+    if (iRead == 0)
+    {
+      // no data from the backend yet, a live stream only ends when it is closed
+      Sleep(NO_DATA_WAIT);
+      continue;
+    }
+
+    // m_end is only changed by this thread
+    int64_t end;
+    {
+      CSingleLock lock(m_critSection);
+      end = m_end;
+
+      // the oldest data gets overwritten, it leaves the window before it is written
+      if (end + iRead - m_begin > static_cast<int64_t>(m_size))
+        m_begin = end + iRead - static_cast<int64_t>(m_size);
+
+      if (m_position < m_begin)
+      {
+        CLog::LogF(LOGDEBUG, "Reader fell behind the timeshift window, skipping {} bytes",
+                   m_begin - m_position);
+        m_position = m_begin;
+      }
+    }
+
+    const bool bWritten = WriteRing(chunk.data(), iRead, end);
+
+    CSingleLock lock(m_critSection);
+    if (!bWritten)
+    {
+      m_bError = true;
+      break;
+    }
+
+    m_end = end + iRead;
+    m_dataAvailable.Set();
+  }
+
+  // buffered data can still be read, afterwards Read reports the end of the stream
+  CSingleLock lock(m_critSection);
+  m_bEndOfInput = true;
+  m_dataAvailable.Set();
+}
+
+bool CPVRTimeshiftBuffer::WriteRing(const uint8_t* buf, size_t size, int64_t position)
+{
+  uint64_t offset = static_cast<uint64_t>(position) % m_size;
+  while (size > 0)
+  {
+    const size_t len = static_cast<size_t>(std::min<uint64_t>(size, m_size - offset));
+    if (m_strFile.empty())
+    {
+      std::memcpy(m_ring.data() + static_cast<size_t>(offset), buf, len);
+    }
+    else if (m_fileWrite.Seek(static_cast<int64_t>(offset), SEEK_SET) != static_cast<int64_t>(offset) ||
+             m_fileWrite.Write(buf, len) != static_cast<ssize_t>(len))
+    {
+      CLog::LogF(LOGERROR, "Failed to write to timeshift file '{}'", m_strFile);
+      return false;
+    }
+
+    buf += len;
+    size -= len;
+    offset = 0;
+  }
+
+  return true;
+}
+
+bool CPVRTimeshiftBuffer::ReadRing(uint8_t* buf, size_t size, int64_t position)
+{
+  uint64_t offset = static_cast<uint64_t>(position) % m_size;
+  while (size > 0)
+  {
+    const size_t len = static_cast<size_t>(std::min<uint64_t>(size, m_size - offset));
+    if (m_strFile.empty())
+    {
+      std::memcpy(buf, m_ring.data() + static_cast<size_t>(offset), len);
+    }
+    else if (m_fileRead.Seek(static_cast<int64_t>(offset), SEEK_SET) != static_cast<int64_t>(offset) ||
+             m_fileRead.Read(buf, len) != static_cast<ssize_t>(len))
+    {
+      CLog::LogF(LOGERROR, "Failed to read from timeshift file '{}'", m_strFile);
+      return false;
+    }
+
+    buf += len;
+    size -= len;
+    offset = 0;
+  }
+
+  return true;
+}
+
+int CPVRTimeshiftBuffer::Read(uint8_t* buf, int buf_size)
+{
+  if (buf_size <= 0)
+    return 0;
+
+  XbmcThreads::EndTime timeout(READ_TIMEOUT);
+  while (true)
+  {
+    int64_t position = 0;
+    size_t size = 0;
+    {
+      CSingleLock lock(m_critSection);
+      const int64_t available = m_end - m_position;
+      if (available > 0)
+      {
+        position = m_position;
+        size = static_cast<size_t>(std::min<int64_t>(available, buf_size));
+      }
+      else if (m_bEndOfInput)
+      {
+        return m_bError ? -1 : 0;
+      }
+      else
+      {
+        m_dataAvailable.Reset();
+      }
+    }
+
+    if (size > 0)
+    {
+      if (!ReadRing(buf, size, position))
+        return -1;
+
+      CSingleLock lock(m_critSection);
+      // overwritten by the live stream while reading, read again from the start of the window
+      if (position < m_begin || position != m_position)
+        continue;
+
+      m_position += size;
+      return static_cast<int>(size);
+    }
+
+    if (timeout.IsTimePast())
+      return -1;
+
+    m_dataAvailable.WaitMSec(std::min(timeout.MillisLeft(), 100u));
+  }
+}
+
+int64_t CPVRTimeshiftBuffer::Seek(int64_t offset, int whence)
+{
+  CSingleLock lock(m_critSection);
+
+  int64_t position;
+  switch (whence)
+  {
+    case SEEK_SET:
+      position = offset;
+      break;
+    case SEEK_CUR:
+      position = m_position + offset;
+      break;
+    case SEEK_END:
+      position = m_end + offset;
+      break;
+    default:
+      return -1;
+  }
+
+  if (position < m_begin || position > m_end)
+    return -1;
+
+  m_position = position;
+  return m_position;
+}
+
+int64_t CPVRTimeshiftBuffer::GetStartPosition() const
+{
+  CSingleLock lock(m_critSection);
+  return m_begin;
+}
+
+int64_t CPVRTimeshiftBuffer::GetLength() const
+{
+  CSingleLock lock(m_critSection);
+  return m_end;
+}
+
+int64_t CPVRTimeshiftBuffer::GetPosition() const
+{
+  CSingleLock lock(m_critSection);
+  return m_position;
+}
@@ -0,0 +1,120 @@
+/*
+ *  Copyright (C) 2012-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "filesystem/File.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+
+#include <functional>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*!
+ * @brief Local timeshift for live streams whose backend does not provide one.
+ *
+ * A background thread keeps reading the live stream into a ring of fixed size, kept in memory
+ * or in a file. Reads and seeks are served from the ring, so the stream can be paused and
+ * rewound within the window. Once the window is full the oldest data is dropped; a reader
+ * falling behind the window continues at its start.
+ */
+class CPVRTimeshiftBuffer : private CThread
+{
+public:
+  /*!
+   * @brief Source of the live stream. Returns the number of bytes read, 0 if no data is
+   * available yet, and a negative value on error. A live stream has no end, it is read until
+   * the buffer is stopped or an error occurs.
+   */
+  using SourceReader = std::function<int(uint8_t* buf, int buf_size)>;
+
+  /*!
+   * @brief The largest window kept in memory. Larger windows need a file.
+   */
+  static constexpr uint64_t MAX_MEMORY_SIZE = 512 * 1024 * 1024;
+
+  /*!
+   * @brief Create a new timeshift buffer.
+   * @param source The live stream.
+   * @param size The size of the window in bytes. A ring kept in memory is limited to
+   * MAX_MEMORY_SIZE.
+   * @param strFile The file to keep the ring in, or empty to keep it in memory.
+   */
+  CPVRTimeshiftBuffer(const SourceReader& source, uint64_t size, const std::string& strFile);
+  ~CPVRTimeshiftBuffer() override;
+
+  /*!
+   * @brief Allocate the ring and start reading the live stream.
+   * @return True on success, false otherwise, e.g. if the ring could not be allocated.
+   */
+  bool Start();
+
+  /*!
+   * @brief Stop reading the live stream and release the ring.
+   */
+  void Stop();
+
+  /*!
+   * @return The size of the window in bytes.
+   */
+  uint64_t GetSize() const { return m_size; }
+
+  /*!
+   * @brief Read from the current position. Waits for the live stream if no data is buffered.
+   * Read and Seek must be called from the same thread.
+   * @return The number of bytes read, 0 once the buffer is stopped, -1 on error or timeout.
+   */
+  int Read(uint8_t* buf, int buf_size);
+
+  /*!
+   * @brief Seek within the window. Positions are stream positions, not ring offsets.
+   * @return The new position or -1 if the position is outside the window.
+   */
+  int64_t Seek(int64_t offset, int whence);
+
+  /*!
+   * @return The stream position of the oldest byte still buffered.
+   */
+  int64_t GetStartPosition() const;
+
+  /*!
+   * @return The number of bytes read from the live stream so far.
+   */
+  int64_t GetLength() const;
+
+  /*!
+   * @return The current read position.
+   */
+  int64_t GetPosition() const;
+
+private:
+  void Process() override;
+
+  // ring I/O happens without the lock, the writer takes the region it writes out of the window
+  // first and the reader checks afterwards whether its region is still in the window
+  bool WriteRing(const uint8_t* buf, size_t size, int64_t position);
+  bool ReadRing(uint8_t* buf, size_t size, int64_t position);
+
+  const SourceReader m_source;
+  const uint64_t m_size;
+  const std::string m_strFile;
+
+  mutable CCriticalSection m_critSection;
+  CEvent m_dataAvailable;
+  std::vector<uint8_t> m_ring;
+  XFILE::CFile m_fileWrite;
+  XFILE::CFile m_fileRead;
+  int64_t m_begin = 0; /*!< stream position of the oldest byte in the ring */
+  int64_t m_end = 0; /*!< stream position after the newest byte in the ring */
+  int64_t m_position = 0; /*!< current read position */
+  bool m_bEndOfInput = false;
+  bool m_bError = false;
+};
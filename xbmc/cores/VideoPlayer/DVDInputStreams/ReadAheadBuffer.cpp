@@ -0,0 +1,288 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ReadAheadBuffer.h"
+
+#include "DVDInputStream.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <inttypes.h>
+
+constexpr size_t CReadAheadBuffer::BLOCK_SIZE;
+constexpr size_t CReadAheadBuffer::BLOCKS;
+constexpr size_t CReadAheadBuffer::CHUNK_SIZE;
+
+CReadAheadBuffer::CReadAheadBuffer(const std::shared_ptr<CDVDInputStream>& input,
+                                   const AbortCheck& aborted,
+                                   const StallCallback& stalled,
+                                   size_t blockSize /* = BLOCK_SIZE */)
+  : CThread("ReadAheadBuffer"),
+    m_input(input),
+    m_aborted(aborted),
+    m_stalled(stalled),
+    m_blockSize(blockSize)
+{
+}
+
+CReadAheadBuffer::~CReadAheadBuffer()
+{
+  Stop();
+}
+
+bool CReadAheadBuffer::Start()
+{
+  Stop();
+
+  const int64_t position = m_input->Seek(0, SEEK_CUR);
+  if (position < 0)
+    return false;
+  const int64_t length = m_input->GetLength();
+
+  {
+    CSingleLock lock(m_critSection);
+    m_blocks.clear();
+    m_length = length;
+    m_position = position;
+    m_readPosition = position;
+    m_seek = false;
+    m_afterSeek = true;
+    m_eof = false;
+    m_error = false;
+  }
+
+  Create();
+  return true;
+}
+
+void CReadAheadBuffer::Stop()
+{
+  if (!IsRunning())
+    return;
+
+  m_bStop = true;
+  {
+    CSingleLock lock(m_critSection);
+    m_blockFree.notifyAll();
+  }
+  StopThread(true);
+
+  // leave the input stream where the reader is
+  CSingleLock lock(m_critSection);
+  if (m_readPosition != m_position || m_seek)
+    m_input->Seek(m_position, SEEK_SET);
+  m_blocks.clear();
+}
+
+void CReadAheadBuffer::Invalidate(int64_t position)
+{
+  m_generation++;
+  m_blocks.clear();
+  m_readPosition = position;
+  m_seek = true;
+  m_afterSeek = true;
+  m_eof = false;
+  m_error = false;
+  m_blockFree.notifyAll();
+}
+
+void CReadAheadBuffer::Process()
+{
+  while (!m_bStop)
+  {
+    std::shared_ptr<Block> block;
+    unsigned int generation;
+    bool seek;
+    {
+      CSingleLock lock(m_critSection);
+      while (!m_bStop && !m_seek && (m_blocks.size() >= BLOCKS || m_eof || m_error))
+        m_blockFree.wait(lock);
+
+      if (m_bStop)
+        break;
+
+      generation = m_generation;
+      seek = m_seek;
+      m_seek = false;
+
+      block = std::make_shared<Block>();
+      block->pos = m_readPosition;
+      block->data.resize(m_blockSize);
+      m_blocks.push_back(block);
+    }
+
+    bool error = seek && m_input->Seek(block->pos, SEEK_SET) != block->pos;
+    if (!error)
+      m_input->HintReadAhead(block->pos + m_blockSize, m_blockSize);
+
+    // publish the block in chunks, a waiting reader doesn't have to wait for the whole block
+    while (!m_bStop)
+    {
+      int read = -1;
+      int64_t length = -1;
+      if (!error)
+      {
+        const size_t size = std::min(CHUNK_SIZE, m_blockSize - block->size);
+        read = m_input->Read(block->data.data() + block->size, static_cast<int>(size));
+        // the input stream may only be used by this thread, files may grow while being read
+        length = m_input->GetLength();
+      }
+
+      CSingleLock lock(m_critSection);
+      if (length >= 0)
+        m_length = length;
+      if (generation != m_generation)
+        break; // seeked away, the block was dropped
+
+      if (read < 0)
+      {
+        CLog::Log(LOGERROR, "CReadAheadBuffer::%s - error reading at position %" PRId64, __FUNCTION__,
+                  block->pos + static_cast<int64_t>(block->size));
+        m_error = true;
+      }
+      else if (read == 0)
+        m_eof = true;
+      else
+      {
+        block->size += read;
+        m_readPosition += read;
+      }
+
+      m_dataAvailable.notifyAll();
+      if (m_error || m_eof || block->size == m_blockSize)
+        break;
+    }
+  }
+}
+
+int CReadAheadBuffer::Read(uint8_t* buf, int buf_size)
+{
+  if (buf_size <= 0)
+    return 0;
+
+  unsigned int stallStart = 0;
+  bool stalled = false;
+  int result;
+  {
+    CSingleLock lock(m_critSection);
+    while (true)
+    {
+      // drop consumed blocks
+      while (!m_blocks.empty() && m_blocks.front()->size == m_blockSize &&
+             m_blocks.front()->pos + static_cast<int64_t>(m_blockSize) <= m_position)
+      {
+        m_blocks.pop_front();
+        m_blockFree.notifyAll();
+      }
+
+      if (!m_blocks.empty())
+      {
+        const Block& block = *m_blocks.front();
+        const int64_t available = block.pos + static_cast<int64_t>(block.size) - m_position;
+        if (available > 0)
+        {
+          const size_t size = static_cast<size_t>(std::min<int64_t>(available, buf_size));
+          memcpy(buf, block.data.data() + (m_position - block.pos), size);
+          m_position += size;
+          m_afterSeek = false;
+          result = static_cast<int>(size);
+          break;
+        }
+      }
+
+      if (m_error)
+      {
+        result = -1;
+        break;
+      }
+      if (m_eof && m_position >= m_readPosition)
+      {
+        result = 0;
+        break;
+      }
+      if (m_aborted && m_aborted())
+      {
+        result = -1;
+        break;
+      }
+
+      if (!stalled && !m_afterSeek)
+      {
+        stalled = true;
+        stallStart = XbmcThreads::SystemClockMillis();
+      }
+      m_dataAvailable.wait(lock, 100);
+    }
+  }
+
+  if (stalled && m_stalled)
+    m_stalled(XbmcThreads::SystemClockMillis() - stallStart);
+
+  return result;
+}
+
+int64_t CReadAheadBuffer::Seek(int64_t offset, int whence)
+{
+  CSingleLock lock(m_critSection);
+
+  int64_t position;
+  switch (whence)
+  {
+    case SEEK_SET:
+      position = offset;
+      break;
+    case SEEK_CUR:
+      position = m_position + offset;
+      break;
+    case SEEK_END:
+      if (m_length < 0)
+        return -1;
+      position = m_length + offset;
+      break;
+    default:
+      return -1;
+  }
+
+  if (position < 0)
+    return -1;
+
+  if (m_blocks.empty() && !m_seek && position == m_readPosition)
+  {
+    m_position = position;
+    return position;
+  }
+
+  // stay with the blocks if the position is buffered or about to be read
+  if (!m_blocks.empty() && position >= m_blocks.front()->pos &&
+      position <= m_blocks.back()->pos + static_cast<int64_t>(m_blockSize) && !m_error)
+  {
+    m_position = position;
+    return position;
+  }
+
+  CLog::Log(LOGDEBUG, "CReadAheadBuffer::%s - seek to %" PRId64 " outside of the buffered blocks",
+            __FUNCTION__, position);
+  m_position = position;
+  Invalidate(position);
+  return position;
+}
+
+int64_t CReadAheadBuffer::GetLength()
+{
+  CSingleLock lock(m_critSection);
+  return m_length;
+}
+
+bool CReadAheadBuffer::IsEOF()
+{
+  CSingleLock lock(m_critSection);
+  return m_eof && m_position >= m_readPosition;
+}
@@ -0,0 +1,117 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/Thread.h"
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+class CDVDInputStream;
+
+/*!
+ * @brief Reads an input stream ahead on a thread of its own.
+ *
+ * Without a file cache every read of the demuxer waits for the input stream. The buffer reads
+ * the stream in large blocks, double buffered: while one block is consumed the next one is read,
+ * and the operating system is asked to prefetch the block after it. Seeks within the buffered
+ * blocks are served from them, other seeks drop the blocks and restart reading at the new
+ * position.
+ *
+ * Once started, the input stream must not be read or seeked by anyone else until Stop().
+ */
+class CReadAheadBuffer : private CThread
+{
+public:
+  /*!
+   * @brief Checked while waiting for data, a read fails once it returns true.
+   */
+  using AbortCheck = std::function<bool()>;
+
+  /*!
+   * @brief Called after a read had to wait for the input stream, with the time waited in ms.
+   */
+  using StallCallback = std::function<void(unsigned int ms)>;
+
+  static constexpr size_t BLOCK_SIZE = 1024 * 1024;
+
+  CReadAheadBuffer(const std::shared_ptr<CDVDInputStream>& input,
+                   const AbortCheck& aborted,
+                   const StallCallback& stalled,
+                   size_t blockSize = BLOCK_SIZE);
+  ~CReadAheadBuffer() override;
+
+  /*!
+   * @brief Start reading ahead at the current position of the input stream.
+   * @return True on success, false if the position of the input stream is unknown.
+   */
+  bool Start();
+
+  /*!
+   * @brief Stop reading ahead. The input stream is left at the position of the reader.
+   */
+  void Stop();
+
+  /*!
+   * @brief Same semantics as CDVDInputStream::Read.
+   */
+  int Read(uint8_t* buf, int buf_size);
+
+  /*!
+   * @brief Same semantics as CDVDInputStream::Seek, without SEEK_POSSIBLE.
+   */
+  int64_t Seek(int64_t offset, int whence);
+
+  /*!
+   * @brief Same semantics as CDVDInputStream::GetLength, as last seen by the read ahead thread.
+   */
+  int64_t GetLength();
+
+  /*!
+   * @return True if the reader reached the end of the input stream.
+   */
+  bool IsEOF();
+
+private:
+  struct Block
+  {
+    int64_t pos = 0;
+    size_t size = 0; //!< bytes read so far, the rest of data is still being read
+    std::vector<uint8_t> data;
+  };
+
+  void Process() override;
+  void Invalidate(int64_t position);
+
+  static constexpr size_t BLOCKS = 2;
+  static constexpr size_t CHUNK_SIZE = 256 * 1024;
+
+  const std::shared_ptr<CDVDInputStream> m_input;
+  const AbortCheck m_aborted;
+  const StallCallback m_stalled;
+  const size_t m_blockSize;
+
+  CCriticalSection m_critSection;
+  XbmcThreads::ConditionVariable m_dataAvailable;
+  XbmcThreads::ConditionVariable m_blockFree;
+  std::deque<std::shared_ptr<Block>> m_blocks; //!< in stream order, the last one may be filling
+  int64_t m_position = 0; //!< position of the reader
+  int64_t m_readPosition = 0; //!< position of the next byte read from the input stream
+  int64_t m_length = -1; //!< length of the input stream
+  unsigned int m_generation = 0; //!< incremented when the blocks are dropped
+  bool m_seek = false; //!< input stream has to be seeked to m_readPosition
+  bool m_afterSeek = true; //!< waiting after a seek is expected and not reported as stall
+  bool m_eof = false;
+  bool m_error = false;
+};
@@ -0,0 +1,196 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDInputStreams/PVRTimeshiftBuffer.h"
+#include "filesystem/File.h"
+#include "test/TestUtils.h"
+#include "threads/SystemClock.h"
+#include "utils/XTimeUtils.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+// stands in for a pvr backend, delivering a local file in ts packet sized pieces
+class CTestLiveStream
+{
+public:
+  bool Open()
+  {
+    if (!m_file.Open(XBMC_REF_FILE_PATH("/xbmc/filesystem/test/reffile.txt")))
+      return false;
+
+    m_data.resize(static_cast<size_t>(m_file.GetLength()));
+    if (m_file.Read(m_data.data(), m_data.size()) != static_cast<ssize_t>(m_data.size()))
+      return false;
+
+    return m_file.Seek(0, SEEK_SET) == 0;
+  }
+
+  CPVRTimeshiftBuffer::SourceReader Reader()
+  {
+    return [this](uint8_t* buf, int buf_size) {
+      return static_cast<int>(m_file.Read(buf, std::min(buf_size, 188)));
+    };
+  }
+
+  const std::vector<uint8_t>& Data() const { return m_data; }
+
+private:
+  XFILE::CFile m_file;
+  std::vector<uint8_t> m_data;
+};
+
+bool WaitForLength(const CPVRTimeshiftBuffer& buffer, int64_t length)
+{
+  XbmcThreads::EndTime timeout(5000);
+  while (buffer.GetLength() < length)
+  {
+    if (timeout.IsTimePast())
+      return false;
+    KODI::TIME::Sleep(10);
+  }
+  return true;
+}
+
+// a live stream has no end, read up to the given stream position
+std::vector<uint8_t> ReadUpTo(CPVRTimeshiftBuffer& buffer, int64_t end)
+{
+  std::vector<uint8_t> result;
+  uint8_t buf[100];
+  while (buffer.GetPosition() < end)
+  {
+    const int read = buffer.Read(
+        buf, static_cast<int>(std::min<int64_t>(sizeof(buf), end - buffer.GetPosition())));
+    if (read <= 0)
+      break;
+    result.insert(result.end(), buf, buf + read);
+  }
+  return result;
+}
+
+} // namespace
+
+TEST(TestPVRTimeshiftBuffer, ReadsLiveStream)
+{
+  CTestLiveStream stream;
+  ASSERT_TRUE(stream.Open());
+
+  CPVRTimeshiftBuffer buffer(stream.Reader(), 4096, "");
+  ASSERT_TRUE(buffer.Start());
+
+  EXPECT_EQ(stream.Data(), ReadUpTo(buffer, stream.Data().size()));
+  EXPECT_EQ(static_cast<int64_t>(stream.Data().size()), buffer.GetLength());
+}
+
+TEST(TestPVRTimeshiftBuffer, WaitsForLiveStream)
+{
+  CTestLiveStream stream;
+  ASSERT_TRUE(stream.Open());
+  const std::vector<uint8_t>& data = stream.Data();
+
+  // the backend has no data for a while, which is not the end of the stream
+  int noData = 5;
+  const CPVRTimeshiftBuffer::SourceReader reader = stream.Reader();
+  CPVRTimeshiftBuffer buffer(
+      [&noData, &reader](uint8_t* buf, int buf_size) {
+        return noData-- > 0 ? 0 : reader(buf, buf_size);
+      },
+      4096, "");
+  ASSERT_TRUE(buffer.Start());
+
+  EXPECT_EQ(data, ReadUpTo(buffer, data.size()));
+
+  // once stopped nothing is left to read
+  buffer.Stop();
+  uint8_t buf[10];
+  EXPECT_EQ(0, buffer.Read(buf, sizeof(buf)));
+}
+
+TEST(TestPVRTimeshiftBuffer, SeeksWithinWindow)
+{
+  CTestLiveStream stream;
+  ASSERT_TRUE(stream.Open());
+  const std::vector<uint8_t>& data = stream.Data();
+
+  CPVRTimeshiftBuffer buffer(stream.Reader(), 4096, "");
+  ASSERT_TRUE(buffer.Start());
+  ASSERT_TRUE(WaitForLength(buffer, data.size()));
+
+  // rewind to the beginning, then skip forward
+  EXPECT_EQ(0, buffer.Seek(0, SEEK_SET));
+  uint8_t buf[20];
+  ASSERT_EQ(20, buffer.Read(buf, sizeof(buf)));
+  EXPECT_TRUE(std::equal(buf, buf + 20, data.begin()));
+
+  EXPECT_EQ(120, buffer.Seek(100, SEEK_CUR));
+  ASSERT_EQ(20, buffer.Read(buf, sizeof(buf)));
+  EXPECT_TRUE(std::equal(buf, buf + 20, data.begin() + 120));
+
+  // seeking beyond the live position is not possible
+  EXPECT_EQ(-1, buffer.Seek(1, SEEK_END));
+}
+
+TEST(TestPVRTimeshiftBuffer, DropsDataOutsideWindow)
+{
+  CTestLiveStream stream;
+  ASSERT_TRUE(stream.Open());
+  const std::vector<uint8_t>& data = stream.Data();
+  ASSERT_GT(data.size(), 1000u);
+
+  CPVRTimeshiftBuffer buffer(stream.Reader(), 500, "");
+  ASSERT_TRUE(buffer.Start());
+  ASSERT_TRUE(WaitForLength(buffer, data.size()));
+
+  // only the last 500 bytes are kept, a paused reader continues at the start of the window
+  EXPECT_EQ(static_cast<int64_t>(data.size() - 500), buffer.GetStartPosition());
+  EXPECT_EQ(-1, buffer.Seek(0, SEEK_SET));
+  EXPECT_EQ(std::vector<uint8_t>(data.end() - 500, data.end()), ReadUpTo(buffer, data.size()));
+}
+
+TEST(TestPVRTimeshiftBuffer, KeepsWindowOnDisk)
+{
+  CTestLiveStream stream;
+  ASSERT_TRUE(stream.Open());
+  const std::vector<uint8_t>& data = stream.Data();
+
+  CPVRTimeshiftBuffer buffer(stream.Reader(), 1000, "special://temp/pvrtimeshifttest.ts");
+  ASSERT_TRUE(buffer.Start());
+  ASSERT_TRUE(WaitForLength(buffer, data.size()));
+
+  EXPECT_EQ(std::vector<uint8_t>(data.end() - 1000, data.end()), ReadUpTo(buffer, data.size()));
+
+  // the ring wraps around in the file as well
+  EXPECT_EQ(static_cast<int64_t>(data.size() - 700), buffer.Seek(-700, SEEK_END));
+  EXPECT_EQ(std::vector<uint8_t>(data.end() - 700, data.end()), ReadUpTo(buffer, data.size()));
+
+  buffer.Stop();
+  EXPECT_FALSE(XFILE::CFile::Exists("special://temp/pvrtimeshifttest.ts"));
+}
+
+TEST(TestPVRTimeshiftBuffer, LimitsWindowInMemory)
+{
+  CTestLiveStream stream;
+  ASSERT_TRUE(stream.Open());
+
+  // 8 GB, the largest advanced setting, wraps in 32 bit math
+  const uint64_t size = 8192ull * 1024 * 1024;
+  CPVRTimeshiftBuffer memory(stream.Reader(), size, "");
+  EXPECT_EQ(CPVRTimeshiftBuffer::MAX_MEMORY_SIZE, memory.GetSize());
+
+  CPVRTimeshiftBuffer disk(stream.Reader(), size, "special://temp/pvrtimeshifttest.ts");
+  EXPECT_EQ(size, disk.GetSize());
+  ASSERT_TRUE(disk.Start());
+  EXPECT_EQ(stream.Data(), ReadUpTo(disk, stream.Data().size()));
+}
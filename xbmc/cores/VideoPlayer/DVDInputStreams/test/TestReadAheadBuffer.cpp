@@ -0,0 +1,140 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "cores/VideoPlayer/DVDInputStreams/DVDInputStreamFile.h"
+#include "cores/VideoPlayer/DVDInputStreams/ReadAheadBuffer.h"
+#include "filesystem/File.h"
+#include "test/TestUtils.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+// small blocks, so the reference file spans a number of them
+constexpr size_t TEST_BLOCK_SIZE = 100;
+
+class TestReadAheadBuffer : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    const std::string path = XBMC_REF_FILE_PATH("/xbmc/filesystem/test/reffile.txt");
+
+    XFILE::CFile file;
+    ASSERT_TRUE(file.Open(path));
+    m_content.resize(static_cast<size_t>(file.GetLength()));
+    ASSERT_EQ(static_cast<ssize_t>(m_content.size()), file.Read(m_content.data(), m_content.size()));
+    file.Close();
+
+    CFileItem item(path, false);
+    m_input = std::make_shared<CDVDInputStreamFile>(item, XFILE::READ_NO_CACHE);
+    ASSERT_TRUE(m_input->Open());
+
+    m_buffer.reset(new CReadAheadBuffer(m_input, nullptr, nullptr, TEST_BLOCK_SIZE));
+  }
+
+  void TearDown() override
+  {
+    m_buffer.reset();
+    m_input.reset();
+  }
+
+  std::vector<uint8_t> ReadAll()
+  {
+    std::vector<uint8_t> data;
+    uint8_t buf[64];
+    int read;
+    while ((read = m_buffer->Read(buf, sizeof(buf))) > 0)
+      data.insert(data.end(), buf, buf + read);
+    EXPECT_EQ(0, read);
+    return data;
+  }
+
+  std::vector<uint8_t> m_content;
+  std::shared_ptr<CDVDInputStreamFile> m_input;
+  std::unique_ptr<CReadAheadBuffer> m_buffer;
+};
+
+} // namespace
+
+TEST_F(TestReadAheadBuffer, ReadsWholeStream)
+{
+  ASSERT_TRUE(m_buffer->Start());
+  EXPECT_EQ(m_content, ReadAll());
+
+  // eof is sticky
+  uint8_t buf[16];
+  EXPECT_EQ(0, m_buffer->Read(buf, sizeof(buf)));
+}
+
+TEST_F(TestReadAheadBuffer, Seeks)
+{
+  ASSERT_TRUE(m_buffer->Start());
+  uint8_t buf[10];
+
+  // within the buffered blocks
+  ASSERT_EQ(10, m_buffer->Read(buf, sizeof(buf)));
+  EXPECT_EQ(5, m_buffer->Seek(5, SEEK_SET));
+  ASSERT_EQ(10, m_buffer->Read(buf, sizeof(buf)));
+  EXPECT_EQ(std::vector<uint8_t>(m_content.begin() + 5, m_content.begin() + 15),
+            std::vector<uint8_t>(buf, buf + sizeof(buf)));
+
+  // far ahead and relative to the current position
+  const int64_t target = static_cast<int64_t>(m_content.size()) - 500;
+  EXPECT_EQ(target, m_buffer->Seek(target - 15, SEEK_CUR));
+  ASSERT_EQ(10, m_buffer->Read(buf, sizeof(buf)));
+  EXPECT_EQ(std::vector<uint8_t>(m_content.begin() + target, m_content.begin() + target + 10),
+            std::vector<uint8_t>(buf, buf + sizeof(buf)));
+
+  // back to the start after eof
+  EXPECT_EQ(static_cast<int64_t>(m_content.size()) - 10, m_buffer->Seek(-10, SEEK_END));
+  ASSERT_EQ(10, m_buffer->Read(buf, sizeof(buf)));
+  EXPECT_EQ(0, m_buffer->Read(buf, sizeof(buf)));
+  EXPECT_EQ(0, m_buffer->Seek(0, SEEK_SET));
+  EXPECT_EQ(m_content, ReadAll());
+
+  EXPECT_EQ(-1, m_buffer->Seek(-1, SEEK_SET));
+}
+
+TEST_F(TestReadAheadBuffer, StopRestoresPosition)
+{
+  ASSERT_TRUE(m_input->Seek(200, SEEK_SET) == 200);
+  ASSERT_TRUE(m_buffer->Start());
+
+  uint8_t buf[50];
+  ASSERT_EQ(50, m_buffer->Read(buf, sizeof(buf)));
+  m_buffer->Stop();
+
+  // the input stream continues where the reader stopped
+  EXPECT_EQ(250, m_input->Seek(0, SEEK_CUR));
+  ASSERT_EQ(50, m_input->Read(buf, sizeof(buf)));
+  EXPECT_EQ(std::vector<uint8_t>(m_content.begin() + 250, m_content.begin() + 300),
+            std::vector<uint8_t>(buf, buf + sizeof(buf)));
+}
+
+TEST_F(TestReadAheadBuffer, ReportsLengthAndEof)
+{
+  ASSERT_TRUE(m_buffer->Start());
+  EXPECT_EQ(static_cast<int64_t>(m_content.size()), m_buffer->GetLength());
+  EXPECT_FALSE(m_buffer->IsEOF());
+
+  EXPECT_EQ(static_cast<int64_t>(m_content.size()) - 10, m_buffer->Seek(-10, SEEK_END));
+  uint8_t buf[10];
+  ASSERT_EQ(10, m_buffer->Read(buf, sizeof(buf)));
+  EXPECT_EQ(0, m_buffer->Read(buf, sizeof(buf)));
+  EXPECT_TRUE(m_buffer->IsEOF());
+
+  EXPECT_EQ(0, m_buffer->Seek(0, SEEK_SET));
+  EXPECT_FALSE(m_buffer->IsEOF());
+}
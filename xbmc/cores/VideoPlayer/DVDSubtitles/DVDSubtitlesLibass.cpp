@@ -113,6 +113,7 @@ bool CDVDSubtitlesLibass::DecodeHeader(char* data, int size)
   }
 
   ass_process_codec_private(m_track, data, size);
+  m_generation++;
   return true;
 }
 
@@ -127,6 +128,7 @@ bool CDVDSubtitlesLibass::DecodeDemuxPkt(const char* data, int size, double star
 
   //! @bug libass isn't const correct
   ass_process_chunk(m_track, const_cast<char*>(data), size, DVD_TIME_TO_MSEC(start), DVD_TIME_TO_MSEC(duration));
+  m_generation++;
   return true;
 }
 
@@ -145,6 +147,7 @@ bool CDVDSubtitlesLibass::CreateTrack(char* buf, size_t size)
   if(m_track == NULL)
     return false;
 
+  m_generation++;
   return true;
 }
 
@@ -11,6 +11,8 @@
 #include "DVDResource.h"
 #include "threads/CriticalSection.h"
 
+#include <atomic>
+
 #include <ass/ass.h>
 
 /** Wrapper for Libass **/
@@ -31,10 +33,17 @@ public:
   bool DecodeDemuxPkt(const char* data, int size, double start, double duration);
   bool CreateTrack(char* buf, size_t size);
 
+  /*!
+   \brief Counts the changes to the events of the track, images rendered
+   with an older generation may lack events that were added since.
+   */
+  unsigned int GetGeneration() const { return m_generation; }
+
 private:
   ASS_Library* m_library = nullptr;
   ASS_Track* m_track = nullptr;
   ASS_Renderer* m_renderer = nullptr;
   CCriticalSection m_section;
+  std::atomic<unsigned int> m_generation{0};
 };
 
@@ -0,0 +1,221 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DropPredictor.h"
+
+#include "DVDCodecs/Video/DVDVideoCodec.h"
+
+#include <algorithm>
+
+namespace
+{
+// weight of a picture in the cost of its type
+constexpr double COST_WEIGHT = 1.0 / 4.0;
+// weight of a picture in the mix of types, about two gops count
+constexpr double SHARE_WEIGHT = 1.0 / 32.0;
+}
+
+constexpr int CDropPredictor::HORIZON;
+constexpr int CDropPredictor::MIN_PICTURES;
+constexpr double CDropPredictor::MAX_GOP_TIME;
+constexpr size_t CDropPredictor::LOG_SIZE;
+
+CDropPredictor::CDropPredictor()
+{
+  Reset();
+}
+
+void CDropPredictor::Reset()
+{
+  for (int i = 0; i < TYPE_COUNT; i++)
+  {
+    m_cost[i] = 0.0;
+    m_share[i] = 0.0;
+    m_hasCost[i] = false;
+  }
+  m_pictures = 0;
+  m_gopTime = 0.0;
+  m_log.clear();
+  m_next = 0;
+  Flush();
+}
+
+void CDropPredictor::Flush()
+{
+  m_keyPts = DVD_NOPTS_VALUE;
+  m_decision = DECODE;
+  m_bRatio = 0.0;
+  m_skipTime = 0.0;
+}
+
+CDropPredictor::Type CDropPredictor::ToType(int frameType)
+{
+  if (frameType == FRAME_TYPE_I)
+    return TYPE_I;
+  else if (frameType == FRAME_TYPE_B)
+    return TYPE_B;
+  // unknown types are taken for reference frames, those are the ones that must not be late
+  return TYPE_P;
+}
+
+void CDropPredictor::AddPicture(double pts, int frameType, double cost, bool dropped)
+{
+  const Type type = ToType(frameType);
+
+  if (type == TYPE_I)
+  {
+    if (pts != DVD_NOPTS_VALUE)
+    {
+      if (m_keyPts != DVD_NOPTS_VALUE && pts > m_keyPts)
+        m_gopTime = pts - m_keyPts;
+      m_keyPts = pts;
+    }
+
+    // decoding picks up again
+    if (m_decision == SKIP_GOP)
+      m_decision = DECODE;
+  }
+
+  if (dropped)
+    return;
+
+  if (m_hasCost[type])
+    m_cost[type] += (cost - m_cost[type]) * COST_WEIGHT;
+  else
+    m_cost[type] = cost;
+  m_hasCost[type] = true;
+
+  if (m_decision != DECODE)
+  {
+    // b frames aren't decoded to learn from while they are skipped, they are assumed to get as
+    // much cheaper or dearer as the reference frames of the same scene do
+    if (type != TYPE_B && m_bRatio > 0.0)
+      m_cost[TYPE_B] = m_bRatio * GetRefCost();
+
+    // pictures the decoder skips don't come out, that would distort the mix
+    return;
+  }
+
+  for (int i = 0; i < TYPE_COUNT; i++)
+    m_share[i] += ((i == type ? 1.0 : 0.0) - m_share[i]) * SHARE_WEIGHT;
+
+  m_pictures++;
+}
+
+double CDropPredictor::GetCost(int frameType) const
+{
+  const Type type = ToType(frameType);
+  if (m_hasCost[type])
+    return m_cost[type];
+
+  // types not seen yet cost what the most expensive type seen does
+  return *std::max_element(m_cost, m_cost + TYPE_COUNT);
+}
+
+double CDropPredictor::GetRefCost() const
+{
+  const double shares = m_share[TYPE_I] + m_share[TYPE_P];
+  if (shares <= 0.0)
+    return GetCost(FRAME_TYPE_P);
+  return (m_share[TYPE_I] * GetCost(FRAME_TYPE_I) + m_share[TYPE_P] * GetCost(FRAME_TYPE_P)) /
+         shares;
+}
+
+CDropPredictor::Decision CDropPredictor::Predict(double pts, double lead)
+{
+  if (m_decision == SKIP_GOP)
+  {
+    // the key frame should have come by now, don't wait for it forever
+    m_skipTime += m_frameTime;
+    if (m_skipTime <= m_gopTime)
+      return m_decision;
+    m_decision = DECODE;
+  }
+
+  const Decision last = m_decision;
+  if (m_pictures < MIN_PICTURES || m_frameTime <= 0.0 || lead == DVD_NOPTS_VALUE)
+  {
+    m_decision = DECODE;
+    return m_decision;
+  }
+
+  double shares = 0.0;
+  for (int i = 0; i < TYPE_COUNT; i++)
+    shares += m_share[i];
+
+  const double costI = GetCost(FRAME_TYPE_I);
+  const double costP = GetCost(FRAME_TYPE_P);
+  const double costB = GetCost(FRAME_TYPE_B);
+
+  Record record;
+  record.pts = pts;
+  record.lead = lead;
+  record.refCost = (m_share[TYPE_I] * costI + m_share[TYPE_P] * costP) / shares;
+  record.cost = record.refCost + m_share[TYPE_B] * costB / shares;
+
+  // a reference frame has to be decoded and rendered before it is due
+  const double margin = m_renderTime + std::max(costI, costP);
+  const double projected = lead + HORIZON * (m_frameTime - record.cost);
+  const double projectedRef = lead + HORIZON * (m_frameTime - record.refCost);
+
+  if (projectedRef < margin && m_gopTime > 0.0 && m_gopTime <= MAX_GOP_TIME)
+    m_decision = SKIP_GOP;
+  else if (projected < margin)
+    m_decision = SKIP_NONREF;
+  // keep skipping until there is a frame to spare
+  else if (m_decision == SKIP_NONREF && projected < margin + m_frameTime)
+    m_decision = SKIP_NONREF;
+  else
+    m_decision = DECODE;
+
+  if (last == DECODE && m_decision != DECODE)
+  {
+    const double refCost = GetRefCost();
+    m_bRatio = refCost > 0.0 ? costB / refCost : 0.0;
+  }
+  if (m_decision == SKIP_GOP)
+    m_skipTime = 0.0;
+
+  record.decision = m_decision;
+  if (m_decision != DECODE || last != DECODE)
+    Log(record);
+
+  return m_decision;
+}
+
+void CDropPredictor::Log(const Record& record)
+{
+  if (m_log.size() < LOG_SIZE)
+  {
+    m_log.push_back(record);
+    return;
+  }
+
+  m_log[m_next] = record;
+  m_next = (m_next + 1) % LOG_SIZE;
+}
+
+std::vector<CDropPredictor::Record> CDropPredictor::GetLog() const
+{
+  std::vector<Record> log(m_log.begin() + m_next, m_log.end());
+  log.insert(log.end(), m_log.begin(), m_log.begin() + m_next);
+  return log;
+}
+
+const char* CDropPredictor::GetDecisionName(Decision decision)
+{
+  switch (decision)
+  {
+    case SKIP_NONREF:
+      return "skip nonref";
+    case SKIP_GOP:
+      return "skip gop";
+    default:
+      return "decode";
+  }
+}
@@ -0,0 +1,126 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "cores/VideoPlayer/Interface/TimingConstants.h"
+
+#include <stddef.h>
+#include <vector>
+
+/*!
+ * \brief Decides ahead of decoding which frames to drop.
+ *
+ * Learns what a picture of each type costs the video thread to decode and how the types mix,
+ * and projects from the time queued ahead of the display whether decoding everything keeps
+ * reference frames in time. If it doesn't, non reference frames are skipped before any
+ * reference frame is late. If not even the reference frames can be decoded in time, the rest
+ * of the gop is dropped and decoding picks up at the next key frame, one long gap instead of
+ * stuttering through the gop.
+ *
+ * Times are in DVD_TIME_BASE units, frame types are FRAME_TYPE_*.
+ */
+class CDropPredictor
+{
+public:
+  enum Decision
+  {
+    DECODE = 0,
+    SKIP_NONREF, //!< skip non reference frames
+    SKIP_GOP //!< skip everything up to the next key frame
+  };
+
+  struct Record
+  {
+    double pts;
+    double lead; //!< time queued ahead of the display
+    double cost; //!< projected decode time per frame when decoding everything
+    double refCost; //!< projected decode time per frame when skipping non reference frames
+    Decision decision;
+  };
+
+  /*! \brief Frames to look ahead */
+  static constexpr int HORIZON = 8;
+  /*! \brief Pictures to learn from before predicting anything */
+  static constexpr int MIN_PICTURES = 16;
+  /*! \brief Longest gop to drop the tail of, longer ones only get their non reference frames skipped */
+  static constexpr double MAX_GOP_TIME = DVD_SEC_TO_TIME(2.0);
+  /*! \brief Decisions kept in the log */
+  static constexpr size_t LOG_SIZE = 256;
+
+  CDropPredictor();
+
+  /*!
+   * \brief Start over, e.g. for a new stream
+   */
+  void Reset();
+
+  /*!
+   * \brief Keep what was learnt about the stream but stop dropping, e.g. after a seek
+   */
+  void Flush();
+
+  void SetFrameTime(double frameTime) { m_frameTime = frameTime; }
+
+  /*!
+   * \brief Time the renderer takes for a frame, it has to be decoded that much earlier
+   */
+  void SetRenderTime(double renderTime) { m_renderTime = renderTime; }
+
+  /*!
+   * \brief Account for a picture the decoder returned
+   * \param cost time spent in the decoder since the previous picture
+   * \param dropped the decoder skipped the picture or parts of it, its cost doesn't count
+   */
+  void AddPicture(double pts, int frameType, double cost, bool dropped);
+
+  /*!
+   * \brief Decide for the next packet
+   * \param lead time queued ahead of the display, pts of the last picture queued for render
+   *             minus pts on display
+   */
+  Decision Predict(double pts, double lead);
+
+  Decision GetDecision() const { return m_decision; }
+  double GetCost(int frameType) const;
+
+  /*!
+   * \brief Decisions to drop in the order they were made, the oldest first
+   */
+  std::vector<Record> GetLog() const;
+
+  static const char* GetDecisionName(Decision decision);
+
+private:
+  enum Type
+  {
+    TYPE_I = 0,
+    TYPE_P,
+    TYPE_B,
+    TYPE_COUNT
+  };
+
+  static Type ToType(int frameType);
+  double GetRefCost() const; //!< mean cost of a reference frame
+  void Log(const Record& record);
+
+  double m_frameTime = 0.0;
+  double m_renderTime = 0.0;
+  double m_cost[TYPE_COUNT];
+  double m_share[TYPE_COUNT];
+  bool m_hasCost[TYPE_COUNT];
+  int m_pictures;
+  double m_keyPts; //!< pts of the last key frame
+  double m_gopTime; //!< distance of the last two key frames, 0 if unknown
+  Decision m_decision;
+  double m_bRatio; //!< cost of a b frame relative to a reference frame when skipping started
+  double m_skipTime; //!< stream time passed since the gop was dropped
+
+  std::vector<Record> m_log;
+  size_t m_next = 0; //!< slot to be written next once the log is full
+};
@@ -103,6 +103,11 @@ class IDVDStreamPlayerAudio : public IDVDStreamPlayer
 public:
   explicit IDVDStreamPlayerAudio(CProcessInfo &processInfo) : IDVDStreamPlayer(processInfo) {};
   ~IDVDStreamPlayerAudio() override = default;
+  /*!
+   * \brief Start opening the codec for a stream that is likely to be opened next, OpenStream
+   * with the same hints picks it up
+   */
+  virtual void PrepareStream(const CDVDStreamInfo& hints) {}
   bool OpenStream(CDVDStreamInfo hints) override = 0;
   void CloseStream(bool bWaitForBuffers) override = 0;
   virtual void SetSpeed(int speed) = 0;
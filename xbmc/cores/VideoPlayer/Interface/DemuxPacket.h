@@ -19,6 +19,8 @@ extern "C"
 {
 #endif /* __cplusplus */
 
+  struct AVBufferRef;
+
   struct DemuxPacket : DEMUX_PACKET
   {
     DemuxPacket()
@@ -40,6 +42,12 @@ extern "C"
 
       cryptoInfo = nullptr;
     }
+
+    /*!
+     * ffmpeg buffer holding pData if the packet references the data of an AVPacket instead of
+     * owning a copy, nullptr otherwise. Released by CDVDDemuxUtils::FreeDemuxPacket.
+     */
+    AVBufferRef* pBuffer = nullptr;
   };
 
 #ifdef __cplusplus
@@ -36,6 +36,8 @@ public:
   void SetVideoDecoderName(const std::string &name, bool isHw);
   std::string GetVideoDecoderName();
   bool IsVideoHwDecoder();
+  void SetVideoDecoderPolicy(const std::string &policy);
+  std::string GetVideoDecoderPolicy();
   void SetVideoDeintMethod(const std::string &method);
   std::string GetVideoDeintMethod();
   void SetVideoPixelFormat(const std::string &pixFormat);
@@ -119,6 +121,7 @@ protected:
   // player video info
   bool m_videoIsHWDecoder;
   std::string m_videoDecoderName;
+  std::string m_videoDecoderPolicy;
   std::string m_videoDeintMethod;
   std::string m_videoPixelFormat;
   std::string m_videoStereoMode;
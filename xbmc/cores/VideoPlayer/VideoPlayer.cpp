@@ -883,6 +883,17 @@ void CVideoPlayer::OpenDefaultStreams(bool reset)
 
   bool valid;
 
+  std::vector<SelectionStream> audioStreams;
+  if (!m_playerOptions.videoOnly)
+  {
+    PredicateAudioFilter af(m_processInfo->GetVideoSettings().m_AudioStream, m_playerOptions.preferStereo);
+    audioStreams = m_SelectionStreams.Get(STREAM_AUDIO, af);
+  }
+
+  // the audio codec opens while the video codec does
+  if (!audioStreams.empty())
+    PrepareAudioStream(audioStreams.front());
+
   // open video stream
   valid   = false;
 
@@ -903,16 +914,12 @@ void CVideoPlayer::OpenDefaultStreams(bool reset)
 
   // open audio stream
   valid = false;
-  if (!m_playerOptions.videoOnly)
+  for (const auto &stream : audioStreams)
   {
-    PredicateAudioFilter af(m_processInfo->GetVideoSettings().m_AudioStream, m_playerOptions.preferStereo);
-    for (const auto &stream : m_SelectionStreams.Get(STREAM_AUDIO, af))
+    if(OpenStream(m_CurrentAudio, stream.demuxerId, stream.id, stream.source, reset))
     {
-      if(OpenStream(m_CurrentAudio, stream.demuxerId, stream.id, stream.source, reset))
-      {
-        valid = true;
-        break;
-      }
+      valid = true;
+      break;
     }
   }
 
@@ -1186,6 +1193,10 @@ void CVideoPlayer::CheckBetterStream(CCurrentStream& current, CDemuxStream* stre
 
 void CVideoPlayer::Prepare()
 {
+  m_startup = {};
+  m_startup.start = XbmcThreads::SystemClockMillis();
+  m_startup.pending = true;
+
   CFFmpegLog::SetLogLevel(1);
   SetPlaySpeed(DVD_PLAYSPEED_NORMAL);
   m_processInfo->SetSpeed(1.0);
@@ -1234,12 +1245,18 @@ void CVideoPlayer::Prepare()
     m_error = true;
     return;
   }
+
+  const unsigned int demuxOpened = XbmcThreads::SystemClockMillis();
+  m_startup.demux = demuxOpened - m_startup.start;
+
   // give players a chance to reconsider now codecs are known
   CreatePlayers();
 
   if (!discStateRestored)
     OpenDefaultStreams();
 
+  m_startup.codecs = XbmcThreads::SystemClockMillis() - demuxOpened;
+
   /*
    * Check to see if the demuxer should start at something other than time 0. This will be the case
    * if there was a start time specified as part of the "Start from where last stopped" (aka
@@ -1993,6 +2010,16 @@ void CVideoPlayer::HandlePlaySpeed()
 
       m_syncTimer.Set(3000);
 
+      // first sync after opening a file, also when switching channels while playing
+      if (m_startup.pending)
+      {
+        const unsigned int firstFrame = XbmcThreads::SystemClockMillis() - m_startup.start;
+        CLog::Log(LOGDEBUG, "CVideoPlayer::Sync - started after %u ms, demuxer %u ms, codecs %u ms",
+                  firstFrame, m_startup.demux, m_startup.codecs);
+        CServiceBroker::GetDataCacheCore().SetStartupTimes(m_startup.demux, m_startup.codecs, firstFrame);
+        m_startup.pending = false;
+      }
+
       if (!m_State.streamsReady)
       {
         if (m_playerOptions.fullscreen)
@@ -2407,6 +2434,7 @@ void CVideoPlayer::OnExit()
 
   CFileItem fileItem(m_item);
   UpdateFileItemStreamDetails(fileItem);
+  UpdateFileItemKeyframeIndex(fileItem);
 
   CloseStream(m_CurrentAudio, !m_bAbortRequest);
   CloseStream(m_CurrentVideo, !m_bAbortRequest);
@@ -2479,10 +2507,12 @@ void CVideoPlayer::HandleMessages()
         m_messenger.GetPacketCount(CDVDMsg::PLAYER_OPENFILE) == 0)
     {
       CDVDMsgOpenFile &msg(*static_cast<CDVDMsgOpenFile*>(pMsg));
+      const unsigned int switchStart = XbmcThreads::SystemClockMillis();
 
       IPlayerCallback *cb = &m_callback;
       CFileItem fileItem(m_item);
       UpdateFileItemStreamDetails(fileItem);
+      UpdateFileItemKeyframeIndex(fileItem);
       CVideoSettings vs = m_processInfo->GetVideoSettings();
       m_outboundEvents->Submit([=]() {
         cb->StoreVideoSettings(fileItem, vs);
@@ -2524,6 +2554,9 @@ void CVideoPlayer::HandleMessages()
       m_SelectionStreams.Clear(STREAM_NONE, STREAM_SOURCE_NONE);
 
       Prepare();
+
+      // time to first frame includes closing the previous file
+      m_startup.start = switchStart;
     }
     else if (pMsg->IsType(CDVDMsg::PLAYER_SEEK) &&
         m_messenger.GetPacketCount(CDVDMsg::PLAYER_SEEK) == 0 &&
@@ -3521,6 +3554,29 @@ bool CVideoPlayer::OpenStream(CCurrentStream& current, int64_t demuxerId, int iS
   return res;
 }
 
+void CVideoPlayer::PrepareAudioStream(const SelectionStream& stream)
+{
+  if (STREAM_SOURCE_MASK(stream.source) != STREAM_SOURCE_DEMUX || !m_pDemuxer)
+    return;
+
+  CDemuxStream* demuxStream = m_pDemuxer->GetStream(stream.demuxerId, stream.id);
+  if (!demuxStream || demuxStream->disabled)
+    return;
+
+  // the same hints OpenStream comes up with, else the prepared codec isn't used
+  CDVDStreamInfo hint;
+  hint.Assign(*demuxStream, true);
+  if (m_pInputStream && m_pInputStream->IsStreamType(DVDSTREAM_TYPE_DVD))
+    hint.filename = "dvd";
+
+  if (m_CurrentAudio.id >= 0 && m_CurrentAudio.hint == hint)
+    return;
+
+  IDVDStreamPlayer* player = GetStreamPlayer(m_CurrentAudio.player);
+  if (player)
+    static_cast<IDVDStreamPlayerAudio*>(player)->PrepareStream(hint);
+}
+
 bool CVideoPlayer::OpenAudioStream(CDVDStreamInfo& hint, bool reset)
 {
   IDVDStreamPlayer* player = GetStreamPlayer(m_CurrentAudio.player);
@@ -4916,6 +4972,17 @@ void CVideoPlayer::OnResetDisplay()
   m_displayLost = false;
 }
 
+void CVideoPlayer::UpdateFileItemKeyframeIndex(CFileItem& item)
+{
+  if (!m_pDemuxer)
+    return;
+
+  // stored with the file state, see CSaveFileState
+  std::string keyframes = m_pDemuxer->GetKeyframeIndex();
+  if (!keyframes.empty())
+    item.SetProperty("keyframeindex", keyframes);
+}
+
 void CVideoPlayer::UpdateFileItemStreamDetails(CFileItem& item)
 {
   if (!m_UpdateStreamDetails)
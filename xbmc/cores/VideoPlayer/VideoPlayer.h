@@ -361,6 +361,7 @@ protected:
 
   void Prepare();
   bool OpenStream(CCurrentStream& current, int64_t demuxerId, int iStream, int source, bool reset = true);
+  void PrepareAudioStream(const SelectionStream& stream);
   bool OpenAudioStream(CDVDStreamInfo& hint, bool reset = true);
   bool OpenVideoStream(CDVDStreamInfo& hint, bool reset = true);
   bool OpenSubtitleStream(CDVDStreamInfo& hint);
@@ -439,6 +440,7 @@ protected:
   void UpdateContentState();
 
   void UpdateFileItemStreamDetails(CFileItem& item);
+  void UpdateFileItemKeyframeIndex(CFileItem& item);
 
   bool m_players_created;
 
@@ -532,6 +534,14 @@ protected:
   mutable CCriticalSection m_StateSection;
   XbmcThreads::EndTime m_syncTimer;
 
+  struct SStartupTimes
+  {
+    unsigned int start; // when opening started
+    unsigned int demux; // ms to open the input stream and demuxer
+    unsigned int codecs; // ms to open the codecs
+    bool pending; // the first frame of the file is not shown yet
+  } m_startup = {};
+
   CEdl m_Edl;
   bool m_SkipCommercials;
 
@@ -45,6 +45,46 @@ public:
   CDVDStreamInfo  m_hints;
 };
 
+/*!
+ * \brief Opens the audio codec for a stream on a thread of its own, while the player opens the
+ * video codec
+ */
+class CVideoPlayerAudio::CCodecOpener : public CThread
+{
+public:
+  CCodecOpener(CVideoPlayerAudio& player, const CDVDStreamInfo& hints)
+    : CThread("AudioCodecOpener"), m_player(player), m_hints(hints)
+  {
+    Create();
+  }
+  ~CCodecOpener() override
+  {
+    StopThread();
+    delete m_codec;
+  }
+
+  const CDVDStreamInfo& GetHints() const { return m_hints; }
+
+  /*!
+   * \brief Wait for the codec to be opened, the caller takes ownership
+   */
+  CDVDAudioCodec* Take()
+  {
+    StopThread();
+    CDVDAudioCodec* codec = m_codec;
+    m_codec = nullptr;
+    return codec;
+  }
+
+protected:
+  void Process() override { m_codec = m_player.CreateCodec(m_hints); }
+
+private:
+  CVideoPlayerAudio& m_player;
+  const CDVDStreamInfo m_hints;
+  CDVDAudioCodec* m_codec = nullptr;
+};
+
 
 CVideoPlayerAudio::CVideoPlayerAudio(CDVDClock* pClock, CDVDMessageQueue& parent, CProcessInfo &processInfo)
 : CThread("VideoPlayerAudio"), IDVDStreamPlayerAudio(processInfo)
@@ -70,24 +110,42 @@ CVideoPlayerAudio::CVideoPlayerAudio(CDVDClock* pClock, CDVDMessageQueue& parent
 
 CVideoPlayerAudio::~CVideoPlayerAudio()
 {
+  m_codecOpener.reset();
   StopThread();
 
   // close the stream, and don't wait for the audio to be finished
   // CloseStream(true);
 }
 
-bool CVideoPlayerAudio::OpenStream(CDVDStreamInfo hints)
+void CVideoPlayerAudio::PrepareStream(const CDVDStreamInfo& hints)
+{
+  m_codecOpener.reset(new CCodecOpener(*this, hints));
+}
+
+CDVDAudioCodec* CVideoPlayerAudio::CreateCodec(const CDVDStreamInfo& hints)
 {
-  CLog::Log(LOGINFO, "Finding audio codec for: %i", hints.codec);
   bool allowpassthrough = !CServiceBroker::GetSettingsComponent()->GetSettings()->GetBool(CSettings::SETTING_VIDEOPLAYER_USEDISPLAYASCLOCK);
   if (m_processInfo.IsRealtimeStream())
     allowpassthrough = false;
 
   CAEStreamInfo::DataType streamType =
       m_audioSink.GetPassthroughStreamType(hints.codec, hints.samplerate, hints.profile);
-  CDVDAudioCodec* codec = CDVDFactoryCodec::CreateAudioCodec(hints, m_processInfo,
-                                                             allowpassthrough, m_processInfo.AllowDTSHDDecode(),
-                                                             streamType);
+  return CDVDFactoryCodec::CreateAudioCodec(hints, m_processInfo,
+                                            allowpassthrough, m_processInfo.AllowDTSHDDecode(),
+                                            streamType);
+}
+
+bool CVideoPlayerAudio::OpenStream(CDVDStreamInfo hints)
+{
+  CLog::Log(LOGINFO, "Finding audio codec for: %i", hints.codec);
+
+  CDVDAudioCodec* codec;
+  if (m_codecOpener && hints == m_codecOpener->GetHints())
+    codec = m_codecOpener->Take();
+  else
+    codec = CreateCodec(hints);
+  m_codecOpener.reset();
+
   if(!codec)
   {
     CLog::Log(LOGERROR, "Unsupported audio codec");
@@ -156,6 +214,8 @@ void CVideoPlayerAudio::CloseStream(bool bWaitForBuffers)
   if (bWait)
     m_messageQueue.WaitUntilEmpty();
 
+  m_codecOpener.reset();
+
   // send abort message to the audio queue
   m_messageQueue.Abort();
 
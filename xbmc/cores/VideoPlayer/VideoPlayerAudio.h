@@ -18,6 +18,7 @@
 #include "utils/BitstreamStats.h"
 
 #include <list>
+#include <memory>
 #include <utility>
 
 
@@ -31,6 +32,7 @@ public:
   CVideoPlayerAudio(CDVDClock* pClock, CDVDMessageQueue& parent, CProcessInfo &processInfo);
   ~CVideoPlayerAudio() override;
 
+  void PrepareStream(const CDVDStreamInfo& hints) override;
   bool OpenStream(CDVDStreamInfo hints) override;
   void CloseStream(bool bWaitForBuffers) override;
 
@@ -65,6 +67,7 @@ protected:
   bool ProcessDecoderOutput(DVDAudioFrame &audioframe);
   void UpdatePlayerInfo();
   void OpenStream(CDVDStreamInfo &hints, CDVDAudioCodec* codec);
+  CDVDAudioCodec* CreateCodec(const CDVDStreamInfo& hints);
   //! Switch codec if needed. Called when the sample rate gotten from the
   //! codec changes, in which case we may want to switch passthrough on/off.
   bool SwitchCodecIfNeeded();
@@ -104,5 +107,8 @@ protected:
 
   mutable CCriticalSection m_info_section;
   SInfo            m_info;
+
+  class CCodecOpener;
+  std::unique_ptr<CCodecOpener> m_codecOpener;
 };
 
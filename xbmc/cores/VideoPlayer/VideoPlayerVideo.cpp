@@ -17,6 +17,7 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
 #include "utils/MathUtils.h"
+#include "utils/TimeUtils.h"
 #include "utils/log.h"
 #include "windowing/GraphicContext.h"
 #include "windowing/WinSystem.h"
@@ -177,6 +178,9 @@ void CVideoPlayerVideo::OpenStream(CDVDStreamInfo &hint, CDVDVideoCodec* codec)
 
   m_iDroppedRequest = 0;
   m_iLateFrames = 0;
+  m_dropPredictor.Reset();
+  m_queuedPts = DVD_NOPTS_VALUE;
+  m_decodeTime = 0.0;
 
   if( m_fFrameRate > 120 || m_fFrameRate < 5 )
   {
@@ -433,6 +437,8 @@ void CVideoPlayerVideo::Process()
       }
       m_packets.clear();
       m_droppingStats.Reset();
+      m_dropPredictor.Flush();
+      m_queuedPts = DVD_NOPTS_VALUE;
       m_syncState = IDVDStreamPlayer::SYNC_STARTING;
       m_renderManager.ShowVideo(false);
       m_rewindStalled = false;
@@ -456,6 +462,8 @@ void CVideoPlayerVideo::Process()
       //! @todo this needs to be set on a streamchange instead
       ResetFrameRateCalc();
       m_droppingStats.Reset();
+      m_dropPredictor.Flush();
+      m_queuedPts = DVD_NOPTS_VALUE;
 
       m_stalled = true;
       if (sync)
@@ -556,11 +564,17 @@ void CVideoPlayerVideo::Process()
         codecControl |= DVD_CODEC_CTRL_DROP;
       if (bRequestDrop)
         codecControl |= DVD_CODEC_CTRL_DROP_ANY;
+      if (!bPacketDrop)
+        codecControl |= PredictDrop(pts, frametime);
       if (!m_renderManager.Supports(RENDERFEATURE_ROTATION))
         codecControl |= DVD_CODEC_CTRL_ROTATE;
       m_pVideoCodec->SetCodecControl(codecControl);
 
-      if (m_pVideoCodec->AddData(*pPacket))
+      int64_t start = CurrentHostCounter();
+      bool added = m_pVideoCodec->AddData(*pPacket);
+      m_decodeTime += static_cast<double>(CurrentHostCounter() - start) * DVD_TIME_BASE / CurrentHostFrequency();
+
+      if (added)
       {
         // buffer packets so we can recover should decoder flush for some reason
         if (m_pVideoCodec->GetConvergeCount() > 0)
@@ -592,7 +606,9 @@ void CVideoPlayerVideo::Process()
 
 bool CVideoPlayerVideo::ProcessDecoderOutput(double &frametime, double &pts)
 {
+  int64_t start = CurrentHostCounter();
   CDVDVideoCodec::VCReturn decoderState = m_pVideoCodec->GetPicture(&m_picture);
+  m_decodeTime += static_cast<double>(CurrentHostCounter() - start) * DVD_TIME_BASE / CurrentHostFrequency();
 
   if (decoderState == CDVDVideoCodec::VC_BUFFER)
   {
@@ -659,6 +675,11 @@ bool CVideoPlayerVideo::ProcessDecoderOutput(double &frametime, double &pts)
   {
     bool hasTimestamp = true;
 
+    m_dropPredictor.AddPicture(m_picture.pts,
+                               m_picture.pict_type ? m_picture.pict_type : m_picture.iFrameType,
+                               m_decodeTime, (m_picture.iFlags & DVP_FLAG_DROPPED) != 0);
+    m_decodeTime = 0.0;
+
     m_picture.iDuration = frametime;
 
     // validate picture timing,
@@ -742,6 +763,8 @@ bool CVideoPlayerVideo::ProcessDecoderOutput(double &frametime, double &pts)
       m_iDroppedFrames++;
       m_ptsTracker.Flush();
     }
+    else if (m_outputSate == OUTPUT_NORMAL)
+      m_queuedPts = m_picture.pts;
 
     if (m_syncState == IDVDStreamPlayer::SYNC_STARTING &&
         m_outputSate != OUTPUT_DROPPED &&
@@ -764,6 +787,16 @@ bool CVideoPlayerVideo::ProcessDecoderOutput(double &frametime, double &pts)
 
 void CVideoPlayerVideo::OnExit()
 {
+  if (CServiceBroker::GetLogging().CanLogComponent(LOGAVTIMING))
+  {
+    for (const CDropPredictor::Record& record : m_dropPredictor.GetLog())
+    {
+      CLog::Log(LOGDEBUG, "CVideoPlayerVideo - drop prediction pts: %f lead: %f cost: %f ref cost: %f -> %s",
+                record.pts, record.lead, record.cost, record.refCost,
+                CDropPredictor::GetDecisionName(record.decision));
+    }
+  }
+
   CLog::Log(LOGINFO, "thread end: video_thread");
 }
 
@@ -1062,6 +1095,41 @@ void CVideoPlayerVideo::CalcFrameRate()
   }
 }
 
+int CVideoPlayerVideo::PredictDrop(double pts, double frametime)
+{
+  // only normal playback has deadlines to keep
+  if (!m_bAllowDrop || m_speed != DVD_PLAYSPEED_NORMAL ||
+      m_syncState != IDVDStreamPlayer::SYNC_INSYNC)
+    return 0;
+
+  int lateframes, queued, discard;
+  double renderPts;
+  m_renderManager.GetStats(lateframes, renderPts, queued, discard);
+
+  double lead = DVD_NOPTS_VALUE;
+  if (m_queuedPts != DVD_NOPTS_VALUE && renderPts != DVD_NOPTS_VALUE)
+    lead = m_queuedPts - renderPts;
+
+  m_dropPredictor.SetFrameTime(frametime);
+  m_dropPredictor.SetRenderTime(DVD_MSEC_TO_TIME(m_renderManager.GetRenderTime()));
+
+  CDropPredictor::Decision last = m_dropPredictor.GetDecision();
+  CDropPredictor::Decision decision = m_dropPredictor.Predict(pts, lead);
+  if (decision != last)
+  {
+    CLog::Log(LOGDEBUG, LOGVIDEO, "CVideoPlayerVideo::PredictDrop - %s, lead: %.1f ms, I: %.1f ms, P: %.1f ms, B: %.1f ms",
+              CDropPredictor::GetDecisionName(decision), lead / 1000,
+              m_dropPredictor.GetCost(FRAME_TYPE_I) / 1000, m_dropPredictor.GetCost(FRAME_TYPE_P) / 1000,
+              m_dropPredictor.GetCost(FRAME_TYPE_B) / 1000);
+  }
+
+  if (decision == CDropPredictor::SKIP_NONREF)
+    return DVD_CODEC_CTRL_DROP_PREDICTED;
+  else if (decision == CDropPredictor::SKIP_GOP)
+    return DVD_CODEC_CTRL_DROP_GOP;
+  return 0;
+}
+
 int CVideoPlayerVideo::CalcDropRequirement(double pts)
 {
   int result = 0;
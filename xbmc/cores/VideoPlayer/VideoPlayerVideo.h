@@ -13,6 +13,7 @@
 #include "DVDMessageQueue.h"
 #include "DVDOverlayContainer.h"
 #include "DVDStreamInfo.h"
+#include "DropPredictor.h"
 #include "IVideoPlayer.h"
 #include "PTSTracker.h"
 #include "cores/VideoPlayer/VideoRenderers/RenderManager.h"
@@ -101,6 +102,7 @@ protected:
   void ResetFrameRateCalc();
   void CalcFrameRate();
   int CalcDropRequirement(double pts);
+  int PredictDrop(double pts, double frametime);
 
   double m_iSubtitleDelay;
 
@@ -135,6 +137,9 @@ protected:
   CPtsTracker m_ptsTracker;
   std::list<DVDMessageListItem> m_packets;
   CDroppingStats m_droppingStats;
+  CDropPredictor m_dropPredictor;
+  double m_queuedPts = DVD_NOPTS_VALUE; //!< pts of the last picture queued for render
+  double m_decodeTime = 0.0; //!< spent in the decoder since the last picture
   CRenderManager& m_renderManager;
   VideoPicture m_picture;
 
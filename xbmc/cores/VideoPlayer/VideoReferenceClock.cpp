@@ -275,3 +275,15 @@ bool CVideoReferenceClock::GetClockInfo(int& MissedVblanks, double& ClockSpeed,
   }
   return false;
 }
+
+//predicts the clock at the next vblank, returns false if vblank isn't used as clock source
+bool CVideoReferenceClock::GetNextVblankTime(int64_t& time)
+{
+  CSingleLock SingleLock(m_CritSection);
+
+  if (!m_UseVblank)
+    return false;
+
+  time = GetTime(false) + static_cast<int64_t>(UpdateInterval());
+  return true;
+}
@@ -27,6 +27,7 @@ class CVideoReferenceClock : CThread
     double  GetSpeed();
     double  GetRefreshRate(double* interval = nullptr);
     bool    GetClockInfo(int& MissedVblanks, double& ClockSpeed, double& RefreshRate) const;
+    bool    GetNextVblankTime(int64_t& time);
 
   private:
     void    Process() override;
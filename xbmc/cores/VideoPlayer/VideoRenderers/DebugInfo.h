@@ -24,6 +24,8 @@ struct DEBUG_INFO_VIDEO
   std::string metaPrim;
   std::string metaLight;
   std::string shader;
+  std::string upload;
+  std::string overlays;
 };
 
 struct DEBUG_INFO_RENDER
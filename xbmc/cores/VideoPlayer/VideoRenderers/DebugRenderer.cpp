@@ -17,7 +17,7 @@ using namespace OVERLAY;
 
 CDebugRenderer::CDebugRenderer()
 {
-  for (int i = 0; i < 6; i++)
+  for (int i = 0; i < 8; i++)
   {
     m_overlay[i] = nullptr;
     m_strDebug[i] = " ";
@@ -126,9 +126,31 @@ void CDebugRenderer::SetInfo(DEBUG_INFO_VIDEO& video, DEBUG_INFO_RENDER& render)
     m_overlay[5] = new CDVDOverlayText();
     m_overlay[5]->AddElement(new CDVDOverlayText::CElementText(m_strDebug[5]));
   }
+  if (video.upload != m_strDebug[6])
+  {
+    m_strDebug[6] = video.upload;
+    if (m_overlay[6])
+      m_overlay[6]->Release();
+    m_overlay[6] = new CDVDOverlayText();
+    m_overlay[6]->AddElement(new CDVDOverlayText::CElementText(m_strDebug[6]));
+  }
+  if (video.overlays != m_strDebug[7])
+  {
+    m_strDebug[7] = video.overlays;
+    if (m_overlay[7])
+      m_overlay[7]->Release();
+    m_overlay[7] = new CDVDOverlayText();
+    m_overlay[7]->AddElement(new CDVDOverlayText::CElementText(m_strDebug[7]));
+  }
 
   for (int i = 0; i < 6; i++)
     m_overlayRenderer.AddOverlay(m_overlay[i], 0, 0);
+  // not every renderer reports uploads
+  for (int i = 6; i < 8; i++)
+  {
+    if (!m_strDebug[i].empty())
+      m_overlayRenderer.AddOverlay(m_overlay[i], 0, 0);
+  }
 }
 
 void CDebugRenderer::Render(CRect& src, CRect& dst, CRect& view)
@@ -34,7 +34,7 @@ protected:
     void Render(int idx) override;
   };
 
-  std::string m_strDebug[6];
-  CDVDOverlayText* m_overlay[6];
+  std::string m_strDebug[8];
+  CDVDOverlayText* m_overlay[8];
   CRenderer m_overlayRenderer;
 };
@@ -0,0 +1,70 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FrameTimingTrace.h"
+
+#include "filesystem/File.h"
+#include "utils/StringUtils.h"
+#include "utils/log.h"
+
+constexpr size_t CFrameTimingTrace::CAPACITY;
+
+void CFrameTimingTrace::Clear()
+{
+  m_frames.clear();
+  m_next = 0;
+}
+
+void CFrameTimingTrace::Add(const Frame& frame)
+{
+  if (m_frames.size() < CAPACITY)
+  {
+    m_frames.push_back(frame);
+    return;
+  }
+
+  m_frames[m_next] = frame;
+  m_next = (m_next + 1) % CAPACITY;
+}
+
+std::vector<CFrameTimingTrace::Frame> CFrameTimingTrace::GetFrames() const
+{
+  std::vector<Frame> frames(m_frames.begin() + m_next, m_frames.end());
+  frames.insert(frames.end(), m_frames.begin(), m_frames.begin() + m_next);
+  return frames;
+}
+
+bool CFrameTimingTrace::Export(const std::string& path) const
+{
+  XFILE::CFile file;
+  if (!file.OpenForWrite(path, true))
+  {
+    CLog::Log(LOGERROR, "CFrameTimingTrace::%s - unable to write %s", __FUNCTION__, path.c_str());
+    return false;
+  }
+
+  std::string csv = "pts,queued,presented,rendered,render_ms,skipped\n";
+  for (const Frame& frame : GetFrames())
+  {
+    csv += StringUtils::Format("%.0f,%lld,%lld,%lld,%.3f,%d\n", frame.pts,
+                               static_cast<long long>(frame.queued),
+                               static_cast<long long>(frame.presented),
+                               static_cast<long long>(frame.rendered), frame.renderTime,
+                               frame.skipped ? 1 : 0);
+  }
+
+  if (file.Write(csv.data(), csv.size()) != static_cast<ssize_t>(csv.size()))
+  {
+    CLog::Log(LOGERROR, "CFrameTimingTrace::%s - unable to write %s", __FUNCTION__, path.c_str());
+    return false;
+  }
+
+  CLog::Log(LOGINFO, "CFrameTimingTrace::%s - wrote %zu frames to %s", __FUNCTION__,
+            m_frames.size(), path.c_str());
+  return true;
+}
@@ -0,0 +1,55 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*!
+ * \brief Records when the frames of a playback went through the render queue.
+ *
+ * Keeps the most recent frames and exports them as csv, one line per frame, for analysing
+ * frame drops offline.
+ */
+class CFrameTimingTrace
+{
+public:
+  /*!
+   * \brief Timing of a frame, times are in ms of the system clock, 0 if not reached
+   */
+  struct Frame
+  {
+    double pts = 0.0; //!< in DVD_TIME_BASE units
+    int64_t queued = 0; //!< the decoder handed the frame over
+    int64_t presented = 0; //!< the frame was selected for display
+    int64_t rendered = 0; //!< the frame was rendered for the first time
+    float renderTime = 0.0f; //!< ms spent rendering the frame the first time, includes upload
+    bool skipped = false; //!< the frame was dropped for being late
+  };
+
+  static constexpr size_t CAPACITY = 4096;
+
+  void Clear();
+  void Add(const Frame& frame);
+
+  /*!
+   * \brief Frames in the order they were added, the oldest first
+   */
+  std::vector<Frame> GetFrames() const;
+
+  /*!
+   * \brief Write the frames to a csv file
+   */
+  bool Export(const std::string& path) const;
+
+private:
+  std::vector<Frame> m_frames;
+  size_t m_next = 0; //!< slot to be written next once the trace is full
+};
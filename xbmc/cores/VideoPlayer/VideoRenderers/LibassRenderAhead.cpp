@@ -0,0 +1,208 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "LibassRenderAhead.h"
+
+#include "cores/VideoPlayer/DVDSubtitles/DVDSubtitlesLibass.h"
+#include "threads/SingleLock.h"
+
+#include <algorithm>
+
+using namespace OVERLAY;
+
+constexpr size_t CLibassRenderAhead::MAX_FRAMES;
+
+bool SLibassGeometry::operator==(const SLibassGeometry& other) const
+{
+  return frameWidth == other.frameWidth && frameHeight == other.frameHeight &&
+         videoWidth == other.videoWidth && videoHeight == other.videoHeight &&
+         sourceWidth == other.sourceWidth && sourceHeight == other.sourceHeight &&
+         useMargin == other.useMargin && position == other.position;
+}
+
+CLibassRenderAhead::CLibassRenderAhead() : CThread("LibassRenderAhead")
+{
+}
+
+CLibassRenderAhead::~CLibassRenderAhead()
+{
+  StopThread();
+  Flush();
+}
+
+void CLibassRenderAhead::Release(std::deque<SEntry>& entries)
+{
+  for (SEntry& entry : entries)
+    entry.libass->Release();
+  entries.clear();
+}
+
+void CLibassRenderAhead::Flush()
+{
+  // the previous frame may be of a libass instance that goes away, a new one can get its address
+  CSingleLock renderLock(m_renderSection);
+  m_lastLibass = nullptr;
+  m_last = SLibassFrame();
+
+  CSingleLock lock(m_section);
+  Release(m_requests);
+  Release(m_frames);
+  m_flushes++;
+}
+
+void CLibassRenderAhead::Request(CDVDSubtitlesLibass* libass, double pts)
+{
+  CSingleLock lock(m_section);
+  if (!m_hasGeometry)
+    return;
+
+  auto isFrame = [libass, pts](const SEntry& entry) {
+    return entry.libass == libass && entry.frame.pts == pts;
+  };
+  if (std::any_of(m_requests.begin(), m_requests.end(), isFrame) ||
+      std::any_of(m_frames.begin(), m_frames.end(), isFrame))
+    return;
+
+  SEntry entry;
+  entry.libass = libass->Acquire();
+  entry.frame.pts = pts;
+  m_requests.push_back(entry);
+
+  // the render thread fell behind, don't render what it will skip anyway
+  while (m_requests.size() > MAX_FRAMES)
+  {
+    m_requests.front().libass->Release();
+    m_requests.pop_front();
+  }
+
+  if (!IsRunning())
+    Create();
+  m_requestEvent.Set();
+}
+
+SLibassFrame CLibassRenderAhead::Get(CDVDSubtitlesLibass* libass,
+                                     const SLibassGeometry& geometry,
+                                     double pts)
+{
+  {
+    CSingleLock lock(m_section);
+    m_geometry = geometry;
+    m_hasGeometry = true;
+
+    // frames before this one are not presented any more
+    for (auto it = m_frames.begin(); it != m_frames.end();)
+    {
+      if (it->frame.pts < pts)
+      {
+        it->libass->Release();
+        it = m_frames.erase(it);
+      }
+      else
+        ++it;
+    }
+
+    for (const SEntry& entry : m_frames)
+    {
+      if (entry.libass == libass && entry.frame.pts == pts && entry.frame.geometry == geometry &&
+          entry.frame.generation == libass->GetGeneration())
+        return entry.frame;
+    }
+  }
+
+  CSingleLock lock(m_renderSection);
+  return Render(libass, geometry, pts);
+}
+
+void CLibassRenderAhead::Process()
+{
+  while (!m_bStop)
+  {
+    SEntry entry;
+    SLibassGeometry geometry;
+    unsigned int flushes;
+    {
+      CSingleLock lock(m_section);
+      if (m_requests.empty())
+      {
+        CSingleExit exit(m_section);
+        AbortableWait(m_requestEvent);
+        continue;
+      }
+      entry = m_requests.front();
+      m_requests.pop_front();
+      geometry = m_geometry;
+      flushes = m_flushes;
+    }
+
+    {
+      CSingleLock lock(m_renderSection);
+      entry.frame = Render(entry.libass, geometry, entry.frame.pts);
+    }
+
+    CSingleLock lock(m_section);
+    if (flushes != m_flushes)
+    {
+      entry.libass->Release();
+      continue;
+    }
+
+    m_frames.push_back(entry);
+    while (m_frames.size() > MAX_FRAMES)
+    {
+      m_frames.front().libass->Release();
+      m_frames.pop_front();
+    }
+  }
+}
+
+SLibassFrame CLibassRenderAhead::Render(CDVDSubtitlesLibass* libass,
+                                        const SLibassGeometry& geometry,
+                                        double pts)
+{
+  SLibassFrame frame;
+  frame.pts = pts;
+  frame.geometry = geometry;
+  // taken before rendering, so events added meanwhile make the frame stale
+  frame.generation = libass->GetGeneration();
+
+  int changes = 2;
+  ASS_Image* images = libass->RenderImage(
+      geometry.frameWidth, geometry.frameHeight, geometry.videoWidth, geometry.videoHeight,
+      geometry.sourceWidth, geometry.sourceHeight, pts, geometry.useMargin, geometry.position,
+      &changes);
+
+  if (libass != m_lastLibass)
+    changes = 2;
+  m_lastLibass = libass;
+
+  // same bitmaps as the previous render, at most moved: keep its atlas
+  if (changes < 2)
+  {
+    frame.quads = m_last.quads;
+    if (update_quad_positions(images, frame.quads))
+    {
+      frame.atlas = m_last.atlas;
+      frame.atlasId = m_last.atlasId;
+      frame.layoutId = changes == 0 ? m_last.layoutId : m_nextId++;
+      m_last = frame;
+      return frame;
+    }
+  }
+
+  frame.quads.clear();
+  std::shared_ptr<SQuads> atlas = std::make_shared<SQuads>();
+  if (convert_quad(images, *atlas, geometry.frameWidth))
+  {
+    frame.atlas = atlas;
+    frame.quads.assign(atlas->quad, atlas->quad + atlas->count);
+  }
+  frame.atlasId = m_nextId++;
+  frame.layoutId = m_nextId++;
+  m_last = frame;
+  return frame;
+}
@@ -0,0 +1,120 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "OverlayRendererUtil.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+class CDVDSubtitlesLibass;
+
+namespace OVERLAY
+{
+
+/*!
+ * \brief Where libass renders the subtitles, see CDVDSubtitlesLibass::RenderImage
+ */
+struct SLibassGeometry
+{
+  int frameWidth = 0;
+  int frameHeight = 0;
+  int videoWidth = 0;
+  int videoHeight = 0;
+  int sourceWidth = 0;
+  int sourceHeight = 0;
+  int useMargin = 0;
+  double position = 0.0;
+
+  bool operator==(const SLibassGeometry& other) const;
+  bool operator!=(const SLibassGeometry& other) const { return !(*this == other); }
+};
+
+/*!
+ * \brief Subtitles of a video frame rendered by libass and packed into a glyph atlas
+ */
+struct SLibassFrame
+{
+  double pts = 0.0;
+  SLibassGeometry geometry;
+  unsigned int generation = 0; //!< generation of the track the frame was rendered from
+  unsigned int atlasId = 0; //!< frames with the same id have the same bitmaps
+  unsigned int layoutId = 0; //!< frames with the same id have the bitmaps at the same positions
+  std::shared_ptr<SQuads> atlas; //!< nullptr if nothing is visible
+  std::vector<SQuad> quads; //!< where the bitmaps of the atlas go in this frame
+};
+
+/*!
+ * \brief Renders libass subtitles ahead of the render thread.
+ *
+ * Frames are requested when their overlays are queued and rendered on a worker thread, the
+ * render thread picks up the packed atlas. A frame that isn't ready by then is rendered on the
+ * spot. Every render of a libass instance has to go through here, the images it returns only
+ * live until its next render.
+ *
+ * The atlas of the previous frame is kept if libass reports that the images only moved.
+ */
+class CLibassRenderAhead : private CThread
+{
+public:
+  /*! \brief Frames rendered ahead at most */
+  static constexpr size_t MAX_FRAMES = 4;
+
+  CLibassRenderAhead();
+  ~CLibassRenderAhead() override;
+
+  /*!
+   * \brief Render the subtitles of a frame in the background
+   *
+   * Uses the geometry of the last Get, nothing is rendered ahead before the first one.
+   */
+  void Request(CDVDSubtitlesLibass* libass, double pts);
+
+  /*!
+   * \brief Get the subtitles of a frame
+   */
+  SLibassFrame Get(CDVDSubtitlesLibass* libass, const SLibassGeometry& geometry, double pts);
+
+  /*!
+   * \brief Drop frames requested or rendered so far
+   *
+   * Waits for a render in progress, the next frame doesn't reuse the atlas of a previous one.
+   */
+  void Flush();
+
+private:
+  struct SEntry
+  {
+    CDVDSubtitlesLibass* libass; //!< acquired
+    SLibassFrame frame;
+  };
+
+  void Process() override;
+  SLibassFrame Render(CDVDSubtitlesLibass* libass, const SLibassGeometry& geometry, double pts);
+  static void Release(std::deque<SEntry>& entries);
+
+  CCriticalSection m_section; //!< guards the queues
+  CEvent m_requestEvent;
+  std::deque<SEntry> m_requests;
+  std::deque<SEntry> m_frames;
+  SLibassGeometry m_geometry;
+  bool m_hasGeometry = false;
+  unsigned int m_flushes = 0;
+
+  CCriticalSection m_renderSection; //!< serializes rendering, guards the state below
+  const CDVDSubtitlesLibass* m_lastLibass = nullptr;
+  SLibassFrame m_last;
+  unsigned int m_nextId = 1;
+};
+
+} // namespace OVERLAY
@@ -26,9 +26,17 @@
 #include "threads/SingleLock.h"
 #include "utils/GLUtils.h"
 #include "utils/MathUtils.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
 #include "utils/log.h"
 #include "windowing/WinSystem.h"
 
+#if defined(HAS_EGL)
+#include "utils/EGLFence.h"
+#include "utils/EGLUtils.h"
+#endif
+
+#include <cstring>
 
 using namespace Shaders;
 
@@ -48,6 +56,7 @@ CLinuxRendererGLES::CLinuxRendererGLES()
   if (verMajor >= 3)
   {
     m_pixelStoreKey = GL_UNPACK_ROW_LENGTH;
+    m_pboSupported = true;
   }
 #endif
 
@@ -682,6 +691,16 @@ void CLinuxRendererGLES::LoadShaders(int field)
         CLog::Log(LOGERROR, "GLES: render method not supported");
       }
     }
+
+    if (m_pboSupported)
+    {
+      CLog::Log(LOGINFO, "GLES: Using pixel buffer objects");
+      m_pboUsed = true;
+    }
+    else
+    {
+      m_pboUsed = false;
+    }
   }
 }
 
@@ -736,6 +755,7 @@ bool CLinuxRendererGLES::CreateTexture(int index)
 void CLinuxRendererGLES::DeleteTexture(int index)
 {
   ReleaseBuffer(index);
+  DeletePbo(index);
 
   if (m_format == AV_PIX_FMT_NV12)
   {
@@ -760,11 +780,14 @@ bool CLinuxRendererGLES::UploadTexture(int index)
   }
 
   bool ret{false};
+  const int64_t start = CurrentHostCounter();
 
   YuvImage &dst = m_buffers[index].image;
   m_buffers[index].videoBuffer->GetPlanes(dst.plane);
   m_buffers[index].videoBuffer->GetStrides(dst.stride);
 
+  const bool pbo = m_pboUsed && MapPbo(index);
+
   if (m_format == AV_PIX_FMT_NV12)
   {
     ret = UploadNV12Texture(index);
@@ -775,14 +798,155 @@ bool CLinuxRendererGLES::UploadTexture(int index)
     ret = UploadYV12Texture(index);
   }
 
+#if HAS_GLES >= 3
+  if (pbo)
+  {
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+#if defined(HAS_EGL)
+    if (m_buffers[index].fence)
+    {
+      m_buffers[index].fence->DestroyFence();
+      m_buffers[index].fence->CreateFence();
+    }
+#endif
+  }
+#endif
+
   if (ret)
   {
     m_buffers[index].loaded = true;
   }
 
+  const float uploadTime = static_cast<float>(CurrentHostCounter() - start) * 1000.0f /
+                           static_cast<float>(CurrentHostFrequency());
+  m_uploadTime += (uploadTime - m_uploadTime) * 0.1f;
+
   return ret;
 }
 
+bool CLinuxRendererGLES::MapPbo(int index)
+{
+#if HAS_GLES >= 3
+  CPictureBuffer& buf = m_buffers[index];
+  YuvImage& im = buf.image;
+
+  // planes are packed tightly, one after the other
+  const int planes = m_format == AV_PIX_FMT_NV12 ? 2 : 3;
+  size_t offset[YuvImage::MAX_PLANES] = {};
+  int lineSize[YuvImage::MAX_PLANES] = {};
+  unsigned int lines[YuvImage::MAX_PLANES] = {};
+  size_t size = 0;
+
+  for (int p = 0; p < planes; p++)
+  {
+    if (p == 0)
+      lineSize[p] = im.width * im.bpp;
+    else if (m_format == AV_PIX_FMT_NV12)
+      lineSize[p] = (im.width >> im.cshift_x) * 2 * im.bpp;
+    else
+      lineSize[p] = (im.width >> im.cshift_x) * im.bpp;
+    lines[p] = p == 0 ? im.height : im.height >> im.cshift_y;
+
+    offset[p] = size;
+    size += lineSize[p] * lines[p];
+  }
+
+  if (!buf.pbo)
+  {
+    glGenBuffers(1, &buf.pbo);
+
+#if defined(HAS_EGL)
+    EGLDisplay display = eglGetCurrentDisplay();
+    if (display != EGL_NO_DISPLAY && CEGLUtils::HasExtension(display, "EGL_KHR_fence_sync"))
+      buf.fence.reset(new KODI::UTILS::EGL::CEGLFence(display));
+#endif
+  }
+
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buf.pbo);
+
+  // without knowing that the gpu has consumed the previous picture, the driver may hand out
+  // fresh storage instead of waiting
+  GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT;
+  if (buf.pboSize != size)
+  {
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    buf.pboSize = size;
+  }
+#if defined(HAS_EGL)
+  else if (buf.fence && buf.fence->IsSignaled())
+  {
+    access |= GL_MAP_UNSYNCHRONIZED_BIT;
+  }
+#endif
+
+  uint8_t* data = static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, access));
+  if (!data)
+  {
+    CLog::Log(LOGERROR, "GLES: Failed to map pixel buffer object, falling back to client memory");
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    m_pboUsed = false;
+    return false;
+  }
+
+  for (int p = 0; p < planes; p++)
+  {
+    const uint8_t* src = im.plane[p];
+    uint8_t* dst = data + offset[p];
+
+    if (im.stride[p] == lineSize[p])
+    {
+      memcpy(dst, src, lineSize[p] * lines[p]);
+    }
+    else
+    {
+      for (unsigned int y = 0; y < lines[p]; ++y, src += im.stride[p], dst += lineSize[p])
+        memcpy(dst, src, lineSize[p]);
+    }
+  }
+
+  if (glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) != GL_TRUE)
+  {
+    // contents got lost, upload from client memory this time
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    return false;
+  }
+
+  // with the pbo bound, the planes are offsets into it
+  for (int p = 0; p < planes; p++)
+  {
+    im.plane[p] = reinterpret_cast<uint8_t*>(offset[p]);
+    im.stride[p] = lineSize[p];
+  }
+
+  return true;
+#else
+  return false;
+#endif
+}
+
+void CLinuxRendererGLES::DeletePbo(int index)
+{
+#if HAS_GLES >= 3
+  CPictureBuffer& buf = m_buffers[index];
+
+#if defined(HAS_EGL)
+  if (buf.fence)
+  {
+    buf.fence->DestroyFence();
+    buf.fence.reset();
+  }
+#endif
+
+  if (buf.pbo)
+  {
+    glDeleteBuffers(1, &buf.pbo);
+    buf.pbo = 0;
+    buf.pboSize = 0;
+  }
+#endif
+}
+
 void CLinuxRendererGLES::Render(unsigned int flags, int index)
 {
   // obtain current field, if interlaced
@@ -1753,6 +1917,20 @@ CRenderInfo CLinuxRendererGLES::GetRenderInfo()
   return info;
 }
 
+DEBUG_INFO_VIDEO CLinuxRendererGLES::GetDebugInfo(int idx)
+{
+  DEBUG_INFO_VIDEO info;
+
+  // renderers of hardware decoders don't upload pictures
+  if (m_uploadTime > 0.0f)
+  {
+    info.upload = StringUtils::Format("Upload: {}, {:.2f} ms", m_pboUsed ? "pbo" : "client memory",
+                                      m_uploadTime);
+  }
+
+  return info;
+}
+
 bool CLinuxRendererGLES::IsGuiLayer()
 {
   return true;
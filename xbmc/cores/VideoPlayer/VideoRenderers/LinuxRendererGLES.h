@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "system_gl.h"
@@ -29,6 +30,16 @@ class CRenderCapture;
 class CRenderSystemGLES;
 
 class CTexture;
+namespace KODI
+{
+namespace UTILS
+{
+namespace EGL
+{
+class CEGLFence;
+}
+}
+}
 namespace Shaders { class BaseYUV2RGBGLSLShader; }
 namespace Shaders { class BaseVideoFilterShader; }
 
@@ -80,6 +91,7 @@ public:
   bool RenderCapture(CRenderCapture* capture) override;
   CRenderInfo GetRenderInfo() override;
   bool ConfigChanged(const VideoPicture& picture) override;
+  DEBUG_INFO_VIDEO GetDebugInfo(int idx) override;
 
   // Feature support
   bool SupportsMultiPassRendering() override;
@@ -118,6 +130,10 @@ protected:
 
   void CalculateTextureSourceRects(int source, int num_planes);
 
+  // pixel buffer objects
+  bool MapPbo(int index);
+  void DeletePbo(int index);
+
   // renderers
   void RenderToFBO(int index, int field);
   void RenderFromFBO();
@@ -184,6 +200,12 @@ protected:
     AVMasteringDisplayMetadata displayMetadata;
     bool hasLightMetadata{false};
     AVContentLightMetadata lightMetadata;
+
+    GLuint pbo{0}; // holds all planes of the picture, tightly packed
+    size_t pboSize{0};
+#if defined(HAS_EGL)
+    std::unique_ptr<KODI::UTILS::EGL::CEGLFence> fence; // signaled when the pbo was consumed
+#endif
   };
 
   // YV12 decoder textures
@@ -206,6 +228,10 @@ protected:
   unsigned char* m_planeBuffer = nullptr;
   size_t m_planeBufferSize = 0;
 
+  bool m_pboSupported = false;
+  bool m_pboUsed = false;
+  float m_uploadTime = 0.0f; // average time in ms spent uploading a picture
+
   // clear colour for "black" bars
   float m_clearColour{0.0f};
   CRect m_viewRect;
@@ -23,6 +23,7 @@
 #include "settings/SettingsComponent.h"
 #include "threads/SingleLock.h"
 #include "utils/ColorUtils.h"
+#include "utils/StringUtils.h"
 #include "OverlayRendererUtil.h"
 #include "OverlayRendererGUI.h"
 #if defined(HAS_GL) || defined(HAS_GLES)
@@ -50,11 +51,13 @@ COverlay::COverlay()
   m_type   = TYPE_NONE;
   m_align  = ALIGN_SCREEN;
   m_pos    = POSITION_RELATIVE;
+  m_memory = 0;
 }
 
 COverlay::~COverlay() = default;
 
 unsigned int CRenderer::m_textureid = 1;
+constexpr size_t CRenderer::MAX_TEXTURE_MEMORY;
 
 CRenderer::CRenderer()
 {
@@ -75,6 +78,10 @@ void CRenderer::AddOverlay(CDVDOverlay* o, double pts, int index)
   e.pts = pts;
   e.overlay_dvd = o->Acquire();
   m_buffers[index].push_back(e);
+
+  // the frame is presented later, render its subtitles meanwhile
+  if (o->IsOverlayType(DVDOVERLAY_TYPE_SSA))
+    m_libassRenderAhead.Request(static_cast<CDVDOverlaySSA*>(o)->m_libass, pts);
 }
 
 void CRenderer::Release(std::vector<SElement>& list)
@@ -96,6 +103,7 @@ void CRenderer::Flush()
   for(std::vector<SElement>& buffer : m_buffers)
     Release(buffer);
 
+  m_libassRenderAhead.Flush();
   ReleaseCache();
 
   g_fontManager.Unload(m_font);
@@ -110,11 +118,14 @@ void CRenderer::Release(int idx)
 
 void CRenderer::ReleaseCache()
 {
-  for (auto& overlay : m_textureCache)
+  for (auto& texture : m_textureCache)
   {
-    delete overlay.second;
+    delete texture.second.overlay;
   }
   m_textureCache.clear();
+  m_textureLru.clear();
+  m_textureMemory = 0;
+  m_libassTextures.clear();
   m_textureid++;
 }
 
@@ -137,18 +148,66 @@ void CRenderer::ReleaseUnused()
         break;
     }
     if (!found)
-    {
-      delete it->second;
-      it = m_textureCache.erase(it);
-    }
+      it = ReleaseTexture(it);
     else
       ++it;
   }
+
+  // over budget, release textures of queued frames as well, they are converted again when their
+  // frame comes up. the ones rendered right now are kept
+  while (m_textureMemory > MAX_TEXTURE_MEMORY && !m_textureLru.empty())
+  {
+    auto it = m_textureCache.find(m_textureLru.back());
+    if (it->second.lastRender == m_renderCount)
+      break;
+    ReleaseTexture(it);
+    m_textureEvictions++;
+  }
+}
+
+std::map<unsigned int, CRenderer::STexture>::iterator CRenderer::ReleaseTexture(std::map<unsigned int, STexture>::iterator it)
+{
+  if (it->second.overlay)
+  {
+    m_textureMemory -= it->second.overlay->m_memory;
+    delete it->second.overlay;
+  }
+  m_textureLru.erase(it->second.lru);
+  m_libassTextures.erase(it->first);
+  return m_textureCache.erase(it);
+}
+
+COverlay* CRenderer::FindTexture(unsigned int id)
+{
+  auto it = m_textureCache.find(id);
+  if (it == m_textureCache.end())
+    return nullptr;
+
+  m_textureLru.splice(m_textureLru.begin(), m_textureLru, it->second.lru);
+  it->second.lastRender = m_renderCount;
+  return it->second.overlay;
+}
+
+void CRenderer::AddTexture(unsigned int id, COverlay* overlay)
+{
+  m_textureLru.push_front(id);
+  m_textureCache[id] = {overlay, m_renderCount, m_textureLru.begin()};
+  if (overlay)
+    m_textureMemory += overlay->m_memory;
+}
+
+std::string CRenderer::GetCacheInfo()
+{
+  CSingleLock lock(m_section);
+  return StringUtils::Format("overlays: %zu textures %.1f/%zu MiB, released %u",
+                             m_textureCache.size(), m_textureMemory / (1024.0 * 1024.0),
+                             MAX_TEXTURE_MEMORY / (1024 * 1024), m_textureEvictions);
 }
 
 void CRenderer::Render(int idx)
 {
   CSingleLock lock(m_section);
+  m_renderCount++;
 
   std::vector<COverlay*> render;
   std::vector<SElement>& list = m_buffers[idx];
@@ -385,25 +444,40 @@ COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
   }
   else
     position = 0.0;
-  int changes = 0;
-  ASS_Image* images = o->m_libass->RenderImage(targetWidth, targetHeight, videoWidth, videoHeight, sourceWidth, sourceHeight,
-                                               pts, useMargin, position, &changes);
+
+  SLibassGeometry geometry;
+  geometry.frameWidth = targetWidth;
+  geometry.frameHeight = targetHeight;
+  geometry.videoWidth = videoWidth;
+  geometry.videoHeight = videoHeight;
+  geometry.sourceWidth = sourceWidth;
+  geometry.sourceHeight = sourceHeight;
+  geometry.useMargin = useMargin;
+  geometry.position = position;
+  SLibassFrame frame = m_libassRenderAhead.Get(o->m_libass, geometry, pts);
 
   if(o->m_textureid)
   {
-    if(changes == 0)
+    COverlay* cached = FindTexture(o->m_textureid);
+    std::map<unsigned int, SLibassTexture>::iterator ids = m_libassTextures.find(o->m_textureid);
+    if (cached && ids != m_libassTextures.end() && ids->second.atlasId == frame.atlasId)
     {
-      std::map<unsigned int, COverlay*>::iterator it = m_textureCache.find(o->m_textureid);
-      if (it != m_textureCache.end())
-        return it->second;
+      if (ids->second.layoutId == frame.layoutId)
+        return cached;
+#if defined(HAS_GL) || defined(HAS_GLES)
+      // only the positions changed, keep the uploaded atlas
+      static_cast<COverlayGlyphGL*>(cached)->SetQuads(frame.quads);
+      ids->second.layoutId = frame.layoutId;
+      return cached;
+#endif
     }
   }
 
   COverlay *overlay = NULL;
 #if defined(HAS_GL) || defined(HAS_GLES)
-  overlay = new COverlayGlyphGL(images, targetWidth, targetHeight);
+  overlay = new COverlayGlyphGL(frame.atlas.get(), frame.quads, targetWidth, targetHeight);
 #elif defined(HAS_DX)
-  overlay = new COverlayQuadsDX(images, targetWidth, targetHeight);
+  overlay = new COverlayQuadsDX(frame.atlas.get(), frame.quads, targetWidth, targetHeight);
 #endif
   // scale to video dimensions
   if (overlay)
@@ -413,7 +487,8 @@ COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
     overlay->m_x = ((float)videoWidth - targetWidth) / 2 / videoWidth;
     overlay->m_y = ((float)videoHeight - targetHeight) / 2 / videoHeight;
   }
-  m_textureCache[m_textureid] = overlay;
+  AddTexture(m_textureid, overlay);
+  m_libassTextures[m_textureid] = {frame.atlasId, frame.layoutId};
   o->m_textureid = m_textureid;
   m_textureid++;
   return overlay;
@@ -427,11 +502,7 @@ COverlay* CRenderer::Convert(CDVDOverlay* o, double pts)
   if(o->IsOverlayType(DVDOVERLAY_TYPE_SSA))
     r = Convert(static_cast<CDVDOverlaySSA*>(o), pts);
   else if(o->m_textureid)
-  {
-    std::map<unsigned int, COverlay*>::iterator it = m_textureCache.find(o->m_textureid);
-    if (it != m_textureCache.end())
-      r = it->second;
-  }
+    r = FindTexture(o->m_textureid);
 
   if (r)
   {
@@ -453,7 +524,7 @@ COverlay* CRenderer::Convert(CDVDOverlay* o, double pts)
   if(!r && o->IsOverlayType(DVDOVERLAY_TYPE_TEXT))
     r = new COverlayText(static_cast<CDVDOverlayText*>(o));
 
-  m_textureCache[m_textureid] = r;
+  AddTexture(m_textureid, r);
   o->m_textureid = m_textureid;
   m_textureid++;
 
@@ -10,9 +10,12 @@
 #pragma once
 
 #include "BaseRenderer.h"
+#include "LibassRenderAhead.h"
 #include "threads/CriticalSection.h"
 
+#include <list>
 #include <map>
+#include <string>
 #include <vector>
 
 class CDVDOverlay;
@@ -61,11 +64,15 @@ namespace OVERLAY {
     float m_y;
     float m_width;
     float m_height;
+    size_t m_memory; // bytes of texture memory
   };
 
   class CRenderer
   {
   public:
+    /*! \brief Texture memory above which the least recently used overlays are released */
+    static constexpr size_t MAX_TEXTURE_MEMORY = 64 * 1024 * 1024;
+
     CRenderer();
     virtual ~CRenderer();
 
@@ -77,6 +84,11 @@ namespace OVERLAY {
     void SetVideoRect(CRect &source, CRect &dest, CRect &view);
     void SetStereoMode(const std::string &stereomode);
 
+    /*!
+     \brief Usage of the texture cache, for the debug overlay
+     */
+    std::string GetCacheInfo();
+
   protected:
 
     struct SElement
@@ -94,13 +106,35 @@ namespace OVERLAY {
     COverlay* Convert(CDVDOverlay* o, double pts);
     COverlay* Convert(CDVDOverlaySSA* o, double pts);
 
+    struct STexture
+    {
+      COverlay* overlay;
+      unsigned int lastRender; // m_renderCount when last used
+      std::list<unsigned int>::iterator lru; // position in m_textureLru
+    };
+
     void Release(std::vector<SElement>& list);
     void ReleaseCache();
     void ReleaseUnused();
+    COverlay* FindTexture(unsigned int id);
+    void AddTexture(unsigned int id, COverlay* overlay);
+    std::map<unsigned int, STexture>::iterator ReleaseTexture(std::map<unsigned int, STexture>::iterator it);
+
+    struct SLibassTexture
+    {
+      unsigned int atlasId;
+      unsigned int layoutId;
+    };
 
     CCriticalSection m_section;
     std::vector<SElement> m_buffers[NUM_BUFFERS];
-    std::map<unsigned int, COverlay*> m_textureCache;
+    std::map<unsigned int, STexture> m_textureCache;
+    std::list<unsigned int> m_textureLru; // texture ids, the most recently used first
+    size_t m_textureMemory = 0;
+    unsigned int m_textureEvictions = 0;
+    unsigned int m_renderCount = 0;
+    std::map<unsigned int, SLibassTexture> m_libassTextures; // by texture id of m_textureCache
+    CLibassRenderAhead m_libassRenderAhead;
     static unsigned int m_textureid;
     CRect m_rv, m_rs, m_rd;
     std::string m_font, m_fontBorder;
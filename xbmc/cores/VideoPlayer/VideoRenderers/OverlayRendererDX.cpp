@@ -58,7 +58,7 @@ static bool LoadTexture(int width, int height, int stride
   return true;
 }
 
-COverlayQuadsDX::COverlayQuadsDX(ASS_Image* images, int width, int height)
+COverlayQuadsDX::COverlayQuadsDX(const SQuads* atlas, const std::vector<SQuad>& quads, int width, int height)
 {
   m_width  = 1.0;
   m_height = 1.0;
@@ -68,32 +68,33 @@ COverlayQuadsDX::COverlayQuadsDX(ASS_Image* images, int width, int height)
   m_y      = 0.0f;
   m_count  = 0;
 
-  SQuads quads;
-  if(!convert_quad(images, quads, width))
+  if(!atlas || quads.empty())
     return;
 
   float u, v;
-  if(!LoadTexture(quads.size_x
-                , quads.size_y
-                , quads.size_x
+  if(!LoadTexture(atlas->size_x
+                , atlas->size_y
+                , atlas->size_x
                 , DXGI_FORMAT_R8_UNORM
-                , quads.data
+                , atlas->data
                 , &u, &v
                 , &m_texture))
   {
     return;
   }
+  m_memory = atlas->size_x * atlas->size_y;
 
-  Vertex* vt = new Vertex[6 * quads.count], *vt_orig = vt;
-  SQuad*  vs = quads.quad;
+  int count = static_cast<int>(quads.size());
+  Vertex*      vt = new Vertex[6 * count], *vt_orig = vt;
+  const SQuad* vs = quads.data();
 
-  float scale_u = u / quads.size_x;
-  float scale_v = v / quads.size_y;
+  float scale_u = u / atlas->size_x;
+  float scale_v = v / atlas->size_y;
 
   float scale_x = 1.0f / width;
   float scale_y = 1.0f / height;
 
-  for (int i = 0; i < quads.count; i++)
+  for (int i = 0; i < count; i++)
   {
     for (int s = 0; s < 6; s++)
     {
@@ -132,9 +133,9 @@ COverlayQuadsDX::COverlayQuadsDX(ASS_Image* images, int width, int height)
   }
 
   vt = vt_orig;
-  m_count = quads.count;
+  m_count = count;
 
-  if (!m_vertex.Create(D3D11_BIND_VERTEX_BUFFER, 6 * quads.count, sizeof(Vertex), DXGI_FORMAT_UNKNOWN, D3D11_USAGE_IMMUTABLE, vt))
+  if (!m_vertex.Create(D3D11_BIND_VERTEX_BUFFER, 6 * count, sizeof(Vertex), DXGI_FORMAT_UNKNOWN, D3D11_USAGE_IMMUTABLE, vt))
   {
     CLog::Log(LOGERROR, "%s - failed to create vertex buffer", __FUNCTION__);
     m_texture.Release();
@@ -204,11 +205,12 @@ COverlayImageDX::COverlayImageDX(CDVDOverlayImage* o)
 {
   uint32_t* rgba;
   int stride;
+  int min_x = 0, max_x = o->width, min_y = 0, max_y = o->height;
   if(o->palette)
   {
     m_pma  = !!USE_PREMULTIPLIED_ALPHA;
-    rgba   = convert_rgba(o, m_pma);
-    stride = o->width * 4;
+    rgba   = convert_rgba(o, m_pma, min_x, max_x, min_y, max_y);
+    stride = (max_x - min_x) * 4;
   }
   else
   {
@@ -223,17 +225,20 @@ COverlayImageDX::COverlayImageDX(CDVDOverlayImage* o)
     return;
   }
 
-  Load(rgba, o->width, o->height, stride);
+  const int width  = max_x - min_x;
+  const int height = max_y - min_y;
+
+  Load(rgba, width, height, stride);
   if((BYTE*)rgba != o->data)
     free(rgba);
 
   if(o->source_width && o->source_height)
   {
-    float center_x = (float)(0.5f * o->width  + o->x) / o->source_width;
-    float center_y = (float)(0.5f * o->height + o->y) / o->source_height;
+    float center_x = (float)(0.5f * width  + o->x + min_x) / o->source_width;
+    float center_y = (float)(0.5f * height + o->y + min_y) / o->source_height;
 
-    m_width  = (float)o->width  / o->source_width;
-    m_height = (float)o->height / o->source_height;
+    m_width  = (float)width  / o->source_width;
+    m_height = (float)height / o->source_height;
     m_pos    = POSITION_RELATIVE;
 
 #if 0
@@ -258,10 +263,10 @@ COverlayImageDX::COverlayImageDX(CDVDOverlayImage* o)
   {
     m_align  = ALIGN_VIDEO;
     m_pos    = POSITION_ABSOLUTE;
-    m_x      = (float)o->x;
-    m_y      = (float)o->y;
-    m_width  = (float)o->width;
-    m_height = (float)o->height;
+    m_x      = (float)(o->x + min_x);
+    m_y      = (float)(o->y + min_y);
+    m_width  = (float)width;
+    m_height = (float)height;
   }
 }
 
@@ -298,6 +303,8 @@ void COverlayImageDX::Load(uint32_t* rgba, int width, int height, int stride)
                 , &m_texture))
     return;
 
+  m_memory = width * height * 4;
+
   Vertex vt[4];
 
   vt[0].texCoord = XMFLOAT2(u, 0.0f);
@@ -9,8 +9,11 @@
 #pragma once
 
 #include "OverlayRenderer.h"
+#include "OverlayRendererUtil.h"
 #include "guilib/D3DResource.h"
 
+#include <vector>
+
 class CDVDOverlay;
 class CDVDOverlayImage;
 class CDVDOverlaySpu;
@@ -23,7 +26,7 @@ namespace OVERLAY {
     : public COverlay
   {
   public:
-    COverlayQuadsDX(ASS_Image* images, int width, int height);
+    COverlayQuadsDX(const SQuads* atlas, const std::vector<SQuad>& quads, int width, int height);
     virtual ~COverlayQuadsDX();
 
     void Render(SRenderState& state);
@@ -163,11 +163,12 @@ COverlayTextureGL::COverlayTextureGL(CDVDOverlayImage* o)
 
   uint32_t* rgba;
   int stride;
+  int min_x = 0, max_x = o->width, min_y = 0, max_y = o->height;
   if(o->palette)
   {
     m_pma  = !!USE_PREMULTIPLIED_ALPHA;
-    rgba   = convert_rgba(o, m_pma);
-    stride = o->width * 4;
+    rgba   = convert_rgba(o, m_pma, min_x, max_x, min_y, max_y);
+    stride = (max_x - min_x) * 4;
   }
   else
   {
@@ -190,9 +191,12 @@ COverlayTextureGL::COverlayTextureGL(CDVDOverlayImage* o)
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 
+  const int width  = max_x - min_x;
+  const int height = max_y - min_y;
+
   LoadTexture(GL_TEXTURE_2D
-            , o->width
-            , o->height
+            , width
+            , height
             , stride
             , &m_u, &m_v
             , false
@@ -201,14 +205,15 @@ COverlayTextureGL::COverlayTextureGL(CDVDOverlayImage* o)
     free(rgba);
 
   glBindTexture(GL_TEXTURE_2D, 0);
+  m_memory = width * height * 4;
 
   if(o->source_width && o->source_height)
   {
-    float center_x = (0.5f * o->width  + o->x) / o->source_width;
-    float center_y = (0.5f * o->height + o->y) / o->source_height;
+    float center_x = (0.5f * width  + o->x + min_x) / o->source_width;
+    float center_y = (0.5f * height + o->y + min_y) / o->source_height;
 
-    m_width  = (float)o->width  / o->source_width;
-    m_height = (float)o->height / o->source_height;
+    m_width  = (float)width  / o->source_width;
+    m_height = (float)height / o->source_height;
     m_pos    = POSITION_RELATIVE;
 
     {
@@ -222,10 +227,10 @@ COverlayTextureGL::COverlayTextureGL(CDVDOverlayImage* o)
   {
     m_align  = ALIGN_VIDEO;
     m_pos    = POSITION_ABSOLUTE;
-    m_x      = (float)o->x;
-    m_y      = (float)o->y;
-    m_width  = (float)o->width;
-    m_height = (float)o->height;
+    m_x      = (float)(o->x + min_x);
+    m_y      = (float)(o->y + min_y);
+    m_width  = (float)width;
+    m_height = (float)height;
   }
 }
 
@@ -262,6 +267,7 @@ COverlayTextureGL::COverlayTextureGL(CDVDOverlaySpu* o)
   free(rgba);
 
   glBindTexture(GL_TEXTURE_2D, 0);
+  m_memory = (max_x - min_x) * (max_y - min_y) * 4;
 
   m_align  = ALIGN_VIDEO;
   m_pos    = POSITION_ABSOLUTE;
@@ -272,9 +278,10 @@ COverlayTextureGL::COverlayTextureGL(CDVDOverlaySpu* o)
   m_pma    = !!USE_PREMULTIPLIED_ALPHA;
 }
 
-COverlayGlyphGL::COverlayGlyphGL(ASS_Image* images, int width, int height)
+COverlayGlyphGL::COverlayGlyphGL(const SQuads* atlas, const std::vector<SQuad>& quads, int width, int height)
 {
   m_vertex = NULL;
+  m_count  = 0;
   m_width  = 1.0;
   m_height = 1.0;
   m_align  = ALIGN_VIDEO;
@@ -283,35 +290,46 @@ COverlayGlyphGL::COverlayGlyphGL(ASS_Image* images, int width, int height)
   m_y      = 0.0f;
   m_texture = 0;
 
-  SQuads quads;
-  if(!convert_quad(images, quads, width))
+  if(!atlas)
     return;
 
   glGenTextures(1, &m_texture);
   glBindTexture(GL_TEXTURE_2D, m_texture);
 
   LoadTexture(GL_TEXTURE_2D
-            , quads.size_x
-            , quads.size_y
-            , quads.size_x
+            , atlas->size_x
+            , atlas->size_y
+            , atlas->size_x
             , &m_u, &m_v
             , true
-            , quads.data);
+            , atlas->data);
+
+
+  m_scale_u = m_u / atlas->size_x;
+  m_scale_v = m_v / atlas->size_y;
 
+  m_scale_x = 1.0f / width;
+  m_scale_y = 1.0f / height;
 
-  float scale_u = m_u / quads.size_x;
-  float scale_v = m_v / quads.size_y;
+  glBindTexture(GL_TEXTURE_2D, 0);
+  m_memory = atlas->size_x * atlas->size_y;
 
-  float scale_x = 1.0f / width;
-  float scale_y = 1.0f / height;
+  SetQuads(quads);
+}
 
-  m_count  = quads.count;
+void COverlayGlyphGL::SetQuads(const std::vector<SQuad>& quads)
+{
+  if(m_texture == 0)
+    return;
+
+  free(m_vertex);
+  m_count  = static_cast<int>(quads.size());
   m_vertex = (VERTEX*)calloc(m_count * 4, sizeof(VERTEX));
 
-  VERTEX* vt = m_vertex;
-  SQuad*  vs = quads.quad;
+  VERTEX*      vt = m_vertex;
+  const SQuad* vs = quads.data();
 
-  for(int i=0; i < quads.count; i++)
+  for(int i=0; i < m_count; i++)
   {
     for(int s = 0; s < 4; s++)
     {
@@ -320,11 +338,11 @@ COverlayGlyphGL::COverlayGlyphGL(ASS_Image* images, int width, int height)
       vt[s].g = vs->g;
       vt[s].b = vs->b;
 
-      vt[s].x = scale_x;
-      vt[s].y = scale_y;
+      vt[s].x = m_scale_x;
+      vt[s].y = m_scale_y;
       vt[s].z = 0.0f;
-      vt[s].u = scale_u;
-      vt[s].v = scale_v;
+      vt[s].u = m_scale_u;
+      vt[s].v = m_scale_v;
     }
 
     vt[0].x *= vs->x;
@@ -350,8 +368,6 @@ COverlayGlyphGL::COverlayGlyphGL(ASS_Image* images, int width, int height)
     vs += 1;
     vt += 4;
   }
-
-  glBindTexture(GL_TEXTURE_2D, 0);
 }
 
 COverlayGlyphGL::~COverlayGlyphGL()
@@ -10,9 +10,12 @@
 #pragma once
 
 #include "OverlayRenderer.h"
+#include "OverlayRendererUtil.h"
 
 #include "system_gl.h"
 
+#include <vector>
+
 class CDVDOverlay;
 class CDVDOverlayImage;
 class CDVDOverlaySpu;
@@ -39,12 +42,15 @@ namespace OVERLAY {
   class COverlayGlyphGL : public COverlay
   {
   public:
-   COverlayGlyphGL(ASS_Image* images, int width, int height);
+   COverlayGlyphGL(const SQuads* atlas, const std::vector<SQuad>& quads, int width, int height);
 
    ~COverlayGlyphGL() override;
 
    void Render(SRenderState& state) override;
 
+   /*! \brief Move the glyphs, the atlas stays as uploaded */
+   void SetQuads(const std::vector<SQuad>& quads);
+
     struct VERTEX
     {
        GLfloat u, v;
@@ -58,6 +64,10 @@ namespace OVERLAY {
    GLuint m_texture;
    float  m_u;
    float  m_v;
+   float  m_scale_u;
+   float  m_scale_v;
+   float  m_scale_x;
+   float  m_scale_y;
   };
 
 }
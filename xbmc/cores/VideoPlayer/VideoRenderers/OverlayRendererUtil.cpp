@@ -16,6 +16,12 @@
 #include "settings/SettingsComponent.h"
 #include "windowing/GraphicContext.h"
 
+#include <algorithm>
+
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace OVERLAY {
 
 static uint32_t build_rgba(int a, int r, int g, int b, bool mergealpha)
@@ -43,25 +49,165 @@ static uint32_t build_rgba(int yuv[3], int alpha, bool mergealpha)
 }
 #undef clamp
 
-uint32_t* convert_rgba(CDVDOverlayImage* o, bool mergealpha)
+namespace
 {
-  uint32_t* rgba = (uint32_t*)malloc(o->width * o->height * sizeof(uint32_t));
 
-  if(!rgba)
-    return NULL;
+struct SPalette
+{
+  uint32_t colors[256];
+  bool     opaque[256];
+  int      transparent; /* a transparent index, -1 if there is none */
+};
+
+/* 16 indices starting at src are all value */
+inline bool is_run16(const uint8_t* src, uint8_t value)
+{
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(static_cast<char>(value)))) == 0xffff;
+#else
+  for(int i = 0; i < 16; i++)
+    if(src[i] != value)
+      return false;
+  return true;
+#endif
+}
+
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+/* 16 pixels of one color */
+inline void fill16(uint32_t* dst, uint32_t color)
+{
+  const __m128i fill = _mm_set1_epi32(static_cast<int>(color));
+  __m128i* out = reinterpret_cast<__m128i*>(dst);
+  _mm_storeu_si128(out    , fill);
+  _mm_storeu_si128(out + 1, fill);
+  _mm_storeu_si128(out + 2, fill);
+  _mm_storeu_si128(out + 3, fill);
+}
+#endif
+
+void expand_row(const SPalette& palette, const uint8_t* src, uint32_t* dst, int width)
+{
+  int x = 0;
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+  /* no byte gather, but the transparent background can be filled 16 pixels at a time */
+  if(palette.transparent >= 0)
+  {
+    const uint32_t color = palette.colors[palette.transparent];
+    for(; x + 16 <= width; x += 16)
+    {
+      if(is_run16(src + x, static_cast<uint8_t>(palette.transparent)))
+        fill16(dst + x, color);
+      else
+      {
+        for(int i = 0; i < 16; i++)
+          dst[x + i] = palette.colors[src[x + i]];
+      }
+    }
+  }
+#endif
+  for(; x < width; x++)
+    dst[x] = palette.colors[src[x]];
+}
+
+/* bounding box of the pixels that aren't fully transparent */
+void find_opaque(const SPalette& palette, const CDVDOverlayImage* o
+               , int& min_x, int& max_x
+               , int& min_y, int& max_y)
+{
+  const int     width = o->width;
+  const bool    skip  = palette.transparent >= 0;
+  const uint8_t bg    = skip ? static_cast<uint8_t>(palette.transparent) : 0;
+
+  min_x = width;
+  max_x = 0;
+  min_y = o->height;
+  max_y = 0;
+
+  for(int y = 0; y < o->height; y++)
+  {
+    const uint8_t* line = o->data + y * o->linesize;
+
+    int x = 0;
+    while(x < width)
+    {
+      if(skip && x + 16 <= width && is_run16(line + x, bg))
+        x += 16;
+      else if(palette.opaque[line[x]])
+        break;
+      else
+        x++;
+    }
+    if(x == width)
+      continue;
 
-  uint32_t palette[256];
-  memset(palette, 0, 256 * sizeof(palette[0]));
+    /* only pixels right of the box so far can widen it */
+    int end   = width;
+    int limit = std::max(x + 1, max_x);
+    while(end > limit)
+    {
+      if(skip && end - 16 >= limit && is_run16(line + end - 16, bg))
+        end -= 16;
+      else if(palette.opaque[line[end - 1]])
+        break;
+      else
+        end--;
+    }
+
+    min_x = std::min(min_x, x);
+    max_x = std::max(max_x, end);
+    min_y = std::min(min_y, y);
+    max_y = y + 1;
+  }
+}
+
+} // namespace
+
+uint32_t* convert_rgba(CDVDOverlayImage* o, bool mergealpha
+                     , int& min_x, int& max_x
+                     , int& min_y, int& max_y)
+{
+  SPalette palette;
+  memset(palette.colors, 0, sizeof(palette.colors));
   for(int i = 0; i < o->palette_colors; i++)
-    palette[i] = build_rgba((o->palette[i] >> PIXEL_ASHIFT) & 0xff
-                          , (o->palette[i] >> PIXEL_RSHIFT) & 0xff
-                          , (o->palette[i] >> PIXEL_GSHIFT) & 0xff
-                          , (o->palette[i] >> PIXEL_BSHIFT) & 0xff
-                          , mergealpha);
+    palette.colors[i] = build_rgba((o->palette[i] >> PIXEL_ASHIFT) & 0xff
+                                 , (o->palette[i] >> PIXEL_RSHIFT) & 0xff
+                                 , (o->palette[i] >> PIXEL_GSHIFT) & 0xff
+                                 , (o->palette[i] >> PIXEL_BSHIFT) & 0xff
+                                 , mergealpha);
+
+  palette.transparent = -1;
+  for(int i = 0; i < 256; i++)
+  {
+    palette.opaque[i] = ((palette.colors[i] >> PIXEL_ASHIFT) & 0xff) != 0;
+    if(!palette.opaque[i] && palette.transparent < 0)
+      palette.transparent = i;
+  }
+  /* the background is likely the color of the first pixel */
+  if(o->width > 0 && o->height > 0 && !palette.opaque[o->data[0]])
+    palette.transparent = o->data[0];
 
-  for(int row = 0; row < o->height; row++)
-    for(int col = 0; col < o->width; col++)
-      rgba[row * o->width + col] = palette[ o->data[row * o->linesize + col] ];
+  find_opaque(palette, o, min_x, max_x, min_y, max_y);
+
+  /* if nothing visible, just output a dummy pixel */
+  if(max_x <= min_x
+  || max_y <= min_y)
+  {
+    max_y = max_x = 1;
+    min_y = min_x = 0;
+  }
+
+  const int width = max_x - min_x;
+  uint32_t* rgba = (uint32_t*)malloc(width * (max_y - min_y) * sizeof(uint32_t));
+
+  if(!rgba)
+    return NULL;
+
+  for(int y = min_y; y < max_y; y++)
+    expand_row(palette
+             , o->data + y * o->linesize + min_x
+             , rgba + (y - min_y) * width
+             , width);
 
   return rgba;
 }
@@ -285,6 +431,26 @@ bool convert_quad(ASS_Image* images, SQuads& quads, int max_x)
   return true;
 }
 
+/* the images moved but kept their bitmaps (libass reports a change of 1),
+ * only update where the quads packed for them are drawn */
+bool update_quad_positions(ASS_Image* images, std::vector<SQuad>& quads)
+{
+  size_t i = 0;
+  for(ASS_Image* img = images; img; img = img->next)
+  {
+    if((img->color & 0xff) == 0xff || img->w == 0 || img->h == 0)
+      continue;
+
+    if (i >= quads.size() || quads[i].w != img->w || quads[i].h != img->h)
+      return false;
+
+    quads[i].x = img->dst_x;
+    quads[i].y = img->dst_y;
+    i++;
+  }
+  return i == quads.size();
+}
+
 int GetStereoscopicDepth()
 {
   int depth = 0;
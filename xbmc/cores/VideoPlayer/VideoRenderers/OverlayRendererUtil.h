@@ -10,6 +10,7 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <vector>
 
 class CDVDOverlayImage;
 class CDVDOverlaySpu;
@@ -48,11 +49,16 @@ namespace OVERLAY {
     SQuad*   quad;
   };
 
-  uint32_t* convert_rgba(CDVDOverlayImage* o, bool mergealpha);
+  /* converts the pixels within the bounding box of the visible ones,
+   * the returned buffer is (max_x - min_x) pixels wide */
+  uint32_t* convert_rgba(CDVDOverlayImage* o, bool mergealpha
+                       , int& min_x, int& max_x
+                       , int& min_y, int& max_y);
   uint32_t* convert_rgba(CDVDOverlaySpu*   o, bool mergealpha
                        , int& min_x, int& max_x
                        , int& min_y, int& max_y);
   bool      convert_quad(ASS_Image* images, SQuads& quads, int max_x);
+  bool      update_quad_positions(ASS_Image* images, std::vector<SQuad>& quads);
   int       GetStereoscopicDepth();
 
 }
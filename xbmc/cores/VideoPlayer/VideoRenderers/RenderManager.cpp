@@ -15,13 +15,16 @@
 #include "ServiceBroker.h"
 #include "cores/VideoPlayer/Interface/TimingConstants.h"
 #include "messaging/ApplicationMessenger.h"
+#include "rendering/RenderSystem.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/MediaSettings.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/MathUtils.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
 #include "utils/XTimeUtils.h"
 #include "utils/log.h"
 #include "windowing/GraphicContext.h"
@@ -201,6 +204,11 @@ bool CRenderManager::Configure()
     m_pRenderer->SetBufferSize(m_QueueSize);
     m_pRenderer->Update();
 
+    // start with a shallow queue, it gets deeper if rendering turns out to be irregular
+    int minDepth = info.optimal_buffer_size > 0 ? static_cast<int>(info.optimal_buffer_size) : 3;
+    m_queueDepth.Reset(std::min(minDepth, m_QueueSize), m_QueueSize);
+    m_lastFrameMove = 0;
+
     m_playerPort->UpdateRenderInfo(info);
     m_playerPort->UpdateGuiRender(true);
     m_playerPort->UpdateVideoRender(!m_pRenderer->IsGuiLayer());
@@ -309,6 +317,17 @@ void CRenderManager::FrameMove()
       m_presentTimer.Set(1000);
     }
 
+    // watch how regular the render thread is while video is presented
+    unsigned int now = XbmcThreads::SystemClockMillis();
+    if (m_lastFrameMove && !m_presentTimer.IsTimePast())
+    {
+      float refreshRate = CServiceBroker::GetWinSystem()->GetGfxContext().GetFPS();
+      m_queueDepth.SetFrameTimes(m_fps > 0 ? 1000.0 / m_fps : 0.0,
+                                 refreshRate > 0 ? 1000.0 / refreshRate : 0.0);
+      m_queueDepth.AddRenderInterval(now - m_lastFrameMove);
+    }
+    m_lastFrameMove = now;
+
     if (m_presentstep == PRESENT_READY)
       PrepareNextRender();
 
@@ -326,6 +345,11 @@ void CRenderManager::FrameMove()
       {
         m_pRenderer->ReleaseBuffer(*it);
         m_overlays.Release(*it);
+        if (m_Queue[*it].timing.queued)
+        {
+          m_frameTiming.Add(m_Queue[*it].timing);
+          m_Queue[*it].timing = {};
+        }
         m_free.push_back(*it);
         it = m_discard.erase(it);
       }
@@ -371,6 +395,10 @@ void CRenderManager::PreInit()
 
   m_QueueSize   = 2;
   m_QueueSkip   = 0;
+  {
+    CSingleLock lock2(m_presentlock);
+    m_frameTiming.Clear();
+  }
   m_presentstep = PRESENT_IDLE;
   m_bRenderGUI = true;
 
@@ -396,6 +424,12 @@ void CRenderManager::UnInit()
 
   DeleteRenderer();
 
+  if (CServiceBroker::GetLogging().CanLogComponent(LOGAVTIMING))
+  {
+    CSingleLock lock2(m_presentlock);
+    m_frameTiming.Export("special://logpath/frametiming.csv");
+  }
+
   m_renderState = STATE_UNCONFIGURED;
   m_width = 0;
   m_height = 0;
@@ -695,9 +729,14 @@ void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
   if (!gui && m_pRenderer->IsGuiLayer())
     return;
 
+  // the renderers set up their own GL state, so GUI textures queued so far must be drawn first
+  CServiceBroker::GetRenderSystem()->FlushGUIBatches();
+
+  float renderTime = -1.0f;
   if (!gui || m_pRenderer->IsGuiLayer())
   {
     SPresent& m = m_Queue[m_presentsource];
+    int64_t start = CurrentHostCounter();
 
     if( m.presentmethod == PRESENT_METHOD_BOB )
       PresentFields(clear, flags, alpha);
@@ -705,6 +744,8 @@ void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
       PresentBlend(clear, flags, alpha);
     else
       PresentSingle(clear, flags, alpha);
+
+    renderTime = static_cast<float>(CurrentHostCounter() - start) * 1000.0f / CurrentHostFrequency();
   }
 
   if (gui)
@@ -723,6 +764,7 @@ void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
       if (m_renderDebugVideo)
       {
         DEBUG_INFO_VIDEO video = m_pRenderer->GetDebugInfo(m_presentsource);
+        video.overlays = m_overlays.GetCacheInfo();
         DEBUG_INFO_RENDER render = CServiceBroker::GetWinSystem()->GetDebugInfo();
 
         m_debugRenderer.SetInfo(video, render);
@@ -736,8 +778,10 @@ void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
         double refreshrate, clockspeed;
         int missedvblanks;
         info.vsync =
-            StringUtils::Format("VSyncOff: %.1f latency: %.3f  ", m_clockSync.m_syncOffset / 1000,
-                                DVD_TIME_TO_MSEC(m_displayLatency) / 1000.0f);
+            StringUtils::Format("VSyncOff: %.1f latency: %.3f queue: %d jitter: %.1f  ",
+                                m_clockSync.m_syncOffset / 1000,
+                                DVD_TIME_TO_MSEC(m_displayLatency) / 1000.0f,
+                                m_queueDepth.GetDepth(), m_queueDepth.GetJitter());
         if (m_dvdClock.GetClockInfo(missedvblanks, clockspeed, refreshrate))
         {
           info.vsync += StringUtils::Format("VSync: refresh:%.3f missed:%i speed:%.3f%%",
@@ -759,6 +803,20 @@ void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
 
   { CSingleLock lock(m_presentlock);
 
+    if (renderTime >= 0.0f && m.timing.queued && !m.timing.rendered)
+    {
+      m.timing.rendered = XbmcThreads::SystemClockMillis();
+      m.timing.renderTime = renderTime;
+    }
+
+    if (renderTime >= 0.0f)
+    {
+      if (m_renderTime > 0.0)
+        m_renderTime += (renderTime - m_renderTime) / 16.0;
+      else
+        m_renderTime = renderTime;
+    }
+
     if (m_presentstep == PRESENT_FRAME)
     {
       if (m.presentmethod == PRESENT_METHOD_BOB)
@@ -919,7 +977,7 @@ bool CRenderManager::AddVideoPicture(const VideoPicture& picture, volatile std::
 {
   CSingleLock lock(m_presentlock);
 
-  if (m_free.empty())
+  if (!HasFreeBuffer())
     return false;
 
   int index = m_free.front();
@@ -977,6 +1035,9 @@ bool CRenderManager::AddVideoPicture(const VideoPicture& picture, volatile std::
   m.presentfield = displayField;
   m.presentmethod = presentmethod;
   m.pts = picture.pts;
+  m.timing = {};
+  m.timing.pts = picture.pts;
+  m.timing.queued = XbmcThreads::SystemClockMillis();
   m_queued.push_back(m_free.front());
   m_free.pop_front();
   m_playerPort->UpdateRenderBuffers(m_queued.size(), m_discard.size(), m_free.size());
@@ -1010,11 +1071,22 @@ bool CRenderManager::AddVideoPicture(const VideoPicture& picture, volatile std::
   return true;
 }
 
+bool CRenderManager::HasFreeBuffer() const
+{
+  // caller holds m_presentlock
+  if (m_free.empty())
+    return false;
+
+  // queued, waiting for release and on screen, fill only up to the current queue depth
+  const int used = m_QueueSize - static_cast<int>(m_free.size());
+  return used < std::max(m_queueDepth.GetDepth(), 2);
+}
+
 void CRenderManager::AddOverlay(CDVDOverlay* o, double pts)
 {
   int idx;
   { CSingleLock lock(m_presentlock);
-    if (m_free.empty())
+    if (!HasFreeBuffer())
       return;
     idx = m_free.front();
   }
@@ -1069,7 +1141,7 @@ int CRenderManager::WaitForBuffer(volatile std::atomic_bool&bStop, int timeout)
   }
 
   XbmcThreads::EndTime endtime(timeout);
-  while(m_free.empty())
+  while (!HasFreeBuffer())
   {
     m_presentevent.wait(lock, std::min(50, timeout));
     if (endtime.IsTimePast() || bStop)
@@ -1098,7 +1170,10 @@ void CRenderManager::PrepareNextRender()
   if (!m_showVideo && !m_forceNext)
     return;
 
-  double frameOnScreen = m_dvdClock.GetClock();
+  // the frame rendered now is shown at the next vblank, predict the clock then if possible
+  double frameOnScreen;
+  if (!m_dvdClock.GetNextVblankClock(frameOnScreen))
+    frameOnScreen = m_dvdClock.GetClock();
   double frametime = 1.0 / CServiceBroker::GetWinSystem()->GetGfxContext().GetFPS() * DVD_TIME_BASE;
 
   m_displayLatency = DVD_MSEC_TO_TIME(m_latencyTweak + CServiceBroker::GetWinSystem()->GetGfxContext().GetDisplayLatency() - m_videoDelay - CServiceBroker::GetWinSystem()->GetFrameLatencyAdjustment());
@@ -1165,6 +1240,7 @@ void CRenderManager::PrepareNextRender()
       if (m_presentsourcePast >= 0)
       {
         m_discard.push_back(m_presentsourcePast);
+        m_Queue[m_presentsourcePast].timing.skipped = true;
         m_QueueSkip++;
       }
       m_presentsourcePast = m_queued.front();
@@ -1173,10 +1249,15 @@ void CRenderManager::PrepareNextRender()
 
     int lateframes = static_cast<int>((renderPts - m_Queue[idx].pts) * m_fps / DVD_TIME_BASE);
     if (lateframes)
+    {
       m_lateframes += lateframes;
+      m_queueDepth.AddLateFrame();
+    }
     else
       m_lateframes = 0;
 
+    m_Queue[idx].timing.presented = XbmcThreads::SystemClockMillis();
+
     m_presentstep = PRESENT_FLIP;
     m_discard.push_back(m_presentsource);
     m_presentsource = idx;
@@ -1194,6 +1275,7 @@ void CRenderManager::PrepareNextRender()
     m_presentsource = m_queued.front();
     m_queued.pop_front();
     m_presentpts = m_Queue[m_presentsource].pts - m_displayLatency - frametime / 2;
+    m_Queue[m_presentsource].timing.presented = XbmcThreads::SystemClockMillis();
     m_presentevent.notifyAll();
   }
 }
@@ -1223,6 +1305,12 @@ bool CRenderManager::GetStats(int &lateframes, double &pts, int &queued, int &di
   return true;
 }
 
+double CRenderManager::GetRenderTime()
+{
+  CSingleLock lock(m_presentlock);
+  return m_renderTime;
+}
+
 void CRenderManager::CheckEnableClockSync()
 {
   // refresh rate can be a multiple of video fps
@@ -10,6 +10,8 @@
 
 #include "DVDClock.h"
 #include "DebugRenderer.h"
+#include "FrameTimingTrace.h"
+#include "RenderQueueDepth.h"
 #include "cores/VideoPlayer/VideoRenderers/BaseRenderer.h"
 #include "cores/VideoPlayer/VideoRenderers/OverlayRenderer.h"
 #include "cores/VideoSettings.h"
@@ -104,6 +106,11 @@ public:
    */
   bool GetStats(int &lateframes, double &pts, int &queued, int &discard);
 
+  /**
+   * Average time in ms it takes to render a frame
+   */
+  double GetRenderTime();
+
   /**
    * Video player call this on flush in oder to discard any queued frames
    */
@@ -131,6 +138,11 @@ protected:
 
   void UpdateLatencyTweak();
   void CheckEnableClockSync();
+  /**
+   * Whether the player may fill another buffer, the adaptive queue depth limits
+   * how many are in use. Must be called with m_presentlock held.
+   */
+  bool HasFreeBuffer() const;
 
   CBaseRenderer *m_pRenderer = nullptr;
   OVERLAY::CRenderer m_overlays;
@@ -180,12 +192,16 @@ protected:
 
   int m_QueueSize = 2;
   int m_QueueSkip = 0;
+  CRenderQueueDepth m_queueDepth; // number of buffers used out of m_QueueSize
+  unsigned int m_lastFrameMove = 0;
+  CFrameTimingTrace m_frameTiming;
 
   struct SPresent
   {
     double         pts;
     EFIELDSYNC     presentfield;
     EPRESENTMETHOD presentmethod;
+    CFrameTimingTrace::Frame timing;
   } m_Queue[NUM_BUFFERS];
 
   std::deque<int> m_free;
@@ -204,6 +220,7 @@ protected:
 
   int m_lateframes = -1;
   double m_presentpts = 0.0;
+  double m_renderTime = 0.0;
   EPRESENTSTEP m_presentstep = PRESENT_IDLE;
   XbmcThreads::EndTime m_presentTimer;
   bool m_forceNext = false;
@@ -0,0 +1,116 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "RenderQueueDepth.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+// weight of a new render interval in the running mean and variance
+constexpr double INTERVAL_WEIGHT = 1.0 / 32.0;
+// intervals longer than this are pauses of playback, not hiccups
+constexpr double MAX_INTERVAL = 1000.0;
+// render intervals needed before the variance is trusted
+constexpr int MIN_SAMPLES = 16;
+} // namespace
+
+constexpr int CRenderQueueDepth::SHRINK_RENDERS;
+constexpr int CRenderQueueDepth::LATE_DECAY_RENDERS;
+
+CRenderQueueDepth::CRenderQueueDepth()
+{
+  Reset(2, 2);
+}
+
+void CRenderQueueDepth::Reset(int minDepth, int maxDepth)
+{
+  m_minDepth = std::max(minDepth, 2);
+  m_maxDepth = std::max(maxDepth, m_minDepth);
+  m_depth = m_minDepth;
+  m_mean = 0.0;
+  m_variance = 0.0;
+  m_samples = 0;
+  m_lateDepth = 0;
+  m_rendersSinceLate = 0;
+  m_rendersBelow = 0;
+}
+
+void CRenderQueueDepth::SetFrameTimes(double frameTime, double refreshTime)
+{
+  m_frameTime = frameTime;
+  m_refreshTime = refreshTime;
+}
+
+double CRenderQueueDepth::GetJitter() const
+{
+  return std::sqrt(m_variance);
+}
+
+void CRenderQueueDepth::AddRenderInterval(double interval)
+{
+  if (interval <= 0.0 || interval > MAX_INTERVAL)
+    return;
+
+  if (m_samples == 0)
+  {
+    m_mean = interval;
+    m_variance = 0.0;
+  }
+  else
+  {
+    const double diff = interval - m_mean;
+    m_mean += INTERVAL_WEIGHT * diff;
+    m_variance = (1.0 - INTERVAL_WEIGHT) * (m_variance + INTERVAL_WEIGHT * diff * diff);
+  }
+  m_samples++;
+
+  if (m_lateDepth > 0 && ++m_rendersSinceLate >= LATE_DECAY_RENDERS)
+  {
+    m_lateDepth--;
+    m_rendersSinceLate = 0;
+  }
+
+  Update();
+}
+
+void CRenderQueueDepth::AddLateFrame()
+{
+  m_lateDepth = std::min(m_lateDepth + 1, m_maxDepth - m_minDepth);
+  m_rendersSinceLate = 0;
+  Update();
+}
+
+void CRenderQueueDepth::Update()
+{
+  int needed = m_minDepth + m_lateDepth;
+
+  // a render that misses a vblank delays all frames behind it, every frame time of delay has
+  // to be covered by a queued frame. intervals scatter around the refresh by the resolution of
+  // the clock, so only those longer than one and a half refreshes count
+  if (m_samples >= MIN_SAMPLES && m_frameTime > 0.0)
+  {
+    const double delay = m_mean + 3.0 * GetJitter() - 1.5 * std::max(m_refreshTime, 0.0);
+    if (delay > 0.0)
+      needed += static_cast<int>(std::ceil(delay / m_frameTime));
+  }
+
+  needed = std::min(std::max(needed, m_minDepth), m_maxDepth);
+
+  if (needed >= m_depth)
+  {
+    m_depth = needed;
+    m_rendersBelow = 0;
+  }
+  else if (++m_rendersBelow >= SHRINK_RENDERS)
+  {
+    m_depth--;
+    m_rendersBelow = 0;
+  }
+}
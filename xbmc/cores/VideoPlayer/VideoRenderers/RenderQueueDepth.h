@@ -0,0 +1,70 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+/*!
+ * \brief Decides how many frames the render queue holds.
+ *
+ * A shallow queue keeps fewer decoded frames (and hardware surfaces) waiting, a deep queue lets
+ * playback ride out hiccups of the render thread. The depth grows with the variance of the time
+ * between two renders relative to the display refresh, and with frames that were presented late.
+ * It shrinks again once renders have been regular for a while.
+ */
+class CRenderQueueDepth
+{
+public:
+  /*! \brief Renders needed below the current depth before it shrinks by one frame */
+  static constexpr int SHRINK_RENDERS = 300;
+  /*! \brief Renders without late frames before one frame added for late frames is removed */
+  static constexpr int LATE_DECAY_RENDERS = 600;
+
+  CRenderQueueDepth();
+
+  /*!
+   * \brief Start over with a new range of depths, the depth starts at the minimum
+   */
+  void Reset(int minDepth, int maxDepth);
+
+  /*!
+   * \brief Set the duration of a video frame and of a display refresh in ms
+   */
+  void SetFrameTimes(double frameTime, double refreshTime);
+
+  /*!
+   * \brief Account the time in ms since the previous render
+   */
+  void AddRenderInterval(double interval);
+
+  /*!
+   * \brief Account a frame that was presented late or skipped
+   */
+  void AddLateFrame();
+
+  int GetDepth() const { return m_depth; }
+  double GetMeanInterval() const { return m_mean; }
+  double GetJitter() const;
+
+private:
+  void Update();
+
+  int m_minDepth = 2;
+  int m_maxDepth = 2;
+  int m_depth = 2;
+  double m_frameTime = 0.0;
+  double m_refreshTime = 0.0;
+
+  // exponentially weighted mean and variance of the render interval
+  double m_mean = 0.0;
+  double m_variance = 0.0;
+  int m_samples = 0;
+
+  int m_lateDepth = 0; //!< frames added for late frames
+  int m_rendersSinceLate = 0;
+  int m_rendersBelow = 0; //!< consecutive renders the needed depth was below the current one
+};
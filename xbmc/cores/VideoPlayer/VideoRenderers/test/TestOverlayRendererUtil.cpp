@@ -0,0 +1,270 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDCodecs/Overlay/DVDOverlayImage.h"
+#include "cores/VideoPlayer/VideoRenderers/OverlayRendererUtil.h"
+#include "utils/TimeUtils.h"
+
+#include <string>
+#include <vector>
+
+#include <ass/ass.h>
+#include <gtest/gtest.h>
+
+using namespace OVERLAY;
+
+namespace
+{
+
+/*!
+ * \brief Images of a typeset karaoke line as libass returns them: glyph, outline and shadow
+ * bitmaps of every syllable, the whole line sliding across the frame
+ */
+class CKaraokeLine
+{
+public:
+  static constexpr int SYLLABLES = 40;
+  static constexpr int GLYPH_W = 24;
+  static constexpr int GLYPH_H = 36;
+
+  CKaraokeLine() : m_bitmap(GLYPH_W * GLYPH_H, 0x80), m_images(SYLLABLES * 3)
+  {
+    for (size_t i = 0; i < m_images.size(); i++)
+    {
+      ASS_Image& img = m_images[i];
+      img.w = GLYPH_W - static_cast<int>(i % 3) * 2;
+      img.h = GLYPH_H - static_cast<int>(i % 3) * 2;
+      img.stride = GLYPH_W;
+      img.bitmap = m_bitmap.data();
+      img.color = 0xffffff00 + static_cast<uint32_t>(i % 3);
+      img.next = i + 1 < m_images.size() ? &m_images[i + 1] : nullptr;
+    }
+    MoveTo(0);
+  }
+
+  void MoveTo(int x)
+  {
+    for (size_t i = 0; i < m_images.size(); i++)
+    {
+      m_images[i].dst_x = x + static_cast<int>(i / 3) * GLYPH_W;
+      m_images[i].dst_y = 900 + static_cast<int>(i % 3);
+    }
+  }
+
+  ASS_Image* GetImages() { return m_images.data(); }
+
+private:
+  std::vector<unsigned char> m_bitmap;
+  std::vector<ASS_Image> m_images;
+};
+
+std::vector<SQuad> ToVector(const SQuads& quads)
+{
+  return std::vector<SQuad>(quads.quad, quads.quad + quads.count);
+}
+
+/*!
+ * \brief A pgs like palette image: a transparent frame with a block of text near the bottom.
+ * Dvb and teletext subtitles have palettes of 16 colors or less.
+ */
+CDVDOverlayImage* CreatePaletteImage(
+    int width, int height, int boxX, int boxY, int boxW, int boxH, int colors = 256)
+{
+  CDVDOverlayImage* image = new CDVDOverlayImage();
+  image->width = width;
+  image->height = height;
+  image->linesize = width + 7;
+  image->data = static_cast<uint8_t*>(malloc(image->linesize * height));
+  memset(image->data, 0xff, image->linesize * height);
+
+  image->palette_colors = colors;
+  image->palette = static_cast<uint32_t*>(malloc(colors * sizeof(uint32_t)));
+  for (int i = 0; i < colors; i++)
+  {
+    const uint32_t alpha = i == 0xff ? 0 : (i * 7) & 0xff;
+    image->palette[i] = alpha << PIXEL_ASHIFT | (i & 0xff) << PIXEL_RSHIFT |
+                        ((i * 3) & 0xff) << PIXEL_GSHIFT | ((i * 5) & 0xff) << PIXEL_BSHIFT;
+  }
+
+  for (int y = boxY; y < boxY + boxH; y++)
+    for (int x = boxX; x < boxX + boxW; x++)
+      image->data[y * image->linesize + x] = static_cast<uint8_t>((x * 31 + y * 17) % (colors - 1));
+  // index 0 has no alpha either, part of the box that isn't visible
+  image->data[boxY * image->linesize + boxX] = 0;
+
+  return image;
+}
+
+uint32_t ExpectedPixel(const CDVDOverlayImage* image, int x, int y)
+{
+  const uint32_t color = image->palette[image->data[y * image->linesize + x]];
+  const int a = (color >> PIXEL_ASHIFT) & 0xff;
+  const int r = (color >> PIXEL_RSHIFT) & 0xff;
+  const int g = (color >> PIXEL_GSHIFT) & 0xff;
+  const int b = (color >> PIXEL_BSHIFT) & 0xff;
+  return a << PIXEL_ASHIFT | (r * a / 255) << PIXEL_RSHIFT | (g * a / 255) << PIXEL_GSHIFT |
+         (b * a / 255) << PIXEL_BSHIFT;
+}
+
+} // namespace
+
+TEST(TestOverlayRendererUtil, ConvertQuad)
+{
+  CKaraokeLine line;
+  SQuads quads;
+  ASSERT_TRUE(convert_quad(line.GetImages(), quads, 1920));
+
+  EXPECT_EQ(CKaraokeLine::SYLLABLES * 3, quads.count);
+  EXPECT_LE(quads.size_x, 1920);
+  for (int i = 0; i < quads.count; i++)
+  {
+    // every bitmap lies within the atlas
+    EXPECT_LE(quads.quad[i].u + quads.quad[i].w, quads.size_x);
+    EXPECT_LE(quads.quad[i].v + quads.quad[i].h, quads.size_y);
+  }
+
+  // nothing visible
+  SQuads empty;
+  EXPECT_FALSE(convert_quad(nullptr, empty, 1920));
+}
+
+TEST(TestOverlayRendererUtil, UpdatePositions)
+{
+  CKaraokeLine line;
+  SQuads quads;
+  ASSERT_TRUE(convert_quad(line.GetImages(), quads, 1920));
+
+  line.MoveTo(-100);
+  std::vector<SQuad> moved = ToVector(quads);
+  ASSERT_TRUE(update_quad_positions(line.GetImages(), moved));
+
+  // same as packing the moved images again, apart from the atlas
+  SQuads repacked;
+  ASSERT_TRUE(convert_quad(line.GetImages(), repacked, 1920));
+  ASSERT_EQ(static_cast<size_t>(repacked.count), moved.size());
+  for (int i = 0; i < repacked.count; i++)
+  {
+    EXPECT_EQ(repacked.quad[i].x, moved[i].x);
+    EXPECT_EQ(repacked.quad[i].y, moved[i].y);
+    EXPECT_EQ(quads.quad[i].u, moved[i].u);
+    EXPECT_EQ(quads.quad[i].v, moved[i].v);
+  }
+
+  // images that don't match the atlas
+  std::vector<SQuad> fewer(moved.begin(), moved.end() - 1);
+  EXPECT_FALSE(update_quad_positions(line.GetImages(), fewer));
+  line.GetImages()->w--;
+  std::vector<SQuad> resized = ToVector(quads);
+  EXPECT_FALSE(update_quad_positions(line.GetImages(), resized));
+}
+
+TEST(TestOverlayRendererUtil, ReplayMovingLine)
+{
+  // ten seconds of a line scrolling at 60 fps, the way karaoke and sign typesetting move
+  constexpr int FRAMES = 600;
+  CKaraokeLine line;
+
+  int64_t start = CurrentHostCounter();
+  for (int frame = 0; frame < FRAMES; frame++)
+  {
+    line.MoveTo(1920 - frame * 4);
+    SQuads quads;
+    ASSERT_TRUE(convert_quad(line.GetImages(), quads, 1920));
+  }
+  const int64_t repack = CurrentHostCounter() - start;
+
+  SQuads atlas;
+  ASSERT_TRUE(convert_quad(line.GetImages(), atlas, 1920));
+  std::vector<SQuad> quads = ToVector(atlas);
+  start = CurrentHostCounter();
+  for (int frame = 0; frame < FRAMES; frame++)
+  {
+    line.MoveTo(1920 - frame * 4);
+    ASSERT_TRUE(update_quad_positions(line.GetImages(), quads));
+  }
+  const int64_t update = CurrentHostCounter() - start;
+
+  const double usPerTick = 1000000.0 / CurrentHostFrequency();
+  RecordProperty("repack_us", std::to_string(static_cast<int64_t>(repack * usPerTick)));
+  RecordProperty("update_us", std::to_string(static_cast<int64_t>(update * usPerTick)));
+}
+
+class TestOverlayRendererUtilPalette : public testing::TestWithParam<int>
+{
+};
+
+TEST_P(TestOverlayRendererUtilPalette, ConvertPaletteImage)
+{
+  CDVDOverlayImage* image = CreatePaletteImage(333, 120, 37, 50, 201, 41, GetParam());
+
+  int min_x, max_x, min_y, max_y;
+  uint32_t* rgba = convert_rgba(image, true, min_x, max_x, min_y, max_y);
+  ASSERT_NE(nullptr, rgba);
+
+  // cropped to the visible pixels, the transparent corner of the box doesn't count
+  EXPECT_EQ(37, min_x);
+  EXPECT_EQ(37 + 201, max_x);
+  EXPECT_EQ(50, min_y);
+  EXPECT_EQ(50 + 41, max_y);
+
+  const int width = max_x - min_x;
+  for (int y = min_y; y < max_y; y++)
+  {
+    for (int x = min_x; x < max_x; x++)
+    {
+      ASSERT_EQ(ExpectedPixel(image, x, y), rgba[(y - min_y) * width + x - min_x])
+          << "at " << x << "," << y;
+    }
+  }
+
+  free(rgba);
+  image->Release();
+}
+
+INSTANTIATE_TEST_SUITE_P(TestOverlayRendererUtil,
+                         TestOverlayRendererUtilPalette,
+                         testing::Values(256, 16));
+
+TEST(TestOverlayRendererUtil, ConvertTransparentImage)
+{
+  CDVDOverlayImage* image = CreatePaletteImage(64, 64, 0, 0, 0, 0);
+
+  int min_x, max_x, min_y, max_y;
+  uint32_t* rgba = convert_rgba(image, true, min_x, max_x, min_y, max_y);
+  ASSERT_NE(nullptr, rgba);
+
+  // a single transparent pixel
+  EXPECT_EQ(1, (max_x - min_x) * (max_y - min_y));
+  EXPECT_EQ(0u, (rgba[0] >> PIXEL_ASHIFT) & 0xff);
+
+  free(rgba);
+  image->Release();
+}
+
+TEST(TestOverlayRendererUtil, ReplayUhdPaletteImage)
+{
+  // a line of pgs subtitles on a 2160p frame, a new image every few frames
+  constexpr int IMAGES = 20;
+  CDVDOverlayImage* image = CreatePaletteImage(3840, 2160, 800, 1800, 2240, 200);
+
+  int64_t start = CurrentHostCounter();
+  for (int i = 0; i < IMAGES; i++)
+  {
+    int min_x, max_x, min_y, max_y;
+    uint32_t* rgba = convert_rgba(image, true, min_x, max_x, min_y, max_y);
+    ASSERT_NE(nullptr, rgba);
+    ASSERT_EQ(2240, max_x - min_x);
+    ASSERT_EQ(200, max_y - min_y);
+    free(rgba);
+  }
+  const int64_t elapsed = CurrentHostCounter() - start;
+
+  RecordProperty("convert_us",
+                 std::to_string(static_cast<int64_t>(elapsed * 1000000.0 / CurrentHostFrequency() / IMAGES)));
+  image->Release();
+}
@@ -0,0 +1,144 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDClock.h"
+#include "cores/VideoPlayer/DVDCodecs/Video/DVDVideoCodec.h"
+#include "cores/VideoPlayer/VideoRenderers/RenderManager.h"
+#include "threads/SingleLock.h"
+
+#include <atomic>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+class CTestRenderer : public CBaseRenderer
+{
+public:
+  bool Configure(const VideoPicture& picture, float fps, unsigned int orientation) override
+  {
+    return true;
+  }
+  bool IsConfigured() override { return true; }
+  void AddVideoPicture(const VideoPicture& picture, int index) override {}
+  void UnInit() override {}
+  void Update() override {}
+  void RenderUpdate(
+      int index, int index2, bool clear, unsigned int flags, unsigned int alpha) override
+  {
+  }
+  bool RenderCapture(CRenderCapture* capture) override { return false; }
+  bool ConfigChanged(const VideoPicture& picture) override { return false; }
+  bool SupportsMultiPassRendering() override { return false; }
+  bool Supports(ESCALINGMETHOD method) override { return false; }
+};
+
+class CTestRenderMsg : public IRenderMsg
+{
+protected:
+  void VideoParamsChange() override {}
+  void GetDebugInfo(std::string& audio, std::string& video, std::string& general) override {}
+  void UpdateClockSync(bool enabled) override {}
+  void UpdateRenderInfo(CRenderInfo& info) override {}
+  void UpdateRenderBuffers(int queued, int discard, int free) override {}
+  void UpdateGuiRender(bool gui) override {}
+  void UpdateVideoRender(bool video) override {}
+  CVideoSettings GetVideoSettings() override { return CVideoSettings(); }
+};
+
+/*!
+ * \brief Render manager with the buffers set up the way Configure() does, without a render thread
+ */
+class CTestRenderManager : public CRenderManager
+{
+public:
+  CTestRenderManager(CDVDClock& clock, IRenderMsg* player) : CRenderManager(clock, player) {}
+
+  void Setup(int queueSize, int depth)
+  {
+    CSingleLock lock(m_presentlock);
+    m_pRenderer = new CTestRenderer();
+    m_QueueSize = queueSize;
+    m_queueDepth.Reset(depth, queueSize);
+    m_free.clear();
+    for (int i = 1; i < m_QueueSize; i++)
+      m_free.push_back(i);
+  }
+
+  void AddLateFrame()
+  {
+    CSingleLock lock(m_presentlock);
+    m_queueDepth.AddLateFrame();
+  }
+
+  // the render thread shows the next frame and releases the previous one
+  void Present()
+  {
+    CSingleLock lock(m_presentlock);
+    m_free.push_back(m_presentsource);
+    m_presentsource = m_queued.front();
+    m_queued.pop_front();
+  }
+
+  int GetDepth()
+  {
+    CSingleLock lock(m_presentlock);
+    return m_queueDepth.GetDepth();
+  }
+};
+
+class TestRenderManager : public testing::Test
+{
+protected:
+  TestRenderManager() : m_renderManager(m_clock, &m_renderMsg) {}
+
+  // add pictures until the render manager refuses them
+  int Fill()
+  {
+    int count = 0;
+    while (m_renderManager.AddVideoPicture(m_picture, m_stop, VS_INTERLACEMETHOD_NONE, false))
+      count++;
+    return count;
+  }
+
+  CDVDClock m_clock;
+  CTestRenderMsg m_renderMsg;
+  CTestRenderManager m_renderManager;
+  VideoPicture m_picture;
+  std::atomic_bool m_stop{false};
+};
+
+} // namespace
+
+TEST_F(TestRenderManager, FillsUpToQueueDepth)
+{
+  // six buffers, three in use at most: the one on screen and two queued
+  m_renderManager.Setup(6, 3);
+  EXPECT_EQ(2, Fill());
+
+  // a presented frame frees a buffer
+  m_renderManager.Present();
+  EXPECT_EQ(1, Fill());
+}
+
+TEST_F(TestRenderManager, FollowsQueueDepth)
+{
+  m_renderManager.Setup(6, 3);
+  EXPECT_EQ(2, Fill());
+
+  // late frames deepen the queue, up to the buffers of the renderer
+  m_renderManager.AddLateFrame();
+  ASSERT_EQ(4, m_renderManager.GetDepth());
+  EXPECT_EQ(1, Fill());
+
+  for (int i = 0; i < 10; i++)
+    m_renderManager.AddLateFrame();
+  ASSERT_EQ(6, m_renderManager.GetDepth());
+  EXPECT_EQ(2, Fill());
+}
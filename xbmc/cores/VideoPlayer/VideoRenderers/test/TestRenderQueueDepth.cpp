@@ -0,0 +1,109 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/VideoRenderers/FrameTimingTrace.h"
+#include "cores/VideoPlayer/VideoRenderers/RenderQueueDepth.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+// 24p on a 60Hz display
+constexpr double FRAME_TIME = 1000.0 / 24.0;
+constexpr double REFRESH_TIME = 1000.0 / 60.0;
+
+class TestRenderQueueDepth : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_depth.Reset(3, 6);
+    m_depth.SetFrameTimes(FRAME_TIME, REFRESH_TIME);
+  }
+
+  void Render(int count, double interval)
+  {
+    for (int i = 0; i < count; i++)
+      m_depth.AddRenderInterval(interval);
+  }
+
+  CRenderQueueDepth m_depth;
+};
+
+} // namespace
+
+TEST_F(TestRenderQueueDepth, RegularRendersKeepMinimum)
+{
+  EXPECT_EQ(3, m_depth.GetDepth());
+  Render(1000, REFRESH_TIME);
+  EXPECT_EQ(3, m_depth.GetDepth());
+  EXPECT_NEAR(REFRESH_TIME, m_depth.GetMeanInterval(), 0.01);
+  EXPECT_NEAR(0.0, m_depth.GetJitter(), 0.01);
+}
+
+TEST_F(TestRenderQueueDepth, JitterDeepensAndRecovers)
+{
+  // every fourth render misses two refreshes
+  for (int i = 0; i < 100; i++)
+  {
+    Render(3, REFRESH_TIME);
+    Render(1, 3 * REFRESH_TIME);
+  }
+  const int depth = m_depth.GetDepth();
+  EXPECT_GT(depth, 3);
+  EXPECT_LE(depth, 6);
+
+  // regular again, the queue gets shallow frame by frame
+  Render(CRenderQueueDepth::SHRINK_RENDERS / 2, REFRESH_TIME);
+  EXPECT_EQ(depth, m_depth.GetDepth());
+  Render(CRenderQueueDepth::SHRINK_RENDERS * 10, REFRESH_TIME);
+  EXPECT_EQ(3, m_depth.GetDepth());
+}
+
+TEST_F(TestRenderQueueDepth, LateFrames)
+{
+  m_depth.AddLateFrame();
+  EXPECT_EQ(4, m_depth.GetDepth());
+  for (int i = 0; i < 10; i++)
+    m_depth.AddLateFrame();
+  EXPECT_EQ(6, m_depth.GetDepth());
+
+  Render(CRenderQueueDepth::LATE_DECAY_RENDERS * 3 + CRenderQueueDepth::SHRINK_RENDERS * 3,
+         REFRESH_TIME);
+  EXPECT_EQ(3, m_depth.GetDepth());
+}
+
+TEST_F(TestRenderQueueDepth, IgnoresPauses)
+{
+  Render(100, REFRESH_TIME);
+  m_depth.AddRenderInterval(5000.0);
+  m_depth.AddRenderInterval(0.0);
+  EXPECT_NEAR(REFRESH_TIME, m_depth.GetMeanInterval(), 0.01);
+  EXPECT_EQ(3, m_depth.GetDepth());
+}
+
+TEST(TestFrameTimingTrace, KeepsLatestFrames)
+{
+  CFrameTimingTrace trace;
+  const size_t count = CFrameTimingTrace::CAPACITY + 10;
+  for (size_t i = 0; i < count; i++)
+  {
+    CFrameTimingTrace::Frame frame;
+    frame.pts = static_cast<double>(i);
+    trace.Add(frame);
+  }
+
+  std::vector<CFrameTimingTrace::Frame> frames = trace.GetFrames();
+  ASSERT_EQ(CFrameTimingTrace::CAPACITY, frames.size());
+  EXPECT_EQ(10.0, frames.front().pts);
+  EXPECT_EQ(static_cast<double>(count - 1), frames.back().pts);
+
+  trace.Clear();
+  EXPECT_TRUE(trace.GetFrames().empty());
+}
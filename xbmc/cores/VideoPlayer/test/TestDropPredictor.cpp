@@ -0,0 +1,241 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDCodecs/Video/DVDVideoCodec.h"
+#include "cores/VideoPlayer/DropPredictor.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+constexpr double FRAME_TIME = DVD_MSEC_TO_TIME(40);
+constexpr double RENDER_TIME = DVD_MSEC_TO_TIME(4);
+
+struct SFrame
+{
+  int type;
+  double cost;
+};
+
+/*!
+ * \brief Generate the decode times of a 25 fps stream with one second gops, I P B B B P B B B ...
+ * The costs of the types are modelled on 1080p hevc decoded in software on a quad core a9, the
+ * scenes are scaled by how hard they are to decode.
+ */
+std::vector<SFrame> GenerateTrace(const std::vector<double>& scenes)
+{
+  std::vector<SFrame> trace;
+  for (double scale : scenes)
+  {
+    for (int i = 0; i < 24; i++)
+    {
+      SFrame frame;
+      if (i == 0)
+        frame = {FRAME_TYPE_I, DVD_MSEC_TO_TIME(60)};
+      else if (i % 4 == 1)
+        frame = {FRAME_TYPE_P, DVD_MSEC_TO_TIME(42)};
+      else
+        frame = {FRAME_TYPE_B, DVD_MSEC_TO_TIME(30)};
+
+      // some noise, the same for every replay
+      frame.cost = frame.cost * scale * (0.9 + 0.2 * ((i * 7919) % 13) / 12.0);
+      trace.push_back(frame);
+    }
+  }
+  return trace;
+}
+
+struct SReplay
+{
+  int lateRef = 0; //!< reference frames presented late
+  int late = 0; //!< frames presented late
+  int skipped = 0; //!< frames skipped in the decoder
+};
+
+/*!
+ * \brief Decode a trace on the video thread against a display running at the frame rate with
+ * a render queue of three frames
+ */
+SReplay Replay(const std::vector<SFrame>& trace, CDropPredictor* predictor)
+{
+  constexpr int QUEUE = 3;
+  SReplay replay;
+  double now = 0.0;
+  double queued = DVD_NOPTS_VALUE; //!< pts of the last frame queued for render
+  const double start = QUEUE * FRAME_TIME; //!< the display starts once the queue is full
+
+  for (size_t i = 0; i < trace.size(); i++)
+  {
+    const SFrame& frame = trace[i];
+    const double pts = i * FRAME_TIME;
+
+    // the render queue is full, wait for a frame to be presented
+    if (queued != DVD_NOPTS_VALUE)
+      now = std::max(now, start + queued - QUEUE * FRAME_TIME);
+
+    CDropPredictor::Decision decision = CDropPredictor::DECODE;
+    if (predictor)
+    {
+      const double displayed = std::max(0.0, now - start);
+      decision = predictor->Predict(pts, queued == DVD_NOPTS_VALUE ? DVD_NOPTS_VALUE
+                                                                 : queued - displayed);
+    }
+
+    if ((decision == CDropPredictor::SKIP_NONREF && frame.type == FRAME_TYPE_B) ||
+        (decision == CDropPredictor::SKIP_GOP && frame.type != FRAME_TYPE_I))
+    {
+      // parsing the header is all there is to do
+      now += DVD_MSEC_TO_TIME(1);
+      replay.skipped++;
+      continue;
+    }
+
+    now += frame.cost;
+    if (predictor)
+      predictor->AddPicture(pts, frame.type, frame.cost, false);
+    queued = pts;
+
+    if (now + RENDER_TIME > start + pts)
+    {
+      replay.late++;
+      if (frame.type != FRAME_TYPE_B)
+        replay.lateRef++;
+    }
+  }
+  return replay;
+}
+
+CDropPredictor CreatePredictor()
+{
+  CDropPredictor predictor;
+  predictor.SetFrameTime(FRAME_TIME);
+  predictor.SetRenderTime(RENDER_TIME);
+  return predictor;
+}
+
+} // namespace
+
+TEST(TestDropPredictor, LearnsCosts)
+{
+  CDropPredictor predictor = CreatePredictor();
+  for (int i = 0; i < CDropPredictor::MIN_PICTURES - 1; i++)
+    predictor.AddPicture(i * FRAME_TIME, i % 2 ? FRAME_TYPE_P : FRAME_TYPE_B, FRAME_TIME * 2, false);
+
+  // nothing is predicted before it knows the stream
+  EXPECT_EQ(CDropPredictor::DECODE, predictor.Predict(0.0, 0.0));
+
+  predictor.AddPicture(0.0, FRAME_TYPE_I, FRAME_TIME * 3, false);
+  EXPECT_DOUBLE_EQ(FRAME_TIME * 3, predictor.GetCost(FRAME_TYPE_I));
+  EXPECT_DOUBLE_EQ(FRAME_TIME * 2, predictor.GetCost(FRAME_TYPE_B));
+  // unknown types count as reference frames
+  EXPECT_DOUBLE_EQ(FRAME_TIME * 2, predictor.GetCost(FRAME_TYPE_UNDEF));
+
+  // skipped pictures don't count
+  predictor.AddPicture(0.0, FRAME_TYPE_B, 0.0, true);
+  EXPECT_DOUBLE_EQ(FRAME_TIME * 2, predictor.GetCost(FRAME_TYPE_B));
+
+  // twice as slow as real time, without a gop length to drop
+  EXPECT_EQ(CDropPredictor::SKIP_NONREF, predictor.Predict(0.0, FRAME_TIME));
+  ASSERT_EQ(1u, predictor.GetLog().size());
+  EXPECT_EQ(CDropPredictor::SKIP_NONREF, predictor.GetLog().back().decision);
+
+  predictor.Flush();
+  EXPECT_EQ(CDropPredictor::DECODE, predictor.GetDecision());
+  predictor.Reset();
+  EXPECT_TRUE(predictor.GetLog().empty());
+}
+
+TEST(TestDropPredictor, ReplayKeepsUp)
+{
+  // decodes faster than real time, nothing to drop
+  const std::vector<SFrame> trace = GenerateTrace({1.0, 1.0, 0.9, 1.0, 1.1});
+  CDropPredictor predictor = CreatePredictor();
+  SReplay replay = Replay(trace, &predictor);
+
+  EXPECT_EQ(0, replay.late);
+  EXPECT_EQ(0, replay.skipped);
+  EXPECT_TRUE(predictor.GetLog().empty());
+}
+
+TEST(TestDropPredictor, ReplayOverload)
+{
+  // a few hard scenes the decoder can't keep up with, unless it skips b frames
+  const std::vector<SFrame> trace = GenerateTrace({1.0, 1.0, 1.4, 1.5, 1.4, 1.0, 1.0});
+
+  SReplay reactive = Replay(trace, nullptr);
+  EXPECT_GT(reactive.lateRef, 0);
+
+  CDropPredictor predictor = CreatePredictor();
+  SReplay predictive = Replay(trace, &predictor);
+  EXPECT_EQ(0, predictive.lateRef);
+  EXPECT_GT(predictive.skipped, 0);
+
+  const std::vector<CDropPredictor::Record> log = predictor.GetLog();
+  ASSERT_FALSE(log.empty());
+  for (const CDropPredictor::Record& record : log)
+    EXPECT_NE(CDropPredictor::SKIP_GOP, record.decision);
+  // it catches up again
+  EXPECT_EQ(CDropPredictor::DECODE, log.back().decision);
+}
+
+TEST(TestDropPredictor, ReplaySevereOverload)
+{
+  // not even the reference frames decode in time, the gop tails go
+  const std::vector<SFrame> trace = GenerateTrace({1.0, 1.0, 4.0, 4.0, 4.0, 1.0, 1.0, 1.0});
+
+  SReplay reactive = Replay(trace, nullptr);
+  CDropPredictor predictor = CreatePredictor();
+  SReplay predictive = Replay(trace, &predictor);
+
+  const std::vector<CDropPredictor::Record> log = predictor.GetLog();
+  EXPECT_TRUE(std::any_of(log.begin(), log.end(), [](const CDropPredictor::Record& record) {
+    return record.decision == CDropPredictor::SKIP_GOP;
+  }));
+  EXPECT_LT(predictive.late, reactive.late / 4);
+}
+
+TEST(TestDropPredictor, ResumesAfterDroppedGop)
+{
+  // one second gops, decoding takes twice as long as real time
+  CDropPredictor predictor = CreatePredictor();
+  for (int i = 0; i <= 25; i++)
+    predictor.AddPicture(i * FRAME_TIME, i % 25 ? FRAME_TYPE_P : FRAME_TYPE_I, FRAME_TIME * 2,
+                         false);
+
+  EXPECT_EQ(CDropPredictor::SKIP_GOP, predictor.Predict(26 * FRAME_TIME, 0.0));
+
+  // a key frame without pts ends it
+  predictor.AddPicture(DVD_NOPTS_VALUE, FRAME_TYPE_I, FRAME_TIME * 2, false);
+  EXPECT_EQ(CDropPredictor::DECODE, predictor.GetDecision());
+
+  // without a key frame it ends after a gop
+  EXPECT_EQ(CDropPredictor::SKIP_GOP, predictor.Predict(27 * FRAME_TIME, 0.0));
+  for (int i = 0; i < 25; i++)
+    EXPECT_EQ(CDropPredictor::SKIP_GOP,
+              predictor.Predict((28 + i) * FRAME_TIME, DVD_SEC_TO_TIME(10)));
+  EXPECT_EQ(CDropPredictor::DECODE, predictor.Predict(53 * FRAME_TIME, DVD_SEC_TO_TIME(10)));
+}
+
+TEST(TestDropPredictor, LogWraps)
+{
+  CDropPredictor predictor = CreatePredictor();
+  for (int i = 0; i < CDropPredictor::MIN_PICTURES; i++)
+    predictor.AddPicture(i * FRAME_TIME, FRAME_TYPE_P, FRAME_TIME * 2, false);
+
+  for (size_t i = 0; i < CDropPredictor::LOG_SIZE + 10; i++)
+    predictor.Predict(i * FRAME_TIME, 0.0);
+
+  const std::vector<CDropPredictor::Record> log = predictor.GetLog();
+  ASSERT_EQ(CDropPredictor::LOG_SIZE, log.size());
+  EXPECT_DOUBLE_EQ(10 * FRAME_TIME, log.front().pts);
+  EXPECT_DOUBLE_EQ((CDropPredictor::LOG_SIZE + 9) * FRAME_TIME, log.back().pts);
+}
@@ -681,6 +681,9 @@ void CDatabase::Close()
     return;
   }
 
+  if (m_batch)
+    CommitBatch();
+
   m_openCount = 0;
   m_multipleExecute = false;
 
@@ -739,6 +742,10 @@ void CDatabase::Interrupt()
 
 void CDatabase::BeginTransaction()
 {
+  // part of the enclosing batch
+  if (m_batch)
+    return;
+
   try
   {
     if (nullptr != m_pDB)
@@ -752,6 +759,9 @@ void CDatabase::BeginTransaction()
 
 bool CDatabase::CommitTransaction()
 {
+  if (m_batch)
+    return true;
+
   try
   {
     if (nullptr != m_pDB)
@@ -769,8 +779,26 @@ void CDatabase::RollbackTransaction()
 {
   try
   {
-    if (nullptr != m_pDB)
+    if (nullptr == m_pDB)
+      return;
+
+    if (!m_batch)
+    {
       m_pDB->rollback_transaction();
+    }
+    else if (m_savepoint)
+    {
+      // only the updates since the savepoint, ReleaseSavepoint() discards the rest
+      m_pDS->exec("ROLLBACK TO SAVEPOINT batch");
+      m_savepointRolledBack = true;
+    }
+    else
+    {
+      CLog::Log(LOGWARNING, "database:rollbacktransaction discarded the current batch");
+      m_pDB->rollback_transaction();
+      m_batch = false;
+      m_batchRolledBack = true;
+    }
   }
   catch (...)
   {
@@ -778,6 +806,75 @@ void CDatabase::RollbackTransaction()
   }
 }
 
+void CDatabase::BeginBatch()
+{
+  if (m_batch)
+    return;
+
+  BeginTransaction();
+  m_batch = true;
+  m_batchRolledBack = false;
+  m_savepoint = false;
+}
+
+bool CDatabase::CommitBatch()
+{
+  if (!m_batch)
+  {
+    // rolled back since BeginBatch()
+    const bool rolledBack = m_batchRolledBack;
+    m_batchRolledBack = false;
+    return !rolledBack;
+  }
+
+  if (m_savepoint)
+    ReleaseSavepoint();
+
+  m_batch = false;
+  return CommitTransaction();
+}
+
+void CDatabase::SetSavepoint()
+{
+  if (!m_batch || nullptr == m_pDB || nullptr == m_pDS)
+    return;
+
+  if (m_savepoint)
+    ReleaseSavepoint();
+
+  try
+  {
+    m_pDS->exec("SAVEPOINT batch");
+    m_savepoint = true;
+    m_savepointRolledBack = false;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "database:setsavepoint failed");
+  }
+}
+
+bool CDatabase::ReleaseSavepoint()
+{
+  if (!m_savepoint)
+    return !m_batchRolledBack;
+
+  m_savepoint = false;
+  try
+  {
+    // discard what followed a rollback as well, the updates belong together
+    if (m_savepointRolledBack)
+      m_pDS->exec("ROLLBACK TO SAVEPOINT batch");
+    m_pDS->exec("RELEASE SAVEPOINT batch");
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "database:releasesavepoint failed");
+    return false;
+  }
+  return !m_savepointRolledBack;
+}
+
 bool CDatabase::CreateDatabase()
 {
   BeginTransaction();
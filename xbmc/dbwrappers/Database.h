@@ -105,6 +105,31 @@ public:
   void BeginTransaction();
   virtual bool CommitTransaction();
   void RollbackTransaction();
+
+  /*! \brief Run the transactions that follow as part of one enclosing transaction.
+   Used to write many small updates (e.g. during a library scan) in one go. A rollback within
+   the batch rolls back to the savepoint set with SetSavepoint(). Without a savepoint it rolls
+   back the whole batch and ends it, CommitBatch() then fails.
+   */
+  void BeginBatch();
+
+  /*! \brief Commit the batch started with BeginBatch().
+   \return true on success, false if the batch was rolled back or the commit failed
+   */
+  bool CommitBatch();
+
+  bool InBatch() const { return m_batch; }
+
+  /*! \brief Mark the point within the batch a rollback returns to, e.g. the start of the
+   updates of one folder.
+   */
+  void SetSavepoint();
+
+  /*! \brief Keep the updates since SetSavepoint() as part of the batch.
+   \return true on success, false if they were rolled back
+   */
+  bool ReleaseSavepoint();
+
   void CopyDB(const std::string& latestDb);
   void DropAnalytics();
 
@@ -208,7 +233,7 @@ public:
    * @brief Commit all queries in the queue.
    * @return True if all queries were executed successfully, false otherwise.
    */
-  bool CommitInsertQueries();
+  virtual bool CommitInsertQueries();
 
   /*!
    * @brief Get the number of INSERT queries in the queue.
@@ -304,4 +329,9 @@ private:
 
   bool m_multipleExecute;
   std::vector<std::string> m_multipleQueries;
+
+  bool m_batch = false;
+  bool m_batchRolledBack = false;
+  bool m_savepoint = false;
+  bool m_savepointRolledBack = false;
 };
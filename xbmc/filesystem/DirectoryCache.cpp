@@ -16,68 +16,94 @@
 #include "utils/URIUtils.h"
 #include "utils/log.h"
 
-#include <algorithm>
-#include <climits>
-
-// Maximum number of directories to keep in our cache
-#define MAX_CACHED_DIRS 50
+#include <functional>
 
 using namespace XFILE;
 
-CDirectoryCache::CDir::CDir(DIR_CACHE_TYPE cacheType)
+namespace
+{
+
+// rough estimate of the memory used by a listing, strings and properties aside from the path
+// and label are not taken into account
+size_t EstimateSize(const CFileItemList& items)
 {
-  m_cacheType = cacheType;
-  m_lastAccess = 0;
-  m_Items = new CFileItemList;
-  m_Items->SetIgnoreURLOptions(true);
-  m_Items->SetFastLookup(true);
+  size_t size = sizeof(CFileItemList);
+  for (int i = 0; i < items.Size(); i++)
+  {
+    const CFileItemPtr item = items[i];
+    size += sizeof(CFileItem) + item->GetPath().capacity() + item->GetLabel().capacity();
+  }
+  return size;
 }
 
-CDirectoryCache::CDir::~CDir()
+std::string GetStoredPath(const std::string& strPath)
 {
-  delete m_Items;
+  // Get rid of any URL options, else the compare may be wrong
+  std::string storedPath = CURL(strPath).GetWithoutOptions();
+  URIUtils::RemoveSlashAtEnd(storedPath);
+  return storedPath;
 }
 
-void CDirectoryCache::CDir::SetLastAccess(unsigned int &accessCounter)
+} // unnamed namespace
+
+constexpr unsigned int CDirectoryCache::SHARDS;
+constexpr size_t CDirectoryCache::MAX_CACHE_SIZE;
+
+CDirectoryCache::CDir::CDir(DIR_CACHE_TYPE cacheType, const std::shared_ptr<CFileItemList>& items)
+  : m_Items(items), m_cacheType(cacheType), m_size(EstimateSize(*items))
 {
-  m_lastAccess = accessCounter++;
 }
 
-CDirectoryCache::CDirectoryCache(void)
+CDirectoryCache::CDirectoryCache(size_t maxSize /* = MAX_CACHE_SIZE */) : m_maxSize(maxSize)
 {
-  m_accessCounter = 0;
-#ifdef _DEBUG
-  m_cacheHits = 0;
-  m_cacheMisses = 0;
-#endif
 }
 
 CDirectoryCache::~CDirectoryCache(void) = default;
 
-bool CDirectoryCache::GetDirectory(const std::string& strPath, CFileItemList &items, bool retrieveAll)
+CDirectoryCache::CShard& CDirectoryCache::GetShard(const std::string& storedPath)
 {
-  CSingleLock lock (m_cs);
+  return m_shards[std::hash<std::string>()(storedPath) % SHARDS];
+}
 
-  // Get rid of any URL options, else the compare may be wrong
-  std::string storedPath = CURL(strPath).GetWithoutOptions();
-  URIUtils::RemoveSlashAtEnd(storedPath);
+void CDirectoryCache::Touch(CShard& shard, CDir& dir)
+{
+  dir.m_lastAccess = m_accessCounter++;
+  if (dir.m_cacheType != DIR_CACHE_ALWAYS)
+    shard.m_lru.splice(shard.m_lru.begin(), shard.m_lru, dir.m_lru);
+}
 
-  ciCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
+bool CDirectoryCache::GetDirectory(const std::string& strPath, CFileItemList &items, bool retrieveAll)
+{
+  std::string storedPath = GetStoredPath(strPath);
+  CShard& shard = GetShard(storedPath);
+
+  std::shared_ptr<const CFileItemList> cached;
   {
-    CDir* dir = i->second;
-    if (dir->m_cacheType == XFILE::DIR_CACHE_ALWAYS ||
-       (dir->m_cacheType == XFILE::DIR_CACHE_ONCE && retrieveAll))
+    CSingleLock lock(shard.m_cs);
+
+    auto i = shard.m_dirs.find(storedPath);
+    if (i != shard.m_dirs.end())
     {
-      items.Copy(*dir->m_Items);
-      dir->SetLastAccess(m_accessCounter);
-#ifdef _DEBUG
-      m_cacheHits+=items.Size();
-#endif
-      return true;
+      CDir& dir = i->second;
+      if (dir.m_cacheType == XFILE::DIR_CACHE_ALWAYS ||
+         (dir.m_cacheType == XFILE::DIR_CACHE_ONCE && retrieveAll))
+      {
+        cached = dir.m_Items;
+        Touch(shard, dir);
+      }
     }
   }
-  return false;
+
+  if (!cached)
+  {
+    m_cacheMisses++;
+    return false;
+  }
+
+  // the cached listing is not modified while we hold a reference, copy without the lock
+  items.Copy(*cached);
+  m_cacheHits++;
+  return true;
 }
 
 void CDirectoryCache::SetDirectory(const std::string& strPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType)
@@ -96,115 +122,154 @@ void CDirectoryCache::SetDirectory(const std::string& strPath, const CFileItemLi
   // IDEALLY, any further processing on the item would actually create a new item
   // instead of altering it, but we can't really enforce that in an easy way, so
   // this is the best solution for now.
-  CSingleLock lock (m_cs);
+  std::shared_ptr<CFileItemList> copy = std::make_shared<CFileItemList>();
+  copy->SetIgnoreURLOptions(true);
+  copy->SetFastLookup(true);
+  copy->Copy(items);
 
-  // Get rid of any URL options, else the compare may be wrong
-  std::string storedPath = CURL(strPath).GetWithoutOptions();
-  URIUtils::RemoveSlashAtEnd(storedPath);
+  std::string storedPath = GetStoredPath(strPath);
+  CShard& shard = GetShard(storedPath);
+  {
+    CSingleLock lock(shard.m_cs);
 
-  ClearDirectory(storedPath);
+    auto i = shard.m_dirs.find(storedPath);
+    if (i != shard.m_dirs.end())
+      Delete(shard, i);
 
-  CheckIfFull();
+    CDir dir(cacheType, copy);
+    if (cacheType != DIR_CACHE_ALWAYS)
+    {
+      if (dir.m_size > m_maxSize)
+      {
+        CLog::Log(LOGDEBUG, "%s - not caching %s, %d items exceed the cache size", __FUNCTION__,
+                  CURL::GetRedacted(storedPath).c_str(), items.Size());
+        return;
+      }
+      dir.m_lru = shard.m_lru.insert(shard.m_lru.begin(), storedPath);
+      m_size += dir.m_size;
+    }
+
+    Touch(shard, shard.m_dirs.emplace(storedPath, dir).first->second);
+  }
 
-  CDir* dir = new CDir(cacheType);
-  dir->m_Items->Copy(items);
-  dir->SetLastAccess(m_accessCounter);
-  m_cache.insert(std::pair<std::string, CDir*>(storedPath, dir));
+  CheckIfFull();
 }
 
 void CDirectoryCache::ClearFile(const std::string& strFile)
 {
-  // Get rid of any URL options, else the compare may be wrong
-  std::string strFile2 = CURL(strFile).GetWithoutOptions();
-  URIUtils::RemoveSlashAtEnd(strFile2);
-
-  ClearDirectory(URIUtils::GetDirectory(strFile2));
+  ClearDirectory(URIUtils::GetDirectory(GetStoredPath(strFile)));
 }
 
 void CDirectoryCache::ClearDirectory(const std::string& strPath)
 {
-  CSingleLock lock (m_cs);
-
-  // Get rid of any URL options, else the compare may be wrong
-  std::string storedPath = CURL(strPath).GetWithoutOptions();
-  URIUtils::RemoveSlashAtEnd(storedPath);
+  std::string storedPath = GetStoredPath(strPath);
+  CShard& shard = GetShard(storedPath);
+  CSingleLock lock(shard.m_cs);
 
-  iCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
-    Delete(i);
+  auto i = shard.m_dirs.find(storedPath);
+  if (i != shard.m_dirs.end())
+    Delete(shard, i);
 }
 
 void CDirectoryCache::ClearSubPaths(const std::string& strPath)
 {
-  CSingleLock lock (m_cs);
-
   // Get rid of any URL options, else the compare may be wrong
   std::string storedPath = CURL(strPath).GetWithoutOptions();
 
-  iCache i = m_cache.begin();
-  while (i != m_cache.end())
+  for (CShard& shard : m_shards)
   {
-    if (URIUtils::PathHasParent(i->first, storedPath))
-      Delete(i++);
-    else
-      i++;
+    CSingleLock lock(shard.m_cs);
+
+    auto i = shard.m_dirs.begin();
+    while (i != shard.m_dirs.end())
+    {
+      if (URIUtils::PathHasParent(i->first, storedPath))
+        Delete(shard, i++);
+      else
+        i++;
+    }
   }
 }
 
 void CDirectoryCache::AddFile(const std::string& strFile)
 {
-  CSingleLock lock (m_cs);
-
   // Get rid of any URL options, else the compare may be wrong
   std::string strPath = URIUtils::GetDirectory(CURL(strFile).GetWithoutOptions());
   URIUtils::RemoveSlashAtEnd(strPath);
 
-  ciCache i = m_cache.find(strPath);
-  if (i != m_cache.end())
+  CShard& shard = GetShard(strPath);
+  CSingleLock lock(shard.m_cs);
+
+  auto i = shard.m_dirs.find(strPath);
+  if (i != shard.m_dirs.end())
   {
-    CDir *dir = i->second;
+    CDir& dir = i->second;
+    if (dir.m_Items.use_count() > 1)
+    {
+      // a reader is still copying the listing, leave it alone and modify a copy
+      std::shared_ptr<CFileItemList> copy = std::make_shared<CFileItemList>();
+      copy->SetIgnoreURLOptions(true);
+      copy->SetFastLookup(true);
+      copy->Copy(*dir.m_Items);
+      dir.m_Items = copy;
+    }
+
     CFileItemPtr item(new CFileItem(strFile, false));
-    dir->m_Items->Add(item);
-    dir->SetLastAccess(m_accessCounter);
+    dir.m_Items->Add(item);
+
+    size_t itemSize = sizeof(CFileItem) + item->GetPath().capacity();
+    dir.m_size += itemSize;
+    if (dir.m_cacheType != DIR_CACHE_ALWAYS)
+      m_size += itemSize;
+
+    Touch(shard, dir);
   }
 }
 
 bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
 {
-  CSingleLock lock (m_cs);
   bInCache = false;
 
   // Get rid of any URL options, else the compare may be wrong
-  std::string strPath = CURL(strFile).GetWithoutOptions();
-  URIUtils::RemoveSlashAtEnd(strPath);
+  std::string strPath = GetStoredPath(strFile);
   std::string storedPath = URIUtils::GetDirectory(strPath);
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  ciCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
+  CShard& shard = GetShard(storedPath);
+  std::shared_ptr<const CFileItemList> cached;
   {
-    bInCache = true;
-    CDir *dir = i->second;
-    dir->SetLastAccess(m_accessCounter);
-#ifdef _DEBUG
-    m_cacheHits++;
-#endif
-    return (URIUtils::PathEquals(strPath, storedPath) || dir->m_Items->Contains(strFile));
+    CSingleLock lock(shard.m_cs);
+
+    auto i = shard.m_dirs.find(storedPath);
+    if (i != shard.m_dirs.end())
+    {
+      cached = i->second.m_Items;
+      Touch(shard, i->second);
+    }
   }
-#ifdef _DEBUG
-  m_cacheMisses++;
-#endif
-  return false;
+
+  if (!cached)
+  {
+    m_cacheMisses++;
+    return false;
+  }
+
+  bInCache = true;
+  m_cacheHits++;
+  return (URIUtils::PathEquals(strPath, storedPath) || cached->Contains(strFile));
 }
 
 void CDirectoryCache::Clear()
 {
   // this routine clears everything
-  CSingleLock lock (m_cs);
+  for (CShard& shard : m_shards)
+  {
+    CSingleLock lock(shard.m_cs);
 
-  iCache i = m_cache.begin();
-  while (i != m_cache.end() )
-    Delete(i++);
+    auto i = shard.m_dirs.begin();
+    while (i != shard.m_dirs.end())
+      Delete(shard, i++);
+  }
 }
 
 void CDirectoryCache::InitCache(std::set<std::string>& dirs)
@@ -219,60 +284,77 @@ void CDirectoryCache::InitCache(std::set<std::string>& dirs)
 
 void CDirectoryCache::ClearCache(std::set<std::string>& dirs)
 {
-  iCache i = m_cache.begin();
-  while (i != m_cache.end())
-  {
-    if (dirs.find(i->first) != dirs.end())
-      Delete(i++);
-    else
-      i++;
-  }
+  for (const std::string& strDir : dirs)
+    ClearDirectory(strDir);
 }
 
 void CDirectoryCache::CheckIfFull()
 {
-  CSingleLock lock (m_cs);
-
-  // find the last accessed folder, and remove if the number of cached folders is too many
-  iCache lastAccessed = m_cache.end();
-  unsigned int numCached = 0;
-  for (iCache i = m_cache.begin(); i != m_cache.end(); i++)
+  while (m_size > m_maxSize)
   {
-    // ensure dirs that are always cached aren't cleared
-    if (i->second->m_cacheType != DIR_CACHE_ALWAYS)
+    // the least recently used folder is at the end of the lru list of one of the shards
+    CShard* oldest = nullptr;
+    unsigned int oldestAccess = 0;
+    for (CShard& shard : m_shards)
     {
-      if (lastAccessed == m_cache.end() || i->second->GetLastAccess() < lastAccessed->second->GetLastAccess())
-        lastAccessed = i;
-      numCached++;
+      CSingleLock lock(shard.m_cs);
+      if (shard.m_lru.empty())
+        continue;
+
+      unsigned int lastAccess = shard.m_dirs.find(shard.m_lru.back())->second.m_lastAccess;
+      if (!oldest || lastAccess < oldestAccess)
+      {
+        oldest = &shard;
+        oldestAccess = lastAccess;
+      }
     }
+
+    if (!oldest)
+      return;
+
+    // the shard may have been accessed in between, that just evicts a slightly newer folder
+    CSingleLock lock(oldest->m_cs);
+    if (!oldest->m_lru.empty())
+      Delete(*oldest, oldest->m_dirs.find(oldest->m_lru.back()));
+  }
+}
+
+void CDirectoryCache::Delete(CShard& shard, std::unordered_map<std::string, CDir>::iterator it)
+{
+  CDir& dir = it->second;
+  if (dir.m_cacheType != DIR_CACHE_ALWAYS)
+  {
+    shard.m_lru.erase(dir.m_lru);
+    m_size -= dir.m_size;
   }
-  if (lastAccessed != m_cache.end() && numCached >= MAX_CACHED_DIRS)
-    Delete(lastAccessed);
+  shard.m_dirs.erase(it);
 }
 
-void CDirectoryCache::Delete(iCache it)
+CDirectoryCache::Stats CDirectoryCache::GetStats() const
 {
-  CDir* dir = it->second;
-  delete dir;
-  m_cache.erase(it);
+  Stats stats;
+  stats.hits = m_cacheHits;
+  stats.misses = m_cacheMisses;
+
+  for (const CShard& shard : m_shards)
+  {
+    CSingleLock lock(shard.m_cs);
+    for (const auto& it : shard.m_dirs)
+    {
+      stats.dirs++;
+      stats.items += it.second.m_Items->Size();
+      stats.size += it.second.m_size;
+    }
+  }
+
+  return stats;
 }
 
 #ifdef _DEBUG
 void CDirectoryCache::PrintStats() const
 {
-  CSingleLock lock (m_cs);
-  CLog::Log(LOGDEBUG, "%s - total of %u cache hits, and %u cache misses", __FUNCTION__, m_cacheHits, m_cacheMisses);
-  // run through and find the oldest and the number of items cached
-  unsigned int oldest = UINT_MAX;
-  unsigned int numItems = 0;
-  unsigned int numDirs = 0;
-  for (ciCache i = m_cache.begin(); i != m_cache.end(); i++)
-  {
-    CDir *dir = i->second;
-    oldest = std::min(oldest, dir->GetLastAccess());
-    numItems += dir->m_Items->Size();
-    numDirs++;
-  }
-  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total.  Oldest is %u, current is %u", __FUNCTION__, numDirs, numItems, oldest, m_accessCounter);
+  Stats stats = GetStats();
+  CLog::Log(LOGDEBUG, "%s - total of %u cache hits, and %u cache misses", __FUNCTION__, stats.hits, stats.misses);
+  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total using about %zu KiB", __FUNCTION__, stats.dirs, stats.items, stats.size / 1024);
 }
 #endif
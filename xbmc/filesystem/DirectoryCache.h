@@ -11,33 +11,65 @@
 #include "IDirectory.h"
 #include "threads/CriticalSection.h"
 
-#include <map>
+#include <atomic>
+#include <list>
+#include <memory>
 #include <set>
+#include <string>
+#include <unordered_map>
 
 class CFileItem;
 
 namespace XFILE
 {
+  /*!
+   \brief Cache of directory listings.
+
+   The listings are spread over a number of shards by path, each with its own lock, so lookups
+   of the scanners and the GUI don't wait for each other. The cache is bounded by the estimated
+   memory used by the listings and evicts the least recently used listing first. Listings are
+   immutable once cached and shared with readers, so copies are made outside of the locks.
+   */
   class CDirectoryCache
   {
     class CDir
     {
     public:
-      explicit CDir(DIR_CACHE_TYPE cacheType);
-      virtual ~CDir();
-
-      void SetLastAccess(unsigned int &accessCounter);
-      unsigned int GetLastAccess() const { return m_lastAccess; };
+      CDir(DIR_CACHE_TYPE cacheType, const std::shared_ptr<CFileItemList>& items);
 
-      CFileItemList* m_Items;
+      std::shared_ptr<CFileItemList> m_Items; // copied before modifying if shared with readers
       DIR_CACHE_TYPE m_cacheType;
-    private:
-      CDir(const CDir&) = delete;
-      CDir& operator=(const CDir&) = delete;
-      unsigned int m_lastAccess;
+      size_t m_size; // estimated memory used by the items
+      unsigned int m_lastAccess = 0;
+      std::list<std::string>::iterator m_lru; // position in the lru list of the shard
     };
+
+    class CShard
+    {
+    public:
+      mutable CCriticalSection m_cs;
+      std::unordered_map<std::string, CDir> m_dirs;
+      std::list<std::string> m_lru; // most recently used first, excludes DIR_CACHE_ALWAYS dirs
+    };
+
   public:
-    CDirectoryCache(void);
+    /*! \brief Default max estimated memory used by the cached listings */
+    static constexpr size_t MAX_CACHE_SIZE = 32 * 1024 * 1024;
+
+    struct Stats
+    {
+      unsigned int hits = 0;
+      unsigned int misses = 0;
+      unsigned int dirs = 0;
+      unsigned int items = 0;
+      size_t size = 0; //!< estimated memory used by the cached listings in bytes
+    };
+
+    /*!
+     \param maxSize max estimated memory used by the cached listings, DIR_CACHE_ALWAYS listings
+     are not counted
+     */
+    explicit CDirectoryCache(size_t maxSize = MAX_CACHE_SIZE);
     virtual ~CDirectoryCache(void);
     bool GetDirectory(const std::string& strPath, CFileItemList &items, bool retrieveAll = false);
     void SetDirectory(const std::string& strPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType);
@@ -47,6 +79,7 @@ namespace XFILE
     void Clear();
     void AddFile(const std::string& strFile);
     bool FileExists(const std::string& strPath, bool& bInCache);
+    Stats GetStats() const;
 #ifdef _DEBUG
     void PrintStats() const;
 #endif
@@ -55,19 +88,19 @@ namespace XFILE
     void ClearCache(std::set<std::string>& dirs);
     void CheckIfFull();
 
-    std::map<std::string, CDir*> m_cache;
-    typedef std::map<std::string, CDir*>::iterator iCache;
-    typedef std::map<std::string, CDir*>::const_iterator ciCache;
-    void Delete(iCache i);
+    static constexpr unsigned int SHARDS = 16;
 
-    mutable CCriticalSection m_cs;
+    CShard& GetShard(const std::string& storedPath);
+    void Touch(CShard& shard, CDir& dir);
+    void Delete(CShard& shard, std::unordered_map<std::string, CDir>::iterator it);
 
-    unsigned int m_accessCounter;
+    const size_t m_maxSize;
+    CShard m_shards[SHARDS];
 
-#ifdef _DEBUG
-    unsigned int m_cacheHits;
-    unsigned int m_cacheMisses;
-#endif
+    std::atomic<size_t> m_size{0};
+    std::atomic<unsigned int> m_accessCounter{0};
+    std::atomic<unsigned int> m_cacheHits{0};
+    std::atomic<unsigned int> m_cacheMisses{0};
   };
 }
 extern XFILE::CDirectoryCache g_directoryCache;
@@ -0,0 +1,284 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DirectoryChangeJournal.h"
+
+#include "URL.h"
+#include "filesystem/SpecialProtocol.h"
+#include "threads/SingleLock.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+
+#if defined(TARGET_LINUX) && !defined(TARGET_ANDROID) && defined(HAVE_INOTIFY)
+#define HAS_DIRECTORY_JOURNAL
+#include "platform/linux/FDEventMonitor.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <sys/inotify.h>
+#endif
+
+#if defined(TARGET_LINUX)
+#include <sys/vfs.h>
+#endif
+
+using namespace XFILE;
+
+namespace
+{
+#if defined(HAS_DIRECTORY_JOURNAL)
+constexpr uint32_t WATCH_EVENTS = IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE |
+                                  IN_DELETE_SELF | IN_MODIFY | IN_MOVE_SELF | IN_MOVED_FROM |
+                                  IN_MOVED_TO | IN_ONLYDIR;
+#endif
+
+#if defined(TARGET_LINUX)
+// filesystems whose contents change without the local kernel knowing (see statfs(2))
+constexpr unsigned long REMOTE_FILESYSTEMS[] = {
+    0x6969, // NFS_SUPER_MAGIC
+    0x517B, // SMB_SUPER_MAGIC
+    0xFF534D42, // CIFS_MAGIC_NUMBER
+    0xFE534D42, // SMB2_MAGIC_NUMBER
+    0x65735546, // FUSE_SUPER_MAGIC, sshfs, davfs, rclone, ...
+    0x564C, // NCP_SUPER_MAGIC
+    0x73757245, // CODA_SUPER_MAGIC
+    0x5346414F, // AFS_SUPER_MAGIC
+    0x6B414653, // AFS_FS_MAGIC
+    0x00C36400, // CEPH_SUPER_MAGIC
+    0x01021997, // V9FS_MAGIC
+    0x01161970, // GFS2_MAGIC
+    0x0BD00BD0, // LUSTRE_SUPER_MAGIC
+    0x47504653, // GPFS_SUPER_MAGIC
+    0x7461636F, // OCFS2_SUPER_MAGIC
+};
+#endif
+} // unnamed namespace
+
+CDirectoryChangeJournal& CDirectoryChangeJournal::GetInstance()
+{
+  static CDirectoryChangeJournal s_instance;
+  return s_instance;
+}
+
+CDirectoryChangeJournal::CDirectoryChangeJournal()
+{
+#if defined(HAS_DIRECTORY_JOURNAL)
+  m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (m_fd < 0)
+  {
+    CLog::Log(LOGWARNING, "CDirectoryChangeJournal - inotify_init1() failed, error %d", errno);
+    return;
+  }
+
+  // not under m_critSection, the monitor thread calls back into us while adding the fd
+  g_fdEventMonitor.AddFD(CFDEventMonitor::MonitoredFD(m_fd, POLLIN, OnEvents, this), m_monitorId);
+#endif
+}
+
+CDirectoryChangeJournal::~CDirectoryChangeJournal()
+{
+#if defined(HAS_DIRECTORY_JOURNAL)
+  if (m_fd >= 0)
+  {
+    g_fdEventMonitor.RemoveFD(m_monitorId);
+    close(m_fd);
+  }
+#endif
+}
+
+std::string CDirectoryChangeJournal::GetWatchPath(const std::string& path)
+{
+  if (URIUtils::IsSpecial(path))
+    return GetWatchPath(CSpecialProtocol::TranslatePath(path));
+
+  // local directories only, remote shares are left to the path hashes
+  if (!CURL(path).GetProtocol().empty() || !IsLocalFilesystem(path))
+    return "";
+
+  return path;
+}
+
+bool CDirectoryChangeJournal::IsLocalFilesystem(const std::string& path)
+{
+#if defined(TARGET_LINUX)
+  // shares mounted into the local tree, e.g. below /mnt or /media
+  struct statfs fs;
+  if (statfs(path.c_str(), &fs) != 0)
+    return false;
+
+  for (unsigned long type : REMOTE_FILESYSTEMS)
+  {
+    if (static_cast<unsigned long>(fs.f_type) == type)
+      return false;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool CDirectoryChangeJournal::Directory::IsUnchanged(const std::string& scanner) const
+{
+  if (watch < 0 || pending.find(scanner) != pending.end())
+    return false;
+
+  const auto it = scanned.find(scanner);
+  return it != scanned.end() && it->second == generation;
+}
+
+void CDirectoryChangeJournal::BeginScan(const std::string& scanner, const std::string& path)
+{
+#if defined(HAS_DIRECTORY_JOURNAL)
+  const std::string key = URIUtils::AddFileToFolder(path, "");
+  const std::string watchPath = GetWatchPath(key);
+  if (m_fd < 0 || watchPath.empty())
+    return;
+
+  CSingleLock lock(m_critSection);
+  Directory& directory = m_directories[key];
+  directory.scanned.erase(scanner);
+
+  // watch before the scanner lists the directory, so no change gets lost in between
+  if (directory.watch < 0)
+  {
+    const int watch = inotify_add_watch(m_fd, watchPath.c_str(), WATCH_EVENTS);
+    if (watch < 0)
+    {
+      if (errno == ENOSPC)
+        CLog::Log(LOGDEBUG, "CDirectoryChangeJournal - out of inotify watches, not tracking %s",
+                  watchPath.c_str());
+    }
+    else if (m_watches.emplace(watch, key).second)
+    {
+      directory.watch = watch;
+    }
+    // else: another path of an already watched directory (symlink), not tracked
+  }
+
+  directory.pending[scanner] = directory.generation;
+#endif
+}
+
+void CDirectoryChangeJournal::EndScan(const std::string& scanner, const std::string& path)
+{
+  const std::string key = URIUtils::AddFileToFolder(path, "");
+
+  CSingleLock lock(m_critSection);
+  const auto directory = m_directories.find(key);
+  if (directory == m_directories.end())
+    return;
+
+  const auto pending = directory->second.pending.find(scanner);
+  if (pending == directory->second.pending.end())
+    return;
+
+  directory->second.scanned[scanner] = pending->second;
+  directory->second.pending.erase(pending);
+}
+
+bool CDirectoryChangeJournal::IsUnchanged(const std::string& scanner, const std::string& path) const
+{
+  const std::string key = URIUtils::AddFileToFolder(path, "");
+
+  CSingleLock lock(m_critSection);
+  auto it = m_directories.find(key);
+  if (it == m_directories.end() || !it->second.IsUnchanged(scanner))
+    return false;
+
+  // the subfolders the scanner visited as part of this directory
+  for (++it; it != m_directories.end() && StringUtils::StartsWith(it->first, key); ++it)
+  {
+    const Directory& directory = it->second;
+    const bool visited = directory.scanned.find(scanner) != directory.scanned.end() ||
+                         directory.pending.find(scanner) != directory.pending.end();
+    if (visited && !directory.IsUnchanged(scanner))
+      return false;
+  }
+
+  return true;
+}
+
+void CDirectoryChangeJournal::Remove(const std::string& path)
+{
+  const std::string key = URIUtils::AddFileToFolder(path, "");
+
+  CSingleLock lock(m_critSection);
+  auto it = m_directories.lower_bound(key);
+  while (it != m_directories.end() && StringUtils::StartsWith(it->first, key))
+  {
+    RemoveWatch(it->second.watch);
+    it = m_directories.erase(it);
+  }
+}
+
+void CDirectoryChangeJournal::RemoveWatch(int watch)
+{
+#if defined(HAS_DIRECTORY_JOURNAL)
+  if (watch < 0)
+    return;
+
+  // the IN_IGNORED event that follows finds no watch anymore
+  inotify_rm_watch(m_fd, watch);
+  m_watches.erase(watch);
+#endif
+}
+
+void CDirectoryChangeJournal::OnEvents(int id, int fd, short revents, void* data)
+{
+  static_cast<CDirectoryChangeJournal*>(data)->ReadEvents();
+}
+
+void CDirectoryChangeJournal::ReadEvents()
+{
+#if defined(HAS_DIRECTORY_JOURNAL)
+  alignas(struct inotify_event) char buffer[4096];
+
+  CSingleLock lock(m_critSection);
+  while (true)
+  {
+    const ssize_t length = read(m_fd, buffer, sizeof(buffer));
+    if (length <= 0)
+      break;
+
+    for (ssize_t offset = 0; offset < length;)
+    {
+      const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+      offset += sizeof(struct inotify_event) + event->len;
+
+      if (event->mask & IN_Q_OVERFLOW)
+      {
+        // events were lost, nothing is known to be unchanged anymore
+        CLog::Log(LOGDEBUG, "CDirectoryChangeJournal - event queue overflow");
+        for (auto& directory : m_directories)
+          directory.second.generation++;
+        continue;
+      }
+
+      const auto watch = m_watches.find(event->wd);
+      if (watch == m_watches.end())
+        continue;
+
+      const auto directory = m_directories.find(watch->second);
+      if (event->mask & IN_IGNORED)
+      {
+        // deleted or unmounted, forget it, a scan that still finds it starts over
+        if (directory != m_directories.end() && directory->second.watch == event->wd)
+          m_directories.erase(directory);
+        m_watches.erase(watch);
+      }
+      else if (directory != m_directories.end())
+      {
+        directory->second.generation++;
+      }
+    }
+  }
+#endif
+}
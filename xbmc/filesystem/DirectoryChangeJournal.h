@@ -0,0 +1,94 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <map>
+#include <stdint.h>
+#include <string>
+
+namespace XFILE
+{
+  /*!
+   \brief Keeps track of changes to local directories between library scans.
+
+   A scanner announces the directories it visits with BeginScan() and EndScan(). For local
+   directories the journal watches them for changes (inotify on Linux), so the next scan can
+   skip a directory and its subfolders with IsUnchanged() instead of listing them again.
+   The state is kept per scanner, as the same directory may be part of different libraries,
+   and only while Kodi is running; directories that can't be watched are never reported as
+   unchanged, so scanners fall back to their path hashes. This includes network and FUSE
+   mounts, where changes made on the server never show up in the local watches.
+   */
+  class CDirectoryChangeJournal
+  {
+  public:
+    static CDirectoryChangeJournal& GetInstance();
+
+    /*! \brief Start tracking a directory, call before listing it.
+     \param scanner name of the scanner, e.g. "music"
+     \param path the directory
+     */
+    void BeginScan(const std::string& scanner, const std::string& path);
+
+    /*! \brief The directory and the subfolders the scanner visits were scanned completely.
+     \param scanner name of the scanner
+     \param path the directory
+     */
+    void EndScan(const std::string& scanner, const std::string& path);
+
+    /*! \brief Check whether a directory needs to be scanned again.
+     \param scanner name of the scanner
+     \param path the directory
+     \return true if neither the directory nor any subfolder scanned with it changed since the
+             scanner completed their last scan, false otherwise
+     */
+    bool IsUnchanged(const std::string& scanner, const std::string& path) const;
+
+    /*! \brief Stop tracking a directory and its subfolders, e.g. when its source is removed.
+     \param path the directory
+     */
+    void Remove(const std::string& path);
+
+    /*! \brief Check whether a path of the local tree is on a local disk, not on a network or
+     FUSE mount below e.g. /mnt or /media.
+     \param path the path, without protocol
+     \return true if the path is on a local disk, false if not or if unknown on this platform
+     */
+    static bool IsLocalFilesystem(const std::string& path);
+
+  private:
+    CDirectoryChangeJournal();
+    ~CDirectoryChangeJournal();
+    CDirectoryChangeJournal(const CDirectoryChangeJournal&) = delete;
+    CDirectoryChangeJournal& operator=(const CDirectoryChangeJournal&) = delete;
+
+    struct Directory
+    {
+      int watch = -1;
+      uint64_t generation = 0; /*!< incremented on every change */
+      std::map<std::string, uint64_t> pending; /*!< scanner -> generation when the scan started */
+      std::map<std::string, uint64_t> scanned; /*!< scanner -> generation of the last complete scan */
+
+      bool IsUnchanged(const std::string& scanner) const;
+    };
+
+    static std::string GetWatchPath(const std::string& path);
+    void RemoveWatch(int watch);
+    static void OnEvents(int id, int fd, short revents, void* data);
+    void ReadEvents();
+
+    mutable CCriticalSection m_critSection;
+    std::map<std::string, Directory> m_directories; // sorted, so subfolders follow their parent
+    std::map<int, std::string> m_watches;
+    int m_fd = -1;
+    int m_monitorId = -1;
+  };
+}
@@ -54,6 +54,12 @@ struct SCacheStatus
   bool     lowspeed; /**< cache low speed condition detected? */
 };
 
+struct SReadAheadHint
+{
+  int64_t offset; /**< start of the range that is going to be read soon */
+  int64_t length; /**< length of the range in bytes */
+};
+
 typedef enum {
   IOCTRL_NATIVE        = 1,  /**< SNativeIoControl structure, containing what should be passed to native ioctrl */
   IOCTRL_SEEK_POSSIBLE = 2,  /**< return 0 if known not to work, 1 if it should work */
@@ -61,6 +67,7 @@ typedef enum {
   IOCTRL_CACHE_SETRATE = 4,  /**< unsigned int with speed limit for caching in bytes per second */
   IOCTRL_SET_CACHE     = 8,  /**< CFileCache */
   IOCTRL_SET_RETRY     = 16, /**< Enable/disable retry within the protocol handler (if supported) */
+  IOCTRL_READ_AHEAD    = 32, /**< SReadAheadHint structure, lets the os prefetch the range (if supported) */
 } EIoControl;
 
 enum CURLOPTIONTYPE
@@ -0,0 +1,117 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "filesystem/DirectoryCache.h"
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+namespace
+{
+
+void SetListing(CDirectoryCache& cache, const std::string& path, int files, DIR_CACHE_TYPE cacheType)
+{
+  CFileItemList items;
+  for (int i = 0; i < files; i++)
+    items.Add(CFileItemPtr(new CFileItem(path + "file" + std::to_string(i) + ".mkv", false)));
+  cache.SetDirectory(path, items, cacheType);
+}
+
+} // namespace
+
+TEST(TestDirectoryCache, ReturnsIndependentCopies)
+{
+  CDirectoryCache cache;
+  SetListing(cache, "/media/movies/", 3, DIR_CACHE_ALWAYS);
+
+  CFileItemList items;
+  ASSERT_TRUE(cache.GetDirectory("/media/movies", items));
+  ASSERT_EQ(3, items.Size());
+
+  // callers may alter their items without affecting the cache
+  items[0]->SetPath("/elsewhere/file0.mkv");
+  bool bInCache = false;
+  EXPECT_TRUE(cache.FileExists("/media/movies/file0.mkv", bInCache));
+  EXPECT_TRUE(bInCache);
+  EXPECT_FALSE(cache.FileExists("/media/movies/missing.mkv", bInCache));
+  EXPECT_TRUE(bInCache);
+
+  CFileItemList again;
+  ASSERT_TRUE(cache.GetDirectory("/media/movies/", again));
+  EXPECT_EQ("/media/movies/file0.mkv", again[0]->GetPath());
+}
+
+TEST(TestDirectoryCache, CacheOnceListingsNeedRetrieveAll)
+{
+  CDirectoryCache cache;
+  SetListing(cache, "/media/tv/", 2, DIR_CACHE_ONCE);
+
+  CFileItemList items;
+  EXPECT_FALSE(cache.GetDirectory("/media/tv/", items));
+  EXPECT_TRUE(cache.GetDirectory("/media/tv/", items, true));
+
+  cache.AddFile("/media/tv/new.mkv");
+  bool bInCache = false;
+  EXPECT_TRUE(cache.FileExists("/media/tv/new.mkv", bInCache));
+
+  cache.ClearFile("/media/tv/new.mkv");
+  EXPECT_FALSE(cache.FileExists("/media/tv/new.mkv", bInCache));
+  EXPECT_FALSE(bInCache);
+}
+
+TEST(TestDirectoryCache, EvictsLeastRecentlyUsed)
+{
+  // room for about two listings
+  CDirectoryCache probe;
+  SetListing(probe, "/p/", 100, DIR_CACHE_ONCE);
+  CDirectoryCache cache(probe.GetStats().size * 5 / 2);
+
+  SetListing(cache, "/a/", 100, DIR_CACHE_ONCE);
+  SetListing(cache, "/b/", 100, DIR_CACHE_ONCE);
+
+  // use /a/ so /b/ is the oldest
+  CFileItemList items;
+  ASSERT_TRUE(cache.GetDirectory("/a/", items, true));
+
+  SetListing(cache, "/c/", 100, DIR_CACHE_ONCE);
+  EXPECT_TRUE(cache.GetDirectory("/a/", items, true));
+  EXPECT_FALSE(cache.GetDirectory("/b/", items, true));
+  EXPECT_TRUE(cache.GetDirectory("/c/", items, true));
+  EXPECT_EQ(2u, cache.GetStats().dirs);
+
+  // listings that are always cached are not evicted
+  SetListing(cache, "/always/", 100, DIR_CACHE_ALWAYS);
+  SetListing(cache, "/d/", 100, DIR_CACHE_ONCE);
+  EXPECT_TRUE(cache.GetDirectory("/always/", items));
+}
+
+TEST(TestDirectoryCache, CountsHitsAndMisses)
+{
+  CDirectoryCache cache;
+  SetListing(cache, "/media/music/", 5, DIR_CACHE_ALWAYS);
+
+  CFileItemList items;
+  cache.GetDirectory("/media/music/", items);
+  cache.GetDirectory("/media/other/", items);
+  bool bInCache;
+  cache.FileExists("/media/music/file1.mkv", bInCache);
+
+  CDirectoryCache::Stats stats = cache.GetStats();
+  EXPECT_EQ(2u, stats.hits);
+  EXPECT_EQ(1u, stats.misses);
+  EXPECT_EQ(1u, stats.dirs);
+  EXPECT_EQ(5u, stats.items);
+  EXPECT_GT(stats.size, 0u);
+
+  cache.Clear();
+  EXPECT_EQ(0u, cache.GetStats().dirs);
+}
@@ -0,0 +1,140 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/Directory.h"
+#include "filesystem/DirectoryChangeJournal.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "threads/SystemClock.h"
+#include "utils/URIUtils.h"
+#include "utils/XTimeUtils.h"
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+namespace
+{
+
+class TestDirectoryChangeJournal : public testing::Test
+{
+protected:
+  TestDirectoryChangeJournal()
+  {
+    // a folder per test, events of the previous test's folder may still be arriving
+    const std::string name = testing::UnitTest::GetInstance()->current_test_info()->name();
+    m_root = URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"),
+                                       "TestDirectoryChangeJournal" + name + "/");
+    m_subdir = URIUtils::AddFileToFolder(m_root, "subdir/");
+    CDirectory::Create(m_subdir);
+  }
+
+  ~TestDirectoryChangeJournal() override { CDirectory::RemoveRecursive(m_root); }
+
+  // a scan of the root visiting the subfolder
+  void Scan(const std::string& scanner)
+  {
+    CDirectoryChangeJournal& journal = CDirectoryChangeJournal::GetInstance();
+    journal.BeginScan(scanner, m_root);
+    journal.BeginScan(scanner, m_subdir);
+    journal.EndScan(scanner, m_subdir);
+    journal.EndScan(scanner, m_root);
+  }
+
+  // events arrive on the fd monitor thread
+  bool WaitForChange(const std::string& scanner, const std::string& path)
+  {
+    XbmcThreads::EndTime timeout(2000);
+    while (CDirectoryChangeJournal::GetInstance().IsUnchanged(scanner, path))
+    {
+      if (timeout.IsTimePast())
+        return false;
+      KODI::TIME::Sleep(10);
+    }
+    return true;
+  }
+
+  std::string m_root;
+  std::string m_subdir;
+};
+
+} // namespace
+
+TEST_F(TestDirectoryChangeJournal, UnchangedAfterCompleteScan)
+{
+  CDirectoryChangeJournal& journal = CDirectoryChangeJournal::GetInstance();
+  EXPECT_FALSE(journal.IsUnchanged("test", m_root));
+
+  Scan("test");
+  EXPECT_TRUE(journal.IsUnchanged("test", m_root));
+  EXPECT_TRUE(journal.IsUnchanged("test", m_subdir));
+
+  // other scanners did not scan it
+  EXPECT_FALSE(journal.IsUnchanged("other", m_root));
+}
+
+TEST_F(TestDirectoryChangeJournal, IncompleteScan)
+{
+  CDirectoryChangeJournal& journal = CDirectoryChangeJournal::GetInstance();
+  Scan("test");
+
+  // the subfolder scan was interrupted
+  journal.BeginScan("test", m_root);
+  journal.BeginScan("test", m_subdir);
+  EXPECT_FALSE(journal.IsUnchanged("test", m_root));
+  EXPECT_FALSE(journal.IsUnchanged("test", m_subdir));
+}
+
+TEST_F(TestDirectoryChangeJournal, ChangeInSubfolder)
+{
+  Scan("test");
+  ASSERT_TRUE(CDirectoryChangeJournal::GetInstance().IsUnchanged("test", m_root));
+
+  CFile file;
+  ASSERT_TRUE(file.OpenForWrite(URIUtils::AddFileToFolder(m_subdir, "new.mp3"), true));
+  file.Close();
+
+  EXPECT_TRUE(WaitForChange("test", m_subdir));
+  EXPECT_FALSE(CDirectoryChangeJournal::GetInstance().IsUnchanged("test", m_root));
+
+  Scan("test");
+  EXPECT_TRUE(CDirectoryChangeJournal::GetInstance().IsUnchanged("test", m_root));
+}
+
+TEST_F(TestDirectoryChangeJournal, RemoteSourcesAreNotTracked)
+{
+  CDirectoryChangeJournal& journal = CDirectoryChangeJournal::GetInstance();
+  journal.BeginScan("test", "smb://server/music/");
+  journal.EndScan("test", "smb://server/music/");
+  EXPECT_FALSE(journal.IsUnchanged("test", "smb://server/music/"));
+}
+
+TEST_F(TestDirectoryChangeJournal, RemovedSourcesAreNotTracked)
+{
+  CDirectoryChangeJournal& journal = CDirectoryChangeJournal::GetInstance();
+  Scan("test");
+  ASSERT_TRUE(journal.IsUnchanged("test", m_root));
+
+  journal.Remove(m_root);
+  EXPECT_FALSE(journal.IsUnchanged("test", m_root));
+  EXPECT_FALSE(journal.IsUnchanged("test", m_subdir));
+
+  // added again
+  Scan("test");
+  EXPECT_TRUE(journal.IsUnchanged("test", m_root));
+}
+
+TEST_F(TestDirectoryChangeJournal, DeletedSubfolder)
+{
+  Scan("test");
+  ASSERT_TRUE(CDirectoryChangeJournal::GetInstance().IsUnchanged("test", m_subdir));
+
+  ASSERT_TRUE(CDirectory::Remove(m_subdir));
+  EXPECT_TRUE(WaitForChange("test", m_subdir));
+  EXPECT_TRUE(WaitForChange("test", m_root));
+}
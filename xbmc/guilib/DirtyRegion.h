@@ -15,13 +15,21 @@
 class CDirtyRegion : public CRect
 {
 public:
-  explicit CDirtyRegion(const CRect &rect) : CRect(rect) { m_age = 0; }
-  CDirtyRegion(float left, float top, float right, float bottom) : CRect(left, top, right, bottom) { m_age = 0; }
-  CDirtyRegion() : CRect() { m_age = 0; }
+  explicit CDirtyRegion(const CRect &rect) : CRect(rect) { m_age = 0; m_cost = 1.0f; }
+  CDirtyRegion(const CRect &rect, float cost) : CRect(rect) { m_age = 0; m_cost = cost; }
+  CDirtyRegion(float left, float top, float right, float bottom) : CRect(left, top, right, bottom) { m_age = 0; m_cost = 1.0f; }
+  CDirtyRegion() : CRect() { m_age = 0; m_cost = 1.0f; }
 
   int UpdateAge() { return ++m_age; }
+
+  /*! \brief Relative fill-rate cost per pixel of the content that made this region dirty.
+   1.0 is an average control, see CGUIControlProfiler::GetFillCost().
+   */
+  float GetCost() const { return m_cost; }
+  void SetCost(float cost) { m_cost = cost; }
 private:
   int m_age;
+  float m_cost;
 };
 
 typedef std::vector<CDirtyRegion> CDirtyRegionList;
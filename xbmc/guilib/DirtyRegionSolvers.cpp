@@ -10,6 +10,7 @@
 
 #include "windowing/GraphicContext.h"
 
+#include <algorithm>
 #include <stdio.h>
 
 void CUnionDirtyRegionSolver::Solve(const CDirtyRegionList &input, CDirtyRegionList &output)
@@ -71,3 +72,100 @@ void CGreedyDirtyRegionSolver::Solve(const CDirtyRegionList &input, CDirtyRegion
       output.push_back(currentRegion);
   }
 }
+
+CCostClusterDirtyRegionSolver::CCostClusterDirtyRegionSolver()
+  : CCostClusterDirtyRegionSolver(10.0f, 0.01f)
+{
+}
+
+CCostClusterDirtyRegionSolver::CCostClusterDirtyRegionSolver(float costNewRegion, float costPerArea)
+  : m_costNewRegion(costNewRegion), m_costPerArea(costPerArea)
+{
+}
+
+float CCostClusterDirtyRegionSolver::Cost(const Cluster &cluster) const
+{
+  // overlapping members are counted twice in area, so never let the uncovered part go negative
+  float uncovered = std::max(0.0f, cluster.rect.Area() - cluster.area);
+  return m_costNewRegion + m_costPerArea * (cluster.weightedArea + uncovered);
+}
+
+CCostClusterDirtyRegionSolver::Cluster CCostClusterDirtyRegionSolver::Merge(const Cluster &a, const Cluster &b)
+{
+  Cluster merged = a;
+  merged.rect.Union(b.rect);
+  merged.area += b.area;
+  merged.weightedArea += b.weightedArea;
+  return merged;
+}
+
+void CCostClusterDirtyRegionSolver::Solve(const CDirtyRegionList &input, CDirtyRegionList &output)
+{
+  std::vector<Cluster> clusters;
+  clusters.reserve(input.size());
+  for (const auto& region : input)
+  {
+    if (region.IsEmpty())
+      continue;
+
+    // identical rects are common (the same control dirty for several buffered frames)
+    auto it = std::find_if(clusters.begin(), clusters.end(),
+                           [&region](const Cluster& c) { return c.rect == region; });
+    if (it != clusters.end())
+    {
+      float weight = std::max(it->weightedArea / it->area, region.GetCost());
+      it->weightedArea = weight * it->area;
+      continue;
+    }
+
+    Cluster cluster;
+    cluster.rect = region;
+    cluster.area = region.Area();
+    cluster.weightedArea = cluster.area * std::max(region.GetCost(), 0.0f);
+    clusters.push_back(cluster);
+  }
+
+  // agglomerative clustering, always apply the merge with the biggest saving
+  std::vector<float> costs;
+  costs.reserve(clusters.size());
+  for (const auto& cluster : clusters)
+    costs.push_back(Cost(cluster));
+
+  while (clusters.size() > 1)
+  {
+    float bestSaving = 0.0f;
+    size_t bestA = 0;
+    size_t bestB = 0;
+    Cluster bestMerge;
+    float bestCost = 0.0f;
+
+    for (size_t a = 0; a < clusters.size(); a++)
+    {
+      for (size_t b = a + 1; b < clusters.size(); b++)
+      {
+        Cluster merged = Merge(clusters[a], clusters[b]);
+        float cost = Cost(merged);
+        float saving = costs[a] + costs[b] - cost;
+        if (saving > bestSaving)
+        {
+          bestSaving = saving;
+          bestA = a;
+          bestB = b;
+          bestMerge = merged;
+          bestCost = cost;
+        }
+      }
+    }
+
+    if (bestSaving <= 0.0f)
+      break;
+
+    clusters[bestA] = bestMerge;
+    costs[bestA] = bestCost;
+    clusters.erase(clusters.begin() + bestB);
+    costs.erase(costs.begin() + bestB);
+  }
+
+  for (const auto& cluster : clusters)
+    output.emplace_back(cluster.rect, cluster.weightedArea / cluster.area);
+}
@@ -37,3 +37,32 @@ private:
   float m_costNewRegion;
   float m_costPerArea;
 };
+
+/*!
+ \brief Clusters dirty regions into scissored render passes based on their fill-rate cost.
+
+ Every pass is charged a fixed overhead plus the cost of the pixels it covers. Pixels of a
+ dirty region are weighted by the region's cost (see CDirtyRegion::GetCost()), pixels that
+ only get drawn because they are inside the bounding box of a merged pass are charged at the
+ baseline rate. Passes are merged greedily, always picking the pair with the largest saving,
+ until no merge reduces the total cost.
+ */
+class CCostClusterDirtyRegionSolver : public IDirtyRegionSolver
+{
+public:
+  CCostClusterDirtyRegionSolver();
+  CCostClusterDirtyRegionSolver(float costNewRegion, float costPerArea);
+  void Solve(const CDirtyRegionList &input, CDirtyRegionList &output) override;
+private:
+  struct Cluster
+  {
+    CRect rect;
+    float area; //!< sum of the member regions' areas
+    float weightedArea; //!< sum of the member regions' areas multiplied with their cost
+  };
+  float Cost(const Cluster &cluster) const;
+  static Cluster Merge(const Cluster &a, const Cluster &b);
+
+  float m_costNewRegion;
+  float m_costPerArea;
+};
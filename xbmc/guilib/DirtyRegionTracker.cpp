@@ -41,6 +41,10 @@ void CDirtyRegionTracker::SelectAlgorithm()
       CLog::Log(LOGDEBUG, "guilib: Cost reduction as algorithm for solving rendering passes");
       m_solver = new CGreedyDirtyRegionSolver();
       break;
+    case DIRTYREGION_SOLVER_COST_CLUSTER:
+      CLog::Log(LOGDEBUG, "guilib: Fill-rate cost clustering as algorithm for solving rendering passes");
+      m_solver = new CCostClusterDirtyRegionSolver();
+      break;
     case DIRTYREGION_SOLVER_UNION:
       m_solver = new CUnionDirtyRegionSolver();
       CLog::Log(LOGDEBUG, "guilib: Union as algorithm for solving rendering passes");
@@ -138,6 +138,10 @@ CFFmpegImage::~CFFmpegImage()
 bool CFFmpegImage::LoadImageFromMemory(unsigned char* buffer, unsigned int bufSize,
                                       unsigned int width, unsigned int height)
 {
+  // big jpegs can be scaled down by the decoder itself, which skips most of the IDCT work
+  m_lowres = 0;
+  if (GetJpegSize(buffer, bufSize, m_codedWidth, m_codedHeight))
+    m_lowres = GetJpegLowres(m_codedWidth, m_codedHeight, width, height);
 
   if (!Initialize(buffer, bufSize))
   {
@@ -249,6 +253,9 @@ bool CFFmpegImage::Initialize(unsigned char* buffer, size_t bufSize)
     return false;
   }
 
+  if (m_lowres > 0 && codec_params->codec_id == AV_CODEC_ID_MJPEG)
+    m_codec_ctx->lowres = std::min(m_lowres, static_cast<int>(codec->max_lowres));
+
   if (avcodec_open2(m_codec_ctx, codec, NULL) < 0)
   {
     avformat_close_input(&m_fctx);
@@ -295,6 +302,11 @@ AVFrame* CFFmpegImage::ExtractFrame()
   m_width = frame->width;
   m_originalWidth = m_width;
   m_originalHeight = m_height;
+  if (m_codec_ctx->lowres > 0)
+  { // report the size of the image, not the one it was decoded at
+    m_originalWidth = m_codedWidth;
+    m_originalHeight = m_codedHeight;
+  }
 
   const AVPixFmtDescriptor* pixDescriptor = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(frame->format));
   if (pixDescriptor && ((pixDescriptor->flags & (AV_PIX_FMT_FLAG_ALPHA | AV_PIX_FMT_FLAG_PAL)) != 0))
@@ -339,6 +351,59 @@ AVPixelFormat CFFmpegImage::ConvertFormats(AVFrame* frame)
   }
 }
 
+bool CFFmpegImage::GetJpegSize(const unsigned char* buffer, size_t bufSize, unsigned int& width, unsigned int& height)
+{
+  if (bufSize < 4 || buffer[0] != 0xFF || buffer[1] != 0xD8)
+    return false;
+
+  // walk the marker segments up to the start of frame
+  size_t pos = 2;
+  while (pos + 4 <= bufSize)
+  {
+    if (buffer[pos] != 0xFF)
+      return false;
+    unsigned char marker = buffer[pos + 1];
+    if (marker == 0xFF)
+    { // fill byte
+      pos++;
+      continue;
+    }
+    if (marker == 0xD9 || marker == 0xDA) // EOI, SOS
+      return false;
+
+    size_t length = (buffer[pos + 2] << 8) | buffer[pos + 3];
+    // SOF0 - SOF15, except DHT, JPG and DAC
+    if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC)
+    {
+      if (length < 7 || pos + 9 > bufSize)
+        return false;
+      height = (buffer[pos + 5] << 8) | buffer[pos + 6];
+      width = (buffer[pos + 7] << 8) | buffer[pos + 8];
+      return width > 0 && height > 0;
+    }
+    pos += 2 + length;
+  }
+  return false;
+}
+
+int CFFmpegImage::GetJpegLowres(unsigned int width, unsigned int height, unsigned int maxWidth, unsigned int maxHeight)
+{
+  // largest power of two reduction (max 1/8) that still decodes at least at the size the image
+  // gets fitted into, so the final scale stays a downscale. no size to fit into, full size.
+  if (maxWidth == 0 || maxHeight == 0)
+    return 0;
+
+  int lowres = 0;
+  while (lowres < 3)
+  {
+    unsigned int scale = 2 << lowres;
+    if (width < maxWidth * scale && height < maxHeight * scale)
+      break;
+    lowres++;
+  }
+  return lowres;
+}
+
 void CFFmpegImage::FreeIOCtx(AVIOContext** ioctx)
 {
   av_freep(&((*ioctx)->buffer));
@@ -468,8 +533,8 @@ bool CFFmpegImage::DecodeFrame(AVFrame* frame, unsigned int width, unsigned int
 
   // assumption quadratic maximums e.g. 2048x2048
   float ratio = m_width / (float)m_height;
-  unsigned int nHeight = m_originalHeight;
-  unsigned int nWidth = m_originalWidth;
+  unsigned int nHeight = frame->height;
+  unsigned int nWidth = frame->width;
   if (nHeight > height)
   {
     nHeight = height;
@@ -481,7 +546,7 @@ bool CFFmpegImage::DecodeFrame(AVFrame* frame, unsigned int width, unsigned int
     nHeight = (unsigned int)(nWidth / ratio + 0.5f);
   }
 
-  struct SwsContext* context = sws_getContext(m_originalWidth, m_originalHeight, pixFormat,
+  struct SwsContext* context = sws_getContext(frame->width, frame->height, pixFormat,
     nWidth, nHeight, AV_PIX_FMT_RGB32, SWS_BICUBIC, NULL, NULL, NULL);
 
   if (range == AVCOL_RANGE_JPEG)
@@ -494,7 +559,7 @@ bool CFFmpegImage::DecodeFrame(AVFrame* frame, unsigned int width, unsigned int
     sws_setColorspaceDetails(context, inv_table, srcRange, table, dstRange, brightness, contrast, saturation);
   }
 
-  sws_scale(context, frame->data, frame->linesize, 0, m_originalHeight,
+  sws_scale(context, frame->data, frame->linesize, 0, frame->height,
     pictureRGB->data, pictureRGB->linesize);
   sws_freeContext(context);
 
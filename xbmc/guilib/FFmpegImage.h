@@ -80,6 +80,8 @@ private:
   static int EncodeFFmpegFrame(AVCodecContext *avctx, AVPacket *pkt, int *got_packet, AVFrame *frame);
   static int DecodeFFmpegFrame(AVCodecContext *avctx, AVFrame *frame, int *got_frame, AVPacket *pkt);
   static AVPixelFormat ConvertFormats(AVFrame* frame);
+  static bool GetJpegSize(const unsigned char* buffer, size_t bufSize, unsigned int& width, unsigned int& height);
+  static int GetJpegLowres(unsigned int width, unsigned int height, unsigned int maxWidth, unsigned int maxHeight);
   std::string m_strMimeType;
   void CleanupLocalOutputBuffer();
 
@@ -92,4 +94,8 @@ private:
 
   AVFrame* m_pFrame;
   uint8_t* m_outputBuffer;
+
+  int m_lowres = 0; ///< jpeg DCT domain downscaling, decode at 1/2^m_lowres of the size
+  unsigned int m_codedWidth = 0;
+  unsigned int m_codedHeight = 0;
 };
@@ -10,9 +10,11 @@
 
 #include "FileItem.h"
 #include "GUIInfoManager.h"
+#include "GUILargeTextureManager.h"
 #include "GUIListItemLayout.h"
 #include "GUIMessage.h"
 #include "ServiceBroker.h"
+#include "guilib/GUIComponent.h"
 #include "guilib/guiinfo/GUIInfoLabels.h"
 #include "input/Key.h"
 #include "listproviders/IListProvider.h"
@@ -26,11 +28,18 @@
 #include "utils/XBMCTinyXML.h"
 #include "utils/log.h"
 
+#include <algorithm>
+
 #define HOLD_TIME_START 100
 #define HOLD_TIME_END   3000
 #define SCROLLING_GAP   200U
 #define SCROLLING_THRESHOLD 300U
 
+// scroll speed (rows per second) needed before we start prefetching
+#define PREFETCH_MIN_VELOCITY 2.0f
+// how far ahead (in seconds of scrolling) to prefetch
+#define PREFETCH_LOOKAHEAD 0.75f
+
 CGUIBaseContainer::CGUIBaseContainer(int parentID, int controlID, float posX, float posY, float width, float height, ORIENTATION orientation, const CScroller& scroller, int preloadItems)
     : IGUIContainer(parentID, controlID, posX, posY, width, height)
     , m_scroller(scroller)
@@ -59,6 +68,8 @@ CGUIBaseContainer::CGUIBaseContainer(const CGUIBaseContainer &) = default;
 
 CGUIBaseContainer::~CGUIBaseContainer(void)
 {
+  ClearPrefetch();
+
   // release the container from items
   for (const auto& item : m_items)
     item->FreeMemory();
@@ -108,6 +119,8 @@ void CGUIBaseContainer::Process(unsigned int currentTime, CDirtyRegionList &dirt
   if ((int)m_items.size() > m_itemsPerPage + cacheBefore + cacheAfter)
     FreeMemory(CorrectOffset(offset - cacheBefore, 0), CorrectOffset(offset + m_itemsPerPage + 1 + cacheAfter, 0));
 
+  UpdatePrefetch(offset - cacheBefore, offset + m_itemsPerPage + 1 + cacheAfter, 1, currentTime);
+
   CPoint origin = CPoint(m_posX, m_posY) + m_renderOffset;
   float pos = (m_orientation == VERTICAL) ? origin.y : origin.x;
   float end = (m_orientation == VERTICAL) ? m_posY + m_height : m_posX + m_width;
@@ -134,9 +147,9 @@ void CGUIBaseContainer::Process(unsigned int currentTime, CDirtyRegionList &dirt
 
       // render our item
       if (m_orientation == VERTICAL)
-        ProcessItem(origin.x, pos, item, focused, currentTime, dirtyregions);
+        ProcessItem(origin.x, pos, item, itemNo, focused, currentTime, dirtyregions);
       else
-        ProcessItem(pos, origin.y, item, focused, currentTime, dirtyregions);
+        ProcessItem(pos, origin.y, item, itemNo, focused, currentTime, dirtyregions);
     }
     // increment our position
     pos += focused ? m_focusedLayout->Size(m_orientation) : m_layout->Size(m_orientation);
@@ -152,7 +165,7 @@ void CGUIBaseContainer::Process(unsigned int currentTime, CDirtyRegionList &dirt
   CGUIControl::Process(currentTime, dirtyregions);
 }
 
-void CGUIBaseContainer::ProcessItem(float posX, float posY, CGUIListItemPtr& item, bool focused, unsigned int currentTime, CDirtyRegionList &dirtyregions)
+void CGUIBaseContainer::ProcessItem(float posX, float posY, CGUIListItemPtr& item, int index, bool focused, unsigned int currentTime, CDirtyRegionList &dirtyregions)
 {
   if (!m_focusedLayout || !m_layout) return;
 
@@ -165,7 +178,9 @@ void CGUIBaseContainer::ProcessItem(float posX, float posY, CGUIListItemPtr& ite
   {
     if (!item->GetFocusedLayout())
     {
-      item->SetFocusedLayout(CGUIListItemLayoutPtr(new CGUIListItemLayout(*m_focusedLayout, this)));
+      if (!item->GetLayout())
+        m_realized.items.push_back({index, item});
+      item->SetFocusedLayout(AcquireLayout(true));
     }
     if (item->GetFocusedLayout())
     {
@@ -189,16 +204,22 @@ void CGUIBaseContainer::ProcessItem(float posX, float posY, CGUIListItemPtr& ite
   {
     if (item->GetFocusedLayout())
       item->GetFocusedLayout()->SetFocusedItem(0);  // focus is not set
+    bool newLayout = false;
     if (!item->GetLayout())
     {
-      CGUIListItemLayoutPtr layout(new CGUIListItemLayout(*m_layout));
-      layout->SetParentControl(this);
-      item->SetLayout(std::move(layout));
+      if (!item->GetFocusedLayout())
+        m_realized.items.push_back({index, item});
+      item->SetLayout(AcquireLayout(false));
+      newLayout = true;
     }
     if (item->GetFocusedLayout())
       item->GetFocusedLayout()->Process(item.get(), m_parentID, currentTime, dirtyregions);
     if (item->GetLayout())
+    {
       item->GetLayout()->Process(item.get(), m_parentID, currentTime, dirtyregions);
+      if (newLayout)
+        LearnPrefetchArt(*item, *item->GetLayout());
+    }
   }
 
   CServiceBroker::GetWinSystem()->GetGfxContext().RestoreOrigin();
@@ -897,6 +918,7 @@ void CGUIBaseContainer::AllocResources()
 void CGUIBaseContainer::FreeResources(bool immediately)
 {
   CGUIControl::FreeResources(immediately);
+  ClearPrefetch();
   if (m_listProvider)
   {
     if (immediately)
@@ -912,8 +934,9 @@ void CGUIBaseContainer::UpdateLayout(bool updateAllItems)
 {
   if (updateAllItems)
   { // free memory of items
-    for (iItems it = m_items.begin(); it != m_items.end(); ++it)
-      (*it)->FreeMemory();
+    FreeRealizedLayouts();
+    // the new layout may show different art
+    m_prefetchArt.clear();
   }
   // and recalculate the layout
   CalculateLayout();
@@ -1178,8 +1201,12 @@ int CGUIBaseContainer::CorrectOffset(int offset, int cursor) const
 void CGUIBaseContainer::Reset()
 {
   m_wasReset = true;
+  for (const auto& realized : m_realized.items)
+    RecycleLayouts(*realized.item);
+  m_realized.items.clear();
   m_items.clear();
   m_lastItem.reset();
+  ClearPrefetch();
   ResetAutoScrolling();
 }
 
@@ -1225,17 +1252,143 @@ void CGUIBaseContainer::SetRenderOffset(const CPoint &offset)
 
 void CGUIBaseContainer::FreeMemory(int keepStart, int keepEnd)
 {
-  if (keepStart < keepEnd)
-  { // remove before keepStart and after keepEnd
-    for (int i = 0; i < keepStart && i < (int)m_items.size(); ++i)
-      m_items[i]->FreeMemory();
-    for (int i = std::max(keepEnd + 1, 0); i < (int)m_items.size(); ++i)
-      m_items[i]->FreeMemory();
+  auto keep = [keepStart, keepEnd](int i) {
+    if (keepStart < keepEnd)
+      return i >= keepStart && i <= keepEnd;
+    // wrapping
+    return i <= keepEnd || i >= keepStart;
+  };
+
+  // only items that own a layout need to be looked at
+  auto& items = m_realized.items;
+  for (size_t i = 0; i < items.size();)
+  {
+    const CGUIListItemPtr& item = items[i].item;
+    if (keep(items[i].index) && (item->GetLayout() || item->GetFocusedLayout()))
+    {
+      ++i;
+      continue;
+    }
+    RecycleLayouts(*item);
+    items[i] = items.back();
+    items.pop_back();
   }
-  else
-  { // wrapping
-    for (int i = std::max(keepEnd + 1, 0); i < keepStart && i < (int)m_items.size(); ++i)
-      m_items[i]->FreeMemory();
+}
+
+void CGUIBaseContainer::UpdatePrefetch(int firstRow, int lastRow, int itemsPerRow, unsigned int currentTime)
+{
+  const float rowSize = m_layout->Size(m_orientation);
+  const float value = m_scroller.GetValue();
+  if (m_prefetchTime && currentTime > m_prefetchTime && rowSize > 0)
+  {
+    float velocity = (value - m_prefetchScrollValue) / rowSize * 1000.0f / (currentTime - m_prefetchTime);
+    m_scrollVelocity = 0.7f * m_scrollVelocity + 0.3f * velocity;
+  }
+  m_prefetchScrollValue = value;
+  m_prefetchTime = currentTime;
+
+  std::vector<std::string> paths;
+  if (!m_prefetchArt.empty() && fabs(m_scrollVelocity) >= PREFETCH_MIN_VELOCITY)
+  {
+    int rows = std::min(std::max(static_cast<int>(fabs(m_scrollVelocity) * PREFETCH_LOOKAHEAD), 1),
+                        2 * m_itemsPerPage);
+    int step = m_scrollVelocity > 0 ? 1 : -1;
+    int row = m_scrollVelocity > 0 ? lastRow + 1 : firstRow - 1;
+    for (int i = 0; i < rows; i++, row += step)
+    {
+      for (int col = 0; col < itemsPerRow; col++)
+      {
+        int itemNo = CorrectOffset(row, col);
+        if (itemNo < 0 || itemNo >= static_cast<int>(m_items.size()))
+          continue;
+        const CGUIListItem::ArtMap &art = m_items[itemNo]->GetArt();
+        for (const auto& type : m_prefetchArt)
+        {
+          auto it = art.find(type);
+          if (it != art.end() && !it->second.empty())
+            paths.push_back(it->second);
+        }
+      }
+    }
+  }
+
+  CServiceBroker::GetGUI()->GetLargeTextureManager().Prefetch(this, paths);
+}
+
+void CGUIBaseContainer::ClearPrefetch()
+{
+  m_scrollVelocity = 0.0f;
+  m_prefetchTime = 0;
+  if (CServiceBroker::GetGUI())
+    CServiceBroker::GetGUI()->GetLargeTextureManager().Prefetch(this, std::vector<std::string>());
+}
+
+void CGUIBaseContainer::LearnPrefetchArt(const CGUIListItem &item, const CGUIListItemLayout &layout)
+{
+  const CGUIListItem::ArtMap &art = item.GetArt();
+  if (art.empty())
+    return;
+
+  std::vector<std::string> files;
+  layout.GetImageFiles(files);
+  for (const auto& it : art)
+  {
+    if (std::find(files.begin(), files.end(), it.second) != files.end())
+      m_prefetchArt.insert(it.first);
+  }
+}
+
+void CGUIBaseContainer::FreeRealizedLayouts()
+{
+  for (const auto& realized : m_realized.items)
+    realized.item->FreeMemory();
+  m_realized.items.clear();
+  m_realized.pool.clear();
+  m_realized.focusedPool.clear();
+}
+
+CGUIListItemLayoutPtr CGUIBaseContainer::AcquireLayout(bool focused)
+{
+  const CGUIListItemLayout *source = focused ? m_focusedLayout : m_layout;
+  const CGUIListItemLayout *&pooledSource = focused ? m_realized.focusedLayout : m_realized.layout;
+  std::vector<CGUIListItemLayoutPtr> &pool = focused ? m_realized.focusedPool : m_realized.pool;
+
+  // the skin switched layouts, pooled copies of the old one are useless
+  if (pooledSource != source)
+  {
+    pool.clear();
+    pooledSource = source;
+  }
+
+  if (!pool.empty())
+  {
+    CGUIListItemLayoutPtr layout = std::move(pool.back());
+    pool.pop_back();
+    return layout;
+  }
+
+  return CGUIListItemLayoutPtr(new CGUIListItemLayout(*source, this));
+}
+
+void CGUIBaseContainer::RecycleLayouts(CGUIListItem& item)
+{
+  // enough to replace every visible and cached item at once
+  const size_t maxPoolSize = static_cast<size_t>(std::max(m_itemsPerPage, 1) + 2 * m_cacheItems + 2) * 4;
+
+  CGUIListItemLayoutPtr layout = item.ReleaseLayout();
+  if (layout)
+  {
+    layout->Recycle();
+    if (m_realized.layout == m_layout && m_realized.pool.size() < maxPoolSize)
+      m_realized.pool.push_back(std::move(layout));
+  }
+
+  CGUIListItemLayoutPtr focusedLayout = item.ReleaseFocusedLayout();
+  if (focusedLayout)
+  {
+    focusedLayout->Recycle();
+    if (m_realized.focusedLayout == m_focusedLayout && m_realized.focusedPool.size() < 2)
+      m_realized.focusedPool.push_back(std::move(focusedLayout));
   }
 }
 
@@ -18,6 +18,9 @@
 #include "utils/Stopwatch.h"
 
 #include <list>
+#include <memory>
+#include <set>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -99,7 +102,7 @@ protected:
   EVENT_RESULT OnMouseEvent(const CPoint &point, const CMouseEvent &event) override;
   bool OnClick(int actionID);
 
-  virtual void ProcessItem(float posX, float posY, CGUIListItemPtr& item, bool focused, unsigned int currentTime, CDirtyRegionList &dirtyregions);
+  virtual void ProcessItem(float posX, float posY, CGUIListItemPtr& item, int index, bool focused, unsigned int currentTime, CDirtyRegionList &dirtyregions);
 
   void Render() override;
   virtual void RenderItem(float posX, float posY, CGUIListItem *item, bool focused);
@@ -127,6 +130,9 @@ protected:
   int ScrollCorrectionRange() const;
   inline float Size() const;
   void FreeMemory(int keepStart, int keepEnd);
+  void FreeRealizedLayouts();
+  std::unique_ptr<CGUIListItemLayout> AcquireLayout(bool focused);
+  void RecycleLayouts(CGUIListItem& item);
   void GetCurrentLayouts();
   CGUIListItemLayout *GetFocusedLayout() const;
 
@@ -152,6 +158,48 @@ protected:
   bool m_layoutCondition = false;
   bool m_focusedLayoutCondition = false;
 
+  /*! \brief Item layouts are only created for the visible items plus the cached ones around them.
+   Only the items that currently own a layout are tracked, so freeing them never walks the whole
+   list, and layouts of items that leave the window are pooled and reused for the items scrolling
+   in rather than being copied from the skin's layout again. A copied container starts empty.
+   */
+  struct CRealizedLayouts
+  {
+    CRealizedLayouts() = default;
+    CRealizedLayouts(const CRealizedLayouts&) {}
+    CRealizedLayouts& operator=(const CRealizedLayouts&) { return *this; }
+
+    struct CItem
+    {
+      int index; //!< position of the item in m_items, items may be shared with other containers
+      CGUIListItemPtr item;
+    };
+
+    std::vector<CItem> items;
+    std::vector<std::unique_ptr<CGUIListItemLayout>> pool;
+    std::vector<std::unique_ptr<CGUIListItemLayout>> focusedPool;
+    const CGUIListItemLayout *layout = nullptr; //!< layout the pooled layouts were copied from
+    const CGUIListItemLayout *focusedLayout = nullptr;
+  };
+  CRealizedLayouts m_realized;
+
+  /*! \brief Prefetch the art of the rows that are about to scroll into view.
+   The scroll velocity decides how many rows past the cached ones are requested, in the direction
+   of travel and nearest first. Nothing is prefetched while the container isn't scrolling.
+   \param firstRow first row kept in memory
+   \param lastRow last row kept in memory
+   \param itemsPerRow number of items in each row
+   \param currentTime time of the current frame
+   */
+  void UpdatePrefetch(int firstRow, int lastRow, int itemsPerRow, unsigned int currentTime);
+  void ClearPrefetch();
+  void LearnPrefetchArt(const CGUIListItem &item, const CGUIListItemLayout &layout);
+
+  std::set<std::string> m_prefetchArt; ///< art types shown by the item layouts
+  float m_prefetchScrollValue = 0.0f;
+  unsigned int m_prefetchTime = 0;
+  float m_scrollVelocity = 0.0f; ///< smoothed, in rows per second
+
   void ScrollToOffset(int offset);
   void SetContainerMoving(int direction);
   void UpdateScrollOffset(unsigned int currentTime);
@@ -151,7 +151,7 @@ void CGUIControl::DoProcess(unsigned int currentTime, CDirtyRegionList &dirtyreg
 
   if (changed)
   {
-    dirtyregions.emplace_back(dirtyRegion);
+    dirtyregions.emplace_back(dirtyRegion, CGUIControlProfiler::Instance().GetFillCost(ControlType));
   }
 }
 
@@ -12,6 +12,8 @@
 #include "utils/TimeUtils.h"
 #include "utils/XBMCTinyXML.h"
 
+#include <algorithm>
+
 bool CGUIControlProfiler::m_bIsRunning = false;
 
 CGUIControlProfilerItem::CGUIControlProfilerItem(CGUIControlProfiler *pProfiler, CGUIControlProfilerItem *pParent, CGUIControl *pControl)
@@ -217,6 +219,24 @@ CGUIControlProfilerItem *CGUIControlProfilerItem::FindOrAddControl(CGUIControl *
   return NULL;
 }
 
+void CGUIControlProfilerItem::AccumulateFillCost(std::map<CGUIControl::GUICONTROLTYPES, std::pair<double, double>> &stats) const
+{
+  // only leaf controls draw pixels themselves, groups just add up their children
+  if (m_pControl && m_vecChildren.empty() && m_renderTime)
+  {
+    float area = m_pControl->GetRenderRegion().Area();
+    if (area > 0.0f)
+    {
+      auto& stat = stats[m_ControlType];
+      stat.first += m_renderTime;
+      stat.second += area;
+    }
+  }
+
+  for (const auto* child : m_vecChildren)
+    child->AccumulateFillCost(stats);
+}
+
 CGUIControlProfiler::CGUIControlProfiler(void)
 : m_ItemHead(NULL, NULL, NULL), m_pLastItem(NULL)
 // m_bIsRunning(false), no isRunning because it is static
@@ -309,6 +329,7 @@ void CGUIControlProfiler::EndFrame(void)
     }
 
     m_bIsRunning = false;
+    UpdateFillCost();
     if (SaveResults())
       m_ItemHead.Reset(this);
   }
@@ -332,3 +353,37 @@ bool CGUIControlProfiler::SaveResults(void)
   m_ItemHead.SaveToXML(root);
   return doc.SaveFile(m_strOutputFile);
 }
+
+void CGUIControlProfiler::UpdateFillCost(void)
+{
+  std::map<CGUIControl::GUICONTROLTYPES, std::pair<double, double>> stats;
+  m_ItemHead.AccumulateFillCost(stats);
+
+  double totalTime = 0.0;
+  double totalArea = 0.0;
+  for (const auto& stat : stats)
+  {
+    totalTime += stat.second.first;
+    totalArea += stat.second.second;
+  }
+
+  if (totalTime <= 0.0 || totalArea <= 0.0)
+    return;
+
+  // normalize so that the average rendered pixel has a cost of 1
+  const double average = totalTime / totalArea;
+  m_fillCost.clear();
+  for (const auto& stat : stats)
+  {
+    float cost = static_cast<float>(stat.second.first / stat.second.second / average);
+    m_fillCost[stat.first] = std::min(std::max(cost, 0.1f), 10.0f);
+  }
+}
+
+float CGUIControlProfiler::GetFillCost(CGUIControl::GUICONTROLTYPES type) const
+{
+  auto it = m_fillCost.find(type);
+  if (it == m_fillCost.end())
+    return 1.0f;
+  return it->second;
+}
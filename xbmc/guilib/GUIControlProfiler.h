@@ -10,6 +10,7 @@
 
 #include "GUIControl.h"
 
+#include <map>
 #include <vector>
 
 class CGUIControlProfiler;
@@ -43,6 +44,7 @@ public:
 
   CGUIControlProfilerItem *AddControl(CGUIControl *pControl);
   CGUIControlProfilerItem *FindOrAddControl(CGUIControl *pControl, bool recurse);
+  void AccumulateFillCost(std::map<CGUIControl::GUICONTROLTYPES, std::pair<double, double>> &stats) const;
 };
 
 class CGUIControlProfiler
@@ -64,6 +66,12 @@ public:
   bool SaveResults(void);
   unsigned int GetTotalTime(void) const { return m_ItemHead.GetTotalTime(); };
 
+  /*! \brief Relative render cost per pixel of a control type, as measured by the last profiling run.
+   \return 1.0 for an average control or if no measurement is available
+   \sa CCostClusterDirtyRegionSolver
+   */
+  float GetFillCost(CGUIControl::GUICONTROLTYPES type) const;
+
   float m_fPerfScale;
 private:
   CGUIControlProfiler(void);
@@ -74,11 +82,13 @@ private:
   CGUIControlProfilerItem m_ItemHead;
   CGUIControlProfilerItem *m_pLastItem;
   CGUIControlProfilerItem *FindOrAddControl(CGUIControl *pControl);
+  void UpdateFillCost(void);
 
   static bool m_bIsRunning;
   std::string m_strOutputFile;
   int m_iMaxFrameCount = 200;
   int m_iFrameCount = 0;
+  std::map<CGUIControl::GUICONTROLTYPES, float> m_fillCost;
 };
 
 #define GUIPROFILER_VISIBILITY_BEGIN(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().BeginVisibility(x); }
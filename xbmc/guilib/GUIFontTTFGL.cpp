@@ -56,6 +56,9 @@ CGUIFontTTFGL::~CGUIFontTTFGL(void)
 
 bool CGUIFontTTFGL::FirstBegin()
 {
+  // queued GUI textures are drawn before the font texture and blending get set up
+  CServiceBroker::GetRenderSystem()->FlushGUIBatches();
+
 #if defined(HAS_GL)
   GLenum pixformat = GL_RED;
   GLenum internalFormat;
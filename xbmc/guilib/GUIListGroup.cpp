@@ -8,6 +8,7 @@
 
 #include "GUIListGroup.h"
 
+#include "GUIImage.h"
 #include "GUIListLabel.h"
 #include "utils/log.h"
 
@@ -177,6 +178,29 @@ unsigned int CGUIListGroup::GetFocusedItem() const
   return m_bHasFocus ? 1 : 0;
 }
 
+void CGUIListGroup::GetImageFiles(std::vector<std::string> &files) const
+{
+  for (ciControls it = m_children.begin(); it != m_children.end(); ++it)
+  {
+    switch ((*it)->GetControlType())
+    {
+    case CGUIControl::GUICONTROL_LISTGROUP:
+      static_cast<const CGUIListGroup *>(*it)->GetImageFiles(files);
+      break;
+    case CGUIControl::GUICONTROL_IMAGE:
+    case CGUIControl::GUICONTROL_BORDEREDIMAGE:
+    {
+      const std::string &file = static_cast<const CGUIImage *>(*it)->GetFileName();
+      if (!file.empty())
+        files.push_back(file);
+      break;
+    }
+    default:
+      break;
+    }
+  }
+}
+
 bool CGUIListGroup::MoveLeft()
 {
   for (iControls it = m_children.begin(); it != m_children.end(); it++)
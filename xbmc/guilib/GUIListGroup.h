@@ -15,6 +15,9 @@
 
 #include "GUIControlGroup.h"
 
+#include <string>
+#include <vector>
+
 /*!
  \ingroup controls
  \brief a group of controls within a list/panel container
@@ -44,6 +47,11 @@ public:
   void SetState(bool selected, bool focused);
   void SelectItemFromPoint(const CPoint &point);
 
+  /*! \brief Collect the files currently shown by the images in this group and its subgroups.
+   \param files [out] the files are appended, empty ones are skipped.
+   */
+  void GetImageFiles(std::vector<std::string> &files) const;
+
 protected:
   const CGUIListItem *m_item;
 };
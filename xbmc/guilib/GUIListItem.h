@@ -131,6 +131,12 @@ public:
   void SetFocusedLayout(CGUIListItemLayoutPtr layout);
   CGUIListItemLayout *GetFocusedLayout();
 
+  /*! \brief Take the layouts away from this item, e.g. to reuse them for another item.
+   \sa CGUIListItemLayout::Recycle
+   */
+  CGUIListItemLayoutPtr ReleaseLayout();
+  CGUIListItemLayoutPtr ReleaseFocusedLayout();
+
   void FreeIcons();
   void FreeMemory(bool immediately = false);
   void SetInvalid();
@@ -215,6 +215,14 @@ void CGUIListItemLayout::FreeResources(bool immediately)
   m_group.FreeResources(immediately);
 }
 
+void CGUIListItemLayout::Recycle()
+{
+  m_group.FreeResources();
+  m_group.ResetAnimations();
+  m_group.SetFocusedItem(0);
+  m_invalidated = true;
+}
+
 #ifdef _DEBUG
 void CGUIListItemLayout::DumpTextureUse()
 {
@@ -31,7 +31,13 @@ public:
   void ResetAnimation(ANIMATION_TYPE animType);
   void SetInvalid() { m_invalidated = true; };
   void FreeResources(bool immediately = false);
+
+  /*! \brief Prepare the layout to be used for a different item.
+   Frees resources, stops animations and forces the info of the next item to be read on Process().
+   */
+  void Recycle();
   void SetParentControl(CGUIControl *control) { m_group.SetParentControl(control); };
+  void GetImageFiles(std::vector<std::string> &files) const { m_group.GetImageFiles(files); };
 
 //#ifdef GUILIB_PYTHON_COMPATIBILITY
   void CreateListControlLayouts(float width, float height, bool focused, const CLabelInfo &labelInfo, const CLabelInfo &labelInfo2, const CTextureInfo &texture, const CTextureInfo &textureFocus, float texHeight, float iconWidth, float iconHeight, const std::string &nofocusCondition, const std::string &focusCondition);
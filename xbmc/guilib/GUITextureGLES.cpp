@@ -17,8 +17,6 @@
 #include "windowing/GraphicContext.h"
 #include "windowing/WinSystem.h"
 
-#include <cstddef>
-
 CGUITexture* CGUITexture::CreateTexture(
     float posX, float posY, float width, float height, const CTextureInfo& texture)
 {
@@ -44,100 +42,44 @@ void CGUITextureGLES::Begin(UTILS::Color color)
   if (m_diffuse.size())
     m_diffuse.m_textures[0]->LoadToGPU();
 
-  texture->BindToUnit(0);
+  m_batchState.texture = texture;
+  m_batchState.diffuse = m_diffuse.size() ? m_diffuse.m_textures[0] : nullptr;
 
   // Setup Colors
-  m_col[0] = (GLubyte)GET_R(color);
-  m_col[1] = (GLubyte)GET_G(color);
-  m_col[2] = (GLubyte)GET_B(color);
-  m_col[3] = (GLubyte)GET_A(color);
+  std::array<GLubyte, 4>& col = m_batchState.color;
+  col[0] = (GLubyte)GET_R(color);
+  col[1] = (GLubyte)GET_G(color);
+  col[2] = (GLubyte)GET_B(color);
+  col[3] = (GLubyte)GET_A(color);
 
   if (CServiceBroker::GetWinSystem()->UseLimitedColor())
   {
-    m_col[0] = (235 - 16) * m_col[0] / 255 + 16;
-    m_col[1] = (235 - 16) * m_col[1] / 255 + 16;
-    m_col[2] = (235 - 16) * m_col[2] / 255 + 16;
+    col[0] = (235 - 16) * col[0] / 255 + 16;
+    col[1] = (235 - 16) * col[1] / 255 + 16;
+    col[2] = (235 - 16) * col[2] / 255 + 16;
   }
 
-  bool hasAlpha = m_texture.m_textures[m_currentFrame]->HasAlpha() || m_col[3] < 255;
+  bool hasAlpha = texture->HasAlpha() || col[3] < 255;
+  bool opaqueColor = col[0] == 255 && col[1] == 255 && col[2] == 255 && col[3] == 255;
 
-  if (m_diffuse.size())
+  if (m_batchState.diffuse)
   {
-    if (m_col[0] == 255 && m_col[1] == 255 && m_col[2] == 255 && m_col[3] == 255 )
-    {
-      m_renderSystem->EnableGUIShader(SM_MULTI);
-    }
-    else
-    {
-      m_renderSystem->EnableGUIShader(SM_MULTI_BLENDCOLOR);
-    }
-
-    hasAlpha |= m_diffuse.m_textures[0]->HasAlpha();
-
-    m_diffuse.m_textures[0]->BindToUnit(1);
-
+    m_batchState.method = opaqueColor ? SM_MULTI : SM_MULTI_BLENDCOLOR;
+    hasAlpha |= m_batchState.diffuse->HasAlpha();
   }
   else
   {
-    if (m_col[0] == 255 && m_col[1] == 255 && m_col[2] == 255 && m_col[3] == 255)
-    {
-      m_renderSystem->EnableGUIShader(SM_TEXTURE_NOBLEND);
-    }
-    else
-    {
-      m_renderSystem->EnableGUIShader(SM_TEXTURE);
-    }
+    m_batchState.method = opaqueColor ? SM_TEXTURE_NOBLEND : SM_TEXTURE;
   }
 
-  if ( hasAlpha )
-  {
-    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_ALPHA, GL_ONE);
-    glEnable( GL_BLEND );
-  }
-  else
-  {
-    glDisable(GL_BLEND);
-  }
+  m_batchState.blend = hasAlpha;
   m_packedVertices.clear();
 }
 
 void CGUITextureGLES::End()
 {
-  if (m_packedVertices.size())
-  {
-    GLint posLoc  = m_renderSystem->GUIShaderGetPos();
-    GLint tex0Loc = m_renderSystem->GUIShaderGetCoord0();
-    GLint tex1Loc = m_renderSystem->GUIShaderGetCoord1();
-    GLint uniColLoc = m_renderSystem->GUIShaderGetUniCol();
-
-    if(uniColLoc >= 0)
-    {
-      glUniform4f(uniColLoc,(m_col[0] / 255.0f), (m_col[1] / 255.0f), (m_col[2] / 255.0f), (m_col[3] / 255.0f));
-    }
-
-    if(m_diffuse.size())
-    {
-      glVertexAttribPointer(tex1Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), (char*)&m_packedVertices[0] + offsetof(PackedVertex, u2));
-      glEnableVertexAttribArray(tex1Loc);
-    }
-    glVertexAttribPointer(posLoc, 3, GL_FLOAT, 0, sizeof(PackedVertex), (char*)&m_packedVertices[0] + offsetof(PackedVertex, x));
-    glEnableVertexAttribArray(posLoc);
-    glVertexAttribPointer(tex0Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), (char*)&m_packedVertices[0] + offsetof(PackedVertex, u1));
-    glEnableVertexAttribArray(tex0Loc);
-
-    glDrawElements(GL_TRIANGLES, m_packedVertices.size()*6 / 4, GL_UNSIGNED_SHORT, m_idx.data());
-
-    if (m_diffuse.size())
-      glDisableVertexAttribArray(tex1Loc);
-
-    glDisableVertexAttribArray(posLoc);
-    glDisableVertexAttribArray(tex0Loc);
-  }
-
-  if (m_diffuse.size())
-    glActiveTexture(GL_TEXTURE0);
-  glEnable(GL_BLEND);
-  m_renderSystem->DisableGUIShader();
+  // quads are queued and drawn together with compatible ones, see CGUIRenderBatcherGLES
+  m_renderSystem->GetGUIBatcher().Add(m_batchState, m_packedVertices);
 }
 
 void CGUITextureGLES::Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation)
@@ -213,17 +155,6 @@ void CGUITextureGLES::Draw(float *x, float *y, float *z, const CRect &texture, c
     vertices[i].z = z[i];
     m_packedVertices.push_back(vertices[i]);
   }
-
-  if ((m_packedVertices.size() / 4) > (m_idx.size() / 6))
-  {
-    size_t i = m_packedVertices.size() - 4;
-    m_idx.push_back(i+0);
-    m_idx.push_back(i+1);
-    m_idx.push_back(i+2);
-    m_idx.push_back(i+2);
-    m_idx.push_back(i+3);
-    m_idx.push_back(i+0);
-  }
 }
 
 void CGUITexture::DrawQuad(const CRect& rect,
@@ -232,6 +163,7 @@ void CGUITexture::DrawQuad(const CRect& rect,
                            const CRect* texCoords)
 {
   CRenderSystemGLES *renderSystem = dynamic_cast<CRenderSystemGLES*>(CServiceBroker::GetRenderSystem());
+  renderSystem->FlushGUIBatches();
   if (texture)
   {
     texture->LoadToGPU();
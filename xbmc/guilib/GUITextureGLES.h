@@ -9,6 +9,7 @@
 #pragma once
 
 #include "GUITexture.h"
+#include "rendering/gles/GUIRenderBatcherGLES.h"
 #include "utils/Color.h"
 
 #include <array>
@@ -16,14 +17,6 @@
 
 #include "system_gl.h"
 
-struct PackedVertex
-{
-  float x, y, z;
-  float u1, v1;
-  float u2, v2;
-};
-typedef std::vector<PackedVertex> PackedVertices;
-
 class CRenderSystemGLES;
 
 class CGUITextureGLES : public CGUITexture
@@ -42,10 +35,9 @@ protected:
 private:
   CGUITextureGLES(const CGUITextureGLES& texture) = default;
 
-  std::array<GLubyte, 4> m_col;
+  GUIBatchState m_batchState;
 
   PackedVertices m_packedVertices;
-  std::vector<GLushort> m_idx;
   CRenderSystemGLES *m_renderSystem;
 };
 
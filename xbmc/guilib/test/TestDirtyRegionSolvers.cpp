@@ -0,0 +1,172 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "guilib/DirtyRegionSolvers.h"
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+struct TraceRegion
+{
+  int frame;
+  float x1, y1, x2, y2;
+  float cost;
+};
+
+// Dirty regions recorded on a 1280x720 home screen: a busy spinner in the top
+// right corner, a clock label, a focus change in the main menu and a fanart
+// crossfade with an expensive (diffuse + fade) image in the last frames.
+const TraceRegion trace[] = {
+  {0, 1200, 20, 1260, 80, 3.0f},   {0, 1100, 20, 1180, 50, 0.5f},
+  {1, 1200, 20, 1260, 80, 3.0f},
+  {2, 1200, 20, 1260, 80, 3.0f},   {2, 40, 300, 400, 360, 1.0f},  {2, 40, 360, 400, 420, 1.0f},
+  {3, 1200, 20, 1260, 80, 3.0f},   {3, 40, 360, 400, 420, 1.0f},  {3, 40, 420, 400, 480, 1.0f},
+  {4, 1200, 20, 1260, 80, 3.0f},
+  {5, 1200, 20, 1260, 80, 3.0f},   {5, 0, 0, 1280, 720, 4.0f},
+  {6, 1200, 20, 1260, 80, 3.0f},   {6, 0, 0, 1280, 720, 4.0f},
+  {7, 1200, 20, 1260, 80, 3.0f},   {7, 40, 420, 400, 480, 1.0f},  {7, 1100, 20, 1180, 50, 0.5f},
+};
+
+const int traceFrames = 8;
+const int buffering = 3;
+
+// replays the trace like CDirtyRegionTracker and returns the pixels drawn per frame
+std::vector<float> Replay(IDirtyRegionSolver &solver, std::vector<size_t> *passes = nullptr)
+{
+  std::vector<float> pixels;
+  CDirtyRegionList marked;
+  for (int frame = 0; frame < traceFrames; frame++)
+  {
+    for (const auto& region : trace)
+    {
+      if (region.frame == frame)
+        marked.emplace_back(CRect(region.x1, region.y1, region.x2, region.y2), region.cost);
+    }
+
+    CDirtyRegionList output;
+    solver.Solve(marked, output);
+
+    float drawn = 0.0f;
+    for (const auto& region : output)
+      drawn += region.Area();
+    pixels.push_back(drawn);
+    if (passes)
+      passes->push_back(output.size());
+
+    for (int i = static_cast<int>(marked.size()) - 1; i >= 0; i--)
+    {
+      if (marked[i].UpdateAge() >= buffering)
+        marked.erase(marked.begin() + i);
+    }
+  }
+  return pixels;
+}
+
+float Sum(const std::vector<float> &values)
+{
+  float sum = 0.0f;
+  for (float value : values)
+    sum += value;
+  return sum;
+}
+
+} // namespace
+
+TEST(TestDirtyRegionSolvers, CostClusterCoversInput)
+{
+  CCostClusterDirtyRegionSolver solver;
+  CDirtyRegionList input;
+  input.emplace_back(CRect(0, 0, 10, 10), 1.0f);
+  input.emplace_back(CRect(500, 500, 600, 600), 2.0f);
+  input.emplace_back(CRect(5, 5, 20, 20), 1.0f);
+
+  CDirtyRegionList output;
+  solver.Solve(input, output);
+
+  for (const auto& in : input)
+  {
+    bool covered = false;
+    for (const auto& out : output)
+    {
+      CRect intersection(out);
+      if (intersection.Intersect(in) == in)
+        covered = true;
+    }
+    EXPECT_TRUE(covered);
+  }
+}
+
+TEST(TestDirtyRegionSolvers, CostClusterMergesAdjacent)
+{
+  CCostClusterDirtyRegionSolver solver;
+  CDirtyRegionList input;
+  input.emplace_back(CRect(0, 0, 100, 10));
+  input.emplace_back(CRect(0, 10, 100, 20));
+
+  CDirtyRegionList output;
+  solver.Solve(input, output);
+
+  ASSERT_EQ(1u, output.size());
+  EXPECT_EQ(CRect(0, 0, 100, 20), static_cast<CRect>(output[0]));
+}
+
+TEST(TestDirtyRegionSolvers, CostClusterKeepsDistantRegionsApart)
+{
+  CCostClusterDirtyRegionSolver solver;
+  CDirtyRegionList input;
+  input.emplace_back(CRect(0, 0, 50, 50), 3.0f);
+  input.emplace_back(CRect(1200, 600, 1280, 720), 3.0f);
+
+  CDirtyRegionList output;
+  solver.Solve(input, output);
+
+  EXPECT_EQ(2u, output.size());
+}
+
+TEST(TestDirtyRegionSolvers, CostClusterEmptyInput)
+{
+  CCostClusterDirtyRegionSolver solver;
+  CDirtyRegionList input;
+  input.emplace_back(CRect());
+
+  CDirtyRegionList output;
+  solver.Solve(input, output);
+
+  EXPECT_TRUE(output.empty());
+}
+
+TEST(TestDirtyRegionSolvers, ReplayTrace)
+{
+  CUnionDirtyRegionSolver unionSolver;
+  CGreedyDirtyRegionSolver greedySolver;
+  CCostClusterDirtyRegionSolver clusterSolver;
+
+  std::vector<size_t> passes;
+  std::vector<float> unionPixels = Replay(unionSolver);
+  std::vector<float> greedyPixels = Replay(greedySolver);
+  std::vector<float> clusterPixels = Replay(clusterSolver, &passes);
+
+  for (int frame = 0; frame < traceFrames; frame++)
+  {
+    // never draw more than a single bounding pass would
+    EXPECT_LE(clusterPixels[frame], unionPixels[frame]);
+    EXPECT_LE(passes[frame], 4u);
+  }
+
+  EXPECT_LT(Sum(clusterPixels), Sum(unionPixels));
+  EXPECT_LE(Sum(clusterPixels), Sum(greedyPixels));
+
+  RecordProperty("union_pixels", static_cast<int>(Sum(unionPixels)));
+  RecordProperty("greedy_pixels", static_cast<int>(Sum(greedyPixels)));
+  RecordProperty("cluster_pixels", static_cast<int>(Sum(clusterPixels)));
+}
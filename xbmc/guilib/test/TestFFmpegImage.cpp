@@ -0,0 +1,148 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "guilib/FFmpegImage.h"
+#include "guilib/TextureFormats.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+// 4K fanart sized image with four solid quadrants
+const unsigned int fanartWidth = 3840;
+const unsigned int fanartHeight = 2160;
+const uint32_t quadrants[] = {0xFFFF0000, 0xFF00FF00, 0xFF0000FF, 0xFFFFFFFF};
+
+std::vector<uint8_t> EncodeFanart()
+{
+  std::vector<uint32_t> pixels(fanartWidth * fanartHeight);
+  for (unsigned int y = 0; y < fanartHeight; y++)
+  {
+    for (unsigned int x = 0; x < fanartWidth; x++)
+      pixels[y * fanartWidth + x] = quadrants[(y >= fanartHeight / 2) * 2 + (x >= fanartWidth / 2)];
+  }
+
+  CFFmpegImage encoder("image/jpeg");
+  unsigned char* out = nullptr;
+  unsigned int outSize = 0;
+  std::vector<uint8_t> jpeg;
+  if (encoder.CreateThumbnailFromSurface(reinterpret_cast<unsigned char*>(pixels.data()),
+                                         fanartWidth, fanartHeight, XB_FMT_A8R8G8B8,
+                                         fanartWidth * 4, "fanart.jpg", out, outSize))
+    jpeg.assign(out, out + outSize);
+  encoder.ReleaseThumbnailBuffer();
+  return jpeg;
+}
+
+// the same steps CTexture takes to load an image
+bool Load(std::vector<uint8_t>& jpeg, unsigned int maxWidth, unsigned int maxHeight,
+          std::vector<uint32_t>& pixels, unsigned int& width, unsigned int& height)
+{
+  CFFmpegImage image("image/jpeg");
+  if (!image.LoadImageFromMemory(jpeg.data(), jpeg.size(), maxWidth, maxHeight))
+    return false;
+
+  width = image.Width();
+  height = image.Height();
+  pixels.assign(width * height, 0);
+  return image.Decode(reinterpret_cast<unsigned char*>(pixels.data()), width, height, width * 4,
+                      XB_FMT_A8R8G8B8);
+}
+
+bool CloseTo(uint32_t a, uint32_t b)
+{
+  for (int shift = 0; shift < 24; shift += 8)
+  {
+    if (std::abs(static_cast<int>((a >> shift) & 0xFF) - static_cast<int>((b >> shift) & 0xFF)) > 16)
+      return false;
+  }
+  return true;
+}
+
+} // namespace
+
+TEST(TestFFmpegImage, DecodesLargeJpegAtReducedSize)
+{
+  std::vector<uint8_t> jpeg = EncodeFanart();
+  ASSERT_FALSE(jpeg.empty());
+
+  CFFmpegImage image("image/jpeg");
+  ASSERT_TRUE(image.LoadImageFromMemory(jpeg.data(), jpeg.size(), 480, 270));
+
+  // decoded at 1/8 in the DCT domain, the real size is still reported
+  EXPECT_EQ(480u, image.Width());
+  EXPECT_EQ(270u, image.Height());
+  EXPECT_EQ(fanartWidth, image.originalWidth());
+  EXPECT_EQ(fanartHeight, image.originalHeight());
+}
+
+TEST(TestFFmpegImage, ReducedSizeIsNeverSmallerThanRequested)
+{
+  std::vector<uint8_t> jpeg = EncodeFanart();
+  ASSERT_FALSE(jpeg.empty());
+
+  // 1/2 still covers 1280x720, 1/4 would not
+  std::vector<uint32_t> pixels;
+  unsigned int width = 0, height = 0;
+  ASSERT_TRUE(Load(jpeg, 1280, 720, pixels, width, height));
+  EXPECT_EQ(1920u, width);
+  EXPECT_EQ(1080u, height);
+
+  // sample the middle of each quadrant
+  for (unsigned int q = 0; q < 4; q++)
+  {
+    unsigned int x = (q % 2) * width / 2 + width / 4;
+    unsigned int y = (q / 2) * height / 2 + height / 4;
+    EXPECT_TRUE(CloseTo(quadrants[q], pixels[y * width + x])) << "quadrant " << q;
+  }
+}
+
+TEST(TestFFmpegImage, SmallerLimitsKeepFullSize)
+{
+  std::vector<uint8_t> jpeg = EncodeFanart();
+  ASSERT_FALSE(jpeg.empty());
+
+  CFFmpegImage image("image/jpeg");
+  ASSERT_TRUE(image.LoadImageFromMemory(jpeg.data(), jpeg.size(), 3000, 3000));
+  EXPECT_EQ(fanartWidth, image.Width());
+  EXPECT_EQ(fanartHeight, image.Height());
+}
+
+TEST(TestFFmpegImage, ThumbnailThroughput)
+{
+  std::vector<uint8_t> jpeg = EncodeFanart();
+  ASSERT_FALSE(jpeg.empty());
+
+  const int images = 10;
+  auto rate = [&jpeg](unsigned int maxWidth, unsigned int maxHeight) {
+    std::vector<uint32_t> pixels;
+    unsigned int width, height;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < images; i++)
+    {
+      if (!Load(jpeg, maxWidth, maxHeight, pixels, width, height))
+        return 0.0;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return images / elapsed.count();
+  };
+
+  double full = rate(fanartWidth, fanartHeight);
+  double thumb = rate(1280, 720);
+  EXPECT_GT(full, 0.0);
+  EXPECT_GT(thumb, 0.0);
+
+  RecordProperty("FullSizeImagesPerSecond", static_cast<int>(full));
+  RecordProperty("ThumbImagesPerSecond", static_cast<int>(thumb));
+}
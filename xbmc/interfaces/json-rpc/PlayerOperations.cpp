@@ -17,7 +17,9 @@
 #include "PlayListPlayer.h"
 #include "SeekHandler.h"
 #include "Util.h"
+#include "ServiceBroker.h"
 #include "VideoLibrary.h"
+#include "cores/DataCacheCore.h"
 #include "cores/IPlayer.h"
 #include "cores/playercorefactory/PlayerCoreFactory.h"
 #include "guilib/GUIWindowManager.h"
@@ -1930,6 +1932,19 @@ JSONRPC_STATUS CPlayerOperations::GetPropertyValue(PlayerType player, const std:
   }
   else if (property == "live")
     result = IsPVRChannel();
+  else if (property == "timetofirstframe")
+  {
+    unsigned int demux = 0;
+    unsigned int codecs = 0;
+    unsigned int firstFrame = 0;
+    if (player == Video || player == Audio)
+      CServiceBroker::GetDataCacheCore().GetStartupTimes(demux, codecs, firstFrame);
+
+    result = CVariant(CVariant::VariantTypeObject);
+    result["total"] = firstFrame;
+    result["demuxer"] = demux;
+    result["codecs"] = codecs;
+  }
   else
     return InvalidParams;
 
@@ -10793,6 +10793,9 @@ int CMusicDatabase::GetSongIDFromPath(const std::string &filePath)
 
 bool CMusicDatabase::CommitTransaction()
 {
+  if (InBatch())
+    return CDatabase::CommitTransaction();
+
   if (CDatabase::CommitTransaction())
   { // number of items in the db has likely changed, so reset the infomanager cache
     CGUIComponent* gui = CServiceBroker::GetGUI();
@@ -13,6 +13,7 @@
 #include "GUIUserMessages.h"
 #include "MusicAlbumInfo.h"
 #include "MusicInfoScraper.h"
+#include "MusicTagReader.h"
 #include "NfoFile.h"
 #include "ServiceBroker.h"
 #include "TextureCache.h"
@@ -27,6 +28,7 @@
 #include "events/EventLog.h"
 #include "events/MediaLibraryEvent.h"
 #include "filesystem/Directory.h"
+#include "filesystem/DirectoryChangeJournal.h"
 #include "filesystem/File.h"
 #include "filesystem/MusicDatabaseDirectory.h"
 #include "filesystem/MusicDatabaseDirectory/DirectoryNode.h"
@@ -53,6 +55,7 @@
 #include "utils/log.h"
 
 #include <algorithm>
+#include <iterator>
 #include <utility>
 
 using namespace MUSIC_INFO;
@@ -62,6 +65,19 @@ using namespace MUSIC_GRABBER;
 using namespace ADDON;
 using KODI::UTILITY::CDigest;
 
+namespace
+{
+// threads loading tags next to the scanner thread
+constexpr unsigned int TAG_READER_THREADS = 4;
+
+// limits of a batch of library additions
+constexpr unsigned int BATCH_MAX_SONGS = 1000;
+constexpr unsigned int BATCH_MAX_TIME = 5000; // ms
+
+// name of the music scanner in the directory change journal
+const std::string JOURNAL_SCANNER = "music";
+} // unnamed namespace
+
 CMusicInfoScanner::CMusicInfoScanner()
 : m_fileCountReader(this, "MusicFileCounter")
 {
@@ -122,6 +138,9 @@ void CMusicInfoScanner::Process()
       m_bCanInterrupt = false;
       m_needsCleanup = false;
 
+      m_tagReader.reset(new CMusicTagReader(TAG_READER_THREADS));
+      m_songsScanned = 0;
+
       bool commit = true;
       for (const auto& it : m_pathsToScan)
       {
@@ -141,7 +160,9 @@ void CMusicInfoScanner::Process()
 
         // Clear list of albums added by this scan
         m_albumsAdded.clear();
+
         bool scancomplete = DoScan(it);
+        CommitBatch();
         if (scancomplete)
         {
           if (m_albumsAdded.size() > 0)
@@ -189,12 +210,14 @@ void CMusicInfoScanner::Process()
       }
 
       m_fileCountReader.StopThread();
+      m_tagReader.reset();
 
       m_musicDatabase.EmptyCache();
 
       tick = XbmcThreads::SystemClockMillis() - tick;
-      CLog::Log(LOGINFO, "My Music: Scanning for music info using worker thread, operation took %s",
-                StringUtils::SecondsToTimeString(tick / 1000).c_str());
+      CLog::Log(LOGINFO, "My Music: Scanning for music info using worker thread, operation took %s (%u songs, %.1f songs/s)",
+                StringUtils::SecondsToTimeString(tick / 1000).c_str(), m_songsScanned,
+                tick > 0 ? m_songsScanned * 1000.0 / tick : 0.0);
     }
     if (m_scanType == 1) // load album info
     {
@@ -268,6 +291,7 @@ void CMusicInfoScanner::Process()
   {
     CLog::Log(LOGERROR, "MusicInfoScanner: Exception while scanning.");
   }
+  m_tagReader.reset();
   m_musicDatabase.Close();
   CLog::Log(LOGDEBUG, "%s - Finished scan", __FUNCTION__);
 
@@ -486,6 +510,25 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
   if (HasNoMedia(strDirectory))
     return true;
 
+  // don't keep the library locked while listing a network folder and reading its tags
+  if (URIUtils::IsRemote(strDirectory))
+    CommitBatch();
+
+  // nothing changed in this folder and its subfolders since they were scanned last time
+  CDirectoryChangeJournal& journal = CDirectoryChangeJournal::GetInstance();
+  if (!(m_flags & SCAN_RESCAN) && journal.IsUnchanged(JOURNAL_SCANNER, strDirectory))
+  {
+    std::string dbHash;
+    if (m_musicDatabase.GetPathHash(strDirectory, dbHash) && !dbHash.empty())
+    {
+      CLog::Log(LOGDEBUG, "%s Skipping dir '%s' and its subfolders, no changes recorded", __FUNCTION__, CURL::GetRedacted(strDirectory).c_str());
+      if (m_handle)
+        OnDirectoryScanned(strDirectory);
+      return true;
+    }
+  }
+  journal.BeginScan(JOURNAL_SCANNER, strDirectory);
+
   // load subfolder
   CFileItemList items;
   CDirectory::GetDirectory(strDirectory, items, CServiceBroker::GetFileExtensionProvider().GetMusicExtensions() + "|.jpg|.tbn|.lrc|.cdg", DIR_FLAG_DEFAULTS);
@@ -520,8 +563,15 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
         OnDirectoryScanned(strDirectory);
     }
 
-    // save information about this folder
-    m_musicDatabase.SetPathHash(strDirectory, hash);
+    // save information about this folder, unless interrupted while reading its tags so it
+    // gets scanned again next time
+    if (!m_bStop)
+    {
+      BeginFolder();
+      m_musicDatabase.SetPathHash(strDirectory, hash);
+    }
+    EndFolder(strDirectory);
+    Checkpoint();
   }
   else
   { // path is the same - no need to rescan
@@ -554,19 +604,81 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
       }
     }
   }
+
+  if (!m_bStop)
+    journal.EndScan(JOURNAL_SCANNER, strDirectory);
+
   return !m_bStop;
 }
 
+void CMusicInfoScanner::Checkpoint()
+{
+  if (!m_musicDatabase.InBatch())
+    return;
+
+  if (m_batchSongs < BATCH_MAX_SONGS &&
+      XbmcThreads::SystemClockMillis() - m_batchStart < BATCH_MAX_TIME)
+    return;
+
+  CLog::Log(LOGDEBUG, "%s - Writing %u songs to the library", __FUNCTION__, m_batchSongs);
+  CommitBatch();
+}
+
+void CMusicInfoScanner::CommitBatch()
+{
+  EndFolder("");
+
+  if (!m_musicDatabase.CommitBatch())
+  {
+    CLog::Log(LOGWARNING, "%s - Failed to write %u songs to the library", __FUNCTION__,
+              m_batchSongs);
+    for (int idAlbum : m_batchAlbums)
+      m_albumsAdded.erase(idAlbum);
+  }
+  m_batchAlbums.clear();
+  m_batchSongs = 0;
+}
+
+void CMusicInfoScanner::BeginFolder()
+{
+  if (m_inFolder)
+    return;
+
+  if (!m_musicDatabase.InBatch())
+  {
+    m_musicDatabase.BeginBatch();
+    m_batchStart = XbmcThreads::SystemClockMillis();
+  }
+
+  m_musicDatabase.SetSavepoint();
+  m_folderAlbums = m_batchAlbums.size();
+  m_inFolder = true;
+}
+
+void CMusicInfoScanner::EndFolder(const std::string& strDirectory)
+{
+  if (!m_inFolder)
+    return;
+
+  m_inFolder = false;
+  if (!m_musicDatabase.ReleaseSavepoint())
+  {
+    CLog::Log(LOGWARNING, "%s - Failed to add '%s' to the library, it is scanned again next time",
+              __FUNCTION__, CURL::GetRedacted(strDirectory).c_str());
+    for (auto it = m_batchAlbums.begin() + m_folderAlbums; it != m_batchAlbums.end(); ++it)
+      m_albumsAdded.erase(*it);
+    m_batchAlbums.resize(m_folderAlbums);
+  }
+}
+
 CInfoScanner::INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items,
                                                    CFileItemList& scannedItems)
 {
   std::vector<std::string> regexps = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_audioExcludeFromScanRegExps;
 
+  std::vector<CFileItemPtr> files;
   for (int i = 0; i < items.Size(); ++i)
   {
-    if (m_bStop)
-      return INFO_CANCELLED;
-
     CFileItemPtr pItem = items[i];
 
     if (CUtil::ExcludeFileOrFolder(pItem->GetPath(), regexps))
@@ -575,10 +687,27 @@ CInfoScanner::INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items,
     if (pItem->m_bIsFolder || pItem->IsPlayList() || pItem->IsPicture() || pItem->IsLyrics())
       continue;
 
+    files.push_back(pItem);
+  }
+
+  // load the tags concurrently, discs are read one file after the other below
+  if (m_tagReader)
+  {
+    std::vector<CFileItemPtr> parallel;
+    std::copy_if(files.begin(), files.end(), std::back_inserter(parallel),
+                 [](const CFileItemPtr& item) { return !item->IsCDDA(); });
+    m_tagReader->Load(parallel, m_bStop);
+  }
+
+  for (const auto& pItem : files)
+  {
+    if (m_bStop)
+      return INFO_CANCELLED;
+
     m_currentItem++;
 
     CMusicInfoTag& tag = *pItem->GetMusicInfoTag();
-    if (!tag.Loaded())
+    if (!tag.Loaded() && (!m_tagReader || pItem->IsCDDA()))
     {
       std::unique_ptr<IMusicInfoTagLoader> pLoader (CMusicInfoTagLoaderFactory::CreateLoader(*pItem));
       if (nullptr != pLoader)
@@ -948,6 +1077,9 @@ int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileI
 
   int numAdded = 0;
 
+  if (!albums.empty() && !m_bStop)
+    BeginFolder();
+
   // Add all albums to the library, and hence any new song or album artists or other contributors
   for (auto& album : albums)
   {
@@ -959,11 +1091,15 @@ int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileI
       album.releaseType = CAlbum::Single;
 
     album.strPath = strDirectory;
-    m_musicDatabase.AddAlbum(album, m_idSourcePath);
-    m_albumsAdded.insert(album.idAlbum);
+    if (m_musicDatabase.AddAlbum(album, m_idSourcePath) &&
+        m_albumsAdded.insert(album.idAlbum).second)
+      m_batchAlbums.push_back(album.idAlbum);
 
     numAdded += static_cast<int>(album.songs.size());
   }
+
+  m_batchSongs += numAdded;
+  m_songsScanned += numAdded;
   return numAdded;
 }
 
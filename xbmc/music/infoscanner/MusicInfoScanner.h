@@ -16,12 +16,16 @@
 #include "threads/Thread.h"
 #include "utils/ScraperUrl.h"
 
+#include <memory>
+#include <vector>
+
 class CAlbum;
 class CArtist;
 class CGUIDialogProgressBarHandle;
 
 namespace MUSIC_INFO
 {
+class CMusicTagReader;
 
 class CMusicInfoScanner : public IRunnable, public CInfoScanner
 {
@@ -248,6 +252,29 @@ protected:
 
   void ScannerWait(unsigned int milliseconds);
 
+  /*! \brief Commit the current batch of library additions once it is full.
+   Additions are written in batches, the path hash of a folder is written in the same batch as
+   its songs. A scan that is interrupted continues after the last checkpoint the next time, as
+   the folders committed until then are skipped as unchanged.
+   */
+  void Checkpoint();
+
+  /*! \brief Commit the current batch of library additions.
+   Albums of a batch that could not be written are not scraped, their folders have no path hash
+   and are scanned again next time.
+   */
+  void CommitBatch();
+
+  /*! \brief Start writing the albums and the path hash of a folder. A batch is only started
+   here, so the library is not locked while reading directories and tags.
+   */
+  void BeginFolder();
+
+  /*! \brief Finish writing a folder. If any of its updates was rolled back, the whole folder is
+   discarded and scanned again next time.
+   */
+  void EndFolder(const std::string& strDirectory);
+
   int m_currentItem;
   int m_itemCount;
   bool m_bStop;
@@ -261,5 +288,13 @@ protected:
   std::set<std::string> m_seenPaths;
   int m_flags;
   CThread m_fileCountReader;
+
+  std::unique_ptr<CMusicTagReader> m_tagReader;
+  unsigned int m_batchSongs = 0;
+  unsigned int m_batchStart = 0;
+  std::vector<int> m_batchAlbums; // albums first added by the current batch
+  size_t m_folderAlbums = 0; // albums of m_batchAlbums added before the current folder
+  bool m_inFolder = false;
+  unsigned int m_songsScanned = 0;
 };
 }
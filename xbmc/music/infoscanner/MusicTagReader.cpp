@@ -0,0 +1,115 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "MusicTagReader.h"
+
+#include "music/tags/MusicInfoTag.h"
+#include "music/tags/MusicInfoTagLoaderFactory.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+
+using namespace MUSIC_INFO;
+
+class CMusicTagReader::CWorker : public CThread
+{
+public:
+  explicit CWorker(CMusicTagReader& owner) : CThread("MusicTagReader"), m_owner(owner) {}
+
+protected:
+  void Process() override { m_owner.Process(); }
+
+private:
+  CMusicTagReader& m_owner;
+};
+
+CMusicTagReader::CMusicTagReader(unsigned int threads) : m_threads(threads)
+{
+}
+
+CMusicTagReader::~CMusicTagReader()
+{
+  {
+    CSingleLock lock(m_critSection);
+    m_bStop = true;
+    m_condition.notifyAll();
+  }
+
+  for (const auto& worker : m_workers)
+    worker->StopThread(true);
+}
+
+void CMusicTagReader::LoadTag(CFileItem& item)
+{
+  CMusicInfoTag& tag = *item.GetMusicInfoTag();
+  if (tag.Loaded())
+    return;
+
+  std::unique_ptr<IMusicInfoTagLoader> pLoader(CMusicInfoTagLoaderFactory::CreateLoader(item));
+  if (nullptr != pLoader)
+    pLoader->Load(item.GetPath(), tag);
+}
+
+bool CMusicTagReader::LoadNext()
+{
+  if (!m_items || m_next >= m_items->size())
+    return false;
+
+  CFileItemPtr item = (*m_items)[m_next++];
+  m_active++;
+  {
+    CSingleExit exit(m_critSection);
+    LoadTag(*item);
+  }
+  m_active--;
+  m_condition.notifyAll();
+  return true;
+}
+
+void CMusicTagReader::Load(const std::vector<CFileItemPtr>& items, const bool& bStop)
+{
+  if (items.empty())
+    return;
+
+  // a single file is not worth waking up the workers
+  if (items.size() == 1 || m_threads == 0)
+  {
+    LoadTag(*items.front());
+    return;
+  }
+
+  while (m_workers.size() < m_threads)
+  {
+    m_workers.emplace_back(new CWorker(*this));
+    m_workers.back()->Create();
+  }
+
+  CSingleLock lock(m_critSection);
+  m_items = &items;
+  m_next = 0;
+  m_condition.notifyAll();
+
+  while (!bStop && LoadNext())
+    ;
+
+  // leave the rest alone and wait for the workers to finish the files they are reading
+  m_next = items.size();
+  while (m_active > 0)
+    m_condition.wait(lock);
+
+  m_items = nullptr;
+}
+
+void CMusicTagReader::Process()
+{
+  CSingleLock lock(m_critSection);
+  while (!m_bStop)
+  {
+    if (!LoadNext())
+      m_condition.wait(lock);
+  }
+}
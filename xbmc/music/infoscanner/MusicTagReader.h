@@ -0,0 +1,64 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "FileItem.h"
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+
+#include <memory>
+#include <vector>
+
+class CThread;
+
+namespace MUSIC_INFO
+{
+
+/*!
+ \brief Loads the tags of music files on a small pool of threads.
+
+ Reading tags is dominated by the latency of opening each file, especially on network shares.
+ The files of a folder are independent of each other, so their tags are loaded concurrently;
+ the scanner still adds the results to the library in order on its own thread.
+ */
+class CMusicTagReader
+{
+public:
+  /*!
+   \param threads number of threads loading tags next to the calling thread
+   */
+  explicit CMusicTagReader(unsigned int threads);
+  ~CMusicTagReader();
+
+  /*! \brief Load the tags of the given items that are not loaded yet.
+   The calling thread loads tags as well and returns once all items are done.
+   \param items the items to load the tags of
+   \param bStop checked between items, once set the remaining items are left alone
+   */
+  void Load(const std::vector<CFileItemPtr>& items, const bool& bStop);
+
+private:
+  class CWorker;
+  friend class CWorker;
+
+  void Process();
+  bool LoadNext(); // called with m_critSection held
+  static void LoadTag(CFileItem& item);
+
+  const unsigned int m_threads;
+
+  CCriticalSection m_critSection;
+  XbmcThreads::ConditionVariable m_condition;
+  const std::vector<CFileItemPtr>* m_items = nullptr;
+  size_t m_next = 0;
+  unsigned int m_active = 0;
+  std::vector<std::unique_ptr<CThread>> m_workers;
+  bool m_bStop = false;
+};
+}
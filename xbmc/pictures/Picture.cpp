@@ -259,6 +259,20 @@ bool CPicture::CacheTexture(uint8_t *pixels, uint32_t width, uint32_t height, ui
   return false;
 }
 
+void CPicture::GetMaxCacheSize(uint32_t &width, uint32_t &height)
+{
+  const std::shared_ptr<CAdvancedSettings> advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+
+  // CacheTexture picks imageres or fanartres depending on the aspect ratio, allow for both
+  uint32_t max_height = std::max(advancedSettings->m_imageRes, advancedSettings->m_fanartRes);
+  if (!max_height)
+    return;
+  uint32_t max_width = max_height * 16/9;
+
+  width = width ? std::min(width, max_width) : max_width;
+  height = height ? std::min(height, max_height) : max_height;
+}
+
 bool CPicture::CreateTiledThumb(const std::vector<std::string> &files, const std::string &thumb)
 {
   if (!files.size())
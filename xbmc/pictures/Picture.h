@@ -57,6 +57,13 @@ public:
     uint32_t &dest_width, uint32_t &dest_height, const std::string &dest,
     CPictureScalingAlgorithm::Algorithm scalingAlgorithm = CPictureScalingAlgorithm::NoAlgorithm);
 
+  /*! \brief Get the largest size CacheTexture may keep an image at
+   Images can be decoded at this size as they will never be cached any larger.
+   \param width [in/out] maximum width in pixels, 0 for no maximum
+   \param height [in/out] maximum height in pixels, 0 for no maximum
+   */
+  static void GetMaxCacheSize(uint32_t &width, uint32_t &height);
+
 private:
   static void GetScale(unsigned int width, unsigned int height, unsigned int &out_width, unsigned int &out_height);
   static bool ScaleImage(uint8_t *in_pixels, unsigned int in_width, unsigned int in_height, unsigned int in_pitch,
@@ -942,6 +942,7 @@ void CSlideShowPic::Render(float* x, float* y, CTexture* pTexture, UTILS::Color
 
 #elif defined(HAS_GLES)
   CRenderSystemGLES *renderSystem = dynamic_cast<CRenderSystemGLES*>(CServiceBroker::GetRenderSystem());
+  renderSystem->FlushGUIBatches();
   if (pTexture)
   {
     pTexture->LoadToGPU();
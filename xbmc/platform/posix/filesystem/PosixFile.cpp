@@ -235,6 +235,17 @@ int CPosixFile::IoControl(EIoControl request, void* param)
       return -1;
     return ioctl(m_fd, ((SNativeIoControl*)param)->request, ((SNativeIoControl*)param)->param);
   }
+  else if (request == IOCTRL_READ_AHEAD)
+  {
+#ifdef POSIX_FADV_WILLNEED
+    if (!param)
+      return -1;
+    const SReadAheadHint* hint = static_cast<const SReadAheadHint*>(param);
+    return posix_fadvise(m_fd, hint->offset, hint->length, POSIX_FADV_WILLNEED) == 0 ? 0 : -1;
+#else
+    return -1;
+#endif
+  }
   else if (request == IOCTRL_SEEK_POSSIBLE)
   {
     if (GetPosition() < 0)
@@ -252,7 +252,8 @@ bool CPVREpg::Update(time_t start,
                      int iUpdateTime,
                      int iPastDays,
                      const std::shared_ptr<CPVREpgDatabase>& database,
-                     bool bForceUpdate /* = false */)
+                     bool bForceUpdate /* = false */,
+                     size_t* iUpdatedTags /* = nullptr */)
 {
   bool bUpdate = false;
   std::shared_ptr<CPVREpg> tmpEpg;
@@ -300,7 +301,7 @@ bool CPVREpg::Update(time_t start,
     }
   }
 
-  // remove obsolete tags
+  // remove obsolete tags, the container cleans up the database for all tables at once
   Cleanup(iPastDays);
 
   bool bGrabSuccess = true;
@@ -309,6 +310,9 @@ bool CPVREpg::Update(time_t start,
   {
     bGrabSuccess = tmpEpg->UpdateFromScraper(start, end, bForceUpdate) && UpdateEntries(*tmpEpg);
 
+    if (bGrabSuccess && iUpdatedTags)
+      *iUpdatedTags = tmpEpg->m_tags.GetChangedTagsCount();
+
     if (!bGrabSuccess)
       CLog::LogF(LOGERROR, "Failed to update table '{}'", Name());
   }
@@ -187,9 +187,16 @@ namespace PVR
      * @param iPastDays Amount of past days from now on, for which past entries are to be kept.
      * @param database If given, the database to store the data.
      * @param bForceUpdate Force update from client even if it's not the time to
+     * @param iUpdatedTags If given, receives the number of events fetched from the client.
      * @return True if the update was successful, false otherwise.
      */
-    bool Update(time_t start, time_t end, int iUpdateTime, int iPastDays, const std::shared_ptr<CPVREpgDatabase>& database, bool bForceUpdate = false);
+    bool Update(time_t start,
+                time_t end,
+                int iUpdateTime,
+                int iPastDays,
+                const std::shared_ptr<CPVREpgDatabase>& database,
+                bool bForceUpdate = false,
+                size_t* iUpdatedTags = nullptr);
 
     /*!
      * @brief Get all EPG tags.
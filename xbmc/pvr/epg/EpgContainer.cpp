@@ -22,8 +22,14 @@
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "threads/SingleLock.h"
+#include "utils/StringUtils.h"
 #include "utils/log.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -31,6 +37,9 @@
 namespace PVR
 {
 
+// max number of clients to fetch EPG data from at the same time
+static constexpr size_t EPG_UPDATE_MAX_PARALLEL_CLIENTS = 4;
+
 class CEpgUpdateRequest
 {
 public:
@@ -44,6 +53,25 @@ private:
   int m_iUniqueChannelID;
 };
 
+class CEpgUpdateWorker : public CThread
+{
+public:
+  explicit CEpgUpdateWorker(const std::function<void()>& update)
+    : CThread("EPGUpdateWorker"), m_update(update)
+  {
+  }
+
+protected:
+  void Process() override
+  {
+    SetPriority(GetMinPriority());
+    m_update();
+  }
+
+private:
+  std::function<void()> m_update;
+};
+
 void CEpgUpdateRequest::Deliver()
 {
   const std::shared_ptr<CPVREpg> epg = CServiceBroker::GetPVRManager().EpgContainer().GetByChannelUid(m_iClientID, m_iUniqueChannelID);
@@ -606,6 +634,10 @@ bool CPVREpgContainer::RemoveOldEntries()
   for (const auto& epgEntry : epgs)
     epgEntry.second->Cleanup(cleanupTime);
 
+  const std::shared_ptr<CPVREpgDatabase> database = GetEpgDatabase();
+  if (database)
+    database->DeleteEpgTags(cleanupTime);
+
   CSingleLock lock(m_critSection);
   CDateTime::GetCurrentDateTime().GetAsUTCDateTime().GetAsTime(m_iLastEpgCleanup);
 
@@ -709,8 +741,6 @@ void CPVREpgContainer::WaitForUpdateFinish()
 
 bool CPVREpgContainer::UpdateEPG(bool bOnlyPending /* = false */)
 {
-  bool bInterrupted = false;
-  unsigned int iUpdatedTables = 0;
   const std::shared_ptr<CAdvancedSettings> advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
 
   /* set start and end time */
@@ -740,45 +770,107 @@ bool CPVREpgContainer::UpdateEPG(bool bOnlyPending /* = false */)
     progressHandler = new CPVRGUIProgressHandler(g_localizeStrings.Get(19004)); // Importing guide from clients
 
   /* load or update all EPG tables */
-  unsigned int iCounter = 0;
   const std::shared_ptr<CPVREpgDatabase> database = GetEpgDatabase();
 
   m_critSection.lock();
   const auto epgsToUpdate = m_epgIdToEpgMap;
   m_critSection.unlock();
 
+  // tables only drop their obsolete in-memory tags. clean up the database with one range delete,
+  // on full updates only, pending ones run for a few tables at a time and the next full one will do
+  if (database && !bOnlyPending)
+    database->DeleteEpgTags(CDateTime::GetUTCDateTime() -
+                            CDateTimeSpan(GetPastDaysToDisplay(), 0, 0, 0));
+
+  // requests to one client are kept sequential, different clients are updated concurrently
+  std::map<int, std::vector<std::shared_ptr<CPVREpg>>> epgsByClient;
   for (const auto& epgEntry : epgsToUpdate)
   {
-    if (InterruptUpdate())
-    {
-      bInterrupted = true;
-      break;
-    }
+    if (epgEntry.second)
+      epgsByClient[epgEntry.second->GetChannelData()->ClientId()].emplace_back(epgEntry.second);
+  }
+
+  std::vector<const std::vector<std::shared_ptr<CPVREpg>>*> clientQueues;
+  for (const auto& client : epgsByClient)
+    clientQueues.emplace_back(&client.second);
 
-    const std::shared_ptr<CPVREpg> epg = epgEntry.second;
-    if (!epg)
-      continue;
-
-    if (bShowProgress && !bOnlyPending)
-      progressHandler->UpdateProgress(epg->GetChannelData()->ChannelName(), ++iCounter,
-                                      epgsToUpdate.size());
-
-    if ((!bOnlyPending || epg->UpdatePending()) &&
-        epg->Update(start,
-                    end,
-                    m_settings.GetIntValue(CSettings::SETTING_EPG_EPGUPDATE) * 60,
-                    m_settings.GetIntValue(CSettings::SETTING_EPG_PAST_DAYSTODISPLAY),
-                    database,
-                    bOnlyPending))
+  std::atomic<bool> bInterrupted(false);
+  std::atomic<unsigned int> iUpdatedTables(0);
+  std::atomic<unsigned int> iCounter(0);
+  std::atomic<size_t> iUpdatedTags(0);
+  std::atomic<size_t> iNextClient(0);
+  CCriticalSection invalidTablesLock;
+  const auto updateStart = std::chrono::steady_clock::now();
+
+  const auto updateClients = [&]() {
+    for (size_t i = iNextClient++; i < clientQueues.size() && !bInterrupted; i = iNextClient++)
     {
-      iUpdatedTables++;
+      for (const auto& epg : *clientQueues[i])
+      {
+        if (InterruptUpdate())
+        {
+          bInterrupted = true;
+          break;
+        }
+
+        if (bShowProgress && !bOnlyPending)
+        {
+          const std::chrono::duration<double> elapsed =
+              std::chrono::steady_clock::now() - updateStart;
+          const int iTagsPerSecond =
+              elapsed.count() > 0 ? static_cast<int>(iUpdatedTags / elapsed.count()) : 0;
+          const std::string strText =
+              iTagsPerSecond > 0
+                  ? StringUtils::Format(g_localizeStrings.Get(19697), // {0:s} ({1:d} events/s)
+                                        epg->GetChannelData()->ChannelName(), iTagsPerSecond)
+                  : epg->GetChannelData()->ChannelName();
+          progressHandler->UpdateProgress(strText, ++iCounter, epgsToUpdate.size());
+        }
+
+        size_t iTags = 0;
+        if ((!bOnlyPending || epg->UpdatePending()) &&
+            epg->Update(start,
+                        end,
+                        m_settings.GetIntValue(CSettings::SETTING_EPG_EPGUPDATE) * 60,
+                        m_settings.GetIntValue(CSettings::SETTING_EPG_PAST_DAYSTODISPLAY),
+                        database,
+                        bOnlyPending,
+                        &iTags))
+        {
+          iUpdatedTables++;
+          iUpdatedTags += iTags;
+        }
+        else if (!epg->IsValid())
+        {
+          CSingleLock lock(invalidTablesLock);
+          invalidTables.push_back(epg);
+        }
+      }
     }
-    else if (!epg->IsValid())
+  };
+
+  {
+    // this thread takes part in the update, so start one worker less
+    std::vector<std::unique_ptr<CEpgUpdateWorker>> workers;
+    const size_t iWorkers =
+        std::min(clientQueues.size(), EPG_UPDATE_MAX_PARALLEL_CLIENTS);
+    for (size_t i = 1; i < iWorkers; ++i)
     {
-      invalidTables.push_back(epg);
+      workers.emplace_back(new CEpgUpdateWorker(updateClients));
+      workers.back()->Create();
     }
+
+    updateClients();
+
+    for (const auto& worker : workers)
+      worker->StopThread(true);
   }
 
+  const std::chrono::duration<double> updateDuration =
+      std::chrono::steady_clock::now() - updateStart;
+  CLog::LogFC(LOGDEBUG, LOGEPG, "Updated {} EPG tables ({} events) in {:.1f}s",
+              iUpdatedTables.load(), iUpdatedTags.load(), updateDuration.count());
+
   if (bShowProgress && !bOnlyPending)
     progressHandler->DestroyProgress();
 
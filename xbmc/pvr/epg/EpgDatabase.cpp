@@ -16,20 +16,45 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
 #include "threads/SingleLock.h"
+#include "utils/StringUtils.h"
 #include "utils/log.h"
 
 #include <cstdlib>
+#include <iterator>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 using namespace dbiplus;
 using namespace PVR;
 
+namespace
+{
+// keep single statements well below the SQLite and MySQL statement size limits
+constexpr size_t EPG_PERSIST_ROWS_PER_QUERY = 250;
+constexpr size_t EPG_PERSIST_MAX_QUERY_LENGTH = 256 * 1024;
+
+const char* EPG_TAG_COLUMNS =
+    "idEpg, iStartTime, iEndTime, sTitle, sPlotOutline, sPlot, sOriginalTitle, sCast, sDirector, "
+    "sWriter, iYear, sIMDBNumber, sIconPath, iGenreType, iGenreSubType, sGenre, sFirstAired, "
+    "iParentalRating, iStarRating, iSeriesId, iEpisodeId, iEpisodePart, sEpisodeName, iFlags, "
+    "sSeriesLink, iBroadcastUid";
+} // unnamed namespace
+
 bool CPVREpgDatabase::Open()
 {
   CSingleLock lock(m_critSection);
-  return CDatabase::Open(CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_databaseEpg);
+  if (!CDatabase::Open(CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_databaseEpg))
+    return false;
+
+  if (m_sqlite)
+  {
+    // REPLACE INTO must fire the delete triggers keeping the search index up to date
+    m_pDS->exec("PRAGMA recursive_triggers=ON");
+    m_bHasSearchIndex = HasSearchIndex();
+  }
+  return true;
 }
 
 void CPVREpgDatabase::Close()
@@ -103,6 +128,8 @@ void CPVREpgDatabase::CreateTables()
         "sLastScan varchar(20)"
       ")"
   );
+
+  CreateSearchIndex();
 }
 
 void CPVREpgDatabase::CreateAnalytics()
@@ -112,6 +139,63 @@ void CPVREpgDatabase::CreateAnalytics()
   CSingleLock lock(m_critSection);
   m_pDS->exec("CREATE UNIQUE INDEX idx_epg_idEpg_iStartTime on epgtags(idEpg, iStartTime desc);");
   m_pDS->exec("CREATE INDEX idx_epg_iEndTime on epgtags(iEndTime);");
+
+  if (m_sqlite && !GetSingleValue("SELECT name FROM sqlite_master "
+                                  "WHERE type = 'table' AND name = 'epgtags_fts'").empty())
+  {
+    CLog::LogFC(LOGDEBUG, LOGEPG, "Creating EPG search index triggers");
+    m_pDS->exec("CREATE TRIGGER epgtags_fts_ai AFTER INSERT ON epgtags BEGIN "
+                "INSERT INTO epgtags_fts(rowid, sTitle, sPlotOutline, sPlot) "
+                "VALUES (new.idBroadcast, new.sTitle, new.sPlotOutline, new.sPlot); END");
+    m_pDS->exec("CREATE TRIGGER epgtags_fts_ad AFTER DELETE ON epgtags BEGIN "
+                "INSERT INTO epgtags_fts(epgtags_fts, rowid, sTitle, sPlotOutline, sPlot) "
+                "VALUES ('delete', old.idBroadcast, old.sTitle, old.sPlotOutline, old.sPlot); END");
+    m_pDS->exec("CREATE TRIGGER epgtags_fts_au AFTER UPDATE ON epgtags BEGIN "
+                "INSERT INTO epgtags_fts(epgtags_fts, rowid, sTitle, sPlotOutline, sPlot) "
+                "VALUES ('delete', old.idBroadcast, old.sTitle, old.sPlotOutline, old.sPlot); "
+                "INSERT INTO epgtags_fts(rowid, sTitle, sPlotOutline, sPlot) "
+                "VALUES (new.idBroadcast, new.sTitle, new.sPlotOutline, new.sPlot); END");
+  }
+}
+
+bool CPVREpgDatabase::CreateSearchIndex()
+{
+  if (!m_sqlite)
+    return false;
+
+  // the trigram tokenizer matches any substring of 3 or more characters, like the LIKE based
+  // search does. It needs FTS5 and SQLite 3.34, without it searches fall back to table scans.
+  try
+  {
+    CLog::LogFC(LOGDEBUG, LOGEPG, "Creating table 'epgtags_fts'");
+    m_pDS->exec("CREATE VIRTUAL TABLE epgtags_fts USING fts5("
+                "sTitle, sPlotOutline, sPlot, "
+                "content='epgtags', content_rowid='idBroadcast', tokenize='trigram')");
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGINFO, "EPG search index not supported by this SQLite version");
+  }
+  return false;
+}
+
+bool CPVREpgDatabase::HasSearchIndex()
+{
+  if (GetSingleValue("SELECT name FROM sqlite_master "
+                     "WHERE type = 'trigger' AND name = 'epgtags_fts_ai'").empty())
+    return false;
+
+  // the database may have been created by an SQLite with FTS5, which this one might lack
+  if (GetSingleValue("SELECT COUNT(*) FROM epgtags_fts WHERE rowid = 0").empty())
+  {
+    CLog::Log(LOGWARNING, "EPG search index can't be used, dropping its triggers");
+    m_pDS->exec("DROP TRIGGER IF EXISTS epgtags_fts_ai");
+    m_pDS->exec("DROP TRIGGER IF EXISTS epgtags_fts_ad");
+    m_pDS->exec("DROP TRIGGER IF EXISTS epgtags_fts_au");
+    return false;
+  }
+  return true;
 }
 
 void CPVREpgDatabase::UpdateTables(int iVersion)
@@ -258,6 +342,12 @@ void CPVREpgDatabase::UpdateTables(int iVersion)
     m_pDS->exec("DROP TABLE epgtags");
     m_pDS->exec("ALTER TABLE epgtags_new RENAME TO epgtags");
   }
+
+  if (iVersion < 14)
+  {
+    if (CreateSearchIndex())
+      m_pDS->exec("INSERT INTO epgtags_fts(epgtags_fts) VALUES ('rebuild')");
+  }
 }
 
 bool CPVREpgDatabase::DeleteEpg()
@@ -501,6 +591,22 @@ class CSearchTermConverter
 public:
   CSearchTermConverter(const std::string& strSearchTerm) { Parse(strSearchTerm); }
 
+  /*!
+   * @brief Whether ToSearchIndexQuery() yields a superset of the rows matched by ToSQL().
+   * Negations and terms shorter than a trigram can't be answered by the index.
+   */
+  bool CanUseSearchIndex() const { return m_bIndexable && !m_strIndexQuery.empty(); }
+
+  std::string ToSearchIndexQuery(bool bSearchInDescription) const
+  {
+    std::string result = bSearchInDescription ? "{sTitle sPlotOutline sPlot}: ("
+                                              : "{sTitle sPlotOutline}: (";
+    result += m_strIndexQuery;
+    result += ")";
+    StringUtils::Replace(result, "'", "''"); // escape '
+    return result;
+  }
+
   std::string ToSQL(const std::string& strFieldName) const
   {
     std::string result = "(";
@@ -539,6 +645,7 @@ private:
         GetAndCutNextTerm(strParsedSearchTerm, strDummy);
         strFragment += " NOT ";
         bNextOR = false;
+        m_bIndexable = false;
       }
       else if (StringUtils::StartsWith(strParsedSearchTerm, "+") ||
                StringUtils::StartsWithNoCase(strParsedSearchTerm, "and"))
@@ -547,6 +654,7 @@ private:
         GetAndCutNextTerm(strParsedSearchTerm, strDummy);
         strFragment += " AND ";
         bNextOR = false;
+        AppendIndexOperator(" AND ");
       }
       else if (StringUtils::StartsWith(strParsedSearchTerm, "|") ||
                StringUtils::StartsWithNoCase(strParsedSearchTerm, "or"))
@@ -555,6 +663,7 @@ private:
         GetAndCutNextTerm(strParsedSearchTerm, strDummy);
         strFragment += " OR ";
         bNextOR = false;
+        AppendIndexOperator(" OR ");
       }
       else
       {
@@ -563,7 +672,11 @@ private:
         if (!strTerm.empty())
         {
           if (bNextOR && !m_fragments.empty())
+          {
             strFragment += " OR "; // default operator
+            AppendIndexOperator(" OR ");
+          }
+          AppendIndexTerm(strTerm);
 
           strFragment += "(UPPER(";
 
@@ -588,6 +701,44 @@ private:
 
     if (!strFragment.empty())
       m_fragments.emplace_back(strFragment);
+
+    // a dangling operator is fine for SQL but a syntax error for the index
+    if (m_bIndexOperatorPending)
+      m_bIndexable = false;
+  }
+
+  void AppendIndexOperator(const char* strOperator)
+  {
+    if (m_strIndexQuery.empty() || m_bIndexOperatorPending)
+      m_bIndexable = false;
+    m_strIndexQuery += strOperator;
+    m_bIndexOperatorPending = true;
+  }
+
+  void AppendIndexTerm(const std::string& strTerm)
+  {
+    if (!m_strIndexQuery.empty() && !m_bIndexOperatorPending)
+      m_strIndexQuery += " OR ";
+    m_bIndexOperatorPending = false;
+
+    // the trigram tokenizer can't find anything shorter than three characters
+    size_t iChars = 0;
+    for (const char c : strTerm)
+    {
+      if ((c & 0xC0) != 0x80)
+        iChars++;
+    }
+    if (iChars < 3)
+      m_bIndexable = false;
+
+    // LIKE wildcards only mean something to the SQL filter
+    if (strTerm.find_first_of("%_") != std::string::npos)
+      m_bIndexable = false;
+
+    // search for the term as a phrase
+    std::string strPhrase(strTerm);
+    StringUtils::Replace(strPhrase, "\"", "\"\"");
+    m_strIndexQuery += "\"" + strPhrase + "\"";
   }
 
   static void GetAndCutNextTerm(std::string& strSearchTerm, std::string& strNextTerm)
@@ -614,6 +765,9 @@ private:
   }
 
   std::vector<std::string> m_fragments;
+  std::string m_strIndexQuery;
+  bool m_bIndexable = true;
+  bool m_bIndexOperatorPending = false;
 };
 
 } // unnamed namespace
@@ -673,6 +827,13 @@ std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpgDatabase::GetEpgTags(
   {
     const CSearchTermConverter conv(searchData.m_strSearchTerm);
 
+    // narrow the candidates down using the search index, the filter below still decides
+    if (m_bHasSearchIndex && conv.CanUseSearchIndex())
+    {
+      filter.AppendWhere("idBroadcast IN (SELECT rowid FROM epgtags_fts WHERE epgtags_fts MATCH '" +
+                         conv.ToSearchIndexQuery(searchData.m_bSearchInDescription) + "')");
+    }
+
     // title
     std::string strWhere = conv.ToSQL("sTitle");
 
@@ -964,6 +1125,49 @@ bool CPVREpgDatabase::QueueDeleteEpgTagsByMinEndMaxStartTimeQuery(int iEpgID,
   return false;
 }
 
+bool CPVREpgDatabase::QueueDeleteEpgTagsByMinEndMaxStartTimeQuery(
+    int iEpgID, const std::vector<std::pair<CDateTime, CDateTime>>& ranges)
+{
+  CSingleLock lock(m_critSection);
+
+  std::string strRanges;
+  size_t iRanges = 0;
+  bool bReturn = true;
+
+  for (auto it = ranges.cbegin(); it != ranges.cend(); ++it)
+  {
+    time_t minEnd;
+    (*it).first.GetAsTime(minEnd);
+
+    time_t maxStart;
+    (*it).second.GetAsTime(maxStart);
+
+    if (!strRanges.empty())
+      strRanges += " OR ";
+
+    strRanges += PrepareSQL("(iEndTime >= %u AND iStartTime <= %u)",
+                            static_cast<unsigned int>(minEnd), static_cast<unsigned int>(maxStart));
+
+    if (++iRanges >= EPG_PERSIST_ROWS_PER_QUERY || std::next(it) == ranges.cend())
+    {
+      Filter filter;
+      filter.AppendWhere(PrepareSQL("idEpg = %u", iEpgID));
+      filter.AppendWhere("(" + strRanges + ")");
+
+      std::string strQuery;
+      if (BuildSQL("DELETE FROM epgtags", filter, strQuery))
+        bReturn &= QueueDeleteQuery(strQuery);
+      else
+        bReturn = false;
+
+      strRanges.clear();
+      iRanges = 0;
+    }
+  }
+
+  return bReturn;
+}
+
 std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpgDatabase::GetAllEpgTags(int iEpgID)
 {
   CSingleLock lock(m_critSection);
@@ -1017,7 +1221,7 @@ bool CPVREpgDatabase::QueuePersistLastEpgScanTimeQuery(int iEpgId, const CDateTi
   std::string strQuery = PrepareSQL("REPLACE INTO lastepgscan(idEpg, sLastScan) VALUES (%u, '%s');",
       iEpgId, lastScanTime.GetAsDBDateTime().c_str());
 
-  return QueueInsertQuery(strQuery);
+  return QueueRowInsertQuery(strQuery);
 }
 
 bool CPVREpgDatabase::QueueDeleteLastEpgScanTimeQuery(const CPVREpg& table)
@@ -1057,7 +1261,7 @@ int CPVREpgDatabase::Persist(const CPVREpg& epg, bool bQueueWrite)
 
   if (bQueueWrite)
   {
-    if (QueueInsertQuery(strQuery))
+    if (QueueRowInsertQuery(strQuery))
       iReturn = epg.EpgID() <= 0 ? 0 : epg.EpgID();
   }
   else
@@ -1069,7 +1273,7 @@ int CPVREpgDatabase::Persist(const CPVREpg& epg, bool bQueueWrite)
   return iReturn;
 }
 
-bool CPVREpgDatabase::DeleteEpgTags(int iEpgId, const CDateTime& maxEndTime)
+bool CPVREpgDatabase::DeleteEpgTags(const CDateTime& maxEndTime)
 {
   time_t iMaxEndTime;
   maxEndTime.GetAsTime(iMaxEndTime);
@@ -1077,8 +1281,8 @@ bool CPVREpgDatabase::DeleteEpgTags(int iEpgId, const CDateTime& maxEndTime)
   Filter filter;
 
   CSingleLock lock(m_critSection);
-  filter.AppendWhere(
-      PrepareSQL("idEpg = %u AND iEndTime < %u", iEpgId, static_cast<unsigned int>(iMaxEndTime)));
+  // a single range delete for all tables, served by idx_epg_iEndTime
+  filter.AppendWhere(PrepareSQL("iEndTime < %u", static_cast<unsigned int>(iMaxEndTime)));
   return DeleteValues("epgtags", filter);
 }
 
@@ -1103,14 +1307,8 @@ bool CPVREpgDatabase::QueueDeleteEpgTags(int iEpgId)
   return QueueDeleteQuery(strQuery);
 }
 
-bool CPVREpgDatabase::QueuePersistQuery(const CPVREpgInfoTag& tag)
+std::string CPVREpgDatabase::GetPersistValues(const CPVREpgInfoTag& tag) const
 {
-  if (tag.EpgID() <= 0)
-  {
-    CLog::LogF(LOGERROR, "Tag '{}' does not have a valid table", tag.Title());
-    return false;
-  }
-
   time_t iStartTime, iEndTime;
   tag.StartAsUTC().GetAsTime(iStartTime);
   tag.EndAsUTC().GetAsTime(iEndTime);
@@ -1119,51 +1317,137 @@ bool CPVREpgDatabase::QueuePersistQuery(const CPVREpgInfoTag& tag)
   if (tag.FirstAired().IsValid())
     sFirstAired = tag.FirstAired().GetAsW3CDate();
 
-  int iBroadcastId = tag.DatabaseID();
-  std::string strQuery;
-
   /* Only store the genre string when needed */
   std::string strGenre = (tag.GenreType() == EPG_GENRE_USE_STRING || tag.GenreSubType() == EPG_GENRE_USE_STRING) ? tag.DeTokenize(tag.Genre()) : "";
 
-  CSingleLock lock(m_critSection);
+  std::string strValues = PrepareSQL(
+      "(%u, %u, %u, '%s', '%s', '%s', '%s', '%s', '%s', '%s', %i, '%s', '%s', %i, %i, '%s', '%s', %i, %i, %i, %i, %i, '%s', %i, '%s', %i",
+      tag.EpgID(), static_cast<unsigned int>(iStartTime), static_cast<unsigned int>(iEndTime),
+      tag.Title().c_str(), tag.PlotOutline().c_str(), tag.Plot().c_str(),
+      tag.OriginalTitle().c_str(), tag.DeTokenize(tag.Cast()).c_str(), tag.DeTokenize(tag.Directors()).c_str(),
+      tag.DeTokenize(tag.Writers()).c_str(), tag.Year(), tag.IMDBNumber().c_str(),
+      tag.Icon().c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
+      sFirstAired.c_str(), tag.ParentalRating(), tag.StarRating(),
+      tag.SeriesNumber(), tag.EpisodeNumber(), tag.EpisodePart(), tag.EpisodeName().c_str(), tag.Flags(), tag.SeriesLink().c_str(),
+      tag.UniqueBroadcastID());
+
+  if (tag.DatabaseID() >= 0)
+    strValues += PrepareSQL(", %i", tag.DatabaseID());
+
+  strValues += ")";
+  return strValues;
+}
 
-  if (iBroadcastId < 0)
+bool CPVREpgDatabase::QueuePersistQuery(const CPVREpgInfoTag& tag)
+{
+  if (tag.EpgID() <= 0)
   {
-    strQuery = PrepareSQL("REPLACE INTO epgtags (idEpg, iStartTime, "
-        "iEndTime, sTitle, sPlotOutline, sPlot, sOriginalTitle, sCast, sDirector, sWriter, iYear, sIMDBNumber, "
-        "sIconPath, iGenreType, iGenreSubType, sGenre, sFirstAired, iParentalRating, iStarRating, iSeriesId, "
-        "iEpisodeId, iEpisodePart, sEpisodeName, iFlags, sSeriesLink, iBroadcastUid) "
-        "VALUES (%u, %u, %u, '%s', '%s', '%s', '%s', '%s', '%s', '%s', %i, '%s', '%s', %i, %i, '%s', '%s', %i, %i, %i, %i, %i, '%s', %i, '%s', %i);",
-        tag.EpgID(), static_cast<unsigned int>(iStartTime), static_cast<unsigned int>(iEndTime),
-        tag.Title().c_str(), tag.PlotOutline().c_str(), tag.Plot().c_str(),
-        tag.OriginalTitle().c_str(), tag.DeTokenize(tag.Cast()).c_str(), tag.DeTokenize(tag.Directors()).c_str(),
-        tag.DeTokenize(tag.Writers()).c_str(), tag.Year(), tag.IMDBNumber().c_str(),
-        tag.Icon().c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
-        sFirstAired.c_str(), tag.ParentalRating(), tag.StarRating(),
-        tag.SeriesNumber(), tag.EpisodeNumber(), tag.EpisodePart(), tag.EpisodeName().c_str(), tag.Flags(), tag.SeriesLink().c_str(),
-        tag.UniqueBroadcastID());
+    CLog::LogF(LOGERROR, "Tag '{}' does not have a valid table", tag.Title());
+    return false;
   }
-  else
+
+  CSingleLock lock(m_critSection);
+
+  std::string strQuery = StringUtils::Format("REPLACE INTO epgtags ({}{}) VALUES {};",
+                                             EPG_TAG_COLUMNS,
+                                             tag.DatabaseID() < 0 ? "" : ", idBroadcast",
+                                             GetPersistValues(tag));
+  QueueRowInsertQuery(strQuery);
+  return true;
+}
+
+bool CPVREpgDatabase::QueuePersistQuery(const std::vector<std::shared_ptr<CPVREpgInfoTag>>& tags)
+{
+  // new tags and tags already known to the database use a different column list
+  std::string strQueries[2];
+  size_t iRows[2] = {0, 0};
+
+  CSingleLock lock(m_critSection);
+
+  const auto flush = [this, &strQueries, &iRows](int i) {
+    if (iRows[i] == 0)
+      return;
+
+    strQueries[i] += ";";
+    QueueInsertQuery(strQueries[i]);
+    strQueries[i].clear();
+    iRows[i] = 0;
+  };
+
+  for (const auto& tag : tags)
   {
-    strQuery = PrepareSQL("REPLACE INTO epgtags (idEpg, iStartTime, "
-        "iEndTime, sTitle, sPlotOutline, sPlot, sOriginalTitle, sCast, sDirector, sWriter, iYear, sIMDBNumber, "
-        "sIconPath, iGenreType, iGenreSubType, sGenre, sFirstAired, iParentalRating, iStarRating, iSeriesId, "
-        "iEpisodeId, iEpisodePart, sEpisodeName, iFlags, sSeriesLink, iBroadcastUid, idBroadcast) "
-        "VALUES (%u, %u, %u, '%s', '%s', '%s', '%s', '%s', '%s', '%s', %i, '%s', '%s', %i, %i, '%s', '%s', %i, %i, %i, %i, %i, '%s', %i, '%s', %i, %i);",
-        tag.EpgID(), static_cast<unsigned int>(iStartTime), static_cast<unsigned int>(iEndTime),
-        tag.Title().c_str(), tag.PlotOutline().c_str(), tag.Plot().c_str(),
-        tag.OriginalTitle().c_str(), tag.DeTokenize(tag.Cast()).c_str(), tag.DeTokenize(tag.Directors()).c_str(),
-        tag.DeTokenize(tag.Writers()).c_str(), tag.Year(), tag.IMDBNumber().c_str(),
-        tag.Icon().c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
-        sFirstAired.c_str(), tag.ParentalRating(), tag.StarRating(),
-        tag.SeriesNumber(), tag.EpisodeNumber(), tag.EpisodePart(), tag.EpisodeName().c_str(), tag.Flags(), tag.SeriesLink().c_str(),
-        tag.UniqueBroadcastID(), iBroadcastId);
+    if (tag->EpgID() <= 0)
+    {
+      CLog::LogF(LOGERROR, "Tag '{}' does not have a valid table", tag->Title());
+      continue;
+    }
+
+    const int i = tag->DatabaseID() < 0 ? 0 : 1;
+    const std::string strInsert = StringUtils::Format("REPLACE INTO epgtags ({}{}) VALUES ",
+                                                      EPG_TAG_COLUMNS, i == 0 ? "" : ", idBroadcast");
+    const std::string strValues = GetPersistValues(*tag);
+
+    // kept in case the multi-row queries fail
+    m_rowQueries.emplace_back(strInsert + strValues + ";");
+    if (!m_bMultiRowPersist)
+    {
+      QueueInsertQuery(m_rowQueries.back());
+      continue;
+    }
+
+    if (iRows[i] == 0)
+      strQueries[i] = strInsert;
+    else
+      strQueries[i] += ", ";
+
+    strQueries[i] += strValues;
+    m_bMultiRowQueued = true;
+
+    if (++iRows[i] >= EPG_PERSIST_ROWS_PER_QUERY ||
+        strQueries[i].size() >= EPG_PERSIST_MAX_QUERY_LENGTH)
+      flush(i);
   }
 
-  QueueInsertQuery(strQuery);
+  flush(0);
+  flush(1);
+  return true;
+}
+
+bool CPVREpgDatabase::QueueRowInsertQuery(const std::string& strQuery)
+{
+  if (!QueueInsertQuery(strQuery))
+    return false;
+
+  m_rowQueries.emplace_back(strQuery);
   return true;
 }
 
+bool CPVREpgDatabase::CommitInsertQueries()
+{
+  CSingleLock lock(m_critSection);
+
+  std::vector<std::string> rowQueries;
+  rowQueries.swap(m_rowQueries);
+  const bool bMultiRowQueued = m_bMultiRowQueued;
+  m_bMultiRowQueued = false;
+
+  bool bReturn = CDatabase::CommitInsertQueries();
+  if (bReturn || !bMultiRowQueued)
+    return bReturn;
+
+  // the queue was rolled back. the database may not take long statements or multi-row values at
+  // all, persist one row per query from now on.
+  CLog::LogF(LOGWARNING, "Failed to persist tags with multi-row queries, retrying {} queries",
+             rowQueries.size());
+  m_bMultiRowPersist = false;
+  m_pDS2->clear_insert_sql();
+
+  for (const auto& strQuery : rowQueries)
+    QueueInsertQuery(strQuery);
+
+  return CDatabase::CommitInsertQueries();
+}
+
 int CPVREpgDatabase::GetLastEPGId()
 {
   CSingleLock lock(m_critSection);
@@ -12,6 +12,8 @@
 #include "threads/CriticalSection.h"
 
 #include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 class CDateTime;
@@ -65,7 +67,7 @@ namespace PVR
      * @brief Get the minimal database version that is required to operate correctly.
      * @return The minimal database version.
      */
-    int GetSchemaVersion() const override { return 13; }
+    int GetSchemaVersion() const override { return 14; }
 
     /*!
      * @brief Get the default sqlite database filename.
@@ -220,6 +222,16 @@ namespace PVR
                                                      const CDateTime& minEndTime,
                                                      const CDateTime& maxStartTime);
 
+    /*!
+     * @brief Write the queries to delete all EPG tags of the given EPG id overlapping any of the
+     * given ranges to db query queue. Many ranges are combined into one query.
+     * @param iEpgID The ID of the EPG for the tags to delete.
+     * @param ranges The (min end time, max start time) pairs of the tags to delete.
+     * @return True if the queries were queued successfully, false otherwise.
+     */
+    bool QueueDeleteEpgTagsByMinEndMaxStartTimeQuery(
+        int iEpgID, const std::vector<std::pair<CDateTime, CDateTime>>& ranges);
+
     /*!
      * @brief Get the last stored EPG scan time.
      * @param iEpgId The table to update the time for. Use 0 for a global value.
@@ -252,12 +264,11 @@ namespace PVR
     int Persist(const CPVREpg& epg, bool bQueueWrite);
 
     /*!
-     * @brief Erase all EPG tags with the given epg ID and an end time less than the given time.
-     * @param iEpgId The ID of the EPG.
+     * @brief Erase all EPG tags of all EPGs with an end time less than the given time.
      * @param maxEndTime The maximum allowed end time.
      * @return True if the entries were removed successfully, false otherwise.
      */
-    bool DeleteEpgTags(int iEpgId, const CDateTime& maxEndTime);
+    bool DeleteEpgTags(const CDateTime& maxEndTime);
 
     /*!
      * @brief Erase all EPG tags with the given epg ID.
@@ -280,6 +291,21 @@ namespace PVR
      */
     bool QueuePersistQuery(const CPVREpgInfoTag& tag);
 
+    /*!
+     * @brief Write the queries to persist the given EPG tags to db query queue. Many tags are
+     * combined into one multi-row query.
+     * @param tags The tags to persist.
+     * @return True on success, false otherwise.
+     */
+    bool QueuePersistQuery(const std::vector<std::shared_ptr<CPVREpgInfoTag>>& tags);
+
+    /*!
+     * @brief Commit all queries in the queue. If multi-row queries fail, the queue is committed
+     * again with one query per row and tags are persisted row by row from then on.
+     * @return True if all queries were executed successfully, false otherwise.
+     */
+    bool CommitInsertQueries() override;
+
     /*!
      * @return Last EPG id in the database
      */
@@ -298,6 +324,20 @@ namespace PVR
      */
     void CreateAnalytics() override;
 
+    /*!
+     * @brief Get the VALUES tuple to persist the given EPG tag.
+     * @param tag The tag.
+     * @return The tuple, including idBroadcast if the tag has a database ID.
+     */
+    std::string GetPersistValues(const CPVREpgInfoTag& tag) const;
+
+    /*!
+     * @brief Put a single-row INSERT or REPLACE query in the queue.
+     * @param strQuery The query to queue.
+     * @return True if the query was added successfully, false otherwise.
+     */
+    bool QueueRowInsertQuery(const std::string& strQuery);
+
     /*!
      * @brief Update an old version of the database.
      * @param version The version to update the database from.
@@ -308,6 +348,22 @@ namespace PVR
 
     std::shared_ptr<CPVREpgInfoTag> CreateEpgTag(const std::unique_ptr<dbiplus::Dataset>& pDS);
 
+    /*!
+     * @brief Create the full-text search index over title, plot outline and plot.
+     * @return True if the index was created, false if the database does not support it.
+     */
+    bool CreateSearchIndex();
+
+    /*!
+     * @brief Check whether the full-text search index exists and is kept up to date.
+     * @return True if the index can be used for searches, false otherwise.
+     */
+    bool HasSearchIndex();
+
     CCriticalSection m_critSection;
+    bool m_bHasSearchIndex = false;
+    bool m_bMultiRowPersist = true; /*!< tags are persisted with multi-row queries */
+    bool m_bMultiRowQueued = false; /*!< the insert queue holds multi-row queries */
+    std::vector<std::string> m_rowQueries; /*!< the insert queue, one query per row */
   };
 }
@@ -14,6 +14,10 @@
 #include "pvr/epg/EpgTagsCache.h"
 #include "utils/log.h"
 
+#include <memory>
+#include <utility>
+#include <vector>
+
 using namespace PVR;
 
 namespace
@@ -318,9 +322,6 @@ void CPVREpgTagsContainer::Cleanup(const CDateTime& time)
       ++it;
     }
   }
-
-  if (m_database)
-    m_database->DeleteEpgTags(m_iEpgID, time);
 }
 
 void CPVREpgTagsContainer::Clear()
@@ -339,6 +340,11 @@ bool CPVREpgTagsContainer::IsEmpty() const
   return true;
 }
 
+size_t CPVREpgTagsContainer::GetChangedTagsCount() const
+{
+  return m_changedTags.size();
+}
+
 std::shared_ptr<CPVREpgInfoTag> CPVREpgTagsContainer::GetTag(const CDateTime& startTime) const
 {
   const auto it = m_changedTags.find(startTime);
@@ -628,15 +634,23 @@ void CPVREpgTagsContainer::QueuePersistQuery()
 
     FixOverlappingEvents(m_changedTags);
 
+    std::vector<std::pair<CDateTime, CDateTime>> conflictRanges;
+    std::vector<std::shared_ptr<CPVREpgInfoTag>> tags;
+    conflictRanges.reserve(m_changedTags.size());
+    tags.reserve(m_changedTags.size());
+
     for (const auto& tag : m_changedTags)
     {
-      // remove any conflicting events from database before persisting the new event
-      m_database->QueueDeleteEpgTagsByMinEndMaxStartTimeQuery(
-          m_iEpgID, tag.second->StartAsUTC() + ONE_SECOND, tag.second->EndAsUTC() - ONE_SECOND);
-
-      tag.second->QueuePersistQuery(m_database);
+      conflictRanges.emplace_back(tag.second->StartAsUTC() + ONE_SECOND,
+                                  tag.second->EndAsUTC() - ONE_SECOND);
+      tags.emplace_back(tag.second);
     }
 
+    // remove any conflicting events from database before persisting the new events. deletes are
+    // committed before inserts, so batching both keeps the original order of operations.
+    m_database->QueueDeleteEpgTagsByMinEndMaxStartTimeQuery(m_iEpgID, conflictRanges);
+    m_database->QueuePersistQuery(tags);
+
     m_changedTags.clear();
 
     m_database->Unlock();
@@ -69,7 +69,8 @@ public:
   void Clear();
 
   /*!
-   * @brief Remove all entries which were finished before the given time.
+   * @brief Remove all not yet persisted entries which were finished before the given time.
+   * Persisted entries are removed for all tables at once, see CPVREpgDatabase::DeleteEpgTags.
    * @param time Delete entries with an end time before this time.
    */
   void Cleanup(const CDateTime& time);
@@ -80,6 +81,12 @@ public:
    */
   bool IsEmpty() const;
 
+  /*!
+   * @brief Get the number of entries not yet persisted.
+   * @return The number of entries.
+   */
+  size_t GetChangedTagsCount() const;
+
   /*!
    * @brief Get an EPG tag given its start time.
    * @param startTime The start time
@@ -19,7 +19,9 @@
 #include "utils/Variant.h"
 #include "utils/log.h"
 
+#include <algorithm>
 #include <cmath>
+#include <iterator>
 #include <memory>
 #include <vector>
 
@@ -144,6 +146,52 @@ void CGUIEPGGridContainerModel::Initialize(const std::unique_ptr<CFileItemList>&
   m_lastActiveBlock = iFirstBlock + iBlocksPerPage - 1;
 }
 
+std::shared_ptr<CFileItem> CGUIEPGGridContainerModel::GetEpgTagItem(const EpgTag& epgTag) const
+{
+  if (!epgTag.item)
+    epgTag.item = CreateEpgTagItem(epgTag.tag);
+
+  return epgTag.item;
+}
+
+std::shared_ptr<CFileItem> CGUIEPGGridContainerModel::CreateEpgTagItem(
+    const std::shared_ptr<CPVREpgInfoTag>& tag) const
+{
+  return std::make_shared<CFileItem>(tag);
+}
+
+const CGUIEPGGridContainerModel::EpgTag* CGUIEPGGridContainerModel::FindEpgTag(
+    const EpgTags& epgTags, int iBlock) const
+{
+  // tags are sorted and do not overlap, the candidate is the last one starting at or before iBlock
+  auto it = std::upper_bound(epgTags.tags.cbegin(), epgTags.tags.cend(), iBlock,
+                             [](int block, const EpgTag& tag) { return block < tag.firstBlock; });
+  if (it == epgTags.tags.cbegin())
+    return nullptr;
+
+  --it;
+  if (iBlock <= (*it).lastBlock)
+    return &(*it);
+
+  return nullptr;
+}
+
+void CGUIEPGGridContainerModel::AppendEpgTags(
+    std::vector<EpgTag>& epgTags, const std::vector<std::shared_ptr<CPVREpgInfoTag>>& tags) const
+{
+  epgTags.reserve(epgTags.size() + tags.size());
+
+  for (const auto& tag : tags)
+  {
+    const int firstBlock = GetFirstEventBlock(tag);
+    const int lastBlock = GetLastEventBlock(tag);
+    if (firstBlock > lastBlock)
+      continue;
+
+    epgTags.emplace_back(firstBlock, lastBlock, tag);
+  }
+}
+
 std::shared_ptr<CFileItem> CGUIEPGGridContainerModel::CreateEpgTags(int iChannel, int iBlock) const
 {
   std::shared_ptr<CFileItem> result;
@@ -165,17 +213,11 @@ std::shared_ptr<CFileItem> CGUIEPGGridContainerModel::CreateEpgTags(int iChannel
   epgTags.firstBlock = firstResultBlock;
   epgTags.lastBlock = lastResultBlock;
 
-  for (const auto& tag : tags)
-  {
-    if (GetFirstEventBlock(tag) > GetLastEventBlock(tag))
-      continue;
+  AppendEpgTags(epgTags.tags, tags);
 
-    const std::shared_ptr<CFileItem> item = std::make_shared<CFileItem>(tag);
-    if (!result && IsEventMemberOfBlock(tag, iBlock))
-      result = item;
-
-    epgTags.tags.emplace_back(item);
-  }
+  const EpgTag* epgTag = FindEpgTag(epgTags, iBlock);
+  if (epgTag)
+    result = GetEpgTagItem(*epgTag);
 
   return result;
 }
@@ -198,14 +240,9 @@ std::shared_ptr<CFileItem> CGUIEPGGridContainerModel::GetEpgTags(EpgTagsMap::ite
   }
   else
   {
-    for (const auto& item : epgTags.tags)
-    {
-      if (IsEventMemberOfBlock(item->GetEPGInfoTag(), iBlock))
-      {
-        result = item;
-        break;
-      }
-    }
+    const EpgTag* epgTag = FindEpgTag(epgTags, iBlock);
+    if (epgTag)
+      result = GetEpgTagItem(*epgTag);
   }
 
   return result;
@@ -241,35 +278,26 @@ std::shared_ptr<CFileItem> CGUIEPGGridContainerModel::GetEpgTagsBefore(EpgTags&
     // insert before the existing tags
     epgTags.firstBlock = firstResultBlock;
 
-    auto it = tags.crbegin();
-    if (!epgTags.tags.empty())
+    std::vector<EpgTag> newTags;
+    AppendEpgTags(newTags, tags);
+
+    if (!newTags.empty() && !epgTags.tags.empty())
     {
       // ptr comp does not work for gap tags!
-      // if ((*it) == epgTags.tags.front()->GetEPGInfoTag())
-
-      const std::shared_ptr<CPVREpgInfoTag> t = epgTags.tags.front()->GetEPGInfoTag();
-      if ((*it)->StartAsUTC() == t->StartAsUTC() && (*it)->EndAsUTC() == t->EndAsUTC())
-      {
-        if (!result && IsEventMemberOfBlock(*it, iBlock))
-          result = epgTags.tags.front();
-
-        ++it; // skip, because we already have that epg tag
-      }
+      const std::shared_ptr<CPVREpgInfoTag>& t = epgTags.tags.front().tag;
+      const std::shared_ptr<CPVREpgInfoTag>& n = newTags.back().tag;
+      if (n->StartAsUTC() == t->StartAsUTC() && n->EndAsUTC() == t->EndAsUTC())
+        newTags.pop_back(); // skip, because we already have that epg tag
     }
 
-    for (; it != tags.crend(); ++it)
-    {
-      if (GetFirstEventBlock(*it) > GetLastEventBlock(*it))
-        continue;
-
-      const std::shared_ptr<CFileItem> item = std::make_shared<CFileItem>(*it);
-      if (!result && IsEventMemberOfBlock(*it, iBlock))
-        result = item;
-
-      epgTags.tags.insert(epgTags.tags.begin(), item);
-    }
+    epgTags.tags.insert(epgTags.tags.begin(), std::make_move_iterator(newTags.begin()),
+                        std::make_move_iterator(newTags.end()));
   }
 
+  const EpgTag* epgTag = FindEpgTag(epgTags, iBlock);
+  if (epgTag)
+    result = GetEpgTagItem(*epgTag);
+
   return result;
 }
 
@@ -303,35 +331,23 @@ std::shared_ptr<CFileItem> CGUIEPGGridContainerModel::GetEpgTagsAfter(EpgTags& e
     // append to the existing tags
     epgTags.lastBlock = lastResultBlock;
 
-    auto it = tags.cbegin();
-    if (!epgTags.tags.empty())
-    {
-      // ptr comp does not work for gap tags!
-      // if ((*it) == epgTags.tags.back()->GetEPGInfoTag())
-
-      const std::shared_ptr<CPVREpgInfoTag> t = epgTags.tags.back()->GetEPGInfoTag();
-      if ((*it)->StartAsUTC() == t->StartAsUTC() && (*it)->EndAsUTC() == t->EndAsUTC())
-      {
-        if (!result && IsEventMemberOfBlock(*it, iBlock))
-          result = epgTags.tags.back();
-
-        ++it; // skip, because we already have that epg tag
-      }
-    }
+    const size_t existing = epgTags.tags.size();
+    AppendEpgTags(epgTags.tags, tags);
 
-    for (; it != tags.cend(); ++it)
+    if (existing > 0 && epgTags.tags.size() > existing)
     {
-      if (GetFirstEventBlock(*it) > GetLastEventBlock(*it))
-        continue;
-
-      const std::shared_ptr<CFileItem> item = std::make_shared<CFileItem>(*it);
-      if (!result && IsEventMemberOfBlock(*it, iBlock))
-        result = item;
-
-      epgTags.tags.emplace_back(item);
+      // ptr comp does not work for gap tags!
+      const std::shared_ptr<CPVREpgInfoTag>& t = epgTags.tags[existing - 1].tag;
+      const std::shared_ptr<CPVREpgInfoTag>& n = epgTags.tags[existing].tag;
+      if (n->StartAsUTC() == t->StartAsUTC() && n->EndAsUTC() == t->EndAsUTC())
+        epgTags.tags.erase(epgTags.tags.begin() + existing); // we already have that epg tag
     }
   }
 
+  const EpgTag* epgTag = FindEpgTag(epgTags, iBlock);
+  if (epgTag)
+    result = GetEpgTagItem(*epgTag);
+
   return result;
 }
 
@@ -559,13 +575,8 @@ bool CGUIEPGGridContainerModel::FreeProgrammeMemory(int firstChannel,
         epgTags.firstBlock = firstResultBlock;
         epgTags.lastBlock = lastResultBlock;
 
-        for (const auto& tag : tags)
-        {
-          if (GetFirstEventBlock(tag) > GetLastEventBlock(tag))
-            continue;
-
-          epgTags.tags.emplace_back(std::make_shared<CFileItem>(tag));
-        }
+        // file items get created on demand, only for the cells actually shown
+        AppendEpgTags(epgTags.tags, tags);
       }
     }
   }
@@ -701,8 +712,9 @@ std::unique_ptr<CFileItemList> CGUIEPGGridContainerModel::GetCurrentTimeLineItem
     if (itEpg != m_epgItems.end())
     {
       // tags are sorted, so we can iterate and append
-      for (const auto& tag : (*itEpg).second.tags)
+      for (const auto& epgTag : (*itEpg).second.tags)
       {
+        const std::shared_ptr<CFileItem> tag = GetEpgTagItem(epgTag);
         tag->SetProperty("TimelineIndex", i);
         items->Add(tag);
         ++i;
@@ -97,7 +97,7 @@ namespace PVR
     bool IsZeroGridDuration() const { return (m_gridEnd - m_gridStart) == CDateTimeSpan(0, 0, 0, 0); }
     const CDateTime& GetGridStart() const { return m_gridStart; }
     const CDateTime& GetGridEnd() const { return m_gridEnd; }
-    unsigned int GetGridStartPadding() const;
+    virtual unsigned int GetGridStartPadding() const;
 
     unsigned int GetPageNowOffset() const;
     int GetNowBlock() const;
@@ -111,23 +111,53 @@ namespace PVR
 
     std::unique_ptr<CFileItemList> GetCurrentTimeLineItems() const;
 
+  protected:
+    /*!
+     * @brief The events of a channel ending after minEventEnd and starting before maxEventStart,
+     * gaps filled with gap tags. Never empty.
+     */
+    virtual std::vector<std::shared_ptr<CPVREpgInfoTag>> GetEPGTimeline(
+        int iChannel, const CDateTime& minEventEnd, const CDateTime& maxEventStart) const;
+
+    virtual std::shared_ptr<CFileItem> CreateEpgTagItem(
+        const std::shared_ptr<CPVREpgInfoTag>& tag) const;
+
   private:
     GridItem* GetGridItemPtr(int iChannel, int iBlock) const;
     std::shared_ptr<CFileItem> CreateGapItem(int iChannel) const;
     std::shared_ptr<CFileItem> GetItem(int iChannel, int iBlock) const;
 
-    std::vector<std::shared_ptr<CPVREpgInfoTag>> GetEPGTimeline(
-        int iChannel, const CDateTime& minEventEnd, const CDateTime& maxEventStart) const;
+    /*!
+     * @brief An event of the timeline. The block range is calculated once, the file item is only
+     * created when the event actually gets displayed.
+     */
+    struct EpgTag
+    {
+      EpgTag(int _firstBlock, int _lastBlock, const std::shared_ptr<CPVREpgInfoTag>& _tag)
+        : firstBlock(_firstBlock), lastBlock(_lastBlock), tag(_tag)
+      {
+      }
+
+      int firstBlock = 0;
+      int lastBlock = 0;
+      std::shared_ptr<CPVREpgInfoTag> tag;
+      mutable std::shared_ptr<CFileItem> item;
+    };
 
     struct EpgTags
     {
-      std::vector<std::shared_ptr<CFileItem>> tags;
+      std::vector<EpgTag> tags; // sorted by start time
       int firstBlock = -1;
       int lastBlock = -1;
     };
 
     using EpgTagsMap = std::unordered_map<int, EpgTags>;
 
+    std::shared_ptr<CFileItem> GetEpgTagItem(const EpgTag& epgTag) const;
+    const EpgTag* FindEpgTag(const EpgTags& epgTags, int iBlock) const;
+    void AppendEpgTags(std::vector<EpgTag>& epgTags,
+                       const std::vector<std::shared_ptr<CPVREpgInfoTag>>& tags) const;
+
     std::shared_ptr<CFileItem> CreateEpgTags(int iChannel, int iBlock) const;
     std::shared_ptr<CFileItem> GetEpgTags(EpgTagsMap::iterator& itEpg,
                                           int iChannel,
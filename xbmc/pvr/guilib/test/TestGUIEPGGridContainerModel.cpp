@@ -0,0 +1,224 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "pvr/epg/EpgChannelData.h"
+#include "pvr/epg/EpgInfoTag.h"
+#include "pvr/guilib/GUIEPGGridContainerModel.h"
+#include "utils/TimeUtils.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace PVR;
+
+namespace
+{
+
+constexpr int CHANNELS = 500;
+constexpr int DAYS = 7;
+constexpr int CHANNELS_PER_PAGE = 8;
+constexpr int BLOCKS_PER_PAGE = 24; // two hours
+constexpr int MINUTES = CGUIEPGGridContainerModel::MINSPERBLOCK;
+
+// event lengths in minutes, every channel runs the same schedule at another offset
+const std::vector<int> SCHEDULE = {30, 60, 25, 90, 45, 120, 5, 15};
+constexpr int SCHEDULE_LENGTH = 390;
+
+/*!
+ * \brief A guide without epg database or pvr manager. Events are created when the grid asks for
+ * them, the way the database returns them.
+ */
+class CSyntheticGuideModel : public CGUIEPGGridContainerModel
+{
+public:
+  explicit CSyntheticGuideModel(const CDateTime& start) : m_origin(start - CDateTimeSpan(1, 0, 0, 0))
+  {
+  }
+
+  unsigned int GetGridStartPadding() const override { return 30; }
+
+  /*!
+   * \brief Start and end of the event of a channel running at the given time
+   */
+  void GetEvent(int iChannel, const CDateTime& time, CDateTime& start, CDateTime& end) const
+  {
+    const CDateTime origin = GetOrigin(iChannel);
+    const int minutes = (time - origin).GetSecondsTotal() / 60;
+    int offset = minutes - minutes % SCHEDULE_LENGTH;
+    for (int length : SCHEDULE)
+    {
+      if (offset + length > minutes)
+      {
+        start = origin + CDateTimeSpan(0, 0, offset, 0);
+        end = start + CDateTimeSpan(0, 0, length, 0);
+        return;
+      }
+      offset += length;
+    }
+  }
+
+  mutable int m_timelineRequests = 0;
+
+protected:
+  std::vector<std::shared_ptr<CPVREpgInfoTag>> GetEPGTimeline(
+      int iChannel, const CDateTime& minEventEnd, const CDateTime& maxEventStart) const override
+  {
+    m_timelineRequests++;
+
+    std::vector<std::shared_ptr<CPVREpgInfoTag>> tags;
+    CDateTime start, end;
+    GetEvent(iChannel, minEventEnd, start, end);
+
+    while (start < maxEventStart || tags.empty())
+    {
+      tags.emplace_back(std::make_shared<CPVREpgInfoTag>(m_channelData, iChannel, start, end, false));
+      GetEvent(iChannel, end, start, end);
+    }
+    return tags;
+  }
+
+  std::shared_ptr<CFileItem> CreateEpgTagItem(
+      const std::shared_ptr<CPVREpgInfoTag>& tag) const override
+  {
+    std::shared_ptr<CFileItem> item = std::make_shared<CFileItem>();
+    item->SetEPGInfoTag(tag);
+    return item;
+  }
+
+private:
+  CDateTime GetOrigin(int iChannel) const
+  {
+    return m_origin - CDateTimeSpan(0, 0, (iChannel * 35) % SCHEDULE_LENGTH, 0);
+  }
+
+  const CDateTime m_origin;
+  const std::shared_ptr<CPVREpgChannelData> m_channelData = std::make_shared<CPVREpgChannelData>();
+};
+
+class TestGUIEPGGridContainerModel : public testing::Test
+{
+protected:
+  TestGUIEPGGridContainerModel() : m_start(2020, 1, 6, 0, 0, 0), m_model(m_start)
+  {
+    for (int i = 0; i < CHANNELS; i++)
+      m_channels->Add(std::make_shared<CFileItem>("channel " + std::to_string(i)));
+  }
+
+  void Initialize()
+  {
+    m_model.Initialize(m_channels, m_start, m_start + CDateTimeSpan(DAYS, 0, 0, 0), 0,
+                       CHANNELS_PER_PAGE, 0, BLOCKS_PER_PAGE, 6, 10.0f);
+  }
+
+  /*!
+   * \brief Look up every cell of a page the way the container renders it
+   * \return false if a cell shows the wrong event
+   */
+  bool CheckPage(int firstChannel, int firstBlock)
+  {
+    const int lastChannel = firstChannel + CHANNELS_PER_PAGE - 1;
+    const int lastBlock = firstBlock + BLOCKS_PER_PAGE - 1;
+    m_model.FreeProgrammeMemory(firstChannel, lastChannel, firstBlock, lastBlock);
+
+    for (int channel = firstChannel; channel <= lastChannel; channel++)
+    {
+      for (int block = firstBlock; block <= lastBlock; block++)
+      {
+        const std::shared_ptr<CFileItem> item = m_model.GetGridItem(channel, block);
+        const CDateTime time = m_model.GetStartTimeForBlock(block);
+        CDateTime start, end;
+        m_model.GetEvent(channel, time, start, end);
+        if (!item || item->GetEPGInfoTag()->StartAsUTC() != start ||
+            item->GetEPGInfoTag()->EndAsUTC() != end ||
+            m_model.GetGridItemStartBlock(channel, block) > block ||
+            m_model.GetGridItemEndBlock(channel, block) < block)
+        {
+          ADD_FAILURE() << "channel " << channel << ", block " << block;
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  const CDateTime m_start;
+  CSyntheticGuideModel m_model;
+  std::unique_ptr<CFileItemList> m_channels = std::make_unique<CFileItemList>();
+};
+
+} // namespace
+
+TEST_F(TestGUIEPGGridContainerModel, Initialize)
+{
+  const int64_t start = CurrentHostCounter();
+  Initialize();
+  const int64_t initialize = CurrentHostCounter() - start;
+
+  RecordProperty("initialize_us",
+                 std::to_string(initialize * 1000000 / CurrentHostFrequency()));
+
+  EXPECT_EQ(CHANNELS, m_model.ChannelItemsSize());
+  EXPECT_EQ(m_start, m_model.GetGridStart());
+  EXPECT_EQ(0, m_model.GridItemsSize() % BLOCKS_PER_PAGE);
+  EXPECT_GE(m_model.GridItemsSize(), DAYS * 24 * 60 / MINUTES);
+  // nothing is fetched before it is shown
+  EXPECT_EQ(0, m_model.m_timelineRequests);
+}
+
+TEST_F(TestGUIEPGGridContainerModel, ScrollBlocks)
+{
+  Initialize();
+  ASSERT_TRUE(CheckPage(0, 0));
+
+  // scroll through the week one block at a time
+  int64_t total = 0;
+  int64_t slowest = 0;
+  int steps = 0;
+  for (int block = 1; block + BLOCKS_PER_PAGE <= m_model.GridItemsSize(); block++, steps++)
+  {
+    const int64_t start = CurrentHostCounter();
+    ASSERT_TRUE(CheckPage(CHANNELS / 2, block));
+    const int64_t frame = CurrentHostCounter() - start;
+    total += frame;
+    slowest = std::max(slowest, frame);
+  }
+
+  const int64_t frequency = CurrentHostFrequency();
+  RecordProperty("block_scroll_mean_us", std::to_string(total * 1000000 / frequency / steps));
+  RecordProperty("block_scroll_max_us", std::to_string(slowest * 1000000 / frequency));
+}
+
+TEST_F(TestGUIEPGGridContainerModel, ScrollChannels)
+{
+  Initialize();
+
+  // page down the channels, the last page of the week
+  const int lastPage = m_model.GridItemsSize() - BLOCKS_PER_PAGE;
+  int64_t total = 0;
+  int64_t slowest = 0;
+  int steps = 0;
+  for (int channel = 0; channel + CHANNELS_PER_PAGE <= CHANNELS; channel++, steps++)
+  {
+    const int64_t start = CurrentHostCounter();
+    ASSERT_TRUE(CheckPage(channel, lastPage));
+    const int64_t frame = CurrentHostCounter() - start;
+    total += frame;
+    slowest = std::max(slowest, frame);
+  }
+
+  const int64_t frequency = CurrentHostFrequency();
+  RecordProperty("channel_scroll_mean_us", std::to_string(total * 1000000 / frequency / steps));
+  RecordProperty("channel_scroll_max_us", std::to_string(slowest * 1000000 / frequency));
+
+  // scrolling in does not refetch the channels that stayed on the page
+  EXPECT_LT(m_model.m_timelineRequests, 2 * (CHANNELS + CHANNELS_PER_PAGE));
+}
@@ -66,6 +66,18 @@ public:
 
   virtual std::string GetShaderPath(const std::string &filename) { return ""; }
 
+  /**
+   * Submit GUI geometry that is still queued for batched drawing. Needs to be called
+   * before rendering with GL state the render system doesn't know about.
+   */
+  virtual void FlushGUIBatches() {}
+
+  /**
+   * Draw calls and quads the GUI batcher submitted in the last frame
+   * \return false if the render system doesn't batch GUI draws
+   */
+  virtual bool GetGUIBatchStats(unsigned int& drawCalls, unsigned int& quads) const { return false; }
+
   void GetRenderVersion(unsigned int& major, unsigned int& minor) const;
   const std::string& GetRenderVendor() const { return m_RenderVendor; }
   const std::string& GetRenderRenderer() const { return m_RenderRenderer; }
@@ -0,0 +1,221 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "GUIRenderBatcherGLES.h"
+
+#include "guilib/Texture.h"
+
+#include <algorithm>
+#include <cstddef>
+
+CGUIRenderBatcherGLES::CGUIRenderBatcherGLES(CRenderSystemGLES& renderSystem)
+  : m_renderSystem(renderSystem)
+{
+}
+
+void CGUIRenderBatcherGLES::Add(const GUIBatchState& state, const PackedVertices& vertices)
+{
+  if (vertices.empty() || vertices.size() > MAX_VERTICES)
+    return;
+
+  if (m_vertices.size() + vertices.size() > MAX_VERTICES)
+    Flush();
+
+  CRect bounds(vertices[0].x, vertices[0].y, vertices[0].x, vertices[0].y);
+  bool flat = true;
+  for (const auto& vertex : vertices)
+  {
+    bounds.x1 = std::min(bounds.x1, vertex.x);
+    bounds.y1 = std::min(bounds.y1, vertex.y);
+    bounds.x2 = std::max(bounds.x2, vertex.x);
+    bounds.y2 = std::max(bounds.y2, vertex.y);
+    if (vertex.z != 0.0f)
+      flat = false;
+  }
+
+  // look for an earlier batch with the same state that we can join without changing the result.
+  // Quads with depth get projected by the shader, so their screen bounds are unknown and they
+  // only ever join the last batch.
+  Batch* target = nullptr;
+  size_t lookback = 0;
+  for (size_t i = m_numBatches; i > 0 && lookback < MAX_LOOKBACK; i--, lookback++)
+  {
+    Batch& batch = m_batches[i - 1];
+    if (batch.state == state)
+    {
+      target = &batch;
+      break;
+    }
+    if (!flat || !batch.reorderable || !CRect(batch.bounds).Intersect(bounds).IsEmpty())
+      break;
+  }
+
+  if (!target)
+  {
+    if (m_numBatches == m_batches.size())
+      m_batches.emplace_back();
+    target = &m_batches[m_numBatches++];
+    target->state = state;
+    target->bounds = bounds;
+    target->reorderable = flat;
+    target->indices.clear();
+  }
+  else
+  {
+    target->bounds.Union(bounds);
+    target->reorderable &= flat;
+  }
+
+  for (size_t i = m_vertices.size(); i < m_vertices.size() + vertices.size(); i += 4)
+  {
+    const GLushort quad = static_cast<GLushort>(i);
+    target->indices.insert(target->indices.end(),
+                           {quad, static_cast<GLushort>(quad + 1), static_cast<GLushort>(quad + 2),
+                            static_cast<GLushort>(quad + 2), static_cast<GLushort>(quad + 3), quad});
+  }
+  m_vertices.insert(m_vertices.end(), vertices.begin(), vertices.end());
+}
+
+void CGUIRenderBatcherGLES::CreateBuffers()
+{
+  if (m_vertexBuffer)
+    return;
+
+  glGenBuffers(1, &m_vertexBuffer);
+  glGenBuffers(1, &m_indexBuffer);
+}
+
+void CGUIRenderBatcherGLES::Flush()
+{
+  if (m_flushing || m_numBatches == 0)
+    return;
+
+  m_flushing = true;
+
+  CreateBuffers();
+
+  // one upload of the vertices, the indices of every batch follow each other
+  size_t indexCount = 0;
+  for (size_t i = 0; i < m_numBatches; i++)
+    indexCount += m_batches[i].indices.size();
+
+  glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+  glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(PackedVertex), m_vertices.data(), GL_STREAM_DRAW);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(GLushort), nullptr, GL_STREAM_DRAW);
+
+  size_t indexOffset = 0;
+  for (size_t i = 0; i < m_numBatches; i++)
+  {
+    const std::vector<GLushort>& indices = m_batches[i].indices;
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, indexOffset * sizeof(GLushort),
+                    indices.size() * sizeof(GLushort), indices.data());
+    indexOffset += indices.size();
+  }
+
+  indexOffset = 0;
+  for (size_t i = 0; i < m_numBatches; i++)
+  {
+    DrawBatch(m_batches[i], indexOffset);
+    indexOffset += m_batches[i].indices.size();
+  }
+  m_numBatches = 0;
+  m_vertices.clear();
+
+  // the rest of the GUI draws from client memory
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+  // the GUI expects blending to be enabled
+  glEnable(GL_BLEND);
+
+  m_flushing = false;
+}
+
+void CGUIRenderBatcherGLES::DrawBatch(const Batch& batch, size_t indexOffset)
+{
+  const GUIBatchState& state = batch.state;
+
+  m_renderSystem.EnableGUIShader(state.method);
+
+  state.texture->BindToUnit(0);
+  if (state.diffuse)
+    state.diffuse->BindToUnit(1);
+
+  if (state.blend)
+  {
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_ALPHA, GL_ONE);
+    glEnable(GL_BLEND);
+  }
+  else
+  {
+    glDisable(GL_BLEND);
+  }
+
+  GLint posLoc = m_renderSystem.GUIShaderGetPos();
+  GLint tex0Loc = m_renderSystem.GUIShaderGetCoord0();
+  GLint tex1Loc = m_renderSystem.GUIShaderGetCoord1();
+  GLint uniColLoc = m_renderSystem.GUIShaderGetUniCol();
+
+  if (uniColLoc >= 0)
+  {
+    glUniform4f(uniColLoc, (state.color[0] / 255.0f), (state.color[1] / 255.0f),
+                (state.color[2] / 255.0f), (state.color[3] / 255.0f));
+  }
+
+  if (state.diffuse)
+  {
+    glVertexAttribPointer(tex1Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex),
+                          reinterpret_cast<const GLvoid*>(offsetof(PackedVertex, u2)));
+    glEnableVertexAttribArray(tex1Loc);
+  }
+  glVertexAttribPointer(posLoc, 3, GL_FLOAT, 0, sizeof(PackedVertex),
+                        reinterpret_cast<const GLvoid*>(offsetof(PackedVertex, x)));
+  glEnableVertexAttribArray(posLoc);
+  glVertexAttribPointer(tex0Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex),
+                        reinterpret_cast<const GLvoid*>(offsetof(PackedVertex, u1)));
+  glEnableVertexAttribArray(tex0Loc);
+
+  glDrawElements(GL_TRIANGLES, batch.indices.size(), GL_UNSIGNED_SHORT,
+                 reinterpret_cast<const GLvoid*>(indexOffset * sizeof(GLushort)));
+  m_drawCalls++;
+  m_quads += batch.indices.size() / 6;
+
+  if (state.diffuse)
+    glDisableVertexAttribArray(tex1Loc);
+  glDisableVertexAttribArray(posLoc);
+  glDisableVertexAttribArray(tex0Loc);
+
+  if (state.diffuse)
+    glActiveTexture(GL_TEXTURE0);
+
+  m_renderSystem.DisableGUIShader();
+}
+
+void CGUIRenderBatcherGLES::FrameDone()
+{
+  Flush();
+  m_lastDrawCalls = m_drawCalls;
+  m_lastQuads = m_quads;
+  m_drawCalls = 0;
+  m_quads = 0;
+}
+
+void CGUIRenderBatcherGLES::Release()
+{
+  m_numBatches = 0;
+  m_batches.clear();
+  m_vertices.clear();
+  if (m_vertexBuffer)
+  {
+    glDeleteBuffers(1, &m_vertexBuffer);
+    glDeleteBuffers(1, &m_indexBuffer);
+    m_vertexBuffer = 0;
+    m_indexBuffer = 0;
+  }
+}
@@ -0,0 +1,116 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "RenderSystemGLES.h"
+#include "utils/Geometry.h"
+
+#include <array>
+#include <vector>
+
+#include "system_gl.h"
+
+class CTexture;
+
+struct PackedVertex
+{
+  float x, y, z;
+  float u1, v1;
+  float u2, v2;
+};
+typedef std::vector<PackedVertex> PackedVertices;
+
+/*!
+ \brief GL state a batch of GUI texture quads is drawn with.
+ Quads can only be merged into one draw call if their state is identical.
+ */
+struct GUIBatchState
+{
+  CTexture* texture = nullptr;
+  CTexture* diffuse = nullptr;
+  ESHADERMETHOD method = SM_TEXTURE;
+  bool blend = true;
+  std::array<GLubyte, 4> color = {{255, 255, 255, 255}};
+
+  bool operator==(const GUIBatchState& rhs) const
+  {
+    return texture == rhs.texture && diffuse == rhs.diffuse && method == rhs.method &&
+           blend == rhs.blend && color == rhs.color;
+  }
+  bool operator!=(const GUIBatchState& rhs) const { return !(*this == rhs); }
+};
+
+/*!
+ \brief Collects the quads of CGUITextureGLES and submits them with as few draw calls as possible.
+
+ Quads are queued until something else needs the GL pipeline (see CRenderSystemGLES), which
+ triggers Flush(). A quad may join an earlier batch with the same state as long as it does not
+ overlap anything queued after that batch, so the result is identical to drawing in order.
+ Vertices go into a single buffer in the order they are added, a batch only keeps the indices
+ of its quads. On flush both are uploaded once and every batch is drawn with one
+ glDrawElements() call.
+
+ Flush() doesn't read back GL state. It leaves texture unit 0 active and no buffers bound, and
+ the textures and blending of the last batch set, like unbatched texture drawing did. Code that
+ sets up its own GL state before asking for the GUI shader has to call
+ CRenderSystemBase::FlushGUIBatches() first.
+ */
+class CGUIRenderBatcherGLES
+{
+public:
+  explicit CGUIRenderBatcherGLES(CRenderSystemGLES& renderSystem);
+  ~CGUIRenderBatcherGLES() = default;
+
+  void Add(const GUIBatchState& state, const PackedVertices& vertices);
+  void Flush();
+
+  /*!
+   \brief Called once per presented frame to make the statistics of the last frame available.
+   */
+  void FrameDone();
+
+  /*!
+   \brief Frees the GL buffers, must be called while the GL context is still current.
+   */
+  void Release();
+
+  unsigned int GetDrawCalls() const { return m_lastDrawCalls; }
+  unsigned int GetQuads() const { return m_lastQuads; }
+
+private:
+  struct Batch
+  {
+    GUIBatchState state;
+    CRect bounds;
+    bool reorderable;
+    std::vector<GLushort> indices;
+  };
+
+  void CreateBuffers();
+  void DrawBatch(const Batch& batch, size_t indexOffset);
+
+  // maximum number of queued batches a quad may be moved past
+  static constexpr size_t MAX_LOOKBACK = 32;
+  // GLushort indices limit a flush to 65536 vertices
+  static constexpr size_t MAX_VERTICES = 65536;
+
+  CRenderSystemGLES& m_renderSystem;
+  std::vector<Batch> m_batches;
+  size_t m_numBatches = 0;
+  PackedVertices m_vertices;
+  bool m_flushing = false;
+
+  GLuint m_vertexBuffer = 0;
+  GLuint m_indexBuffer = 0;
+
+  unsigned int m_drawCalls = 0;
+  unsigned int m_quads = 0;
+  unsigned int m_lastDrawCalls = 0;
+  unsigned int m_lastQuads = 0;
+};
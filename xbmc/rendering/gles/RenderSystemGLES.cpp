@@ -8,6 +8,7 @@
 
 #include "RenderSystemGLES.h"
 
+#include "GUIRenderBatcherGLES.h"
 #include "guilib/DirtyRegion.h"
 #include "rendering/MatrixGL.h"
 #include "settings/AdvancedSettings.h"
@@ -27,8 +28,11 @@
 CRenderSystemGLES::CRenderSystemGLES()
  : CRenderSystemBase()
 {
+  m_guiBatcher.reset(new CGUIRenderBatcherGLES(*this));
 }
 
+CRenderSystemGLES::~CRenderSystemGLES() = default;
+
 bool CRenderSystemGLES::InitRenderSystem()
 {
   GLint maxTextureSize;
@@ -147,6 +151,7 @@ bool CRenderSystemGLES::DestroyRenderSystem()
   glFinish();
   PresentRenderImpl(true);
 
+  m_guiBatcher->Release();
   ReleaseShaders();
   m_bRenderCreated = false;
 
@@ -176,6 +181,8 @@ bool CRenderSystemGLES::EndRender()
   if (!m_bRenderCreated)
     return false;
 
+  m_guiBatcher->Flush();
+
   return true;
 }
 
@@ -184,6 +191,8 @@ bool CRenderSystemGLES::ClearBuffers(UTILS::Color color)
   if (!m_bRenderCreated)
     return false;
 
+  m_guiBatcher->Flush();
+
   float r = GET_R(color) / 255.0f;
   float g = GET_G(color) / 255.0f;
   float b = GET_B(color) / 255.0f;
@@ -222,6 +231,7 @@ void CRenderSystemGLES::PresentRender(bool rendered, bool videoLayer)
   if (!m_bRenderCreated)
     return;
 
+  m_guiBatcher->FrameDone();
   PresentRenderImpl(rendered);
 
   // if video is rendered to a separate layer, we should not block this thread
@@ -252,6 +262,8 @@ void CRenderSystemGLES::CaptureStateBlock()
   if (!m_bRenderCreated)
     return;
 
+  m_guiBatcher->Flush();
+
   glMatrixProject.Push();
   glMatrixModview.Push();
   glMatrixTexture.Push();
@@ -281,6 +293,8 @@ void CRenderSystemGLES::SetCameraPosition(const CPoint &camera, int screenWidth,
   if (!m_bRenderCreated)
     return;
 
+  m_guiBatcher->Flush();
+
   CPoint offset = camera - CPoint(screenWidth*0.5f, screenHeight*0.5f);
 
   float w = (float)m_viewPort[2]*0.5f;
@@ -329,6 +343,8 @@ void CRenderSystemGLES::SetViewPort(const CRect& viewPort)
   if (!m_bRenderCreated)
     return;
 
+  m_guiBatcher->Flush();
+
   glScissor((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
   glViewport((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
   m_viewPort[0] = viewPort.x1;
@@ -363,6 +379,8 @@ void CRenderSystemGLES::SetScissors(const CRect &rect)
 {
   if (!m_bRenderCreated)
     return;
+
+  m_guiBatcher->Flush();
   GLint x1 = MathUtils::round_int(rect.x1);
   GLint y1 = MathUtils::round_int(rect.y1);
   GLint x2 = MathUtils::round_int(rect.x2);
@@ -538,6 +556,9 @@ void CRenderSystemGLES::ReleaseShaders()
 
 void CRenderSystemGLES::EnableGUIShader(ESHADERMETHOD method)
 {
+  // anything that wants the GUI shader draws on top of the queued GUI textures
+  m_guiBatcher->Flush();
+
   m_method = method;
   if (m_pShader[m_method])
   {
@@ -549,6 +570,18 @@ void CRenderSystemGLES::EnableGUIShader(ESHADERMETHOD method)
   }
 }
 
+void CRenderSystemGLES::FlushGUIBatches()
+{
+  m_guiBatcher->Flush();
+}
+
+bool CRenderSystemGLES::GetGUIBatchStats(unsigned int& drawCalls, unsigned int& quads) const
+{
+  drawCalls = m_guiBatcher->GetDrawCalls();
+  quads = m_guiBatcher->GetQuads();
+  return true;
+}
+
 void CRenderSystemGLES::DisableGUIShader()
 {
   if (m_pShader[m_method])
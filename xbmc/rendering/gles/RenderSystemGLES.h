@@ -13,6 +13,7 @@
 #include "utils/Color.h"
 
 #include <array>
+#include <memory>
 
 #include "system_gl.h"
 
@@ -33,11 +34,13 @@ enum ESHADERMETHOD
   SM_MAX
 };
 
+class CGUIRenderBatcherGLES;
+
 class CRenderSystemGLES : public CRenderSystemBase
 {
 public:
   CRenderSystemGLES();
-  ~CRenderSystemGLES() override = default;
+  ~CRenderSystemGLES() override;
 
   bool InitRenderSystem() override;
   bool DestroyRenderSystem() override;
@@ -71,6 +74,10 @@ public:
 
   std::string GetShaderPath(const std::string &filename) override { return "GLES/2.0/"; }
 
+  void FlushGUIBatches() override;
+  bool GetGUIBatchStats(unsigned int& drawCalls, unsigned int& quads) const override;
+  CGUIRenderBatcherGLES& GetGUIBatcher() { return *m_guiBatcher; }
+
   void InitialiseShaders();
   void ReleaseShaders();
   void EnableGUIShader(ESHADERMETHOD method);
@@ -102,6 +109,8 @@ protected:
   std::array<std::unique_ptr<CGLESShader>, SM_MAX> m_pShader;
   ESHADERMETHOD m_method = SM_DEFAULT;
 
+  std::unique_ptr<CGUIRenderBatcherGLES> m_guiBatcher;
+
   GLint      m_viewPort[4];
 };
 
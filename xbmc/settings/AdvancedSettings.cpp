@@ -375,6 +375,8 @@ void CAdvancedSettings::Initialize()
   m_iPVRNumericChannelSwitchTimeout = 2000;
   m_iPVRTimeshiftThreshold = 10;
   m_bPVRTimeshiftSimpleOSD = true;
+  m_iPVRLocalTimeshiftBufferSize = 0;
+  m_bPVRLocalTimeshiftOnDisk = false;
   m_PVRDefaultSortOrder.sortBy = SortByDate;
   m_PVRDefaultSortOrder.sortOrder = SortOrderDescending;
 
@@ -1104,6 +1106,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pPVR, "numericchannelswitchtimeout", m_iPVRNumericChannelSwitchTimeout, 50, 60000);
     XMLUtils::GetInt(pPVR, "timeshiftthreshold", m_iPVRTimeshiftThreshold, 0, 60);
     XMLUtils::GetBoolean(pPVR, "timeshiftsimpleosd", m_bPVRTimeshiftSimpleOSD);
+    XMLUtils::GetInt(pPVR, "localtimeshiftbuffersize", m_iPVRLocalTimeshiftBufferSize, 0, 8192);
+    XMLUtils::GetBoolean(pPVR, "localtimeshiftondisk", m_bPVRLocalTimeshiftOnDisk);
     TiXmlElement* pSortDecription = pPVR->FirstChildElement("pvrrecordings");
     if (pSortDecription)
     {
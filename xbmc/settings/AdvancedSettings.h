@@ -322,6 +322,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_iPVRNumericChannelSwitchTimeout; /*!< @brief time in msecs after that a channel switch occurs after entering a channel number, if confirmchannelswitch is disabled */
     int m_iPVRTimeshiftThreshold; /*!< @brief time diff between current playing time and timeshift buffer end, in seconds, before a playing stream is displayed as timeshifting. */
     bool m_bPVRTimeshiftSimpleOSD; /*!< @brief use simple timeshift OSD (with progress only for the playing event instead of progress for the whole ts buffer). */
+    int m_iPVRLocalTimeshiftBufferSize; /*!< @brief size in MB of the local timeshift buffer used for live streams if the backend does not support timeshift. 0 disables it. defaults to 0. */
+    bool m_bPVRLocalTimeshiftOnDisk; /*!< @brief keep the local timeshift buffer in a file in the temp folder instead of memory. */
     SortDescription m_PVRDefaultSortOrder; /*!< @brief SortDecription used to store default recording sort type and sort order */
 
     DatabaseSettings m_databaseMusic; // advanced music database setup
@@ -11,6 +11,7 @@
 #include "ServiceBroker.h"
 #include "URL.h"
 #include "Util.h"
+#include "filesystem/DirectoryChangeJournal.h"
 #include "filesystem/File.h"
 #include "media/MediaLockState.h"
 #include "network/WakeOnAccess.h"
@@ -236,6 +237,8 @@ bool CMediaSourceSettings::DeleteSource(const std::string &strType, const std::s
     if (it->strName == strName && it->strPath == strPath)
     {
       CLog::Log(LOGDEBUG, "CMediaSourceSettings: found share, removing!");
+      for (const std::string& path : it->vecPaths)
+        XFILE::CDirectoryChangeJournal::GetInstance().Remove(path);
       pShares->erase(it);
       found = true;
       break;
@@ -20,6 +20,10 @@
 
 #include <algorithm>
 
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 enum {
   AVC_NAL_SLICE=1,
   AVC_NAL_DPA,
@@ -179,15 +183,41 @@ static int nal_bs_read_ue(nal_bitstream *bs)
 
 static const uint8_t* avc_find_startcode_internal(const uint8_t *p, const uint8_t *end)
 {
+  // the last position a start code is looked for
+  const uint8_t *last = end - 3;
+
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i one = _mm_set1_epi8(1);
+
+  // test 16 positions at once, the loads reach 2 bytes past them
+  for (; last - p >= 16; p += 16)
+  {
+    const __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 1));
+    const __m128i b2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 2));
+    int mask = _mm_movemask_epi8(_mm_and_si128(
+        _mm_and_si128(_mm_cmpeq_epi8(b0, zero), _mm_cmpeq_epi8(b1, zero)), _mm_cmpeq_epi8(b2, one)));
+    if (mask)
+    {
+      while (!(mask & 1))
+      {
+        mask >>= 1;
+        p++;
+      }
+      return p;
+    }
+  }
+#else
   const uint8_t *a = p + 4 - ((intptr_t)p & 3);
 
-  for (end -= 3; p < a && p < end; p++)
+  for (; p < a && p < last; p++)
   {
     if (p[0] == 0 && p[1] == 0 && p[2] == 1)
       return p;
   }
 
-  for (end -= 3; p < end; p += 4)
+  for (; last - p > 3; p += 4)
   {
     uint32_t x = *(const uint32_t*)p;
     if ((x - 0x01010101) & (~x) & 0x80808080) // generic
@@ -208,14 +238,15 @@ static const uint8_t* avc_find_startcode_internal(const uint8_t *p, const uint8_
       }
     }
   }
+#endif
 
-  for (end += 3; p < end; p++)
+  for (; p < last; p++)
   {
     if (p[0] == 0 && p[1] == 0 && p[2] == 1)
       return p;
   }
 
-  return end + 3;
+  return end;
 }
 
 static const uint8_t* avc_find_startcode(const uint8_t *p, const uint8_t *end)
@@ -312,6 +343,8 @@ CBitstreamConverter::CBitstreamConverter()
   m_convert_bitstream = false;
   m_convertBuffer     = NULL;
   m_convertSize       = 0;
+  m_convertAlloc      = NULL;
+  m_convertAllocSize  = 0;
   m_inputBuffer       = NULL;
   m_inputSize         = 0;
   m_to_annexb         = false;
@@ -492,9 +525,12 @@ void CBitstreamConverter::Close(void)
   if (m_sps_pps_context.sps_pps_data)
     av_free(m_sps_pps_context.sps_pps_data), m_sps_pps_context.sps_pps_data = NULL;
 
-  if (m_convertBuffer)
-    av_free(m_convertBuffer), m_convertBuffer = NULL;
+  if (m_convertAlloc)
+    av_free(m_convertAlloc), m_convertAlloc = NULL;
+  m_convertAllocSize = 0;
+  m_convertBuffer = NULL;
   m_convertSize = 0;
+  m_nalUnits.clear();
 
   if (m_extradata)
     av_free(m_extradata), m_extradata = NULL;
@@ -510,11 +546,7 @@ void CBitstreamConverter::Close(void)
 
 bool CBitstreamConverter::Convert(uint8_t *pData, int iSize)
 {
-  if (m_convertBuffer)
-  {
-    av_free(m_convertBuffer);
-    m_convertBuffer = NULL;
-  }
+  m_convertBuffer = NULL;
   m_inputSize = 0;
   m_convertSize = 0;
   m_inputBuffer = NULL;
@@ -526,29 +558,14 @@ bool CBitstreamConverter::Convert(uint8_t *pData, int iSize)
     {
       if (m_to_annexb)
       {
-        int demuxer_bytes = iSize;
-        uint8_t *demuxer_content = pData;
-
         if (m_convert_bitstream)
         {
           // convert demuxer packet from bitstream to bytestream (AnnexB)
-          int bytestream_size = 0;
-          uint8_t *bytestream_buff = NULL;
-
-          BitstreamConvert(demuxer_content, demuxer_bytes, &bytestream_buff, &bytestream_size);
-          if (bytestream_buff && (bytestream_size > 0))
-          {
-            m_convertSize   = bytestream_size;
-            m_convertBuffer = bytestream_buff;
+          if (BitstreamConvert(pData, iSize))
             return true;
-          }
-          else
-          {
-            m_convertSize = 0;
-            m_convertBuffer = NULL;
-            CLog::Log(LOGERROR, "CBitstreamConverter::Convert: error converting.");
-            return false;
-          }
+
+          CLog::Log(LOGERROR, "CBitstreamConverter::Convert: error converting.");
+          return false;
         }
         else
         {
@@ -564,50 +581,17 @@ bool CBitstreamConverter::Convert(uint8_t *pData, int iSize)
 
         if (m_convert_bytestream)
         {
-          if(m_convertBuffer)
-          {
-            av_free(m_convertBuffer);
-            m_convertBuffer = NULL;
-          }
-          m_convertSize = 0;
-
           // convert demuxer packet from bytestream (AnnexB) to bitstream
-          AVIOContext *pb;
-
-          if(avio_open_dyn_buf(&pb) < 0)
-          {
-            return false;
-          }
-          m_convertSize = avc_parse_nal_units(pb, pData, iSize);
-          m_convertSize = avio_close_dyn_buf(pb, &m_convertBuffer);
+          return BytestreamConvert(pData, iSize);
         }
         else if (m_convert_3byteTo4byteNALSize)
         {
-          if(m_convertBuffer)
-          {
-            av_free(m_convertBuffer);
-            m_convertBuffer = NULL;
-          }
-          m_convertSize = 0;
-
           // convert demuxer packet from 3 byte NAL sizes to 4 byte
-          AVIOContext *pb;
-          if (avio_open_dyn_buf(&pb) < 0)
-            return false;
-
-          uint32_t nal_size;
-          uint8_t *end = pData + iSize;
-          uint8_t *nal_start = pData;
-          while (nal_start < end)
-          {
-            nal_size = BS_RB24(nal_start);
-            avio_wb32(pb, nal_size);
-            nal_start += 3;
-            avio_write(pb, nal_start, nal_size);
-            nal_start += nal_size;
-          }
+          if (NALSizeConvert(pData, iSize))
+            return true;
 
-          m_convertSize = avio_close_dyn_buf(pb, &m_convertBuffer);
+          CLog::Log(LOGERROR, "CBitstreamConverter::Convert: error converting NAL sizes.");
+          return false;
         }
         return true;
       }
@@ -617,7 +601,6 @@ bool CBitstreamConverter::Convert(uint8_t *pData, int iSize)
   return false;
 }
 
-
 uint8_t *CBitstreamConverter::GetConvertBuffer() const
 {
   if((m_convert_bitstream || m_convert_bytestream || m_convert_3byteTo4byteNALSize) && m_convertBuffer != NULL)
@@ -865,19 +848,19 @@ bool CBitstreamConverter::IsSlice(uint8_t unit_type)
   }
 }
 
-bool CBitstreamConverter::BitstreamConvert(uint8_t* pData, int iSize, uint8_t **poutbuf, int *poutbuf_size)
+bool CBitstreamConverter::BitstreamConvert(const uint8_t* pData, int iSize)
 {
   // based on h264_mp4toannexb_bsf.c (ffmpeg)
   // which is Copyright (c) 2007 Benoit Fouet <benoit.fouet@free.fr>
   // and Licensed GPL 2.1 or greater
 
   int i;
-  uint8_t *buf = pData;
-  uint32_t buf_size = iSize;
   uint8_t  unit_type, nal_sps, nal_pps, nal_sei;
+  uint8_t  first_idr = 0, idr_sps_pps_seen = 0;
   int32_t  nal_size;
-  uint32_t cumul_size = 0;
-  const uint8_t *buf_end = buf + buf_size;
+  uint32_t out_size = 0;
+  uint8_t *out = NULL;
+  const uint8_t *buf_end = pData + iSize;
 
   switch (m_codec)
   {
@@ -895,93 +878,188 @@ bool CBitstreamConverter::BitstreamConvert(uint8_t* pData, int iSize, uint8_t **
       return false;
   }
 
-  do
+  // the first pass validates the packet and sizes the output, the second one writes it
+  for (int pass = 0; pass < 2; pass++)
   {
-    if (buf + m_sps_pps_context.length_size > buf_end)
-      goto fail;
+    const uint8_t *buf = pData;
+    uint32_t cumul_size = 0;
+    uint32_t offset = 0;
 
-    for (nal_size = 0, i = 0; i < m_sps_pps_context.length_size; i++)
-      nal_size = (nal_size << 8) | buf[i];
+    first_idr = m_sps_pps_context.first_idr;
+    idr_sps_pps_seen = m_sps_pps_context.idr_sps_pps_seen;
 
-    buf += m_sps_pps_context.length_size;
-    if (m_codec == AV_CODEC_ID_H264)
+    if (pass == 1)
     {
-        unit_type = *buf & 0x1f;
+      out = AllocConvertBuffer(out_size);
+      if (!out)
+        return false;
     }
-    else
+
+    do
     {
-        unit_type = (*buf >> 1) & 0x3f;
-    }
+      if (buf + m_sps_pps_context.length_size > buf_end)
+        return false;
 
-    if (buf + nal_size > buf_end || nal_size <= 0)
-      goto fail;
+      for (nal_size = 0, i = 0; i < m_sps_pps_context.length_size; i++)
+        nal_size = (nal_size << 8) | buf[i];
 
-    // Don't add sps/pps if the unit already contain them
-    if (m_sps_pps_context.first_idr && (unit_type == nal_sps || unit_type == nal_pps))
-      m_sps_pps_context.idr_sps_pps_seen = 1;
+      buf += m_sps_pps_context.length_size;
+      if (m_codec == AV_CODEC_ID_H264)
+      {
+          unit_type = *buf & 0x1f;
+      }
+      else
+      {
+          unit_type = (*buf >> 1) & 0x3f;
+      }
 
-    if (!m_start_decode && (unit_type == nal_sps || IsIDR(unit_type) || (unit_type == nal_sei && has_sei_recovery_point(buf, buf + nal_size))))
-      m_start_decode = true;
+      if (nal_size > buf_end - buf || nal_size <= 0)
+        return false;
 
-    // prepend only to the first access unit of an IDR picture, if no sps/pps already present
-    if (m_sps_pps_context.first_idr && IsIDR(unit_type) && !m_sps_pps_context.idr_sps_pps_seen)
-    {
-      BitstreamAllocAndCopy(poutbuf, poutbuf_size,
-        m_sps_pps_context.sps_pps_data, m_sps_pps_context.size, buf, nal_size);
-      m_sps_pps_context.first_idr = 0;
-    }
-    else
-    {
-      BitstreamAllocAndCopy(poutbuf, poutbuf_size, NULL, 0, buf, nal_size);
-      if (!m_sps_pps_context.first_idr && IsSlice(unit_type))
+      // Don't add sps/pps if the unit already contain them
+      if (first_idr && (unit_type == nal_sps || unit_type == nal_pps))
+        idr_sps_pps_seen = 1;
+
+      if (pass == 0 && !m_start_decode && (unit_type == nal_sps || IsIDR(unit_type) || (unit_type == nal_sei && has_sei_recovery_point(buf, buf + nal_size))))
+        m_start_decode = true;
+
+      // prepend only to the first access unit of an IDR picture, if no sps/pps already present
+      uint32_t sps_pps_size = 0;
+      if (first_idr && IsIDR(unit_type) && !idr_sps_pps_seen)
       {
-          m_sps_pps_context.first_idr = 1;
-          m_sps_pps_context.idr_sps_pps_seen = 0;
+        sps_pps_size = m_sps_pps_context.size;
+        first_idr = 0;
       }
-    }
+      else if (!first_idr && IsSlice(unit_type))
+      {
+        first_idr = 1;
+        idr_sps_pps_seen = 0;
+      }
+
+      // the first unit gets a 4 byte start code, the following ones 3 bytes
+      const uint32_t nal_header_size = offset ? 3 : 4;
+      if (out)
+      {
+        uint8_t *nal_header = out + offset + sps_pps_size;
+        if (sps_pps_size)
+          memcpy(out + offset, m_sps_pps_context.sps_pps_data, sps_pps_size);
+        if (nal_header_size == 4)
+        {
+          BS_WB32(nal_header, 1);
+        }
+        else
+        {
+          nal_header[0] = 0;
+          nal_header[1] = 0;
+          nal_header[2] = 1;
+        }
+        memcpy(nal_header + nal_header_size, buf, nal_size);
+      }
+      offset += sps_pps_size + nal_header_size + nal_size;
 
-    buf += nal_size;
-    cumul_size += nal_size + m_sps_pps_context.length_size;
-  } while (cumul_size < buf_size);
+      buf += nal_size;
+      cumul_size += nal_size + m_sps_pps_context.length_size;
+    } while (cumul_size < static_cast<uint32_t>(iSize));
 
+    out_size = offset;
+  }
+
+  m_sps_pps_context.first_idr = first_idr;
+  m_sps_pps_context.idr_sps_pps_seen = idr_sps_pps_seen;
+  m_convertBuffer = out;
+  m_convertSize = out_size;
   return true;
+}
 
-fail:
-  av_free(*poutbuf), *poutbuf = NULL;
-  *poutbuf_size = 0;
-  return false;
+bool CBitstreamConverter::BytestreamConvert(const uint8_t* pData, int iSize)
+{
+  const uint8_t *end = pData + iSize;
+  const uint8_t *nal_start, *nal_end;
+  int out_size = 0;
+
+  // find the units first, they get a 4 byte size instead of their start code
+  m_nalUnits.clear();
+  nal_start = avc_find_startcode(pData, end);
+  for (;;)
+  {
+    while (nal_start < end && !*(nal_start++));
+    if (nal_start == end)
+      break;
+
+    nal_end = avc_find_startcode(nal_start, end);
+    m_nalUnits.emplace_back(nal_start, static_cast<int>(nal_end - nal_start));
+    out_size += 4 + static_cast<int>(nal_end - nal_start);
+    nal_start = nal_end;
+  }
+
+  uint8_t *out = AllocConvertBuffer(out_size);
+  if (!out)
+    return false;
+
+  m_convertBuffer = out;
+  m_convertSize = out_size;
+  for (const auto& unit : m_nalUnits)
+  {
+    BS_WB32(out, unit.second);
+    memcpy(out + 4, unit.first, unit.second);
+    out += 4 + unit.second;
+  }
+  return true;
 }
 
-void CBitstreamConverter::BitstreamAllocAndCopy( uint8_t **poutbuf, int *poutbuf_size,
-    const uint8_t *sps_pps, uint32_t sps_pps_size, const uint8_t *in, uint32_t in_size)
+bool CBitstreamConverter::NALSizeConvert(const uint8_t* pData, int iSize)
 {
-  // based on h264_mp4toannexb_bsf.c (ffmpeg)
-  // which is Copyright (c) 2007 Benoit Fouet <benoit.fouet@free.fr>
-  // and Licensed GPL 2.1 or greater
+  const uint8_t *end = pData + iSize;
+  const uint8_t *nal_start;
+  uint32_t nal_size;
+  int out_size = 0;
 
-  uint32_t offset = *poutbuf_size;
-  uint8_t nal_header_size = offset ? 3 : 4;
-  void *tmp;
+  // every unit grows by a byte
+  for (nal_start = pData; nal_start < end; nal_start += nal_size)
+  {
+    if (end - nal_start < 3)
+      return false;
+    nal_size = BS_RB24(nal_start);
+    nal_start += 3;
+    if (nal_size > static_cast<uint32_t>(end - nal_start))
+      return false;
+    out_size += 4 + nal_size;
+  }
 
-  *poutbuf_size += sps_pps_size + in_size + nal_header_size;
-  tmp = av_realloc(*poutbuf, *poutbuf_size);
-  if (!tmp)
-    return;
-  *poutbuf = (uint8_t*)tmp;
-  if (sps_pps)
-    memcpy(*poutbuf + offset, sps_pps, sps_pps_size);
+  uint8_t *out = AllocConvertBuffer(out_size);
+  if (!out)
+    return false;
 
-  memcpy(*poutbuf + sps_pps_size + nal_header_size + offset, in, in_size);
-  if (!offset)
+  m_convertBuffer = out;
+  m_convertSize = out_size;
+  for (nal_start = pData; nal_start < end; nal_start += nal_size)
   {
-    BS_WB32(*poutbuf + sps_pps_size, 1);
+    nal_size = BS_RB24(nal_start);
+    nal_start += 3;
+    BS_WB32(out, nal_size);
+    memcpy(out + 4, nal_start, nal_size);
+    out += 4 + nal_size;
   }
-  else
+  return true;
+}
+
+uint8_t* CBitstreamConverter::AllocConvertBuffer(int size)
+{
+  // the packets of a stream are about the same size, so one buffer serves all of them and is
+  // only replaced when a packet outgrows it
+  if (size + AV_INPUT_BUFFER_PADDING_SIZE > m_convertAllocSize)
   {
-    (*poutbuf + offset + sps_pps_size)[0] = 0;
-    (*poutbuf + offset + sps_pps_size)[1] = 0;
-    (*poutbuf + offset + sps_pps_size)[2] = 1;
+    av_free(m_convertAlloc);
+    m_convertAllocSize = size + size / 8 + AV_INPUT_BUFFER_PADDING_SIZE;
+    m_convertAlloc = static_cast<uint8_t*>(av_malloc(m_convertAllocSize));
+    if (!m_convertAlloc)
+    {
+      m_convertAllocSize = 0;
+      return NULL;
+    }
   }
+  memset(m_convertAlloc + size, 0, AV_INPUT_BUFFER_PADDING_SIZE);
+  return m_convertAlloc;
 }
 
 int CBitstreamConverter::avc_parse_nal_units(AVIOContext *pb, const uint8_t *buf_in, int size)
@@ -9,6 +9,8 @@
 #pragma once
 
 #include <stdint.h>
+#include <utility>
+#include <vector>
 
 extern "C" {
 #include <libavutil/avutil.h>
@@ -108,9 +110,11 @@ protected:
   bool              IsSlice(uint8_t unit_type);
   bool              BitstreamConvertInitAVC(void *in_extradata, int in_extrasize);
   bool              BitstreamConvertInitHEVC(void *in_extradata, int in_extrasize);
-  bool              BitstreamConvert(uint8_t* pData, int iSize, uint8_t **poutbuf, int *poutbuf_size);
-  static void       BitstreamAllocAndCopy(uint8_t **poutbuf, int *poutbuf_size,
-                      const uint8_t *sps_pps, uint32_t sps_pps_size, const uint8_t *in, uint32_t in_size);
+  bool              BitstreamConvert(const uint8_t* pData, int iSize);
+  // bytestream (Annex B) to bitstream conversion support.
+  bool              BytestreamConvert(const uint8_t* pData, int iSize);
+  bool              NALSizeConvert(const uint8_t* pData, int iSize);
+  uint8_t*          AllocConvertBuffer(int size);
 
   typedef struct omx_bitstream_ctx {
       uint8_t  length_size;
@@ -122,6 +126,9 @@ protected:
 
   uint8_t          *m_convertBuffer;
   int               m_convertSize;
+  uint8_t          *m_convertAlloc; // reused for the packets, m_convertBuffer points into it
+  int               m_convertAllocSize;
+  std::vector<std::pair<const uint8_t*, int>> m_nalUnits;
   uint8_t          *m_inputBuffer;
   int               m_inputSize;
 
@@ -150,6 +150,11 @@ void CSaveFileState::DoWork(CFileItem& item,
           }
         }
 
+        // key frame positions the player recorded, see CKeyframeIndex
+        if (item.HasProperty("keyframeindex"))
+          videodatabase.SetKeyframeIndex(progressTrackingFile,
+                                         item.GetProperty("keyframeindex").asString());
+
         // Could be part of an ISO stack. In this case the bookmark is saved onto the part.
         // In order to properly update the list, we need to refresh the stack's resume point
         CApplicationStackHelper& stackHelper = g_application.GetAppStackHelper();
@@ -0,0 +1,311 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "utils/BitstreamConverter.h"
+
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+typedef std::vector<uint8_t> Buffer;
+
+const Buffer SPS = {0x67, 0x42, 0xc0, 0x1e, 0xd9, 0x00, 0xa0, 0x47, 0xfe, 0xc8};
+const Buffer PPS = {0x68, 0xce, 0x3c, 0x80};
+
+/*!
+ * \brief A h264 unit of the given type with an escaped random payload, the way an encoder writes
+ * it: no start code emulation but plenty of zeros and 00 00 03 sequences.
+ */
+Buffer CreateUnit(uint8_t header, size_t size, std::mt19937& random)
+{
+  Buffer unit = {header};
+  std::uniform_int_distribution<int> byte(0, 255);
+  while (unit.size() < size - 1)
+  {
+    // every fourth byte is zero
+    uint8_t value = random() % 4 ? byte(random) : 0;
+    size_t count = unit.size();
+    if (count >= 2 && unit[count - 2] == 0 && unit[count - 1] == 0 && value <= 3)
+      unit.push_back(0x03);
+    unit.push_back(value);
+  }
+  // rbsp trailing bits
+  unit.push_back(0x80);
+  return unit;
+}
+
+/*!
+ * \brief Stream of slices sized like a high bitrate stream, many units per packet
+ */
+std::vector<Buffer> CreateStream(size_t count, size_t maxSize, unsigned int seed)
+{
+  std::mt19937 random(seed);
+  std::vector<Buffer> units;
+  for (size_t i = 0; i < count; i++)
+    units.push_back(CreateUnit(0x41, 2 + random() % maxSize, random));
+  return units;
+}
+
+Buffer ToAnnexB(const std::vector<Buffer>& units)
+{
+  Buffer packet;
+  for (const Buffer& unit : units)
+  {
+    // the first unit gets a 4 byte start code, the converter writes it that way
+    if (packet.empty())
+      packet.push_back(0);
+    packet.insert(packet.end(), {0, 0, 1});
+    packet.insert(packet.end(), unit.begin(), unit.end());
+  }
+  return packet;
+}
+
+Buffer ToBitstream(const std::vector<Buffer>& units, int lengthSize)
+{
+  Buffer packet;
+  for (const Buffer& unit : units)
+  {
+    for (int i = lengthSize - 1; i >= 0; i--)
+      packet.push_back(static_cast<uint8_t>(unit.size() >> (8 * i)));
+    packet.insert(packet.end(), unit.begin(), unit.end());
+  }
+  return packet;
+}
+
+Buffer CreateAvcC(uint8_t lengthSizeMinusOne)
+{
+  Buffer avcC = {1, SPS[1], SPS[2], SPS[3], static_cast<uint8_t>(0xFC | lengthSizeMinusOne), 0xE1};
+  avcC.push_back(0);
+  avcC.push_back(static_cast<uint8_t>(SPS.size()));
+  avcC.insert(avcC.end(), SPS.begin(), SPS.end());
+  avcC.push_back(1);
+  avcC.push_back(0);
+  avcC.push_back(static_cast<uint8_t>(PPS.size()));
+  avcC.insert(avcC.end(), PPS.begin(), PPS.end());
+  return avcC;
+}
+
+Buffer Convert(CBitstreamConverter& converter, Buffer packet)
+{
+  if (!converter.Convert(packet.data(), static_cast<int>(packet.size())))
+    return Buffer();
+  const uint8_t* data = converter.GetConvertBuffer();
+  return Buffer(data, data + converter.GetConvertSize());
+}
+
+/*!
+ * \brief The start code scan the converter used before, testing a word for zero bytes at a time
+ */
+const uint8_t* FindStartCodeWordwise(const uint8_t* p, const uint8_t* end)
+{
+  const uint8_t* last = end - 3;
+  const uint8_t* a = p + 4 - (reinterpret_cast<intptr_t>(p) & 3);
+
+  for (; p < a && p < last; p++)
+  {
+    if (p[0] == 0 && p[1] == 0 && p[2] == 1)
+      return p;
+  }
+
+  for (; last - p > 3; p += 4)
+  {
+    uint32_t x;
+    memcpy(&x, p, sizeof(x));
+    if ((x - 0x01010101) & (~x) & 0x80808080)
+    {
+      if (p[1] == 0)
+      {
+        if (p[0] == 0 && p[2] == 1)
+          return p;
+        if (p[2] == 0 && p[3] == 1)
+          return p + 1;
+      }
+      if (p[3] == 0)
+      {
+        if (p[2] == 0 && p[4] == 1)
+          return p + 2;
+        if (p[4] == 0 && p[5] == 1)
+          return p + 3;
+      }
+    }
+  }
+
+  for (; p < last; p++)
+  {
+    if (p[0] == 0 && p[1] == 0 && p[2] == 1)
+      return p;
+  }
+
+  return end;
+}
+
+size_t CountStartCodes(const Buffer& packet)
+{
+  size_t count = 0;
+  const uint8_t* end = packet.data() + packet.size();
+  for (const uint8_t* p = FindStartCodeWordwise(packet.data(), end); p < end;
+       p = FindStartCodeWordwise(p + 3, end))
+    count++;
+  return count;
+}
+
+} // namespace
+
+TEST(TestBitstreamConverter, BitstreamToAnnexB)
+{
+  Buffer avcC = CreateAvcC(3);
+  CBitstreamConverter converter;
+  ASSERT_TRUE(converter.Open(AV_CODEC_ID_H264, avcC.data(), static_cast<int>(avcC.size()), true));
+  ASSERT_TRUE(converter.NeedConvert());
+
+  std::mt19937 random(1);
+  const Buffer idr = CreateUnit(0x65, 300, random);
+  const Buffer slice = CreateUnit(0x41, 200, random);
+
+  // sps and pps go in front of the first idr
+  Buffer expected = {0, 0, 0, 1};
+  expected.insert(expected.end(), SPS.begin(), SPS.end());
+  expected.insert(expected.end(), {0, 0, 0, 1});
+  expected.insert(expected.end(), PPS.begin(), PPS.end());
+  Buffer annexB = ToAnnexB({idr});
+  expected.insert(expected.end(), annexB.begin(), annexB.end());
+  converter.ResetStartDecode();
+  EXPECT_EQ(expected, Convert(converter, ToBitstream({idr}, 4)));
+  EXPECT_TRUE(converter.CanStartDecode());
+
+  EXPECT_EQ(ToAnnexB({slice, slice}), Convert(converter, ToBitstream({slice, slice}, 4)));
+
+  // and in front of the next one, unless the packet has its own
+  EXPECT_EQ(expected, Convert(converter, ToBitstream({idr}, 4)));
+  EXPECT_EQ(ToAnnexB({slice}), Convert(converter, ToBitstream({slice}, 4)));
+  EXPECT_EQ(ToAnnexB({SPS, PPS, idr}), Convert(converter, ToBitstream({SPS, PPS, idr}, 4)));
+
+  // broken units
+  Buffer truncated = ToBitstream({slice}, 4);
+  truncated.pop_back();
+  EXPECT_TRUE(Convert(converter, truncated).empty());
+  EXPECT_EQ(ToAnnexB({slice}), Convert(converter, ToBitstream({slice}, 4)));
+}
+
+TEST(TestBitstreamConverter, AnnexBToBitstream)
+{
+  Buffer extraData = ToAnnexB({SPS, PPS});
+  CBitstreamConverter converter;
+  ASSERT_TRUE(
+      converter.Open(AV_CODEC_ID_H264, extraData.data(), static_cast<int>(extraData.size()), false));
+  EXPECT_EQ(1, converter.GetExtraData()[0]);
+
+  // units of every size up to a few vector widths put start codes at every offset
+  std::mt19937 random(2);
+  std::vector<Buffer> units;
+  for (size_t size = 2; size < 100; size++)
+    units.push_back(CreateUnit(0x41, size, random));
+
+  EXPECT_EQ(ToBitstream(units, 4), Convert(converter, ToAnnexB(units)));
+
+  // 4 byte start codes and zeros in front of the first one
+  Buffer packet = {0, 0, 0, 0, 0, 1};
+  packet.insert(packet.end(), SPS.begin(), SPS.end());
+  packet.insert(packet.end(), {0, 0, 0, 1});
+  packet.insert(packet.end(), PPS.begin(), PPS.end());
+  EXPECT_EQ(ToBitstream({SPS, PPS}, 4), Convert(converter, packet));
+}
+
+TEST(TestBitstreamConverter, NALSizeTo4Bytes)
+{
+  Buffer avcC = CreateAvcC(2);
+  CBitstreamConverter converter;
+  ASSERT_TRUE(converter.Open(AV_CODEC_ID_H264, avcC.data(), static_cast<int>(avcC.size()), false));
+
+  const std::vector<Buffer> units = CreateStream(20, 500, 3);
+  EXPECT_EQ(ToBitstream(units, 4), Convert(converter, ToBitstream(units, 3)));
+
+  Buffer truncated = ToBitstream(units, 3);
+  truncated.pop_back();
+  EXPECT_TRUE(Convert(converter, truncated).empty());
+}
+
+TEST(TestBitstreamConverter, Benchmark)
+{
+  // about a second of a 40 MBit/s stream, 16 packets of many slices. There are no h264 samples
+  // in the tree, the slices are escaped like encoder output instead
+  constexpr int PACKETS = 16;
+  constexpr int ROUNDS = 8;
+  std::vector<std::vector<Buffer>> packets;
+  std::vector<Buffer> annexB;
+  size_t bytes = 0;
+  for (int i = 0; i < PACKETS; i++)
+  {
+    packets.push_back(CreateStream(32, 16384, i));
+    annexB.push_back(ToAnnexB(packets.back()));
+    bytes += annexB.back().size();
+  }
+
+  Buffer extraData = ToAnnexB({SPS, PPS});
+  CBitstreamConverter toBitstream;
+  ASSERT_TRUE(toBitstream.Open(AV_CODEC_ID_H264, extraData.data(),
+                               static_cast<int>(extraData.size()), false));
+  CBitstreamConverter toAnnexB;
+  ASSERT_TRUE(toAnnexB.Open(AV_CODEC_ID_H264, toBitstream.GetExtraData(),
+                            toBitstream.GetExtraSize(), true));
+
+  typedef std::chrono::steady_clock Clock;
+  auto mbPerSecond = [bytes](Clock::duration duration) {
+    return bytes * ROUNDS / std::chrono::duration<double>(duration).count() / (1024 * 1024);
+  };
+
+  size_t startCodes = 0;
+  Clock::time_point start = Clock::now();
+  for (int round = 0; round < ROUNDS; round++)
+  {
+    for (const Buffer& packet : annexB)
+      startCodes += CountStartCodes(packet);
+  }
+  const Clock::duration scan = Clock::now() - start;
+  EXPECT_EQ(static_cast<size_t>(PACKETS * 32 * ROUNDS), startCodes);
+
+  Clock::duration toBitstreamTime(0);
+  Clock::duration toAnnexBTime(0);
+  for (int round = 0; round < ROUNDS; round++)
+  {
+    for (int i = 0; i < PACKETS; i++)
+    {
+      Buffer packet = annexB[i];
+      start = Clock::now();
+      ASSERT_TRUE(toBitstream.Convert(packet.data(), static_cast<int>(packet.size())));
+      toBitstreamTime += Clock::now() - start;
+      Buffer bitstream(toBitstream.GetConvertBuffer(),
+                       toBitstream.GetConvertBuffer() + toBitstream.GetConvertSize());
+
+      start = Clock::now();
+      ASSERT_TRUE(toAnnexB.Convert(bitstream.data(), static_cast<int>(bitstream.size())));
+      toAnnexBTime += Clock::now() - start;
+
+      // slices only, nothing gets prepended
+      if (round == 0)
+      {
+        EXPECT_EQ(ToBitstream(packets[i], 4), bitstream);
+        EXPECT_EQ(annexB[i], Buffer(toAnnexB.GetConvertBuffer(),
+                                    toAnnexB.GetConvertBuffer() + toAnnexB.GetConvertSize()));
+      }
+    }
+  }
+
+  RecordProperty("wordwise_scan_mbps", std::to_string(static_cast<int>(mbPerSecond(scan))));
+  RecordProperty("annexb_to_bitstream_mbps",
+                 std::to_string(static_cast<int>(mbPerSecond(toBitstreamTime))));
+  RecordProperty("bitstream_to_annexb_mbps",
+                 std::to_string(static_cast<int>(mbPerSecond(toAnnexBTime))));
+}
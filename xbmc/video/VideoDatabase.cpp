@@ -25,6 +25,7 @@
 #include "dialogs/GUIDialogProgress.h"
 #include "dialogs/GUIDialogYesNo.h"
 #include "filesystem/Directory.h"
+#include "filesystem/DirectoryChangeJournal.h"
 #include "filesystem/File.h"
 #include "filesystem/MultiPathDirectory.h"
 #include "filesystem/PluginDirectory.h"
@@ -100,6 +101,9 @@ void CVideoDatabase::CreateTables()
   CLog::Log(LOGINFO, "create stacktimes table");
   m_pDS->exec("CREATE TABLE stacktimes (idFile integer, times text)\n");
 
+  CLog::Log(LOGINFO, "create keyframes table");
+  m_pDS->exec("CREATE TABLE keyframes (idFile integer primary key, keyframes text)\n");
+
   CLog::Log(LOGINFO, "create genre table");
   m_pDS->exec("CREATE TABLE genre ( genre_id integer primary key, name TEXT)\n");
   m_pDS->exec("CREATE TABLE genre_link (genre_id integer, media_id integer, media_type TEXT)");
@@ -343,6 +347,7 @@ void CVideoDatabase::CreateAnalytics()
               "DELETE FROM settings WHERE idFile=old.idFile; "
               "DELETE FROM stacktimes WHERE idFile=old.idFile; "
               "DELETE FROM streamdetails WHERE idFile=old.idFile; "
+              "DELETE FROM keyframes WHERE idFile=old.idFile; "
               "END");
 
   CreateViews();
@@ -5057,6 +5062,54 @@ void CVideoDatabase::SetStackTimes(const std::string& filePath, const std::vecto
   }
 }
 
+bool CVideoDatabase::GetKeyframeIndex(const std::string& filePath, std::string& keyframes)
+{
+  try
+  {
+    int idFile = GetFileId(filePath);
+    if (idFile < 0)
+      return false;
+    if (nullptr == m_pDB)
+      return false;
+    if (nullptr == m_pDS)
+      return false;
+
+    m_pDS->query(PrepareSQL("SELECT keyframes FROM keyframes WHERE idFile=%i", idFile));
+    bool found = !m_pDS->eof();
+    if (found)
+      keyframes = m_pDS->fv(0).get_asString();
+    m_pDS->close();
+    return found;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s (%s) failed", __FUNCTION__, filePath.c_str());
+  }
+  return false;
+}
+
+void CVideoDatabase::SetKeyframeIndex(const std::string& filePath, const std::string& keyframes)
+{
+  try
+  {
+    if (nullptr == m_pDB)
+      return;
+    if (nullptr == m_pDS)
+      return;
+    int idFile = GetFileId(filePath);
+    if (idFile < 0)
+      return;
+
+    m_pDS->exec(PrepareSQL("DELETE FROM keyframes WHERE idFile=%i", idFile));
+    m_pDS->exec(PrepareSQL("INSERT INTO keyframes (idFile, keyframes) VALUES (%i, '%s')", idFile,
+                           keyframes.c_str()));
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s (%s) failed", __FUNCTION__, filePath.c_str());
+  }
+}
+
 void CVideoDatabase::RemoveContentForPath(const std::string& strPath, CGUIDialogProgress *progress /* = NULL */)
 {
   if(URIUtils::IsMultiPath(strPath))
@@ -5067,6 +5120,10 @@ void CVideoDatabase::RemoveContentForPath(const std::string& strPath, CGUIDialog
     for(unsigned i=0;i<paths.size();i++)
       RemoveContentForPath(paths[i], progress);
   }
+  else
+  {
+    CDirectoryChangeJournal::GetInstance().Remove(strPath);
+  }
 
   try
   {
@@ -5811,11 +5868,14 @@ void CVideoDatabase::UpdateTables(int iVersion)
 
   if (iVersion < 119)
     m_pDS->exec("ALTER TABLE path ADD allAudio bool");
+
+  if (iVersion < 120)
+    m_pDS->exec("CREATE TABLE keyframes (idFile integer primary key, keyframes text)");
 }
 
 int CVideoDatabase::GetSchemaVersion() const
 {
-  return 119;
+  return 120;
 }
 
 bool CVideoDatabase::LookupByFolders(const std::string &path, bool shows)
@@ -610,6 +610,18 @@ public:
   bool GetStackTimes(const std::string &filePath, std::vector<uint64_t> &times);
   void SetStackTimes(const std::string &filePath, const std::vector<uint64_t> &times);
 
+  /*! \brief Get the serialized keyframe index of a file, see CKeyframeIndex.
+   \param filePath the path of the file
+   \param keyframes [out] the serialized index
+   \return true if an index is stored for the file
+   */
+  bool GetKeyframeIndex(const std::string& filePath, std::string& keyframes);
+
+  /*! \brief Store the serialized keyframe index of a file. Only files already known to the
+   database get an index, others are not added for it.
+   */
+  void SetKeyframeIndex(const std::string& filePath, const std::string& keyframes);
+
   void GetBookMarksForFile(const std::string& strFilenameAndPath, VECBOOKMARKS& bookmarks, CBookmark::EType type = CBookmark::STANDARD, bool bAppend=false, long partNumber=0);
   void AddBookMarkToFile(const std::string& strFilenameAndPath, const CBookmark &bookmark, CBookmark::EType type = CBookmark::STANDARD);
   bool GetResumeBookMark(const std::string& strFilenameAndPath, CBookmark &bookmark);
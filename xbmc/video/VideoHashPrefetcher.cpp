@@ -0,0 +1,154 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "VideoHashPrefetcher.h"
+
+#include "URL.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+
+#include <algorithm>
+
+using namespace VIDEO;
+
+class CVideoHashPrefetcher::CWorker : public CThread
+{
+public:
+  explicit CWorker(CVideoHashPrefetcher& owner)
+    : CThread("VideoHashPrefetcher"), m_owner(owner)
+  {
+  }
+
+protected:
+  void Process() override { m_owner.Process(); }
+
+private:
+  CVideoHashPrefetcher& m_owner;
+};
+
+CVideoHashPrefetcher::CVideoHashPrefetcher(unsigned int maxThreads, unsigned int maxPerHost)
+  : m_maxThreads(std::max(maxThreads, 1u)), m_maxPerHost(std::max(maxPerHost, 1u))
+{
+}
+
+CVideoHashPrefetcher::~CVideoHashPrefetcher()
+{
+  Stop();
+}
+
+void CVideoHashPrefetcher::Add(const std::string& path,
+                               const HashFunction& hashFunction,
+                               bool first /* = false */)
+{
+  CSingleLock lock(m_critSection);
+  if (first)
+    m_queue.push_front({path, CURL(path).GetHostName(), hashFunction});
+  else
+    m_queue.push_back({path, CURL(path).GetHostName(), hashFunction});
+  m_condition.notifyAll();
+}
+
+void CVideoHashPrefetcher::Start()
+{
+  {
+    CSingleLock lock(m_critSection);
+    m_bStop = false;
+  }
+
+  while (m_workers.size() < m_maxThreads)
+  {
+    m_workers.emplace_back(new CWorker(*this));
+    m_workers.back()->Create();
+  }
+}
+
+void CVideoHashPrefetcher::Stop()
+{
+  {
+    CSingleLock lock(m_critSection);
+    m_bStop = true;
+    m_queue.clear();
+    m_condition.notifyAll();
+  }
+
+  for (const auto& worker : m_workers)
+    worker->StopThread(true);
+  m_workers.clear();
+
+  CSingleLock lock(m_critSection);
+  m_results.clear();
+}
+
+bool CVideoHashPrefetcher::NextJob(Job& job)
+{
+  // the first queued path whose host is not busy yet
+  for (auto it = m_queue.begin(); it != m_queue.end(); ++it)
+  {
+    if (m_activePerHost[(*it).host] < m_maxPerHost)
+    {
+      job = std::move(*it);
+      m_queue.erase(it);
+      return true;
+    }
+  }
+  return false;
+}
+
+void CVideoHashPrefetcher::Process()
+{
+  CSingleLock lock(m_critSection);
+  while (!m_bStop)
+  {
+    Job job;
+    if (!NextJob(job))
+    {
+      // nothing to do, or all queued paths are on busy hosts
+      m_condition.wait(lock, 1000);
+      continue;
+    }
+
+    m_activePerHost[job.host]++;
+    m_running.insert(job.path);
+
+    std::string hash;
+    {
+      CSingleExit exit(m_critSection);
+      hash = job.hashFunction();
+    }
+
+    m_activePerHost[job.host]--;
+    m_running.erase(job.path);
+    m_results[job.path] = hash;
+    m_condition.notifyAll();
+  }
+}
+
+bool CVideoHashPrefetcher::Get(const std::string& path, std::string& hash)
+{
+  CSingleLock lock(m_critSection);
+
+  // still queued: the scanner caught up with the prefetcher
+  auto queued = std::find_if(m_queue.begin(), m_queue.end(),
+                             [&path](const Job& job) { return job.path == path; });
+  if (queued != m_queue.end())
+  {
+    m_queue.erase(queued);
+    return false;
+  }
+
+  while (m_running.find(path) != m_running.end())
+    m_condition.wait(lock);
+
+  const auto result = m_results.find(path);
+  if (result == m_results.end())
+    return false;
+
+  hash = result->second;
+  m_results.erase(result);
+  return true;
+}
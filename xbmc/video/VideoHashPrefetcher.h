@@ -0,0 +1,96 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+class CThread;
+
+namespace VIDEO
+{
+  /*!
+   \brief Computes the (fast) hashes of the paths the scanner is going to visit ahead of time.
+
+   The scanner visits the paths of a library one after another and waits for every stat or
+   listing round trip. The hashes are independent of each other, so they are computed on a
+   small pool of threads in the order the scanner will ask for them, with a limit on the
+   number of concurrent requests to a single host. The scanner still processes (scrapes and
+   writes) the paths in its own order and just picks up the results.
+   */
+  class CVideoHashPrefetcher
+  {
+  public:
+    using HashFunction = std::function<std::string()>;
+
+    /*!
+     \param maxThreads number of threads computing hashes
+     \param maxPerHost max number of hashes computed concurrently for paths on the same host
+     */
+    CVideoHashPrefetcher(unsigned int maxThreads, unsigned int maxPerHost);
+    ~CVideoHashPrefetcher();
+
+    /*! \brief Queue a path, hashes are computed in the order the paths are added.
+     \param path the path, also used to determine the host
+     \param hashFunction computes the hash of the path
+     \param first queue the path ahead of all queued paths, e.g. for the subfolders of the folder
+     the scanner is in
+     */
+    void Add(const std::string& path, const HashFunction& hashFunction, bool first = false);
+
+    /*! \brief Start computing the queued hashes. */
+    void Start();
+
+    /*! \brief Stop computing hashes, waits for the running computations to finish. */
+    void Stop();
+
+    /*! \brief Get the hash of a path. Waits if the hash is being computed right now.
+     A path that is still queued is removed from the queue, the caller is expected to compute
+     its hash itself instead of waiting for the queue to catch up.
+     \param path the path
+     \param hash [out] the hash
+     \return true if the hash was computed, false if the caller has to compute it
+     */
+    bool Get(const std::string& path, std::string& hash);
+
+  private:
+    class CWorker;
+    friend class CWorker;
+
+    struct Job
+    {
+      std::string path;
+      std::string host;
+      HashFunction hashFunction;
+    };
+
+    void Process();
+    bool NextJob(Job& job);
+
+    const unsigned int m_maxThreads;
+    const unsigned int m_maxPerHost;
+
+    CCriticalSection m_critSection;
+    XbmcThreads::ConditionVariable m_condition;
+    std::deque<Job> m_queue;
+    std::map<std::string, unsigned int> m_activePerHost;
+    std::set<std::string> m_running;
+    std::map<std::string, std::string> m_results; // path -> hash
+    std::vector<std::unique_ptr<CThread>> m_workers;
+    bool m_bStop = false;
+  };
+}
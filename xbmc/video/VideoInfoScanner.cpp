@@ -23,6 +23,7 @@
 #include "events/MediaLibraryEvent.h"
 #include "filesystem/Directory.h"
 #include "filesystem/DirectoryCache.h"
+#include "filesystem/DirectoryChangeJournal.h"
 #include "filesystem/File.h"
 #include "filesystem/MultiPathDirectory.h"
 #include "filesystem/PluginDirectory.h"
@@ -44,6 +45,7 @@
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
 #include "utils/log.h"
+#include "video/VideoHashPrefetcher.h"
 #include "video/VideoLibraryQueue.h"
 #include "video/VideoThumbLoader.h"
 
@@ -57,6 +59,16 @@ using namespace KODI::MESSAGING;
 using KODI::MESSAGING::HELPERS::DialogResponse;
 using KODI::UTILITY::CDigest;
 
+namespace
+{
+// bounds for computing fast hashes ahead of the scan
+constexpr unsigned int HASH_PREFETCH_THREADS = 8;
+constexpr unsigned int HASH_PREFETCH_THREADS_PER_HOST = 4;
+
+// name of the video scanner in the directory change journal
+const std::string JOURNAL_SCANNER = "video";
+} // unnamed namespace
+
 namespace VIDEO
 {
 
@@ -113,6 +125,9 @@ namespace VIDEO
       // result in unexpected behaviour.
       m_bCanInterrupt = false;
 
+      m_pathsChecked = 0;
+      PrefetchFastHashes();
+
       bool bCancelled = false;
       while (!bCancelled && !m_pathsToScan.empty())
       {
@@ -141,6 +156,17 @@ namespace VIDEO
           bCancelled = true;
       }
 
+      if (m_hashPrefetcher)
+      {
+        m_hashPrefetcher->Stop();
+        m_hashPrefetcher.reset();
+      }
+
+      const unsigned int checkTime = XbmcThreads::SystemClockMillis() - tick;
+      CLog::Log(LOGINFO, "VideoInfoScanner: Checked %u paths in %s (%.1f paths/s)", m_pathsChecked,
+                StringUtils::SecondsToTimeString(checkTime / 1000).c_str(),
+                checkTime > 0 ? m_pathsChecked * 1000.0 / checkTime : 0.0);
+
       if (!bCancelled)
       {
         if (m_bClean)
@@ -165,6 +191,8 @@ namespace VIDEO
       CLog::Log(LOGERROR, "VideoInfoScanner: Exception while scanning.");
     }
 
+    m_hashPrefetcher.reset();
+
     m_bRunning = false;
     CServiceBroker::GetAnnouncementManager()->Announce(ANNOUNCEMENT::VideoLibrary,
                                                        "OnScanFinished");
@@ -283,11 +311,22 @@ namespace VIDEO
         m_handle->SetTitle(StringUtils::Format(g_localizeStrings.Get(str).c_str(), info->Name().c_str()));
       }
 
+      CDirectoryChangeJournal& journal = CDirectoryChangeJournal::GetInstance();
+      const bool unchanged = journal.IsUnchanged(JOURNAL_SCANNER, strDirectory);
+      journal.BeginScan(JOURNAL_SCANNER, strDirectory);
+
       std::string fastHash;
-      if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_bVideoLibraryUseFastHash && !URIUtils::IsPlugin(strDirectory))
-        fastHash = GetFastHash(strDirectory, regexps);
+      if (!unchanged && CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_bVideoLibraryUseFastHash && !URIUtils::IsPlugin(strDirectory))
+        fastHash = GetPrefetchedFastHash(strDirectory, regexps, false);
+
+      m_pathsChecked++;
 
-      if (m_database.GetPathHash(strDirectory, dbHash) && !fastHash.empty() && StringUtils::EqualsNoCase(fastHash, dbHash))
+      const bool hasDbHash = m_database.GetPathHash(strDirectory, dbHash);
+      if (hasDbHash && unchanged && !dbHash.empty())
+      { // no changes recorded since the last scan - no need to process anything
+        hash = dbHash;
+      }
+      else if (hasDbHash && !fastHash.empty() && StringUtils::EqualsNoCase(fastHash, dbHash))
       { // fast hashes match - no need to process anything
         hash = fastHash;
       }
@@ -379,6 +418,17 @@ namespace VIDEO
     if (m_handle)
       OnDirectoryScanned(strDirectory);
 
+    // hash the subfolders ahead of the recursion below, in the order it visits them
+    if (settings.recurse > 0 && (content == CONTENT_MOVIES || content == CONTENT_MUSICVIDEOS))
+    {
+      for (int i = items.Size() - 1; i >= 0; --i)
+      {
+        const CFileItemPtr pItem = items[i];
+        if (pItem->m_bIsFolder && !pItem->IsParentFolder() && !pItem->IsPlayList())
+          PrefetchFastHash(pItem->GetPath(), content, true);
+      }
+    }
+
     for (int i = 0; i < items.Size(); ++i)
     {
       CFileItemPtr pItem = items[i];
@@ -396,6 +446,13 @@ namespace VIDEO
         }
       }
     }
+
+    // the folder is complete once its hash is stored, otherwise it's processed again next time
+    std::string storedHash;
+    if (!m_bStop && !hash.empty() && m_database.GetPathHash(strDirectory, storedHash) &&
+        StringUtils::EqualsNoCase(storedHash, hash))
+      CDirectoryChangeJournal::GetInstance().EndScan(JOURNAL_SCANNER, strDirectory);
+
     return !m_bStop;
   }
 
@@ -865,7 +922,9 @@ namespace VIDEO
         }
       }
       else if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_bVideoLibraryUseFastHash)
-        hash = GetRecursiveFastHash(item->GetPath(), regexps);
+        hash = GetPrefetchedFastHash(item->GetPath(), regexps, true);
+
+      m_pathsChecked++;
 
       if (m_database.GetPathHash(item->GetPath(), dbHash) && (allowEmptyHash || !hash.empty()) && StringUtils::EqualsNoCase(dbHash, hash))
       {
@@ -2007,6 +2066,65 @@ namespace VIDEO
     return "";
   }
 
+  void CVideoInfoScanner::PrefetchFastHashes()
+  {
+    const std::shared_ptr<CAdvancedSettings> advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+    if (!advancedSettings->m_bVideoLibraryUseFastHash)
+      return;
+
+    m_hashPrefetcher.reset(new CVideoHashPrefetcher(HASH_PREFETCH_THREADS, HASH_PREFETCH_THREADS_PER_HOST));
+
+    // same order as the scan, so the prefetcher stays ahead of it
+    for (const auto& path : m_pathsToScan)
+    {
+      SScanSettings settings;
+      bool foundDirectly = false;
+      ScraperPtr info = m_database.GetScraperForPath(path, settings, foundDirectly);
+      CONTENT_TYPE content = info ? info->Content() : CONTENT_NONE;
+      if (content == CONTENT_NONE || (!m_scanAll && settings.noupdate))
+        continue;
+
+      // a show found directly is hashed from its listing, not with a fast hash
+      if (content != CONTENT_TVSHOWS || !foundDirectly || settings.parent_name_root)
+        PrefetchFastHash(path, content, false);
+    }
+
+    m_hashPrefetcher->Start();
+  }
+
+  void CVideoInfoScanner::PrefetchFastHash(const std::string &directory, CONTENT_TYPE content, bool first)
+  {
+    if (!m_hashPrefetcher || URIUtils::IsPlugin(directory))
+      return;
+
+    const std::shared_ptr<CAdvancedSettings> advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+    if (content == CONTENT_MOVIES || content == CONTENT_MUSICVIDEOS)
+    {
+      // DoScan() doesn't hash a folder without changes recorded since the last scan
+      const std::vector<std::string>& regexps = advancedSettings->m_moviesExcludeFromScanRegExps;
+      if (CUtil::ExcludeFileOrFolder(directory, regexps) ||
+          CDirectoryChangeJournal::GetInstance().IsUnchanged(JOURNAL_SCANNER, directory))
+        return;
+
+      m_hashPrefetcher->Add(directory, [this, directory, regexps]() { return GetFastHash(directory, regexps); }, first);
+    }
+    else if (content == CONTENT_TVSHOWS)
+    {
+      // show folders, hashed recursively by EnumerateSeriesFolder()
+      const std::vector<std::string> regexps = advancedSettings->m_tvshowExcludeFromScanRegExps;
+      m_hashPrefetcher->Add(directory, [this, directory, regexps]() { return GetRecursiveFastHash(directory, regexps); }, first);
+    }
+  }
+
+  std::string CVideoInfoScanner::GetPrefetchedFastHash(const std::string &directory, const std::vector<std::string> &excludes, bool recursive)
+  {
+    std::string hash;
+    if (m_hashPrefetcher && m_hashPrefetcher->Get(directory, hash))
+      return hash;
+
+    return recursive ? GetRecursiveFastHash(directory, excludes) : GetFastHash(directory, excludes);
+  }
+
   void CVideoInfoScanner::GetSeasonThumbs(const CVideoInfoTag &show,
       std::map<int, std::map<std::string, std::string>> &seasonArt, const std::vector<std::string> &artTypes, bool useLocal)
   {
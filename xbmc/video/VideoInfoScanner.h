@@ -12,6 +12,7 @@
 #include "VideoDatabase.h"
 #include "addons/Scraper.h"
 
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -22,6 +23,7 @@ class CFileItemList;
 
 namespace VIDEO
 {
+  class CVideoHashPrefetcher;
   class IVideoInfoTagLoader;
 
   typedef struct SScanSettings
@@ -212,6 +214,27 @@ namespace VIDEO
      */
     bool CanFastHash(const CFileItemList &items, const std::vector<std::string> &excludes) const;
 
+    /*! \brief Queue the fast hashes of all paths to scan for computation in the background
+     The content of each path is resolved here, so the prefetched hash is the one DoScan() or
+     EnumerateSeriesFolder() would compute for it.
+     */
+    void PrefetchFastHashes();
+
+    /*! \brief Queue the fast hash of a folder for computation in the background
+     \param directory folder to hash
+     \param content content of the folder
+     \param first compute it ahead of the hashes queued so far
+     */
+    void PrefetchFastHash(const std::string &directory, CONTENT_TYPE content, bool first);
+
+    /*! \brief Get a fast hash, either prefetched or computed right away
+     \param directory folder to hash
+     \param excludes string array of exclude expressions
+     \param recursive whether to compute the recursive hash
+     \return the md5 hash of the folder
+     */
+    std::string GetPrefetchedFastHash(const std::string &directory, const std::vector<std::string> &excludes, bool recursive);
+
     /*! \brief Process a series folder, filling in episode details and adding them to the database.
      @todo Ideally we would return INFO_HAVE_ALREADY if we don't have to update any episodes
      and we should return INFO_NOT_FOUND only if no information is found for any of
@@ -234,6 +257,8 @@ namespace VIDEO
     CVideoDatabase m_database;
     std::set<std::string> m_pathsToCount;
     std::set<int> m_pathsToClean;
+    std::unique_ptr<CVideoHashPrefetcher> m_hashPrefetcher;
+    unsigned int m_pathsChecked = 0;
 
   private:
     static void AddLocalItemArtwork(CGUIListItem::ArtMap& itemArt,
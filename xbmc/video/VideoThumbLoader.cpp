@@ -129,6 +129,11 @@ bool CThumbExtractor::DoWork()
         }
       }
     }
+    else if (m_fillStreamDetails && m_item.GetVideoInfoTag()->HasStreamDetails())
+    {
+      // no thumb, but keep the stream details probed with the same open
+      result = true;
+    }
   }
   else if (!m_item.IsPlugin() &&
            (!m_item.HasVideoInfoTag() ||
@@ -178,7 +183,7 @@ bool CThumbExtractor::DoWork()
 }
 
 CVideoThumbLoader::CVideoThumbLoader() :
-  CThumbLoader(), CJobQueue(true, 1, CJob::PRIORITY_LOW_PAUSABLE)
+  CThumbLoader(), CJobQueue(true, 2, CJob::PRIORITY_LOW_PAUSABLE)
 {
   m_videoDatabase = new CVideoDatabase();
 }
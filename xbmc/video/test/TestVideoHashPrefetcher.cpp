@@ -0,0 +1,142 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "utils/XTimeUtils.h"
+#include "video/VideoHashPrefetcher.h"
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace VIDEO;
+
+TEST(TestVideoHashPrefetcher, ReturnsComputedHashes)
+{
+  std::atomic<int> computed{0};
+  CVideoHashPrefetcher prefetcher(4, 4);
+  for (int i = 0; i < 20; i++)
+  {
+    const std::string path = "smb://server/movies/" + std::to_string(i) + "/";
+    prefetcher.Add(path, [path, &computed]() {
+      computed++;
+      return "hash:" + path;
+    });
+  }
+  prefetcher.Start();
+
+  // let the workers get ahead of the scanner
+  for (int i = 0; i < 500 && computed < 20; i++)
+    KODI::TIME::Sleep(10);
+
+  int prefetched = 0;
+  for (int i = 0; i < 20; i++)
+  {
+    const std::string path = "smb://server/movies/" + std::to_string(i) + "/";
+    std::string hash;
+    if (prefetcher.Get(path, hash))
+    {
+      EXPECT_EQ("hash:" + path, hash);
+      prefetched++;
+    }
+  }
+  EXPECT_EQ(20, prefetched);
+
+  // each result is handed out once
+  std::string hash;
+  EXPECT_FALSE(prefetcher.Get("smb://server/movies/0/", hash));
+  EXPECT_FALSE(prefetcher.Get("smb://server/unknown/", hash));
+}
+
+TEST(TestVideoHashPrefetcher, QueuesFirstPathsAhead)
+{
+  CCriticalSection section;
+  std::vector<std::string> order;
+  auto hashFunction = [&section, &order](const std::string& path) {
+    CSingleLock lock(section);
+    order.push_back(path);
+    return std::string("hash");
+  };
+
+  CVideoHashPrefetcher prefetcher(1, 1);
+  for (const std::string path : {"/movies/a/", "/movies/b/"})
+    prefetcher.Add(path, std::bind(hashFunction, path));
+  // the subfolders of a, the way the scanner queues them
+  for (const std::string path : {"/movies/a/2/", "/movies/a/1/"})
+    prefetcher.Add(path, std::bind(hashFunction, path), true);
+  prefetcher.Start();
+
+  for (int i = 0; i < 500; i++)
+  {
+    {
+      CSingleLock lock(section);
+      if (order.size() == 4)
+        break;
+    }
+    KODI::TIME::Sleep(10);
+  }
+  prefetcher.Stop();
+
+  const std::vector<std::string> expected = {"/movies/a/1/", "/movies/a/2/", "/movies/a/",
+                                             "/movies/b/"};
+  EXPECT_EQ(expected, order);
+}
+
+TEST(TestVideoHashPrefetcher, LimitsRequestsPerHost)
+{
+  std::atomic<int> active{0};
+  std::atomic<int> maxActive{0};
+  auto hashFunction = [&active, &maxActive]() {
+    int current = ++active;
+    int seen = maxActive.load();
+    while (current > seen && !maxActive.compare_exchange_weak(seen, current))
+      ;
+    KODI::TIME::Sleep(20);
+    --active;
+    return std::string("hash");
+  };
+
+  CVideoHashPrefetcher prefetcher(8, 2);
+  for (int i = 0; i < 12; i++)
+    prefetcher.Add("nfs://nas/tvshows/" + std::to_string(i) + "/", hashFunction);
+  prefetcher.Start();
+
+  // let the workers pick up jobs before the paths are requested
+  std::string hash;
+  KODI::TIME::Sleep(50);
+  for (int i = 0; i < 12; i++)
+    prefetcher.Get("nfs://nas/tvshows/" + std::to_string(i) + "/", hash);
+  prefetcher.Stop();
+
+  EXPECT_LE(maxActive.load(), 2);
+  EXPECT_GE(maxActive.load(), 1);
+}
+
+TEST(TestVideoHashPrefetcher, StopDiscardsQueuedPaths)
+{
+  std::atomic<int> computed{0};
+  CVideoHashPrefetcher prefetcher(1, 1);
+  for (int i = 0; i < 100; i++)
+  {
+    prefetcher.Add("/movies/" + std::to_string(i), [&computed]() {
+      computed++;
+      KODI::TIME::Sleep(5);
+      return std::string("hash");
+    });
+  }
+  prefetcher.Start();
+  prefetcher.Stop();
+
+  EXPECT_LT(computed.load(), 100);
+  std::string hash;
+  EXPECT_FALSE(prefetcher.Get("/movies/99", hash));
+}
@@ -20,6 +20,7 @@
 #include "guilib/GUITextLayout.h"
 #include "guilib/GUIWindowManager.h"
 #include "input/WindowTranslator.h"
+#include "rendering/RenderSystem.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
 #include "utils/CPUInfo.h"
@@ -119,6 +120,9 @@ void CGUIWindowDebugInfo::Process(unsigned int currentTime, CDirtyRegionList &di
                                 stat.availPhys / 1024, stat.totalPhys / 1024, CServiceBroker::GetGUI()->GetInfoManager().GetInfoProviders().GetSystemInfoProvider().GetFPS(),
                                 strCores.c_str(), ucAppName.c_str(), dCPU, profiling.c_str());
 #endif
+    unsigned int drawCalls, quads;
+    if (CServiceBroker::GetRenderSystem()->GetGUIBatchStats(drawCalls, quads))
+      info += StringUtils::Format("\nGUI: %u draw calls (%u quads)", drawCalls, quads);
   }
 
   // render the skin debug info